@@ -9,7 +9,11 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
 #include <math.h>
+#include <string.h>
 
 static const char *TAG = "QMI8658A";
 
@@ -21,6 +25,15 @@ static qmi8658a_config_t g_config;
 static bool g_initialized = false;
 
 #define I2C_TIMEOUT_MS  1000
+#define CTRL9_TIMEOUT_MS 10
+
+// FIFO state
+static qmi8658a_fifo_config_t g_fifo;
+static bool g_fifo_enabled = false;
+static SemaphoreHandle_t g_fifo_sem = NULL;     // Given by the watermark ISR
+static uint32_t g_fifo_overflows = 0;
+static uint8_t g_fifo_buf[QMI8658A_FIFO_MAX_SAMPLES * QMI8658A_FIFO_SAMPLE_BYTES];
+static qmi8658a_raw_data_t g_fifo_raw[QMI8658A_FIFO_MAX_SAMPLES];  // Staging for converted reads
 
 // ═══════════════════════════════════════════════════════
 // I2C COMMUNICATION HELPERS
@@ -34,6 +47,20 @@ static esp_err_t write_reg(uint8_t reg_addr, uint8_t value)
                                      I2C_TIMEOUT_MS / portTICK_PERIOD_MS);
 }
 
+static esp_err_t write_regs(uint8_t reg_addr, const uint8_t *data, size_t len)
+{
+    uint8_t write_buf[9];
+    
+    if (len > sizeof(write_buf) - 1) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    write_buf[0] = reg_addr;
+    memcpy(&write_buf[1], data, len);
+    return i2c_master_write_to_device(g_config.i2c_num, g_config.i2c_addr,
+                                     write_buf, len + 1,
+                                     I2C_TIMEOUT_MS / portTICK_PERIOD_MS);
+}
+
 static esp_err_t read_reg(uint8_t reg_addr, uint8_t *out_value)
 {
     return i2c_master_write_read_device(g_config.i2c_num, g_config.i2c_addr,
@@ -50,44 +77,115 @@ static esp_err_t read_regs(uint8_t reg_addr, uint8_t *out_buf, size_t len)
                                        I2C_TIMEOUT_MS / portTICK_PERIOD_MS);
 }
 
+/**
+ * @brief Run a CTRL9 host command and acknowledge it
+ */
+static esp_err_t ctrl9_command(uint8_t cmd)
+{
+    esp_err_t ret = write_reg(QMI8658A_REG_CTRL9, cmd);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    uint8_t status = 0;
+    int64_t deadline = esp_timer_get_time() + CTRL9_TIMEOUT_MS * 1000;
+    do {
+        ret = read_reg(QMI8658A_REG_STATUSINT, &status);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (esp_timer_get_time() > deadline) {
+            return ESP_ERR_TIMEOUT;
+        }
+    } while (!(status & QMI8658A_STATUSINT_CMD_DONE));
+    
+    return write_reg(QMI8658A_REG_CTRL9, QMI8658A_CTRL9_CMD_ACK);
+}
+
+static void IRAM_ATTR fifo_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(g_fifo_sem, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
 // ═══════════════════════════════════════════════════════
 // CONVERSION HELPERS
 // ═══════════════════════════════════════════════════════
 
-static float accel_to_ms2(int16_t raw_value)
+// Sensitivity (LSB per unit) indexed by range bits
+static const float s_accel_lsb_per_g[4] = { 16384.0f, 8192.0f, 4096.0f, 2048.0f };
+static const float s_gyro_lsb_per_dps[8] = {
+    2048.0f, 1024.0f, 512.0f, 256.0f, 128.0f, 64.0f, 32.0f, 16.0f
+};
+
+// Fixed-point scales: accel is m/s² per LSB in Q32 (so raw * scale >> 16 is
+// Q16.16); gyro sensitivities are powers of two, so Q16.16 dps is a shift
+#define ACCEL_SCALE_Q32(lsb_per_g)  ((int32_t)(9.81 * 4294967296.0 / (lsb_per_g) + 0.5))
+static const int32_t s_accel_scale_q32[4] = {
+    ACCEL_SCALE_Q32(16384), ACCEL_SCALE_Q32(8192), ACCEL_SCALE_Q32(4096), ACCEL_SCALE_Q32(2048)
+};
+static const uint8_t s_gyro_shift[8] = { 5, 6, 7, 8, 9, 10, 11, 12 };
+
+// Active scales, selected from the configured ranges at init
+static float g_accel_scale = 9.81f / 4096.0f;
+static float g_gyro_scale = 1.0f / 64.0f;
+static int32_t g_accel_scale_q32 = ACCEL_SCALE_Q32(4096);
+static int32_t g_gyro_scale_q16 = 1L << 10;
+
+// Calibration, with the accel scales folded into per-axis conversion factors
+static qmi8658a_calibration_t g_cal = {
+    .accel_scale = { QMI8658A_Q16_ONE, QMI8658A_Q16_ONE, QMI8658A_Q16_ONE },
+};
+static float g_accel_axis_scale[3] = { 9.81f / 4096.0f, 9.81f / 4096.0f, 9.81f / 4096.0f };
+static int32_t g_accel_axis_q32[3] = { ACCEL_SCALE_Q32(4096), ACCEL_SCALE_Q32(4096), ACCEL_SCALE_Q32(4096) };
+
+static void select_scales(void)
 {
-    float sensitivity;
-    uint8_t range_bits = (g_config.accel_range >> 4) & 0x07;
-    
-    switch (range_bits) {
-        case 0x00: sensitivity = 16384.0f; break;  // ±2g
-        case 0x01: sensitivity = 8192.0f;  break;  // ±4g
-        case 0x02: sensitivity = 4096.0f;  break;  // ±8g
-        case 0x03: sensitivity = 2048.0f;  break;  // ±16g
-        default:   sensitivity = 4096.0f;
+    uint8_t accel_bits = (g_config.accel_range >> 4) & 0x03;
+    uint8_t gyro_bits = (g_config.gyro_range >> 4) & 0x07;
+    
+    g_accel_scale = 9.81f / s_accel_lsb_per_g[accel_bits];
+    g_gyro_scale = 1.0f / s_gyro_lsb_per_dps[gyro_bits];
+    g_accel_scale_q32 = s_accel_scale_q32[accel_bits];
+    g_gyro_scale_q16 = 1L << s_gyro_shift[gyro_bits];
+    
+    for (int axis = 0; axis < 3; axis++) {
+        int32_t scale = g_cal.accel_scale[axis];
+        g_accel_axis_scale[axis] = g_accel_scale * QMI8658A_Q16_TO_FLOAT(scale);
+        g_accel_axis_q32[axis] = (int32_t)(((int64_t)g_accel_scale_q32 * scale) >> 16);
     }
-    
-    return (raw_value / sensitivity) * 9.81f;
 }
 
-static float gyro_to_dps(int16_t raw_value)
+static inline float accel_to_ms2(int16_t raw_value, int axis)
 {
-    float sensitivity;
-    uint8_t range_bits = (g_config.gyro_range >> 4) & 0x07;
-    
-    switch (range_bits) {
-        case 0x00: sensitivity = 2048.0f; break;   // ±16 dps
-        case 0x01: sensitivity = 1024.0f; break;   // ±32 dps
-        case 0x02: sensitivity = 512.0f;  break;   // ±64 dps
-        case 0x03: sensitivity = 256.0f;  break;   // ±128 dps
-        case 0x04: sensitivity = 128.0f;  break;   // ±256 dps
-        case 0x05: sensitivity = 64.0f;   break;   // ±512 dps
-        case 0x06: sensitivity = 32.0f;   break;   // ±1024 dps
-        case 0x07: sensitivity = 16.0f;   break;   // ±2048 dps
-        default:   sensitivity = 64.0f;
-    }
-    
-    return raw_value / sensitivity;
+    return raw_value * g_accel_axis_scale[axis] - QMI8658A_Q16_TO_FLOAT(g_cal.accel_offset[axis]);
+}
+
+static inline float gyro_to_dps(int16_t raw_value, int axis)
+{
+    return raw_value * g_gyro_scale - QMI8658A_Q16_TO_FLOAT(g_cal.gyro_offset[axis]);
+}
+
+static inline int32_t accel_to_q16(int16_t raw_value, int axis)
+{
+    return (int32_t)(((int64_t)raw_value * g_accel_axis_q32[axis]) >> 16) - g_cal.accel_offset[axis];
+}
+
+static inline int32_t gyro_to_q16(int16_t raw_value, int axis)
+{
+    return (int32_t)raw_value * g_gyro_scale_q16 - g_cal.gyro_offset[axis];
+}
+
+static void unpack_sample(const uint8_t *data, qmi8658a_raw_data_t *out_data)
+{
+    // Combine bytes (little-endian)
+    out_data->accel_x = (int16_t)((data[1] << 8) | data[0]);
+    out_data->accel_y = (int16_t)((data[3] << 8) | data[2]);
+    out_data->accel_z = (int16_t)((data[5] << 8) | data[4]);
+    out_data->gyro_x = (int16_t)((data[7] << 8) | data[6]);
+    out_data->gyro_y = (int16_t)((data[9] << 8) | data[8]);
+    out_data->gyro_z = (int16_t)((data[11] << 8) | data[10]);
 }
 
 // ═══════════════════════════════════════════════════════
@@ -105,6 +203,7 @@ bool qmi8658a_init(const qmi8658a_config_t *config)
     }
     
     g_config = *config;
+    select_scales();
     
     ESP_LOGI(TAG, "Initializing on I2C%d (SDA: GPIO%d, SCL: GPIO%d, addr: 0x%02X)",
              g_config.i2c_num, g_config.sda_pin, g_config.scl_pin, g_config.i2c_addr);
@@ -231,13 +330,8 @@ bool qmi8658a_read_raw(qmi8658a_raw_data_t *out_data)
         return false;
     }
     
-    // Combine bytes (little-endian)
-    out_data->accel_x = (int16_t)((data[1] << 8) | data[0]);
-    out_data->accel_y = (int16_t)((data[3] << 8) | data[2]);
-    out_data->accel_z = (int16_t)((data[5] << 8) | data[4]);
-    out_data->gyro_x = (int16_t)((data[7] << 8) | data[6]);
-    out_data->gyro_y = (int16_t)((data[9] << 8) | data[8]);
-    out_data->gyro_z = (int16_t)((data[11] << 8) | data[10]);
+    unpack_sample(data, out_data);
+    out_data->timestamp_us = esp_timer_get_time();
     
     return true;
 }
@@ -250,22 +344,397 @@ bool qmi8658a_read(qmi8658a_data_t *out_data)
         return false;
     }
     
-    out_data->accel_x = accel_to_ms2(raw.accel_x);
-    out_data->accel_y = accel_to_ms2(raw.accel_y);
-    out_data->accel_z = accel_to_ms2(raw.accel_z);
+    qmi8658a_convert(&raw, out_data);
+    return true;
+}
+
+void qmi8658a_convert(const qmi8658a_raw_data_t *raw_data, qmi8658a_data_t *out_data)
+{
+    const qmi8658a_raw_data_t raw = *raw_data;
     
-    out_data->gyro_x = gyro_to_dps(raw.gyro_x);
-    out_data->gyro_y = gyro_to_dps(raw.gyro_y);
-    out_data->gyro_z = gyro_to_dps(raw.gyro_z);
+    out_data->accel_x = accel_to_ms2(raw.accel_x, 0);
+    out_data->accel_y = accel_to_ms2(raw.accel_y, 1);
+    out_data->accel_z = accel_to_ms2(raw.accel_z, 2);
+    
+    out_data->gyro_x = gyro_to_dps(raw.gyro_x, 0);
+    out_data->gyro_y = gyro_to_dps(raw.gyro_y, 1);
+    out_data->gyro_z = gyro_to_dps(raw.gyro_z, 2);
     
     out_data->accel_magnitude = sqrtf(
         out_data->accel_x * out_data->accel_x +
         out_data->accel_y * out_data->accel_y +
         out_data->accel_z * out_data->accel_z);
     
+    out_data->timestamp_us = raw.timestamp_us;
+}
+
+bool qmi8658a_read_fixed(qmi8658a_fixed_data_t *out_data)
+{
+    qmi8658a_raw_data_t raw;
+    
+    if (!qmi8658a_read_raw(&raw)) {
+        return false;
+    }
+    
+    qmi8658a_convert_fixed(&raw, out_data);
     return true;
 }
 
+void qmi8658a_convert_fixed(const qmi8658a_raw_data_t *raw_data, qmi8658a_fixed_data_t *out_data)
+{
+    out_data->accel_x = accel_to_q16(raw_data->accel_x, 0);
+    out_data->accel_y = accel_to_q16(raw_data->accel_y, 1);
+    out_data->accel_z = accel_to_q16(raw_data->accel_z, 2);
+    
+    out_data->gyro_x = gyro_to_q16(raw_data->gyro_x, 0);
+    out_data->gyro_y = gyro_to_q16(raw_data->gyro_y, 1);
+    out_data->gyro_z = gyro_to_q16(raw_data->gyro_z, 2);
+    
+    out_data->timestamp_us = raw_data->timestamp_us;
+}
+
+uint32_t qmi8658a_get_sample_period_us(void)
+{
+    // Actual output rates of the nominal ODR settings (datasheet table)
+    static const float odr_hz[] = {
+        7174.4f, 3587.2f, 1793.6f, 896.8f, 448.4f, 224.2f, 112.1f, 56.05f, 28.025f
+    };
+    
+    uint8_t odr = g_config.gyro_odr & 0x0F;
+    if (odr >= sizeof(odr_hz) / sizeof(odr_hz[0])) {
+        odr = QMI8658A_GYRO_ODR_500;
+    }
+    return (uint32_t)(1e6f / odr_hz[odr]);
+}
+
+void qmi8658a_set_calibration(const qmi8658a_calibration_t *cal)
+{
+    if (cal) {
+        g_cal = *cal;
+    } else {
+        memset(&g_cal, 0, sizeof(g_cal));
+        for (int axis = 0; axis < 3; axis++) {
+            g_cal.accel_scale[axis] = QMI8658A_Q16_ONE;
+        }
+    }
+    select_scales();
+}
+
+void qmi8658a_get_calibration(qmi8658a_calibration_t *cal)
+{
+    *cal = g_cal;
+}
+
+bool qmi8658a_set_odr(qmi8658a_accel_odr_t accel_odr, qmi8658a_gyro_odr_t gyro_odr)
+{
+    if (!g_initialized) {
+        ESP_LOGE(TAG, "Not initialized");
+        return false;
+    }
+    
+    g_config.accel_odr = accel_odr;
+    g_config.gyro_odr = gyro_odr;
+    
+    // Rates are only changed with the sensors stopped
+    esp_err_t ret = write_reg(QMI8658A_REG_CTRL7, 0x00);
+    if (ret == ESP_OK) {
+        ret = write_reg(QMI8658A_REG_CTRL2, (g_config.accel_range & 0x70) | (accel_odr & 0x0F));
+    }
+    if (ret == ESP_OK) {
+        ret = write_reg(QMI8658A_REG_CTRL3, (g_config.gyro_range & 0x70) | (gyro_odr & 0x0F));
+    }
+    if (ret == ESP_OK) {
+        ret = write_reg(QMI8658A_REG_CTRL7, QMI8658A_CTRL7_ACCEL_EN | QMI8658A_CTRL7_GYRO_EN);
+    }
+    
+    // Samples at the old rate would get the new period's timestamps
+    if (ret == ESP_OK && g_fifo_enabled) {
+        ret = ctrl9_command(QMI8658A_CTRL9_CMD_RST_FIFO);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to change ODR: %s", esp_err_to_name(ret));
+        return false;
+    }
+    
+    ESP_LOGD(TAG, "ODR: accel %d, gyro %d (%lu us period)", accel_odr, gyro_odr,
+             (unsigned long)qmi8658a_get_sample_period_us());
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════
+// MOTION ENGINE API
+// ═══════════════════════════════════════════════════════
+
+// MOTION_MODE_CTRL: any-motion on X, Y or Z; no-motion needs X, Y and Z
+#define MOTION_MODE_ANY_XYZ_OR  0x07
+#define MOTION_MODE_NO_XYZ_AND  0xF0
+
+/**
+ * @brief Motion threshold in the engine's unsigned 3.5 fixed point (g)
+ */
+static uint8_t motion_threshold(float g)
+{
+    if (g <= 0) return 0;
+    if (g >= 255.0f / 32.0f) return 255;
+    return (uint8_t)(g * 32.0f + 0.5f);
+}
+
+bool qmi8658a_motion_enable(const qmi8658a_motion_config_t *motion)
+{
+    if (!g_initialized || motion == NULL) {
+        ESP_LOGE(TAG, "Not initialized");
+        return false;
+    }
+    
+    uint8_t any = motion_threshold(motion->any_threshold_g);
+    uint8_t still = motion_threshold(motion->no_threshold_g);
+    
+    // Page 1: per-axis thresholds and axis logic; page 2: windows
+    // (significant-motion windows are left at 0, it stays off)
+    const uint8_t page1[8] = {
+        any, any, any, still, still, still,
+        MOTION_MODE_ANY_XYZ_OR | MOTION_MODE_NO_XYZ_AND, 0x01
+    };
+    const uint8_t page2[8] = { motion->any_window, motion->no_window, 0, 0, 0, 0, 0, 0x02 };
+    
+    uint8_t ctrl1 = 0;
+    esp_err_t ret = write_reg(QMI8658A_REG_CTRL7, 0x00);
+    if (ret == ESP_OK) {
+        ret = write_regs(QMI8658A_REG_CAL1_L, page1, sizeof(page1));
+    }
+    if (ret == ESP_OK) {
+        ret = ctrl9_command(QMI8658A_CTRL9_CMD_CFG_MOTION);
+    }
+    if (ret == ESP_OK) {
+        ret = write_regs(QMI8658A_REG_CAL1_L, page2, sizeof(page2));
+    }
+    if (ret == ESP_OK) {
+        ret = ctrl9_command(QMI8658A_CTRL9_CMD_CFG_MOTION);
+    }
+    
+    // Enable the output pin alongside whatever the FIFO set up
+    if (ret == ESP_OK) {
+        ret = read_reg(QMI8658A_REG_CTRL1, &ctrl1);
+    }
+    if (ret == ESP_OK) {
+        ctrl1 |= (motion->int_line == QMI8658A_INT1) ? QMI8658A_CTRL1_INT1_EN : QMI8658A_CTRL1_INT2_EN;
+        ret = write_reg(QMI8658A_REG_CTRL1, ctrl1);
+    }
+    if (ret == ESP_OK) {
+        uint8_t ctrl8 = QMI8658A_CTRL8_HANDSHAKE_STATUSINT |
+                        QMI8658A_CTRL8_ANY_MOTION_EN | QMI8658A_CTRL8_NO_MOTION_EN;
+        if (motion->int_line == QMI8658A_INT1) {
+            ctrl8 |= QMI8658A_CTRL8_ACTIVITY_INT1;
+        }
+        ret = write_reg(QMI8658A_REG_CTRL8, ctrl8);
+    }
+    if (ret == ESP_OK) {
+        ret = write_reg(QMI8658A_REG_CTRL7, QMI8658A_CTRL7_ACCEL_EN | QMI8658A_CTRL7_GYRO_EN);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure motion engine: %s", esp_err_to_name(ret));
+        return false;
+    }
+    
+    ESP_LOGI(TAG, "Motion engine: any > %.2f g x%d, still < %.2f g x%d",
+             any / 32.0f, motion->any_window, still / 32.0f, motion->no_window);
+    return true;
+}
+
+bool qmi8658a_motion_read(uint8_t *status)
+{
+    if (!g_initialized || status == NULL) {
+        return false;
+    }
+    return read_reg(QMI8658A_REG_STATUS1, status) == ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════
+// FIFO API
+// ═══════════════════════════════════════════════════════
+
+bool qmi8658a_fifo_enable(const qmi8658a_fifo_config_t *fifo)
+{
+    if (!g_initialized || fifo == NULL) {
+        ESP_LOGE(TAG, "Not initialized");
+        return false;
+    }
+    
+    g_fifo = *fifo;
+    if (g_fifo.watermark == 0) {
+        g_fifo.watermark = 1;
+    }
+    
+    // Route the FIFO interrupt to the selected pin
+    uint8_t ctrl1 = QMI8658A_CTRL1_ADDR_AI;
+    if (g_fifo.int_pin != GPIO_NUM_NC) {
+        ctrl1 |= (g_fifo.int_line == QMI8658A_INT1)
+            ? (QMI8658A_CTRL1_INT1_EN | QMI8658A_CTRL1_FIFO_INT_SEL)
+            : QMI8658A_CTRL1_INT2_EN;
+    }
+    
+    esp_err_t ret = write_reg(QMI8658A_REG_CTRL1, ctrl1);
+    if (ret == ESP_OK) {
+        ret = write_reg(QMI8658A_REG_FIFO_WTM_TH, g_fifo.watermark);
+    }
+    if (ret == ESP_OK) {
+        ret = write_reg(QMI8658A_REG_FIFO_CTRL, (g_fifo.size & 0x0C) | (g_fifo.mode & 0x03));
+    }
+    if (ret == ESP_OK) {
+        ret = ctrl9_command(QMI8658A_CTRL9_CMD_RST_FIFO);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure FIFO: %s", esp_err_to_name(ret));
+        return false;
+    }
+    
+    if (g_fifo_sem == NULL) {
+        g_fifo_sem = xSemaphoreCreateBinary();
+        if (g_fifo_sem == NULL) {
+            ESP_LOGE(TAG, "Failed to create FIFO semaphore");
+            return false;
+        }
+    }
+    
+    if (g_fifo.int_pin != GPIO_NUM_NC) {
+        gpio_config_t io = {
+            .pin_bit_mask = 1ULL << g_fifo.int_pin,
+            .mode = GPIO_MODE_INPUT,
+            .pull_up_en = GPIO_PULLUP_DISABLE,
+            .pull_down_en = GPIO_PULLDOWN_ENABLE,
+            .intr_type = GPIO_INTR_POSEDGE,
+        };
+        ret = gpio_config(&io);
+        
+        // The ISR service may already be installed by another driver
+        esp_err_t isr_ret = gpio_install_isr_service(0);
+        if (ret == ESP_OK && isr_ret != ESP_OK && isr_ret != ESP_ERR_INVALID_STATE) {
+            ret = isr_ret;
+        }
+        if (ret == ESP_OK) {
+            ret = gpio_isr_handler_add(g_fifo.int_pin, fifo_isr, NULL);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to set up INT GPIO%d: %s", g_fifo.int_pin, esp_err_to_name(ret));
+            return false;
+        }
+    }
+    
+    g_fifo_enabled = true;
+    ESP_LOGI(TAG, "FIFO enabled: watermark %d samples, %s",
+             g_fifo.watermark,
+             g_fifo.int_pin != GPIO_NUM_NC ? "interrupt driven" : "polled");
+    return true;
+}
+
+bool qmi8658a_fifo_wait(uint32_t timeout_ms)
+{
+    if (!g_fifo_enabled) {
+        return false;
+    }
+    
+    if (g_fifo.int_pin == GPIO_NUM_NC) {
+        // No interrupt line: sleep about one watermark worth of samples
+        uint32_t wait_ms = (qmi8658a_get_sample_period_us() * g_fifo.watermark) / 1000;
+        if (wait_ms > timeout_ms) {
+            wait_ms = timeout_ms;
+        }
+        TickType_t ticks = pdMS_TO_TICKS(wait_ms);
+        vTaskDelay(ticks > 0 ? ticks : 1);
+        return false;
+    }
+    
+    return xSemaphoreTake(g_fifo_sem, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+int qmi8658a_fifo_read_raw(qmi8658a_raw_data_t *out, int max_samples)
+{
+    if (!g_fifo_enabled || out == NULL || max_samples <= 0) {
+        return -1;
+    }
+    
+    // Put the FIFO into read mode
+    esp_err_t ret = ctrl9_command(QMI8658A_CTRL9_CMD_REQ_FIFO);
+    if (ret != ESP_OK) {
+        return -1;
+    }
+    
+    uint8_t level[2];
+    ret = read_regs(QMI8658A_REG_FIFO_SMPL_CNT, level, sizeof(level));
+    int64_t read_us = esp_timer_get_time();
+    
+    int count = 0;
+    if (ret == ESP_OK) {
+        if (level[1] & QMI8658A_FIFO_STATUS_OVFLOW) {
+            g_fifo_overflows++;
+        }
+        
+        size_t bytes = (size_t)(((level[1] & 0x03) << 8) | level[0]) * 2;
+        if (bytes > sizeof(g_fifo_buf)) {
+            bytes = sizeof(g_fifo_buf);
+        }
+        count = bytes / QMI8658A_FIFO_SAMPLE_BYTES;
+        
+        // One burst for the whole batch
+        if (count > 0) {
+            ret = read_regs(QMI8658A_REG_FIFO_DATA, g_fifo_buf, count * QMI8658A_FIFO_SAMPLE_BYTES);
+        }
+    }
+    
+    // Leave read mode so the FIFO keeps filling
+    write_reg(QMI8658A_REG_FIFO_CTRL, (g_fifo.size & 0x0C) | (g_fifo.mode & 0x03));
+    
+    if (ret != ESP_OK) {
+        return -1;
+    }
+    
+    int first = (count > max_samples) ? count - max_samples : 0;
+    uint32_t period_us = qmi8658a_get_sample_period_us();
+    
+    for (int i = first; i < count; i++) {
+        qmi8658a_raw_data_t *sample = &out[i - first];
+        unpack_sample(&g_fifo_buf[i * QMI8658A_FIFO_SAMPLE_BYTES], sample);
+        sample->timestamp_us = read_us - (int64_t)(count - 1 - i) * period_us;
+    }
+    
+    return count - first;
+}
+
+int qmi8658a_fifo_read(qmi8658a_data_t *out, int max_samples)
+{
+    qmi8658a_raw_data_t *raw = g_fifo_raw;
+    
+    if (max_samples > QMI8658A_FIFO_MAX_SAMPLES) {
+        max_samples = QMI8658A_FIFO_MAX_SAMPLES;
+    }
+    
+    int count = qmi8658a_fifo_read_raw(raw, max_samples);
+    for (int i = 0; i < count; i++) {
+        qmi8658a_convert(&raw[i], &out[i]);
+    }
+    return count;
+}
+
+int qmi8658a_fifo_read_fixed(qmi8658a_fixed_data_t *out, int max_samples)
+{
+    qmi8658a_raw_data_t *raw = g_fifo_raw;
+    
+    if (max_samples > QMI8658A_FIFO_MAX_SAMPLES) {
+        max_samples = QMI8658A_FIFO_MAX_SAMPLES;
+    }
+    
+    int count = qmi8658a_fifo_read_raw(raw, max_samples);
+    for (int i = 0; i < count; i++) {
+        qmi8658a_convert_fixed(&raw[i], &out[i]);
+    }
+    return count;
+}
+
+uint32_t qmi8658a_fifo_get_overflows(void)
+{
+    return g_fifo_overflows;
+}
+
 void qmi8658a_debug_status(void)
 {
     uint8_t val;
@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "driver/i2c.h"
+#include "driver/gpio.h"
 
 // ═══════════════════════════════════════════════════════
 // QMI8658A CONFIGURATION
@@ -35,6 +36,19 @@
 #define QMI8658A_REG_CTRL7          0x08        // Enable Sensors
 #define QMI8658A_REG_CTRL8          0x09        // Motion Detection
 #define QMI8658A_REG_CTRL9          0x0A        // Host Commands
+#define QMI8658A_REG_CAL1_L         0x0B        // Host command parameters (CAL1_L..CAL4_H)
+#define QMI8658A_REG_CAL1_H         0x0C
+#define QMI8658A_REG_CAL2_L         0x0D
+#define QMI8658A_REG_CAL2_H         0x0E
+#define QMI8658A_REG_CAL3_L         0x0F
+#define QMI8658A_REG_CAL3_H         0x10
+#define QMI8658A_REG_CAL4_L         0x11
+#define QMI8658A_REG_CAL4_H         0x12
+
+#define QMI8658A_REG_FIFO_WTM_TH    0x13        // FIFO watermark (samples)
+#define QMI8658A_REG_FIFO_CTRL      0x14        // FIFO mode, size, read mode
+#define QMI8658A_REG_FIFO_SMPL_CNT  0x15        // FIFO fill level LSB (2-byte units)
+#define QMI8658A_REG_FIFO_STATUS    0x16        // FIFO flags + fill level MSB
 
 #define QMI8658A_REG_STATUSINT      0x2D        // Sensor Data Availability
 #define QMI8658A_REG_STATUS0        0x2E        // Output Data Overrun & Availability
@@ -55,6 +69,42 @@
 #define QMI8658A_REG_GZ_L           0x3F        // Gyroscope Z low byte
 #define QMI8658A_REG_GZ_H           0x40        // Gyroscope Z high byte
 
+#define QMI8658A_REG_FIFO_DATA      0x49        // FIFO read port
+
+// CTRL1 bits
+#define QMI8658A_CTRL1_ADDR_AI      (1 << 6)    // Register address auto-increment
+#define QMI8658A_CTRL1_INT2_EN      (1 << 4)    // INT2 pin output enable
+#define QMI8658A_CTRL1_INT1_EN      (1 << 3)    // INT1 pin output enable
+#define QMI8658A_CTRL1_FIFO_INT_SEL (1 << 2)    // FIFO interrupt on INT1 (else INT2)
+
+// CTRL7 bits
+#define QMI8658A_CTRL7_ACCEL_EN     (1 << 0)
+#define QMI8658A_CTRL7_GYRO_EN      (1 << 1)
+
+// CTRL8 bits (motion engine)
+#define QMI8658A_CTRL8_HANDSHAKE_STATUSINT (1 << 7) // CTRL9 done flag in STATUSINT, INT1 stays free
+#define QMI8658A_CTRL8_ACTIVITY_INT1 (1 << 6)   // Motion interrupts on INT1 (else INT2)
+#define QMI8658A_CTRL8_NO_MOTION_EN (1 << 2)
+#define QMI8658A_CTRL8_ANY_MOTION_EN (1 << 1)
+
+// CTRL9 host commands
+#define QMI8658A_CTRL9_CMD_ACK      0x00
+#define QMI8658A_CTRL9_CMD_RST_FIFO 0x04
+#define QMI8658A_CTRL9_CMD_REQ_FIFO 0x05
+#define QMI8658A_CTRL9_CMD_CFG_MOTION 0x0E      // Thresholds/windows from CAL1-CAL4, two pages
+
+// STATUS1 bits (cleared when read)
+#define QMI8658A_STATUS1_NO_MOTION  (1 << 6)
+#define QMI8658A_STATUS1_ANY_MOTION (1 << 5)
+
+// STATUSINT / FIFO_CTRL / FIFO_STATUS bits
+#define QMI8658A_STATUSINT_CMD_DONE (1 << 7)
+#define QMI8658A_FIFO_CTRL_RD_MODE  (1 << 7)
+#define QMI8658A_FIFO_STATUS_OVFLOW (1 << 5)
+
+#define QMI8658A_FIFO_SAMPLE_BYTES  12          // 6 accel + 6 gyro per FIFO sample
+#define QMI8658A_FIFO_MAX_SAMPLES   128
+
 // ═══════════════════════════════════════════════════════
 // ACCELEROMETER CONFIGURATION
 // ═══════════════════════════════════════════════════════
@@ -113,6 +163,31 @@ typedef enum {
     QMI8658A_GYRO_ODR_31   = 0x08,              // 28.025 Hz
 } qmi8658a_gyro_odr_t;
 
+// ═══════════════════════════════════════════════════════
+// FIFO CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+// FIFO depth in samples (bits 3:2 of FIFO_CTRL)
+typedef enum {
+    QMI8658A_FIFO_SIZE_16  = (0x00 << 2),
+    QMI8658A_FIFO_SIZE_32  = (0x01 << 2),
+    QMI8658A_FIFO_SIZE_64  = (0x02 << 2),
+    QMI8658A_FIFO_SIZE_128 = (0x03 << 2),
+} qmi8658a_fifo_size_t;
+
+// FIFO mode (bits 1:0 of FIFO_CTRL)
+typedef enum {
+    QMI8658A_FIFO_MODE_BYPASS = 0x00,           // FIFO disabled
+    QMI8658A_FIFO_MODE_FIFO   = 0x01,           // Stop when full
+    QMI8658A_FIFO_MODE_STREAM = 0x02,           // Overwrite oldest when full
+} qmi8658a_fifo_mode_t;
+
+// Sensor interrupt line carrying the FIFO watermark
+typedef enum {
+    QMI8658A_INT1,
+    QMI8658A_INT2,
+} qmi8658a_int_line_t;
+
 // ═══════════════════════════════════════════════════════
 // DATA STRUCTURES
 // ═══════════════════════════════════════════════════════
@@ -127,6 +202,7 @@ typedef struct {
     int16_t gyro_x;
     int16_t gyro_y;
     int16_t gyro_z;
+    int64_t timestamp_us;   // Sample time (esp_timer clock)
 } qmi8658a_raw_data_t;
 
 /**
@@ -140,8 +216,31 @@ typedef struct {
     float gyro_y;           // °/s
     float gyro_z;           // °/s
     float accel_magnitude;  // Total acceleration
+    int64_t timestamp_us;   // Sample time (esp_timer clock)
 } qmi8658a_data_t;
 
+// Q16.16 fixed point: 1.0 == 65536
+#define QMI8658A_Q16_SHIFT          16
+#define QMI8658A_Q16_ONE            (1L << QMI8658A_Q16_SHIFT)
+#define QMI8658A_Q16(x)             ((int32_t)((x) * 65536.0f))     // Compile-time constants
+#define QMI8658A_Q16_TO_FLOAT(q)    ((float)(q) * (1.0f / 65536.0f))
+
+/**
+ * @brief Fixed-point IMU sensor readings (Q16.16)
+ * 
+ * Same units as qmi8658a_data_t without any float work per sample.
+ * The magnitude is left out since it needs a square root.
+ */
+typedef struct {
+    int32_t accel_x;        // m/s², Q16.16
+    int32_t accel_y;        // m/s², Q16.16
+    int32_t accel_z;        // m/s², Q16.16
+    int32_t gyro_x;         // °/s, Q16.16
+    int32_t gyro_y;         // °/s, Q16.16
+    int32_t gyro_z;         // °/s, Q16.16
+    int64_t timestamp_us;   // Sample time (esp_timer clock)
+} qmi8658a_fixed_data_t;
+
 /**
  * @brief IMU configuration structure (passed by user)
  */
@@ -160,6 +259,44 @@ typedef struct {
     qmi8658a_gyro_odr_t gyro_odr;
 } qmi8658a_config_t;
 
+/**
+ * @brief Motion engine configuration (passed to qmi8658a_motion_enable)
+ * 
+ * Thresholds apply to each accel axis, in g (0 to 7.97, 1/32 g steps).
+ * Windows count accel samples, so their duration follows the accel ODR.
+ */
+typedef struct {
+    float any_threshold_g;          // Any-motion: an axis changes by more than this
+    uint8_t any_window;             // ... for this many consecutive samples
+    float no_threshold_g;           // No-motion: every axis stays within this
+    uint8_t no_window;              // ... for this many consecutive samples
+    qmi8658a_int_line_t int_line;   // Sensor pin that carries the motion interrupts
+} qmi8658a_motion_config_t;
+
+/**
+ * @brief Sensor calibration applied by the conversions (qmi8658a_set_calibration)
+ * 
+ * Each accel axis is scaled first and the offset subtracted from the
+ * result, so offsets are in the output units. The gyro is only offset:
+ * its scale stays a shift.
+ */
+typedef struct {
+    int32_t gyro_offset[3];         // °/s, Q16.16 (X, Y, Z)
+    int32_t accel_offset[3];        // m/s², Q16.16
+    int32_t accel_scale[3];         // Q16.16 factor, QMI8658A_Q16_ONE = as datasheet
+} qmi8658a_calibration_t;
+
+/**
+ * @brief FIFO configuration (passed to qmi8658a_fifo_enable)
+ */
+typedef struct {
+    qmi8658a_fifo_size_t size;
+    qmi8658a_fifo_mode_t mode;
+    uint8_t watermark;              // Samples before the watermark interrupt fires
+    qmi8658a_int_line_t int_line;   // Sensor pin that carries the watermark interrupt
+    gpio_num_t int_pin;             // Host GPIO wired to that pin, GPIO_NUM_NC to poll instead
+} qmi8658a_fifo_config_t;
+
 // ═══════════════════════════════════════════════════════
 // PUBLIC API
 // ═══════════════════════════════════════════════════════
@@ -191,6 +328,127 @@ bool qmi8658a_read_raw(qmi8658a_raw_data_t *out_data);
  */
 bool qmi8658a_read(qmi8658a_data_t *out_data);
 
+/**
+ * @brief Read sensor data in Q16.16 fixed point
+ * @param out_data Pointer to fixed-point data structure
+ * @return true if read successful
+ */
+bool qmi8658a_read_fixed(qmi8658a_fixed_data_t *out_data);
+
+/**
+ * @brief Convert a raw sample to physical units (keeps the timestamp)
+ */
+void qmi8658a_convert(const qmi8658a_raw_data_t *raw, qmi8658a_data_t *out_data);
+
+/**
+ * @brief Convert a raw sample to Q16.16 physical units (keeps the timestamp)
+ * 
+ * Uses per-range scale constants selected at init: a shift for the gyro
+ * and one 32x32 multiply for each accel axis, then subtracts the offsets
+ * (see qmi8658a_set_calibration).
+ */
+void qmi8658a_convert_fixed(const qmi8658a_raw_data_t *raw, qmi8658a_fixed_data_t *out_data);
+
+/**
+ * @brief Output data period of the configured gyro ODR
+ * @return Sample period in microseconds
+ */
+uint32_t qmi8658a_get_sample_period_us(void);
+
+/**
+ * @brief Set the calibration every conversion applies from now on
+ * 
+ * Call from the task that reads the sensor, or before it starts.
+ * 
+ * @param cal Calibration, NULL for none
+ */
+void qmi8658a_set_calibration(const qmi8658a_calibration_t *cal);
+
+/**
+ * @brief Get the calibration in use
+ */
+void qmi8658a_get_calibration(qmi8658a_calibration_t *cal);
+
+/**
+ * @brief Change the output data rates at runtime (ranges are kept)
+ * 
+ * The sensors are stopped while the rates change. With the FIFO on, it
+ * is reset so no sample is timestamped with the wrong period.
+ * 
+ * @return true if the sensor accepted the new rates
+ */
+bool qmi8658a_set_odr(qmi8658a_accel_odr_t accel_odr, qmi8658a_gyro_odr_t gyro_odr);
+
+// ═══════════════════════════════════════════════════════
+// MOTION ENGINE API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Configure and start on-chip any-motion and no-motion detection
+ * @param motion Thresholds, windows and interrupt line
+ * @return true if the engine was configured
+ */
+bool qmi8658a_motion_enable(const qmi8658a_motion_config_t *motion);
+
+/**
+ * @brief Read and clear the motion flags
+ * @param status Output QMI8658A_STATUS1_* bits seen since the previous read
+ * @return true if read successful
+ */
+bool qmi8658a_motion_read(uint8_t *status);
+
+// ═══════════════════════════════════════════════════════
+// FIFO API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Enable the on-chip FIFO and the watermark interrupt
+ * 
+ * With an int_pin, a GPIO ISR signals qmi8658a_fifo_wait() when the
+ * watermark is reached. Without one, qmi8658a_fifo_wait() sleeps for
+ * one watermark period instead.
+ * 
+ * @param fifo FIFO configuration
+ * @return true if the FIFO was configured
+ */
+bool qmi8658a_fifo_enable(const qmi8658a_fifo_config_t *fifo);
+
+/**
+ * @brief Block until the FIFO reaches its watermark
+ * @param timeout_ms Maximum time to wait
+ * @return true if the watermark interrupt fired (false on timeout or polling)
+ */
+bool qmi8658a_fifo_wait(uint32_t timeout_ms);
+
+/**
+ * @brief Drain the FIFO in one burst read
+ * 
+ * Timestamps are back-dated from the read time by the sample period.
+ * If the FIFO holds more than max_samples, the newest are returned.
+ * 
+ * @param out Output samples, oldest first
+ * @param max_samples Capacity of out
+ * @return Number of samples returned, -1 on I2C error
+ */
+int qmi8658a_fifo_read_raw(qmi8658a_raw_data_t *out, int max_samples);
+
+/**
+ * @brief Drain the FIFO and convert to physical units
+ * @return Number of samples returned, -1 on I2C error
+ */
+int qmi8658a_fifo_read(qmi8658a_data_t *out, int max_samples);
+
+/**
+ * @brief Drain the FIFO and convert to Q16.16 fixed point
+ * @return Number of samples returned, -1 on I2C error
+ */
+int qmi8658a_fifo_read_fixed(qmi8658a_fixed_data_t *out, int max_samples);
+
+/**
+ * @brief Number of FIFO overflows seen (samples lost)
+ */
+uint32_t qmi8658a_fifo_get_overflows(void);
+
 /**
  * @brief Print diagnostic information
  */
@@ -11,5 +11,6 @@
 
 #include "sts3032_protocol.h"
 #include "sts3032_servo.h"
+#include "sts3032_parser.h"
 
 #endif // STS3032_DRIVER_H
@@ -0,0 +1,114 @@
+/**
+ * @file sts3032_parser.h
+ * @brief STS3032 Streaming Frame Parser
+ *
+ * Incremental decoder for STS status packets. The parser owns its receive
+ * buffer: the UART is read straight into it (sts_parser_write_ptr), and
+ * decoded frames point back into the same storage, so back-to-back replies
+ * of a SYNC READ are parsed without an intermediate copy.
+ *
+ * State machine: hunt 0xFF 0xFF -> ID -> length -> exactly length bytes.
+ * Stray bytes, impossible lengths and bad checksums drop one byte and
+ * resynchronize on the next header instead of discarding the whole read.
+ */
+
+#ifndef STS3032_PARSER_H
+#define STS3032_PARSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════
+// CONSTANTS
+// ═══════════════════════════════════════════════════════
+
+#define STS_PARSER_BUF_LEN  256   // Receive buffer owned by the parser
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef enum {
+    STS_PARSE_FRAME = 0,        // A complete, checksum-valid frame was returned
+    STS_PARSE_NEED_MORE,        // Buffer holds no complete frame yet
+    STS_PARSE_BAD_CHECKSUM,     // Dropped a frame with a bad checksum (resyncing)
+} sts_parse_result_t;
+
+typedef enum {
+    STS_PARSER_HUNT_HEADER = 0, // Looking for 0xFF 0xFF
+    STS_PARSER_READ_LENGTH,     // Header found, waiting for ID and length bytes
+    STS_PARSER_READ_BODY,       // Length known, waiting for the rest of the frame
+} sts_parser_state_t;
+
+/**
+ * @brief Decoded status packet
+ *
+ * @c params points into the parser buffer and stays valid until the next
+ * sts_parser_write_ptr() or sts_parser_reset() call.
+ */
+typedef struct {
+    uint8_t id;                 // Responding servo ID
+    uint8_t error;              // Status/error byte
+    const uint8_t *params;      // Parameter bytes (register data)
+    uint8_t param_len;          // Number of parameter bytes
+    const uint8_t *raw;         // Whole frame, header through checksum
+    uint8_t raw_len;            // Whole frame length
+} sts_frame_t;
+
+typedef struct {
+    uint8_t buf[STS_PARSER_BUF_LEN];
+    int head;                   // Start of unparsed data
+    int tail;                   // End of received data
+    sts_parser_state_t state;
+    uint8_t frame_len;          // Total frame length once the length byte is known
+    uint32_t resync_bytes;      // Bytes skipped while hunting for a header
+    uint32_t checksum_errors;   // Frames dropped for a bad checksum
+} sts_parser_t;
+
+// ═══════════════════════════════════════════════════════
+// PARSER API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Discard all buffered data and return to header hunting
+ */
+void sts_parser_reset(sts_parser_t *parser);
+
+/**
+ * @brief Get the buffer location the next received bytes should be written to
+ *
+ * Compacts the buffer if needed. Invalidates previously returned frames.
+ *
+ * @param parser Parser
+ * @param space Output, number of bytes that fit at the returned pointer
+ * @return Write pointer inside the parser buffer
+ */
+uint8_t *sts_parser_write_ptr(sts_parser_t *parser, int *space);
+
+/**
+ * @brief Mark @p len bytes written at sts_parser_write_ptr() as received
+ */
+void sts_parser_commit(sts_parser_t *parser, int len);
+
+/**
+ * @brief Copy bytes into the parser (for callers that already hold a buffer)
+ * @return Number of bytes accepted
+ */
+int sts_parser_feed(sts_parser_t *parser, const uint8_t *data, int len);
+
+/**
+ * @brief Decode the next frame from buffered data
+ * @param parser Parser
+ * @param frame Output frame, filled when STS_PARSE_FRAME is returned
+ * @return Parse result
+ */
+sts_parse_result_t sts_parser_next(sts_parser_t *parser, sts_frame_t *frame);
+
+/**
+ * @brief Minimum number of additional bytes needed to complete the next frame
+ *
+ * Lets the caller read exactly the header, then exactly the announced body.
+ */
+int sts_parser_bytes_needed(const sts_parser_t *parser);
+
+#endif // STS3032_PARSER_H
@@ -4,6 +4,12 @@
  *
  * Low-level protocol implementation for STS3032 serial bus servos.
  * Handles packet construction, checksums, and basic communication.
+ *
+ * Every function works on one bus (sts_bus_t): a UART with its TXEN pin,
+ * timing, receive parser and lock. Buses are independent, so servos split
+ * over several UARTs are driven in parallel: in RS485 mode a packet is
+ * only queued to the UART driver, and packets queued on two buses are on
+ * the wire at the same time.
  */
 
 #ifndef STS3032_PROTOCOL_H
@@ -13,6 +19,9 @@
 #include <stdbool.h>
 #include "driver/uart.h"
 #include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "sts3032_parser.h"
 
 // ═══════════════════════════════════════════════════════
 // PROTOCOL CONSTANTS
@@ -25,6 +34,13 @@
 #define STS_PING            0x01
 #define STS_READ            0x02
 #define STS_WRITE           0x03
+#define STS_SYNC_READ       0x82  // Read the same register block from many IDs in one request
+#define STS_SYNC_WRITE      0x83  // Broadcast write of the same register block to many IDs
+
+// Packet limits
+#define STS_MAX_PACKET_LEN  128   // Header + ID + length + instruction + params + checksum
+#define STS_MAX_PARAM_LEN   (STS_MAX_PACKET_LEN - 6)
+#define STS_SYNC_READ_TIMEOUT_MS 20   // Whole-transaction timeout for SYNC READ replies (legacy timing)
 
 // Memory Addresses (EEPROM)
 #define STS_ID              0x05  // Servo ID address
@@ -42,29 +58,129 @@
 #define STS_PRESENT_POSITION_H 0x39
 #define STS_PRESENT_SPEED_L    0x3A
 #define STS_PRESENT_SPEED_H    0x3B
+#define STS_PRESENT_LOAD_L     0x3C
+#define STS_PRESENT_LOAD_H     0x3D
+#define STS_PRESENT_VOLTAGE    0x3E
+#define STS_PRESENT_TEMPERATURE 0x3F
+#define STS_SERVO_STATUS       0x41
+#define STS_MOVING             0x42
 
 // ═══════════════════════════════════════════════════════
 // HARDWARE CONFIGURATION
 // ═══════════════════════════════════════════════════════
 
+/**
+ * @brief Bus turnaround / response timing strategy
+ */
+typedef enum {
+    STS_TIMING_LEGACY = 0,  // TXEN toggled by GPIO, fixed 1 ms / 5 ms sleeps, 100 ms read timeout
+    STS_TIMING_RS485,       // UART RS485 half-duplex (TXEN on RTS), timeouts derived from baud rate
+} sts_timing_mode_t;
+
+// Servo-side processing and return delay budget added to RS485 read timeouts
+#ifndef STS_RESPONSE_LATENCY_US
+#define STS_RESPONSE_LATENCY_US 1000
+#endif
+
+// UART RX idle timeout (in symbol times) that hands received bytes to the driver
+#define STS_RS485_RX_TOUT_SYMBOLS 2
+
 typedef struct {
     uart_port_t uart_num;
     gpio_num_t tx_pin;
     gpio_num_t rx_pin;
     gpio_num_t txen_pin;
     uint32_t baud_rate;
+    sts_timing_mode_t timing_mode;  // Zero-initialized configs keep legacy timing
 } sts_protocol_config_t;
 
+/**
+ * @brief One servo bus (allocate statically, set up with sts_protocol_init)
+ */
+typedef struct {
+    uart_port_t uart_num;
+    gpio_num_t txen_pin;
+    sts_timing_mode_t timing_mode;
+    uint32_t byte_time_us;          // Wire time of one byte (start + 8 data + stop bits)
+    int last_tx_len;                // Last frame sent; in RS485 mode it may still be on the wire
+    sts_parser_t rx_parser;         // UART bytes are read directly into its buffer
+    SemaphoreHandle_t mutex;        // Serializes transactions (request + reply) between tasks
+    StaticSemaphore_t mutex_buf;
+} sts_bus_t;
+
 // ═══════════════════════════════════════════════════════
 // PROTOCOL FUNCTIONS
 // ═══════════════════════════════════════════════════════
 
-esp_err_t sts_protocol_init(const sts_protocol_config_t *config);
-void sts_protocol_deinit(void);
+/**
+ * @brief Set up a bus and install its UART driver
+ * @param bus Bus to initialize (must stay valid while in use)
+ * @param config UART, pins and timing
+ */
+esp_err_t sts_protocol_init(sts_bus_t *bus, const sts_protocol_config_t *config);
+void sts_protocol_deinit(sts_bus_t *bus);
+
+/**
+ * @brief Take exclusive (recursive) ownership of a servo bus
+ *
+ * Every packet and every request/reply transaction already takes this lock.
+ * Hold it explicitly only to keep several transactions back-to-back.
+ */
+void sts_protocol_lock(sts_bus_t *bus);
+void sts_protocol_unlock(sts_bus_t *bus);
+
 uint8_t sts_checksum(uint8_t *buf, int len);
-void sts_send_packet(uint8_t id, uint8_t cmd, uint8_t *params, int param_len);
-bool sts_read_response(uint8_t *response, int max_len, int *out_len);
-void sts_write_register(uint8_t id, uint8_t address, uint8_t *data, int len);
-bool sts_read_register(uint8_t id, uint8_t address, int len, uint8_t *data);
+void sts_send_packet(sts_bus_t *bus, uint8_t id, uint8_t cmd, uint8_t *params, int param_len);
+bool sts_read_response(sts_bus_t *bus, uint8_t *response, int max_len, int *out_len);
+void sts_write_register(sts_bus_t *bus, uint8_t id, uint8_t address, uint8_t *data, int len);
+bool sts_read_register(sts_bus_t *bus, uint8_t id, uint8_t address, int len, uint8_t *data);
+
+/**
+ * @brief Write the same register block on several servos in one packet
+ *
+ * Sends a single broadcast SYNC WRITE so every listed servo latches its new
+ * values at the same time. No status packets are returned.
+ *
+ * @param bus Bus the servos are on
+ * @param address First register address written on every servo
+ * @param data_len Number of bytes written per servo
+ * @param ids Servo IDs, @p count entries
+ * @param data Register data, @p data_len bytes per servo in the same order as @p ids
+ * @param count Number of servos
+ */
+void sts_sync_write(sts_bus_t *bus, uint8_t address, uint8_t data_len,
+                    const uint8_t *ids, const uint8_t *data, int count);
+
+/**
+ * @brief Read the same register block from several servos in one round trip
+ *
+ * Sends a single SYNC READ request and collects every servo's status packet
+ * from one UART read, instead of paying a full request/response cycle per
+ * servo. Servos that do not answer (or answer with a bad checksum) are
+ * marked invalid and their data is left untouched.
+ *
+ * @param bus Bus the servos are on
+ * @param address First register address read on every servo
+ * @param data_len Number of bytes read per servo
+ * @param ids Servo IDs, @p count entries
+ * @param count Number of servos
+ * @param data Output, @p data_len bytes per servo in the same order as @p ids
+ * @param valid Optional output, one flag per servo (NULL to ignore)
+ * @return Number of servos that returned valid data
+ */
+int sts_sync_read(sts_bus_t *bus, uint8_t address, uint8_t data_len,
+                  const uint8_t *ids, int count, uint8_t *data, bool *valid);
+
+/**
+ * @brief sts_sync_read in two halves, to overlap round trips on several buses
+ *
+ * Send the request on every bus, then collect each bus's replies. Hold
+ * the bus lock from request to collect so no other transaction lands in
+ * between; the arguments of both calls must match.
+ */
+void sts_sync_read_request(sts_bus_t *bus, uint8_t address, uint8_t data_len,
+                           const uint8_t *ids, int count);
+int sts_sync_read_collect(sts_bus_t *bus, uint8_t data_len,
+                          const uint8_t *ids, int count, uint8_t *data, bool *valid);
 
 #endif // STS3032_PROTOCOL_H
@@ -5,6 +5,10 @@
  * High-level API for controlling STS3032 serial bus servos.
  * Provides easy-to-use functions for position control, torque control,
  * and servo management.
+ * 
+ * Servos are addressed by ID only: each ID is routed to the bus it was
+ * added with (sts_servo_add_bus). Sync writes and reads that span several
+ * buses send one packet per bus and run the buses side by side.
  */
 
 #ifndef STS3032_SERVO_H
@@ -14,6 +18,51 @@
 #include <stdbool.h>
 #include "sts3032_protocol.h"
 
+// ═══════════════════════════════════════════════════════
+// BUS ROUTING
+// ═══════════════════════════════════════════════════════
+
+#ifndef STS_MAX_BUSES
+#define STS_MAX_BUSES       4
+#endif
+
+/**
+ * @brief Route servo IDs to a bus (after sts_protocol_init on it)
+ * 
+ * The first bus added also carries every ID not listed on any bus and
+ * the broadcast ID. Adding a bus that is already known only adds IDs.
+ * Routing is not locked: add buses during init, before other tasks use
+ * the servos.
+ * 
+ * @param bus Initialized bus (must stay valid)
+ * @param ids Servo IDs on this bus (NULL for none)
+ * @param count Number of IDs
+ * @return false if STS_MAX_BUSES are already in use or an ID is invalid
+ */
+bool sts_servo_add_bus(sts_bus_t *bus, const uint8_t *ids, int count);
+
+/**
+ * @brief Bus a servo ID is routed to (NULL before the first sts_servo_add_bus)
+ * 
+ * Hold its sts_protocol_lock() to keep a raw protocol transaction and
+ * the servo API calls around it together.
+ */
+sts_bus_t *sts_servo_get_bus(uint8_t id);
+
+/**
+ * @brief Number of buses added
+ */
+int sts_servo_bus_count(void);
+
+/**
+ * @brief Take every bus lock, in the order the buses were added
+ * 
+ * Keeps other tasks off all buses (a multi-bus sync write or read
+ * locks the same way, so this cannot deadlock against one).
+ */
+void sts_servo_lock_all(void);
+void sts_servo_unlock_all(void);
+
 // ═══════════════════════════════════════════════════════
 // SPEED PRESETS
 // ═══════════════════════════════════════════════════════
@@ -27,6 +76,73 @@ typedef enum {
     SPEED_MAX       = 4095
 } sts_servo_speed_t;
 
+// ═══════════════════════════════════════════════════════
+// SHADOW REGISTER CACHE
+// ═══════════════════════════════════════════════════════
+
+// Goal and torque writes are checked against the last values sent to the
+// same ID and dropped if they would not change anything. Writes are not
+// acknowledged, so cached values also expire after STS_CACHE_REFRESH_MS
+// and are sent again. Servo IDs >= STS_CACHE_SLOTS are never cached.
+#ifndef STS_CACHE_SLOTS
+#define STS_CACHE_SLOTS     16
+#endif
+
+// Goal positions within this many steps of the last sent goal are not re-sent
+#ifndef STS_CACHE_DEADBAND
+#define STS_CACHE_DEADBAND  0
+#endif
+
+#ifndef STS_CACHE_REFRESH_MS
+#define STS_CACHE_REFRESH_MS 1000
+#endif
+
+typedef struct {
+    uint32_t sent;          // Goals written to the bus
+    uint32_t suppressed;    // Goals and torque writes dropped as unchanged
+    uint32_t invalidated;   // Cache entries dropped (errors, ID changes, explicit)
+} sts_servo_cache_stats_t;
+
+/**
+ * @brief Turn write suppression on or off (on by default)
+ * 
+ * Turning it off also forgets every cached value.
+ */
+void sts_servo_cache_set_enabled(bool enabled);
+
+/**
+ * @brief Set the goal position deadband in steps
+ */
+void sts_servo_cache_set_deadband(uint16_t steps);
+
+/**
+ * @brief Forget the cached state of one servo so its next write goes out
+ * @param id Servo ID, or STS_BROADCAST_ID for every servo
+ */
+void sts_servo_cache_invalidate(uint8_t id);
+
+/**
+ * @brief Get cache counters
+ */
+void sts_servo_cache_get_stats(sts_servo_cache_stats_t *stats);
+
+// ═══════════════════════════════════════════════════════
+// TELEMETRY
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Decoded present-state block (registers 0x38-0x42)
+ */
+typedef struct {
+    uint16_t position;      // Present position (0-4095)
+    int16_t speed;          // Present speed in steps/s, negative = reverse
+    int16_t load;           // Present load in 0.1% of max torque, negative = reverse
+    uint8_t voltage;        // Supply voltage in 0.1 V
+    uint8_t temperature;    // Temperature in °C
+    uint8_t status;         // Error/status flags
+    bool moving;            // True while the servo is moving to its goal
+} sts_servo_telemetry_t;
+
 // ═══════════════════════════════════════════════════════
 // CONVERSION FUNCTIONS
 // ═══════════════════════════════════════════════════════
@@ -34,6 +150,19 @@ typedef enum {
 uint16_t sts_angle_to_position(float angle);
 float sts_position_to_angle(uint16_t position);
 
+/**
+ * @brief Goal speed that covers a move in a given time
+ * 
+ * Servos started in the same SYNC WRITE with speeds from this function
+ * arrive together. The servo's acceleration ramp comes on top.
+ * 
+ * @param from Present position (steps)
+ * @param to Goal position (steps)
+ * @param time_ms Time to arrive
+ * @return Speed in steps/s (1-4095; 4095 for time_ms = 0)
+ */
+uint16_t sts_speed_for_time(uint16_t from, uint16_t to, uint32_t time_ms);
+
 // ═══════════════════════════════════════════════════════
 // BASIC SERVO FUNCTIONS
 // ═══════════════════════════════════════════════════════
@@ -42,6 +171,34 @@ bool sts_servo_ping(uint8_t id);
 int sts_servo_scan_bus(uint8_t start_id, uint8_t end_id);
 void sts_servo_enable_torque(uint8_t id, bool enable);
 
+/**
+ * @brief Ping a range of IDs back-to-back and list the ones that answer
+ * 
+ * No sleeps between IDs and no banner. With STS_TIMING_RS485 a missing
+ * ID only costs the baud-derived reply timeout (about one tick), so
+ * 1-253 scans in a couple of seconds; legacy timing keeps its 100 ms
+ * timeout per missing ID.
+ * 
+ * @param start_id First ID
+ * @param end_id Last ID (clamped to 253)
+ * @param found Output IDs that answered (NULL to only count)
+ * @param max_found Capacity of found
+ * @return Number of servos that answered
+ */
+int sts_servo_scan_fast(uint8_t start_id, uint8_t end_id, uint8_t *found, int max_found);
+
+/**
+ * @brief Switch torque on several servos with one SYNC WRITE
+ * 
+ * Servos already in the requested state (see the shadow register cache)
+ * are skipped, and the settle delay is only paid if something was sent.
+ * 
+ * @param ids Servo IDs
+ * @param count Number of servos
+ * @param enable Torque on or off
+ */
+void sts_servo_sync_enable_torque(const uint8_t *ids, int count, bool enable);
+
 // ═══════════════════════════════════════════════════════
 // POSITION CONTROL
 // ═══════════════════════════════════════════════════════
@@ -52,6 +209,62 @@ bool sts_servo_get_position(uint8_t id, uint16_t *position);
 bool sts_servo_get_angle(uint8_t id, float *angle);
 bool sts_servo_get_speed(uint8_t id, uint16_t *speed);
 
+/**
+ * @brief Set goal position and speed on several servos in one bus transaction
+ * 
+ * Servos whose goal is unchanged (see the shadow register cache) are left
+ * out of the packet; nothing is sent if none changed.
+ * 
+ * @param ids Servo IDs
+ * @param positions Goal positions (0-4095), one per servo
+ * @param speeds Goal speeds (0-4095), one per servo
+ * @param count Number of servos
+ */
+void sts_servo_sync_set_positions(const uint8_t *ids, const uint16_t *positions,
+                                  const uint16_t *speeds, int count);
+
+/**
+ * @brief Set goal angle and speed on several servos in one bus transaction
+ * @param ids Servo IDs
+ * @param angles Goal angles in degrees (0-360), one per servo
+ * @param speeds Goal speeds (0-4095), one per servo
+ * @param count Number of servos
+ */
+void sts_servo_sync_set_angles(const uint8_t *ids, const float *angles,
+                               const uint16_t *speeds, int count);
+
+// ═══════════════════════════════════════════════════════
+// TELEMETRY READ
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Read the telemetry block of a single servo
+ * @param id Servo ID
+ * @param telemetry Output telemetry
+ * @return true if the servo answered
+ */
+bool sts_servo_get_telemetry(uint8_t id, sts_servo_telemetry_t *telemetry);
+
+/**
+ * @brief Read the telemetry block of several servos in one SYNC READ per bus
+ * @param ids Servo IDs
+ * @param count Number of servos
+ * @param telemetry Output telemetry, one per servo
+ * @param valid Optional per-servo success flags (NULL to ignore)
+ * @return Number of servos that answered
+ */
+int sts_servo_sync_read_telemetry(const uint8_t *ids, int count,
+                                  sts_servo_telemetry_t *telemetry, bool *valid);
+
+/**
+ * @brief Read present angles of several servos in one SYNC READ per bus
+ * @param ids Servo IDs
+ * @param count Number of servos
+ * @param angles Output angles in degrees, one per servo
+ * @return true only if every servo answered
+ */
+bool sts_servo_sync_get_angles(const uint8_t *ids, int count, float *angles);
+
 // ═══════════════════════════════════════════════════════
 // ID MANAGEMENT
 // ═══════════════════════════════════════════════════════
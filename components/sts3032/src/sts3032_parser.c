@@ -0,0 +1,159 @@
+/**
+ * @file sts3032_parser.c
+ * @brief STS3032 Streaming Frame Parser Implementation
+ */
+
+#include "sts3032_parser.h"
+#include "sts3032_protocol.h"
+#include <string.h>
+
+// Header(2) + ID + length; the length byte counts error + params + checksum
+#define FRAME_PREFIX_LEN    4
+#define FRAME_MIN_LEN       6
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL HELPERS
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Drop one byte at the head and go back to hunting for a header
+ */
+static void resync(sts_parser_t *parser)
+{
+    parser->head++;
+    parser->resync_bytes++;
+    parser->state = STS_PARSER_HUNT_HEADER;
+}
+
+// ═══════════════════════════════════════════════════════
+// PARSER API
+// ═══════════════════════════════════════════════════════
+
+void sts_parser_reset(sts_parser_t *parser)
+{
+    parser->head = 0;
+    parser->tail = 0;
+    parser->state = STS_PARSER_HUNT_HEADER;
+    parser->frame_len = 0;
+}
+
+uint8_t *sts_parser_write_ptr(sts_parser_t *parser, int *space)
+{
+    // Move a partial frame to the front only when the tail is out of room
+    if (parser->head == parser->tail) {
+        parser->head = 0;
+        parser->tail = 0;
+    } else if (parser->head > 0 && parser->tail >= STS_PARSER_BUF_LEN - FRAME_MIN_LEN) {
+        int pending = parser->tail - parser->head;
+        memmove(parser->buf, &parser->buf[parser->head], pending);
+        parser->head = 0;
+        parser->tail = pending;
+    }
+    
+    if (space) {
+        *space = STS_PARSER_BUF_LEN - parser->tail;
+    }
+    return &parser->buf[parser->tail];
+}
+
+void sts_parser_commit(sts_parser_t *parser, int len)
+{
+    if (len <= 0) {
+        return;
+    }
+    if (len > STS_PARSER_BUF_LEN - parser->tail) {
+        len = STS_PARSER_BUF_LEN - parser->tail;
+    }
+    parser->tail += len;
+}
+
+int sts_parser_feed(sts_parser_t *parser, const uint8_t *data, int len)
+{
+    int space;
+    uint8_t *dst = sts_parser_write_ptr(parser, &space);
+    
+    if (len > space) {
+        len = space;
+    }
+    if (len > 0) {
+        memcpy(dst, data, len);
+        sts_parser_commit(parser, len);
+    }
+    return len;
+}
+
+sts_parse_result_t sts_parser_next(sts_parser_t *parser, sts_frame_t *frame)
+{
+    while (1) {
+        int avail = parser->tail - parser->head;
+        uint8_t *p = &parser->buf[parser->head];
+        
+        switch (parser->state) {
+            case STS_PARSER_HUNT_HEADER:
+                if (avail < 2) {
+                    return STS_PARSE_NEED_MORE;
+                }
+                if (p[0] != STS_FRAME_HEADER || p[1] != STS_FRAME_HEADER) {
+                    resync(parser);
+                    continue;
+                }
+                parser->state = STS_PARSER_READ_LENGTH;
+                break;
+                
+            case STS_PARSER_READ_LENGTH:
+                if (avail < FRAME_PREFIX_LEN) {
+                    return STS_PARSE_NEED_MORE;
+                }
+                // 0xFF as ID means we locked onto a run of header bytes; a
+                // length below 2 or beyond the buffer cannot be a real frame
+                if (p[2] == STS_FRAME_HEADER || p[3] < 2 ||
+                    FRAME_PREFIX_LEN + p[3] > STS_PARSER_BUF_LEN) {
+                    resync(parser);
+                    continue;
+                }
+                parser->frame_len = FRAME_PREFIX_LEN + p[3];
+                parser->state = STS_PARSER_READ_BODY;
+                break;
+                
+            case STS_PARSER_READ_BODY:
+                if (avail < parser->frame_len) {
+                    return STS_PARSE_NEED_MORE;
+                }
+                if (sts_checksum(p, parser->frame_len) != p[parser->frame_len - 1]) {
+                    parser->checksum_errors++;
+                    resync(parser);
+                    return STS_PARSE_BAD_CHECKSUM;
+                }
+                if (frame) {
+                    frame->id = p[2];
+                    frame->error = p[4];
+                    frame->params = &p[5];
+                    frame->param_len = parser->frame_len - FRAME_MIN_LEN;
+                    frame->raw = p;
+                    frame->raw_len = parser->frame_len;
+                }
+                parser->head += parser->frame_len;
+                parser->state = STS_PARSER_HUNT_HEADER;
+                return STS_PARSE_FRAME;
+        }
+    }
+}
+
+int sts_parser_bytes_needed(const sts_parser_t *parser)
+{
+    int avail = parser->tail - parser->head;
+    int needed;
+    
+    switch (parser->state) {
+        case STS_PARSER_READ_BODY:
+            needed = parser->frame_len - avail;
+            break;
+        case STS_PARSER_READ_LENGTH:
+        case STS_PARSER_HUNT_HEADER:
+        default:
+            needed = FRAME_PREFIX_LEN - avail;
+            break;
+    }
+    
+    return needed > 0 ? needed : 1;
+}
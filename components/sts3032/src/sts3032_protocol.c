@@ -4,29 +4,118 @@
  */
 
 #include "sts3032_protocol.h"
+#include "sts3032_parser.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <string.h>
 
 static const char *TAG = "STS_PROTOCOL";
 
-// Hardware configuration (stored after init)
-static uart_port_t g_uart_num = UART_NUM_1;
-static gpio_num_t g_txen_pin = GPIO_NUM_3;
+// ═══════════════════════════════════════════════════════
+// TIMING HELPERS
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Read timeout for @p rx_bytes expected from @p responders servos
+ *
+ * Legacy mode keeps the historical fixed 100 ms. RS485 mode budgets the
+ * still-draining request frame, the reply bytes and a per-servo latency,
+ * rounded up to whole ticks plus one (the current tick is partial).
+ * uart_read_bytes returns as soon as the bytes arrive, so the timeout only
+ * bounds the cost of a servo that never answers.
+ */
+static TickType_t rx_timeout_ticks(const sts_bus_t *bus, int rx_bytes, int responders)
+{
+    if (bus->timing_mode != STS_TIMING_RS485) {
+        return pdMS_TO_TICKS(100);
+    }
+    
+    uint32_t us = (uint32_t)(bus->last_tx_len + rx_bytes) * bus->byte_time_us +
+                  (uint32_t)responders * STS_RESPONSE_LATENCY_US;
+    return pdMS_TO_TICKS((us + 999) / 1000) + 1;
+}
+
+/**
+ * @brief Feed UART bytes into the parser until a frame decodes or @p deadline passes
+ *
+ * Reads exactly what the parser still needs (header, then the announced
+ * body) directly into its buffer. Garbage and bad checksums only cost the
+ * bytes they occupy; the parser resynchronizes on the next header.
+ */
+static bool receive_frame(sts_bus_t *bus, sts_frame_t *frame, TickType_t deadline)
+{
+    sts_parser_t *parser = &bus->rx_parser;
+    
+    while (1) {
+        sts_parse_result_t res = sts_parser_next(parser, frame);
+        
+        if (res == STS_PARSE_FRAME) {
+            return true;
+        }
+        if (res == STS_PARSE_BAD_CHECKSUM) {
+            ESP_LOGW(TAG, "Checksum mismatch, resyncing");
+            continue;
+        }
+        
+        TickType_t now = xTaskGetTickCount();
+        if ((int32_t)(deadline - now) <= 0) {
+            return false;
+        }
+        
+        int space;
+        uint8_t *dst = sts_parser_write_ptr(parser, &space);
+        int need = sts_parser_bytes_needed(parser);
+        
+        if (space <= 0) {
+            // Buffer full of undecodable bytes; start over
+            sts_parser_reset(parser);
+            continue;
+        }
+        if (need > space) {
+            need = space;
+        }
+        
+        int got = uart_read_bytes(bus->uart_num, dst, need, deadline - now);
+        if (got <= 0) {
+            return false;
+        }
+        sts_parser_commit(parser, got);
+    }
+}
+
+/**
+ * @brief True if the servo will answer this instruction with a status packet
+ */
+static bool expects_response(uint8_t id, uint8_t cmd)
+{
+    if (cmd == STS_SYNC_READ) {
+        return true;
+    }
+    return id != STS_BROADCAST_ID && (cmd == STS_PING || cmd == STS_READ);
+}
 
 // ═══════════════════════════════════════════════════════
 // INITIALIZATION
 // ═══════════════════════════════════════════════════════
 
-esp_err_t sts_protocol_init(const sts_protocol_config_t *config) {
-    if (!config) {
+esp_err_t sts_protocol_init(sts_bus_t *bus, const sts_protocol_config_t *config) {
+    if (!bus || !config) {
         return ESP_ERR_INVALID_ARG;
     }
     
+    if (bus->mutex == NULL) {
+        bus->mutex = xSemaphoreCreateRecursiveMutexStatic(&bus->mutex_buf);
+    }
+    
     // Store configuration
-    g_uart_num = config->uart_num;
-    g_txen_pin = config->txen_pin;
+    bus->uart_num = config->uart_num;
+    bus->txen_pin = config->txen_pin;
+    bus->timing_mode = config->timing_mode;
+    bus->byte_time_us = (10 * 1000000UL + config->baud_rate - 1) / config->baud_rate;
+    bus->last_tx_len = 0;
+    sts_parser_reset(&bus->rx_parser);
     
     ESP_LOGI(TAG, "Initializing STS3032 protocol");
     ESP_LOGI(TAG, "  UART: %d", config->uart_num);
@@ -34,17 +123,22 @@ esp_err_t sts_protocol_init(const sts_protocol_config_t *config) {
     ESP_LOGI(TAG, "  RX Pin: %d", config->rx_pin);
     ESP_LOGI(TAG, "  TXEN Pin: %d", config->txen_pin);
     ESP_LOGI(TAG, "  Baud Rate: %lu", config->baud_rate);
+    ESP_LOGI(TAG, "  Timing: %s", bus->timing_mode == STS_TIMING_RS485 ? "RS485 (baud-derived)" : "legacy");
     
-    // Configure TXEN pin
-    gpio_config_t io_conf = {
-        .pin_bit_mask = (1ULL << config->txen_pin),
-        .mode = GPIO_MODE_OUTPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE,
-    };
-    gpio_config(&io_conf);
-    gpio_set_level(config->txen_pin, 0);
+    bool rs485 = (bus->timing_mode == STS_TIMING_RS485);
+    
+    // Configure TXEN pin (RS485 mode hands it to the UART as RTS instead)
+    if (!rs485) {
+        gpio_config_t io_conf = {
+            .pin_bit_mask = (1ULL << config->txen_pin),
+            .mode = GPIO_MODE_OUTPUT,
+            .pull_up_en = GPIO_PULLUP_DISABLE,
+            .pull_down_en = GPIO_PULLDOWN_DISABLE,
+            .intr_type = GPIO_INTR_DISABLE,
+        };
+        gpio_config(&io_conf);
+        gpio_set_level(config->txen_pin, 0);
+    }
     
     // Configure UART
     uart_config_t uart_config = {
@@ -70,22 +164,53 @@ esp_err_t sts_protocol_init(const sts_protocol_config_t *config) {
     }
     
     ret = uart_set_pin(config->uart_num, config->tx_pin, config->rx_pin,
-                      UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+                      rs485 ? config->txen_pin : UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set UART pins");
         uart_driver_delete(config->uart_num);
         return ret;
     }
     
+    if (rs485) {
+        // Hardware drives TXEN (RTS) for exactly the duration of each frame
+        ret = uart_set_mode(config->uart_num, UART_MODE_RS485_HALF_DUPLEX);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to set RS485 half-duplex mode");
+            uart_driver_delete(config->uart_num);
+            return ret;
+        }
+        
+        // Deliver reply bytes to the driver as soon as the line goes idle
+        uart_set_rx_timeout(config->uart_num, STS_RS485_RX_TOUT_SYMBOLS);
+        
+        ESP_LOGI(TAG, "  Byte time: %lu us", (unsigned long)bus->byte_time_us);
+    }
+    
     vTaskDelay(pdMS_TO_TICKS(100));
     ESP_LOGI(TAG, "STS3032 protocol initialized successfully");
     
     return ESP_OK;
 }
 
-void sts_protocol_deinit(void) {
-    uart_driver_delete(g_uart_num);
-    ESP_LOGI(TAG, "STS3032 protocol deinitialized");
+void sts_protocol_deinit(sts_bus_t *bus) {
+    uart_driver_delete(bus->uart_num);
+    ESP_LOGI(TAG, "STS3032 protocol on UART %d deinitialized", bus->uart_num);
+}
+
+// ═══════════════════════════════════════════════════════
+// BUS LOCKING
+// ═══════════════════════════════════════════════════════
+
+void sts_protocol_lock(sts_bus_t *bus) {
+    if (bus && bus->mutex) {
+        xSemaphoreTakeRecursive(bus->mutex, portMAX_DELAY);
+    }
+}
+
+void sts_protocol_unlock(sts_bus_t *bus) {
+    if (bus && bus->mutex) {
+        xSemaphoreGiveRecursive(bus->mutex);
+    }
 }
 
 // ═══════════════════════════════════════════════════════
@@ -100,8 +225,18 @@ uint8_t sts_checksum(uint8_t *buf, int len) {
     return ~sum;
 }
 
-void sts_send_packet(uint8_t id, uint8_t cmd, uint8_t *params, int param_len) {
-    uint8_t packet[64];
+void sts_send_packet(sts_bus_t *bus, uint8_t id, uint8_t cmd, uint8_t *params, int param_len) {
+    uint8_t packet[STS_MAX_PACKET_LEN];
+    
+    if (!bus) {
+        ESP_LOGE(TAG, "No bus for servo ID %d", id);
+        return;
+    }
+    
+    if (param_len < 0 || param_len > STS_MAX_PARAM_LEN) {
+        ESP_LOGE(TAG, "Packet too long (%d param bytes)", param_len);
+        return;
+    }
     
     packet[0] = STS_FRAME_HEADER;
     packet[1] = STS_FRAME_HEADER;
@@ -116,44 +251,65 @@ void sts_send_packet(uint8_t id, uint8_t cmd, uint8_t *params, int param_len) {
     int total_len = 5 + param_len + 1;
     packet[total_len - 1] = sts_checksum(packet, total_len);
     
+    sts_protocol_lock(bus);
+    bus->last_tx_len = total_len;
+    
+    if (bus->timing_mode == STS_TIMING_RS485) {
+        // Stale bytes only matter if a reply is coming; TXEN is driven by the UART.
+        // The frame is only queued: other buses can transmit meanwhile
+        if (expects_response(id, cmd)) {
+            uart_flush_input(bus->uart_num);
+        }
+        uart_write_bytes(bus->uart_num, packet, total_len);
+        sts_protocol_unlock(bus);
+        return;
+    }
+    
     // Enable transmit
-    gpio_set_level(g_txen_pin, 1);
+    gpio_set_level(bus->txen_pin, 1);
     vTaskDelay(pdMS_TO_TICKS(1));
     
     // Send packet
-    uart_flush(g_uart_num);
-    uart_write_bytes(g_uart_num, packet, total_len);
-    uart_wait_tx_done(g_uart_num, pdMS_TO_TICKS(100));
+    uart_flush(bus->uart_num);
+    uart_write_bytes(bus->uart_num, packet, total_len);
+    uart_wait_tx_done(bus->uart_num, pdMS_TO_TICKS(100));
     
     // Disable transmit (enable receive)
-    gpio_set_level(g_txen_pin, 0);
+    gpio_set_level(bus->txen_pin, 0);
+    sts_protocol_unlock(bus);
 }
 
-bool sts_read_response(uint8_t *response, int max_len, int *out_len) {
-    vTaskDelay(pdMS_TO_TICKS(5));
+bool sts_read_response(sts_bus_t *bus, uint8_t *response, int max_len, int *out_len) {
+    sts_frame_t frame;
     
-    int len = uart_read_bytes(g_uart_num, response, max_len, pdMS_TO_TICKS(100));
-    
-    if (len < 6) {
+    if (!bus) {
         return false;
     }
     
-    if (response[0] != STS_FRAME_HEADER || response[1] != STS_FRAME_HEADER) {
-        return false;
+    if (bus->timing_mode != STS_TIMING_RS485) {
+        vTaskDelay(pdMS_TO_TICKS(5));
     }
     
-    uint8_t calc_checksum = sts_checksum(response, len);
-    if (calc_checksum != response[len - 1]) {
-        ESP_LOGW(TAG, "Checksum mismatch: expected 0x%02X, got 0x%02X", 
-                 calc_checksum, response[len - 1]);
-        return false;
+    sts_protocol_lock(bus);
+    sts_parser_reset(&bus->rx_parser);
+    TickType_t deadline = xTaskGetTickCount() + rx_timeout_ticks(bus, max_len, 1);
+    
+    bool ok = receive_frame(bus, &frame, deadline);
+    
+    if (ok && frame.raw_len > max_len) {
+        ESP_LOGW(TAG, "Response too long (%d bytes)", frame.raw_len);
+        ok = false;
     }
     
-    if (out_len) *out_len = len;
-    return true;
+    if (ok) {
+        memcpy(response, frame.raw, frame.raw_len);
+        if (out_len) *out_len = frame.raw_len;
+    }
+    sts_protocol_unlock(bus);
+    return ok;
 }
 
-void sts_write_register(uint8_t id, uint8_t address, uint8_t *data, int len) {
+void sts_write_register(sts_bus_t *bus, uint8_t id, uint8_t address, uint8_t *data, int len) {
     uint8_t params[32];
     params[0] = address;
     
@@ -161,27 +317,145 @@ void sts_write_register(uint8_t id, uint8_t address, uint8_t *data, int len) {
         memcpy(&params[1], data, len);
     }
     
-    sts_send_packet(id, STS_WRITE, params, len + 1);
+    sts_send_packet(bus, id, STS_WRITE, params, len + 1);
 }
 
-bool sts_read_register(uint8_t id, uint8_t address, int len, uint8_t *data) {
+bool sts_read_register(sts_bus_t *bus, uint8_t id, uint8_t address, int len, uint8_t *data) {
     uint8_t params[2];
     params[0] = address;
     params[1] = len;
     
-    sts_send_packet(id, STS_READ, params, 2);
-    
     uint8_t response[32];
     int resp_len;
+    bool ok = false;
     
-    if (sts_read_response(response, 32, &resp_len)) {
+    sts_protocol_lock(bus);
+    sts_send_packet(bus, id, STS_READ, params, 2);
+    
+    if (sts_read_response(bus, response, 32, &resp_len)) {
         if (resp_len >= (5 + len + 1)) {
             if (data) {
                 memcpy(data, &response[5], len);
             }
-            return true;
+            ok = true;
         }
     }
+    sts_protocol_unlock(bus);
+    
+    return ok;
+}
+
+void sts_sync_write(sts_bus_t *bus, uint8_t address, uint8_t data_len,
+                    const uint8_t *ids, const uint8_t *data, int count) {
+    uint8_t params[STS_MAX_PARAM_LEN];
+    int param_len = 2 + count * (1 + data_len);
+    
+    if (!ids || !data || count <= 0) {
+        return;
+    }
+    
+    if (param_len > STS_MAX_PARAM_LEN) {
+        ESP_LOGE(TAG, "Sync write too long (%d servos x %d bytes)", count, data_len);
+        return;
+    }
+    
+    // SYNC WRITE params: [address][data_len] then [id][data...] per servo
+    params[0] = address;
+    params[1] = data_len;
+    
+    uint8_t *p = &params[2];
+    for (int i = 0; i < count; i++) {
+        *p++ = ids[i];
+        memcpy(p, &data[i * data_len], data_len);
+        p += data_len;
+    }
+    
+    sts_send_packet(bus, STS_BROADCAST_ID, STS_SYNC_WRITE, params, param_len);
+}
+
+void sts_sync_read_request(sts_bus_t *bus, uint8_t address, uint8_t data_len,
+                           const uint8_t *ids, int count) {
+    uint8_t params[STS_MAX_PARAM_LEN];
+    
+    if (!bus || !ids || count <= 0 || 2 + count > STS_MAX_PARAM_LEN) {
+        return;
+    }
+    
+    // SYNC READ params: [address][data_len][id1][id2]...
+    params[0] = address;
+    params[1] = data_len;
+    memcpy(&params[2], ids, count);
+    
+    sts_protocol_lock(bus);
+    sts_parser_reset(&bus->rx_parser);
+    sts_send_packet(bus, STS_BROADCAST_ID, STS_SYNC_READ, params, 2 + count);
+    sts_protocol_unlock(bus);
+}
+
+int sts_sync_read_collect(sts_bus_t *bus, uint8_t data_len,
+                          const uint8_t *ids, int count, uint8_t *data, bool *valid) {
+    bool got[STS_MAX_PARAM_LEN] = {0};
+    int frame_len = 6 + data_len;  // Header(2) + ID + length + error + data + checksum
+    int expected_len = count * frame_len;
+    
+    if (!bus || !ids || !data || count <= 0 || count > STS_MAX_PARAM_LEN) {
+        return 0;
+    }
+    
+    // Servos answer back-to-back in ID order; frames are decoded straight
+    // out of the parser buffer as they arrive
+    TickType_t timeout = (bus->timing_mode == STS_TIMING_RS485)
+        ? rx_timeout_ticks(bus, expected_len, count)
+        : pdMS_TO_TICKS(STS_SYNC_READ_TIMEOUT_MS);
+    
+    sts_protocol_lock(bus);
+    TickType_t deadline = xTaskGetTickCount() + timeout;
+    
+    int found = 0;
+    sts_frame_t frame;
+    
+    while (found < count && receive_frame(bus, &frame, deadline)) {
+        if (frame.param_len != data_len) {
+            continue;
+        }
+        
+        for (int i = 0; i < count; i++) {
+            if (ids[i] == frame.id && !got[i]) {
+                memcpy(&data[i * data_len], frame.params, data_len);
+                got[i] = true;
+                found++;
+                break;
+            }
+        }
+    }
+    sts_protocol_unlock(bus);
+    
+    if (valid) {
+        memcpy(valid, got, count * sizeof(bool));
+    }
+    
+    if (found < count) {
+        ESP_LOGD(TAG, "Sync read on UART %d: %d of %d servos answered", bus->uart_num, found, count);
+    }
+    
+    return found;
+}
+
+int sts_sync_read(sts_bus_t *bus, uint8_t address, uint8_t data_len,
+                  const uint8_t *ids, int count, uint8_t *data, bool *valid) {
+    if (!bus || !ids || !data || count <= 0) {
+        return 0;
+    }
+    
+    if (2 + count > STS_MAX_PARAM_LEN || count * (6 + data_len) > STS_PARSER_BUF_LEN) {
+        ESP_LOGE(TAG, "Sync read too long (%d servos x %d bytes)", count, data_len);
+        return 0;
+    }
+    
+    sts_protocol_lock(bus);
+    sts_sync_read_request(bus, address, data_len, ids, count);
+    int found = sts_sync_read_collect(bus, data_len, ids, count, data, valid);
+    sts_protocol_unlock(bus);
     
-    return false;
+    return found;
 }
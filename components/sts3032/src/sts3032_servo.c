@@ -4,12 +4,211 @@
  */
 
 #include "sts3032_servo.h"
+#include "sts3032_parser.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <string.h>
 
 static const char *TAG = "STS_SERVO";
 
+// ═══════════════════════════════════════════════════════
+// BUS ROUTING
+// ═══════════════════════════════════════════════════════
+
+static sts_bus_t *s_buses[STS_MAX_BUSES];
+static int s_bus_count = 0;
+static uint8_t s_id_bus[STS_BROADCAST_ID];     // Index into s_buses per ID (0 = first bus)
+
+static int bus_index(uint8_t id) {
+    return (id < STS_BROADCAST_ID) ? s_id_bus[id] : 0;
+}
+
+static sts_bus_t *bus_of(uint8_t id) {
+    return (s_bus_count > 0) ? s_buses[bus_index(id)] : NULL;
+}
+
+static bool have_bus(void) {
+    if (s_bus_count == 0) {
+        ESP_LOGE(TAG, "No servo bus added");
+        return false;
+    }
+    return true;
+}
+
+bool sts_servo_add_bus(sts_bus_t *bus, const uint8_t *ids, int count) {
+    int index = 0;
+    
+    if (!bus) {
+        return false;
+    }
+    
+    while (index < s_bus_count && s_buses[index] != bus) {
+        index++;
+    }
+    if (index == s_bus_count) {
+        if (s_bus_count >= STS_MAX_BUSES) {
+            ESP_LOGE(TAG, "No room for another bus (max %d)", STS_MAX_BUSES);
+            return false;
+        }
+        s_buses[s_bus_count++] = bus;
+    }
+    
+    for (int i = 0; ids && i < count; i++) {
+        if (ids[i] >= STS_BROADCAST_ID) {
+            ESP_LOGE(TAG, "Invalid servo ID %d for bus", ids[i]);
+            return false;
+        }
+        s_id_bus[ids[i]] = index;
+    }
+    
+    ESP_LOGI(TAG, "Bus %d on UART %d: %d servo(s)%s", index, bus->uart_num, count,
+             index == 0 ? " + unlisted IDs" : "");
+    return true;
+}
+
+sts_bus_t *sts_servo_get_bus(uint8_t id) {
+    return bus_of(id);
+}
+
+int sts_servo_bus_count(void) {
+    return s_bus_count;
+}
+
+void sts_servo_lock_all(void) {
+    for (int b = 0; b < s_bus_count; b++) {
+        sts_protocol_lock(s_buses[b]);
+    }
+}
+
+void sts_servo_unlock_all(void) {
+    for (int b = s_bus_count - 1; b >= 0; b--) {
+        sts_protocol_unlock(s_buses[b]);
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// SHADOW REGISTER CACHE
+// ═══════════════════════════════════════════════════════
+
+#define CACHE_GOAL_VALID    0x01
+#define CACHE_TORQUE_VALID  0x02
+
+/**
+ * @brief Last values written to one servo (guarded by the lock of its bus)
+ */
+typedef struct {
+    uint8_t flags;
+    bool torque;
+    uint16_t position;
+    uint16_t speed;
+    TickType_t goal_sent;
+    TickType_t torque_sent;
+} cache_entry_t;
+
+// Settings are changed with every bus locked; counters are kept per bus
+static cache_entry_t s_cache[STS_CACHE_SLOTS];
+static bool s_cache_enabled = true;
+static uint16_t s_cache_deadband = STS_CACHE_DEADBAND;
+static sts_servo_cache_stats_t s_cache_stats[STS_MAX_BUSES];
+
+static cache_entry_t *cache_entry(uint8_t id) {
+    return (s_cache_enabled && id < STS_CACHE_SLOTS) ? &s_cache[id] : NULL;
+}
+
+static sts_servo_cache_stats_t *cache_stats(uint8_t id) {
+    return &s_cache_stats[bus_index(id)];
+}
+
+static bool cache_fresh(TickType_t sent, TickType_t now) {
+    return (TickType_t)(now - sent) < pdMS_TO_TICKS(STS_CACHE_REFRESH_MS);
+}
+
+/**
+ * @brief True if this goal would not change what the servo already holds
+ */
+static bool cache_goal_unchanged(uint8_t id, uint16_t position, uint16_t speed, TickType_t now) {
+    cache_entry_t *e = cache_entry(id);
+    
+    if (!e || !(e->flags & CACHE_GOAL_VALID) || !cache_fresh(e->goal_sent, now)) {
+        return false;
+    }
+    
+    int delta = (int)position - (int)e->position;
+    return speed == e->speed && delta <= s_cache_deadband && delta >= -(int)s_cache_deadband;
+}
+
+static void cache_goal_sent(uint8_t id, uint16_t position, uint16_t speed, TickType_t now) {
+    cache_entry_t *e = cache_entry(id);
+    
+    cache_stats(id)->sent++;
+    if (e) {
+        e->flags |= CACHE_GOAL_VALID;
+        e->position = position;
+        e->speed = speed;
+        e->goal_sent = now;
+    }
+}
+
+/**
+ * @brief Drop a servo's cached state after it failed to answer or reported a fault
+ */
+static void cache_drop(uint8_t id) {
+    cache_entry_t *e = cache_entry(id);
+    
+    if (e && e->flags) {
+        sts_bus_t *bus = bus_of(id);
+        sts_protocol_lock(bus);
+        e->flags = 0;
+        cache_stats(id)->invalidated++;
+        sts_protocol_unlock(bus);
+    }
+}
+
+void sts_servo_cache_set_enabled(bool enabled) {
+    sts_servo_lock_all();
+    s_cache_enabled = enabled;
+    memset(s_cache, 0, sizeof(s_cache));
+    sts_servo_unlock_all();
+}
+
+void sts_servo_cache_set_deadband(uint16_t steps) {
+    sts_servo_lock_all();
+    s_cache_deadband = steps;
+    sts_servo_unlock_all();
+}
+
+void sts_servo_cache_invalidate(uint8_t id) {
+    if (id != STS_BROADCAST_ID) {
+        cache_drop(id);
+        return;
+    }
+    
+    sts_servo_lock_all();
+    for (int i = 0; i < STS_CACHE_SLOTS; i++) {
+        if (s_cache[i].flags) {
+            s_cache[i].flags = 0;
+            cache_stats(i)->invalidated++;
+        }
+    }
+    sts_servo_unlock_all();
+}
+
+void sts_servo_cache_get_stats(sts_servo_cache_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+    
+    memset(stats, 0, sizeof(*stats));
+    sts_servo_lock_all();
+    for (int b = 0; b < STS_MAX_BUSES; b++) {
+        stats->sent += s_cache_stats[b].sent;
+        stats->suppressed += s_cache_stats[b].suppressed;
+        stats->invalidated += s_cache_stats[b].invalidated;
+    }
+    sts_servo_unlock_all();
+}
+
 // ═══════════════════════════════════════════════════════
 // CONVERSION FUNCTIONS
 // ═══════════════════════════════════════════════════════
@@ -17,11 +216,25 @@ static const char *TAG = "STS_SERVO";
 uint16_t sts_angle_to_position(float angle) {
     if (angle < 0) angle = 0;
     if (angle > 360) angle = 360;
-    return (uint16_t)(angle * 4095.0 / 360.0);
+    return (uint16_t)(angle * (4095.0f / 360.0f));  // float: the S3 FPU has no double support
 }
 
 float sts_position_to_angle(uint16_t position) {
-    return (float)position * 360.0 / 4095.0;
+    return (float)position * (360.0f / 4095.0f);
+}
+
+uint16_t sts_speed_for_time(uint16_t from, uint16_t to, uint32_t time_ms) {
+    uint32_t distance = (from > to) ? from - to : to - from;
+    
+    if (time_ms == 0) {
+        return SPEED_MAX;
+    }
+    
+    // Round up so the servo is never late
+    uint32_t speed = (distance * 1000u + time_ms - 1) / time_ms;
+    if (speed < 1) return 1;
+    if (speed > SPEED_MAX) return SPEED_MAX;
+    return (uint16_t)speed;
 }
 
 // ═══════════════════════════════════════════════════════
@@ -29,12 +242,19 @@ float sts_position_to_angle(uint16_t position) {
 // ═══════════════════════════════════════════════════════
 
 bool sts_servo_ping(uint8_t id) {
-    sts_send_packet(id, STS_PING, NULL, 0);
-    
     uint8_t response[32];
     int len;
+    sts_bus_t *bus = bus_of(id);
+    
+    sts_protocol_lock(bus);
+    sts_send_packet(bus, id, STS_PING, NULL, 0);
+    bool ok = sts_read_response(bus, response, 32, &len);
+    sts_protocol_unlock(bus);
     
-    return sts_read_response(response, 32, &len);
+    if (!ok) {
+        cache_drop(id);
+    }
+    return ok;
 }
 
 int sts_servo_scan_bus(uint8_t start_id, uint8_t end_id) {
@@ -63,13 +283,117 @@ int sts_servo_scan_bus(uint8_t start_id, uint8_t end_id) {
 }
 
 void sts_servo_enable_torque(uint8_t id, bool enable) {
+    TickType_t now = xTaskGetTickCount();
+    sts_bus_t *bus = bus_of(id);
+    
+    sts_protocol_lock(bus);
+    cache_entry_t *e = cache_entry(id);
+    
+    if (e && (e->flags & CACHE_TORQUE_VALID) && e->torque == enable &&
+        cache_fresh(e->torque_sent, now)) {
+        cache_stats(id)->suppressed++;
+        sts_protocol_unlock(bus);
+        return;
+    }
+    
     ESP_LOGI(TAG, "Servo ID %d: Torque %s", id, enable ? "ON" : "OFF");
     
     uint8_t value = enable ? 1 : 0;
-    sts_write_register(id, STS_TORQUE_ENABLE, &value, 1);
+    sts_write_register(bus, id, STS_TORQUE_ENABLE, &value, 1);
+    
+    // Switching torque re-latches the goal; the next goal must go out
+    if (e) {
+        e->flags = CACHE_TORQUE_VALID;
+        e->torque = enable;
+        e->torque_sent = now;
+    }
+    sts_protocol_unlock(bus);
+    
     vTaskDelay(pdMS_TO_TICKS(50));
 }
 
+int sts_servo_scan_fast(uint8_t start_id, uint8_t end_id, uint8_t *found, int max_found) {
+    TickType_t start = xTaskGetTickCount();
+    int found_count = 0;
+    int last = (end_id < STS_BROADCAST_ID) ? end_id : STS_BROADCAST_ID - 1;
+    
+    for (int id = start_id; id <= last; id++) {
+        if (sts_servo_ping(id)) {
+            if (found && found_count < max_found) {
+                found[found_count] = id;
+            }
+            found_count++;
+            ESP_LOGI(TAG, "✓ Servo ID %d is online", id);
+        }
+    }
+    
+    ESP_LOGI(TAG, "Fast scan %d-%d: %d servo(s) in %lu ms", start_id, last, found_count,
+             (unsigned long)pdTICKS_TO_MS(xTaskGetTickCount() - start));
+    return found_count;
+}
+
+// Torque register written per servo in a SYNC WRITE
+#define SYNC_TORQUE_MAX_SERVOS  ((STS_MAX_PARAM_LEN - 2) / 2)
+
+void sts_servo_sync_enable_torque(const uint8_t *ids, int count, bool enable) {
+    uint8_t sent_ids[SYNC_TORQUE_MAX_SERVOS];
+    uint8_t data[SYNC_TORQUE_MAX_SERVOS];
+    int total = 0;
+    
+    if (!ids || count <= 0 || count > SYNC_TORQUE_MAX_SERVOS) {
+        ESP_LOGE(TAG, "Sync torque: invalid servo count %d", count);
+        return;
+    }
+    
+    if (!have_bus()) {
+        return;
+    }
+    
+    TickType_t now = xTaskGetTickCount();
+    
+    // One SYNC WRITE per bus
+    for (int b = 0; b < s_bus_count; b++) {
+        int sent = 0;
+        sts_protocol_lock(s_buses[b]);
+        
+        for (int i = 0; i < count; i++) {
+            if (bus_index(ids[i]) != b) {
+                continue;
+            }
+            
+            cache_entry_t *e = cache_entry(ids[i]);
+            
+            if (e && (e->flags & CACHE_TORQUE_VALID) && e->torque == enable &&
+                cache_fresh(e->torque_sent, now)) {
+                s_cache_stats[b].suppressed++;
+                continue;
+            }
+            
+            sent_ids[sent] = ids[i];
+            data[sent] = enable ? 1 : 0;
+            sent++;
+            
+            // Switching torque re-latches the goal; the next goal must go out
+            if (e) {
+                e->flags = CACHE_TORQUE_VALID;
+                e->torque = enable;
+                e->torque_sent = now;
+            }
+        }
+        
+        if (sent > 0) {
+            sts_sync_write(s_buses[b], STS_TORQUE_ENABLE, 1, sent_ids, data, sent);
+        }
+        sts_protocol_unlock(s_buses[b]);
+        total += sent;
+    }
+    
+    if (total > 0) {
+        ESP_LOGI(TAG, "Torque %s on %d servo(s)", enable ? "ON" : "OFF", total);
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+}
+
 // ═══════════════════════════════════════════════════════
 // POSITION CONTROL
 // ═══════════════════════════════════════════════════════
@@ -77,7 +401,7 @@ void sts_servo_enable_torque(uint8_t id, bool enable) {
 void sts_servo_set_angle(uint8_t id, float angle, uint16_t speed) {
     uint16_t position = sts_angle_to_position(angle);
     
-    ESP_LOGI(TAG, "Servo ID %d: Moving to %.1f° (pos=%d) at speed %d",
+    ESP_LOGD(TAG, "Servo ID %d: Moving to %.1f° (pos=%d) at speed %d",
              id, angle, position, speed);
     
     sts_servo_set_position(id, position, speed);
@@ -85,6 +409,15 @@ void sts_servo_set_angle(uint8_t id, float angle, uint16_t speed) {
 
 void sts_servo_set_position(uint8_t id, uint16_t position, uint16_t speed) {
     uint8_t params[6];
+    TickType_t now = xTaskGetTickCount();
+    sts_bus_t *bus = bus_of(id);
+    
+    sts_protocol_lock(bus);
+    if (cache_goal_unchanged(id, position, speed, now)) {
+        cache_stats(id)->suppressed++;
+        sts_protocol_unlock(bus);
+        return;
+    }
     
     params[0] = position & 0xFF;
     params[1] = (position >> 8) & 0xFF;
@@ -93,19 +426,22 @@ void sts_servo_set_position(uint8_t id, uint16_t position, uint16_t speed) {
     params[4] = speed & 0xFF;
     params[5] = (speed >> 8) & 0xFF;
     
-    sts_write_register(id, STS_GOAL_POSITION_L, params, 6);
+    sts_write_register(bus, id, STS_GOAL_POSITION_L, params, 6);
+    cache_goal_sent(id, position, speed, now);
+    sts_protocol_unlock(bus);
 }
 
 bool sts_servo_get_position(uint8_t id, uint16_t *position) {
     uint8_t data[2];
     
-    if (sts_read_register(id, STS_PRESENT_POSITION_L, 2, data)) {
+    if (sts_read_register(bus_of(id), id, STS_PRESENT_POSITION_L, 2, data)) {
         if (position) {
             *position = data[0] | (data[1] << 8);
         }
         return true;
     }
     
+    cache_drop(id);
     return false;
 }
 
@@ -125,16 +461,237 @@ bool sts_servo_get_angle(uint8_t id, float *angle) {
 bool sts_servo_get_speed(uint8_t id, uint16_t *speed) {
     uint8_t data[2];
     
-    if (sts_read_register(id, STS_PRESENT_SPEED_L, 2, data)) {
+    if (sts_read_register(bus_of(id), id, STS_PRESENT_SPEED_L, 2, data)) {
         if (speed) {
             *speed = data[0] | (data[1] << 8);
         }
         return true;
     }
     
+    cache_drop(id);
     return false;
 }
 
+// ═══════════════════════════════════════════════════════
+// SYNCHRONIZED POSITION CONTROL
+// ═══════════════════════════════════════════════════════
+
+// Goal block written per servo: position L/H, time L/H, speed L/H
+#define SYNC_GOAL_DATA_LEN  6
+#define SYNC_MAX_SERVOS     ((STS_MAX_PARAM_LEN - 2) / (1 + SYNC_GOAL_DATA_LEN))
+
+void sts_servo_sync_set_positions(const uint8_t *ids, const uint16_t *positions,
+                                  const uint16_t *speeds, int count) {
+    uint8_t data[SYNC_MAX_SERVOS * SYNC_GOAL_DATA_LEN];
+    uint8_t sent_ids[SYNC_MAX_SERVOS];
+    
+    if (count <= 0 || count > SYNC_MAX_SERVOS) {
+        ESP_LOGE(TAG, "Sync move: invalid servo count %d", count);
+        return;
+    }
+    
+    if (!have_bus()) {
+        return;
+    }
+    
+    TickType_t now = xTaskGetTickCount();
+    
+    // One SYNC WRITE per bus; in RS485 mode each is only queued, so the
+    // buses transmit side by side
+    for (int b = 0; b < s_bus_count; b++) {
+        int sent = 0;
+        sts_protocol_lock(s_buses[b]);
+        
+        for (int i = 0; i < count; i++) {
+            if (bus_index(ids[i]) != b) {
+                continue;
+            }
+            
+            if (cache_goal_unchanged(ids[i], positions[i], speeds[i], now)) {
+                s_cache_stats[b].suppressed++;
+                continue;
+            }
+            
+            uint8_t *d = &data[sent * SYNC_GOAL_DATA_LEN];
+            d[0] = positions[i] & 0xFF;
+            d[1] = (positions[i] >> 8) & 0xFF;
+            d[2] = 0x00;  // Time Low (0 = max speed)
+            d[3] = 0x00;  // Time High
+            d[4] = speeds[i] & 0xFF;
+            d[5] = (speeds[i] >> 8) & 0xFF;
+            sent_ids[sent++] = ids[i];
+            cache_goal_sent(ids[i], positions[i], speeds[i], now);
+        }
+        
+        if (sent > 0) {
+            sts_sync_write(s_buses[b], STS_GOAL_POSITION_L, SYNC_GOAL_DATA_LEN, sent_ids, data, sent);
+        }
+        sts_protocol_unlock(s_buses[b]);
+    }
+}
+
+void sts_servo_sync_set_angles(const uint8_t *ids, const float *angles,
+                               const uint16_t *speeds, int count) {
+    uint16_t positions[SYNC_MAX_SERVOS];
+    
+    if (count <= 0 || count > SYNC_MAX_SERVOS) {
+        ESP_LOGE(TAG, "Sync move: invalid servo count %d", count);
+        return;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        positions[i] = sts_angle_to_position(angles[i]);
+        ESP_LOGD(TAG, "Servo ID %d: Sync move to %.1f° (pos=%d) at speed %d",
+                 ids[i], angles[i], positions[i], speeds[i]);
+    }
+    
+    sts_servo_sync_set_positions(ids, positions, speeds, count);
+}
+
+// ═══════════════════════════════════════════════════════
+// TELEMETRY READ
+// ═══════════════════════════════════════════════════════
+
+// Present-state block: position(2) speed(2) load(2) voltage temperature
+// async-write flag, status, moving -> 0x38..0x42
+#define TELEMETRY_DATA_LEN  (STS_MOVING - STS_PRESENT_POSITION_L + 1)
+#define SYNC_READ_MAX_SERVOS (STS_PARSER_BUF_LEN / (6 + TELEMETRY_DATA_LEN))
+
+/**
+ * @brief Decode a sign-magnitude register value (direction in @p sign_bit)
+ */
+static int16_t decode_signed(uint16_t raw, int sign_bit) {
+    int16_t magnitude = (int16_t)(raw & ((1u << sign_bit) - 1));
+    return (raw & (1u << sign_bit)) ? -magnitude : magnitude;
+}
+
+/**
+ * @brief SYNC READ a register block from servos on any number of buses
+ * 
+ * The request goes out on every involved bus before the first reply is
+ * awaited, so the round trips overlap. Outputs are in the order of @p ids.
+ */
+static int sync_read(uint8_t address, uint8_t data_len, const uint8_t *ids, int count,
+                     uint8_t *data, bool *ok) {
+    uint8_t bus_ids[STS_MAX_BUSES][SYNC_READ_MAX_SERVOS];
+    uint8_t slot[STS_MAX_BUSES][SYNC_READ_MAX_SERVOS];
+    int bus_count[STS_MAX_BUSES] = {0};
+    uint8_t block[SYNC_READ_MAX_SERVOS * TELEMETRY_DATA_LEN];
+    bool got[SYNC_READ_MAX_SERVOS];
+    int found = 0;
+    
+    memset(ok, 0, count * sizeof(bool));
+    if (!have_bus()) {
+        return 0;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        int b = bus_index(ids[i]);
+        slot[b][bus_count[b]] = i;
+        bus_ids[b][bus_count[b]++] = ids[i];
+    }
+    
+    sts_servo_lock_all();
+    for (int b = 0; b < s_bus_count; b++) {
+        if (bus_count[b] > 0) {
+            sts_sync_read_request(s_buses[b], address, data_len, bus_ids[b], bus_count[b]);
+        }
+    }
+    
+    for (int b = 0; b < s_bus_count; b++) {
+        if (bus_count[b] == 0) {
+            continue;
+        }
+        
+        found += sts_sync_read_collect(s_buses[b], data_len, bus_ids[b], bus_count[b], block, got);
+        for (int k = 0; k < bus_count[b]; k++) {
+            if (got[k]) {
+                memcpy(&data[slot[b][k] * data_len], &block[k * data_len], data_len);
+                ok[slot[b][k]] = true;
+            }
+        }
+    }
+    sts_servo_unlock_all();
+    
+    return found;
+}
+
+static void decode_telemetry(const uint8_t *d, sts_servo_telemetry_t *t) {
+    t->position    = d[0] | (d[1] << 8);
+    t->speed       = decode_signed(d[2] | (d[3] << 8), 15);
+    t->load        = decode_signed(d[4] | (d[5] << 8), 10);
+    t->voltage     = d[STS_PRESENT_VOLTAGE - STS_PRESENT_POSITION_L];
+    t->temperature = d[STS_PRESENT_TEMPERATURE - STS_PRESENT_POSITION_L];
+    t->status      = d[STS_SERVO_STATUS - STS_PRESENT_POSITION_L];
+    t->moving      = d[STS_MOVING - STS_PRESENT_POSITION_L] != 0;
+}
+
+bool sts_servo_get_telemetry(uint8_t id, sts_servo_telemetry_t *telemetry) {
+    uint8_t data[TELEMETRY_DATA_LEN];
+    
+    if (sts_read_register(bus_of(id), id, STS_PRESENT_POSITION_L, TELEMETRY_DATA_LEN, data)) {
+        sts_servo_telemetry_t t;
+        decode_telemetry(data, &t);
+        if (t.status) {
+            cache_drop(id);
+        }
+        if (telemetry) {
+            *telemetry = t;
+        }
+        return true;
+    }
+    
+    cache_drop(id);
+    return false;
+}
+
+int sts_servo_sync_read_telemetry(const uint8_t *ids, int count,
+                                  sts_servo_telemetry_t *telemetry, bool *valid) {
+    uint8_t data[SYNC_READ_MAX_SERVOS * TELEMETRY_DATA_LEN];
+    bool ok[SYNC_READ_MAX_SERVOS];
+    
+    if (!telemetry || count <= 0 || count > SYNC_READ_MAX_SERVOS) {
+        ESP_LOGE(TAG, "Sync telemetry: invalid servo count %d", count);
+        return 0;
+    }
+    
+    int found = sync_read(STS_PRESENT_POSITION_L, TELEMETRY_DATA_LEN, ids, count, data, ok);
+    
+    for (int i = 0; i < count; i++) {
+        if (ok[i]) {
+            decode_telemetry(&data[i * TELEMETRY_DATA_LEN], &telemetry[i]);
+        }
+        if (!ok[i] || telemetry[i].status) {
+            cache_drop(ids[i]);
+        }
+        if (valid) valid[i] = ok[i];
+    }
+    
+    return found;
+}
+
+bool sts_servo_sync_get_angles(const uint8_t *ids, int count, float *angles) {
+    uint8_t data[SYNC_READ_MAX_SERVOS * 2];
+    bool ok[SYNC_READ_MAX_SERVOS];
+    
+    if (!angles || count <= 0 || count > SYNC_READ_MAX_SERVOS) {
+        return false;
+    }
+    
+    if (sync_read(STS_PRESENT_POSITION_L, 2, ids, count, data, ok) != count) {
+        for (int i = 0; i < count; i++) {
+            if (!ok[i]) cache_drop(ids[i]);
+        }
+        return false;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        angles[i] = sts_position_to_angle(data[i * 2] | (data[i * 2 + 1] << 8));
+    }
+    
+    return true;
+}
+
 // ═══════════════════════════════════════════════════════
 // ID MANAGEMENT
 // ═══════════════════════════════════════════════════════
@@ -149,7 +706,14 @@ bool sts_servo_change_id(uint8_t old_id, uint8_t new_id) {
     ESP_LOGW(TAG, "    This writes to EEPROM!");
     
     uint8_t value = new_id;
-    sts_write_register(old_id, STS_ID, &value, 1);
+    sts_write_register(bus_of(old_id), old_id, STS_ID, &value, 1);
+    sts_servo_cache_invalidate(old_id);
+    sts_servo_cache_invalidate(new_id);
+    
+    // The servo stays on its bus under the new ID
+    if (old_id < STS_BROADCAST_ID) {
+        s_id_bus[new_id] = s_id_bus[old_id];
+    }
     vTaskDelay(pdMS_TO_TICKS(100));  // Wait for EEPROM write
     
     // Verify by pinging the new ID
@@ -168,7 +732,7 @@ bool sts_servo_change_id(uint8_t old_id, uint8_t new_id) {
 bool sts_servo_read_id(uint8_t query_id, uint8_t *current_id) {
     uint8_t id;
     
-    if (sts_read_register(query_id, STS_ID, 1, &id)) {
+    if (sts_read_register(bus_of(query_id), query_id, STS_ID, 1, &id)) {
         if (current_id) {
             *current_id = id;
         }
@@ -182,13 +746,16 @@ bool sts_servo_read_id(uint8_t query_id, uint8_t *current_id) {
 void sts_servo_broadcast_reset_id(void) {
     ESP_LOGW(TAG, "");
     ESP_LOGW(TAG, "🚨 BROADCAST: Resetting ALL servos to ID 1");
-    ESP_LOGW(TAG, "   Disconnect all but ONE servo first!");
+    ESP_LOGW(TAG, "   Disconnect all but ONE servo per bus first!");
     ESP_LOGW(TAG, "");
     
     vTaskDelay(pdMS_TO_TICKS(2000));
     
     uint8_t value = 1;
-    sts_write_register(STS_BROADCAST_ID, STS_ID, &value, 1);
+    for (int b = 0; b < s_bus_count; b++) {
+        sts_write_register(s_buses[b], STS_BROADCAST_ID, STS_ID, &value, 1);
+    }
+    sts_servo_cache_invalidate(STS_BROADCAST_ID);
     vTaskDelay(pdMS_TO_TICKS(200));
     
     ESP_LOGI(TAG, "Broadcast complete. Servo(s) should now be ID 1");
@@ -0,0 +1,452 @@
+/**
+ * @file dog_bench.c
+ * @brief On-Target Benchmark Suite Implementation
+ * 
+ * Each bus sample takes the bus lock before its first timestamp, so it
+ * times the transaction itself and not the wait for other traffic, and
+ * the lock is dropped between samples so the bus scheduler keeps running.
+ * Report lines go straight to stdout without the log prefix.
+ */
+
+#include "dog_bench.h"
+#include "dog_config.h"
+#include "control_loop.h"
+#include "dog_tasks.h"
+#include "dog_kinematics.h"
+#include "dog_dsp.h"
+#include "qmi8658a.h"
+#include "sts3032_servo.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_idf_version.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "BENCH";
+
+#define BENCH_REPORT_VERSION    1
+#define BENCH_LINE_MAX          384
+
+// ═══════════════════════════════════════════════════════
+// METRICS
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    const char *name;
+    uint32_t *samples;          // First DOG_BENCH_SAMPLES values (for percentiles)
+    uint32_t n;                 // Values recorded
+    uint32_t fail;              // Transactions that failed (not timed)
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t hist[DOG_BENCH_HIST_BUCKETS];
+} bench_metric_t;
+
+static uint32_t s_samples[DOG_BENCH_SAMPLES];       // Metric being measured / reported
+static uint32_t s_ble_samples[DOG_BENCH_SAMPLES];
+static bench_metric_t s_ble_metric = { .name = "ble_to_bus", .samples = s_ble_samples, .min_us = UINT32_MAX };
+static portMUX_TYPE s_ble_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t s_ble_rx_us = 0;                     // Last BLE write not yet on the bus (0 = none)
+
+static TaskHandle_t s_task = NULL;
+static volatile bool s_running = false;
+
+static void metric_reset(bench_metric_t *m, const char *name, uint32_t *samples)
+{
+    memset(m, 0, sizeof(*m));
+    m->name = name;
+    m->samples = samples;
+    m->min_us = UINT32_MAX;
+}
+
+static void metric_add(bench_metric_t *m, uint32_t us)
+{
+    int bucket = (us < 2) ? 0 : 31 - __builtin_clz(us);
+    if (bucket >= DOG_BENCH_HIST_BUCKETS) {
+        bucket = DOG_BENCH_HIST_BUCKETS - 1;
+    }
+    m->hist[bucket]++;
+    
+    if (m->n < DOG_BENCH_SAMPLES) {
+        m->samples[m->n] = us;
+    }
+    m->n++;
+    m->sum_us += us;
+    if (us < m->min_us) m->min_us = us;
+    if (us > m->max_us) m->max_us = us;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Print one metric line (sorts the stored samples)
+ */
+static void metric_report(bench_metric_t *m)
+{
+    char line[BENCH_LINE_MAX];
+    uint32_t stored = (m->n < DOG_BENCH_SAMPLES) ? m->n : DOG_BENCH_SAMPLES;
+    uint32_t p50 = 0, p90 = 0, p99 = 0;
+    
+    if (stored > 0) {
+        qsort(m->samples, stored, sizeof(uint32_t), compare_u32);
+        p50 = m->samples[(stored - 1) * 50 / 100];
+        p90 = m->samples[(stored - 1) * 90 / 100];
+        p99 = m->samples[(stored - 1) * 99 / 100];
+    }
+    
+    int len = snprintf(line, sizeof(line),
+                       "{\"name\":\"%s\",\"unit\":\"us\",\"n\":%lu,\"fail\":%lu,"
+                       "\"min\":%lu,\"mean\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu,\"hist\":[",
+                       m->name, (unsigned long)m->n, (unsigned long)m->fail,
+                       (unsigned long)(m->n ? m->min_us : 0),
+                       (unsigned long)(m->n ? m->sum_us / m->n : 0),
+                       (unsigned long)p50, (unsigned long)p90, (unsigned long)p99,
+                       (unsigned long)m->max_us);
+    for (int i = 0; i < DOG_BENCH_HIST_BUCKETS && len < (int)sizeof(line); i++) {
+        len += snprintf(line + len, sizeof(line) - len, "%s%lu", i ? "," : "",
+                        (unsigned long)m->hist[i]);
+    }
+    printf("BENCH %s]}\n", line);
+}
+
+// ═══════════════════════════════════════════════════════
+// SERVO BUS
+// ═══════════════════════════════════════════════════════
+
+static const uint8_t s_ids[DOG_SERVO_COUNT] = {
+    DOG_SERVO_FR, DOG_SERVO_FL, DOG_SERVO_BR, DOG_SERVO_BL
+};
+static uint16_t s_goal_pos[DOG_SERVO_COUNT];
+static uint16_t s_goal_speed[DOG_SERVO_COUNT];
+
+/**
+ * @brief Read the goals the servos hold, so writing them back moves nothing
+ */
+static bool read_goals(void)
+{
+    for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+        uint8_t data[6];    // Goal position, goal time, goal speed
+        if (!sts_read_register(sts_servo_get_bus(s_ids[i]), s_ids[i], STS_GOAL_POSITION_L,
+                               sizeof(data), data)) {
+            ESP_LOGW(TAG, "Servo %u not responding, skipping bus writes", s_ids[i]);
+            return false;
+        }
+        s_goal_pos[i] = data[0] | (data[1] << 8);
+        s_goal_speed[i] = data[4] | (data[5] << 8);
+    }
+    return true;
+}
+
+static void write_one(void)
+{
+    sts_servo_set_position(s_ids[0], s_goal_pos[0], s_goal_speed[0]);
+}
+
+static void write_four(void)
+{
+    for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+        sts_servo_set_position(s_ids[i], s_goal_pos[i], s_goal_speed[i]);
+    }
+}
+
+static void sync_write_four(void)
+{
+    sts_servo_sync_set_positions(s_ids, s_goal_pos, s_goal_speed, DOG_SERVO_COUNT);
+}
+
+static void bench_bus_write(const char *name, void (*op)(void), bool goals_ok)
+{
+    bench_metric_t m;
+    metric_reset(&m, name, s_samples);
+    
+    for (int i = 0; goals_ok && i < DOG_BENCH_SAMPLES; i++) {
+        sts_servo_lock_all();
+        sts_servo_cache_invalidate(STS_BROADCAST_ID);   // Same goals every time: defeat write suppression
+        int64_t t0 = esp_timer_get_time();
+        op();
+        uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+        sts_servo_unlock_all();
+        
+        metric_add(&m, dt);
+        vTaskDelay(pdMS_TO_TICKS(DOG_BENCH_GAP_MS));
+    }
+    if (!goals_ok) {
+        m.fail = DOG_BENCH_SAMPLES;
+    }
+    metric_report(&m);
+}
+
+static void bench_bus_read(void)
+{
+    bench_metric_t m;
+    metric_reset(&m, "sts_read_reg", s_samples);
+    
+    for (int i = 0; i < DOG_BENCH_SAMPLES; i++) {
+        uint8_t data[2];
+        uint8_t id = s_ids[i % DOG_SERVO_COUNT];
+        sts_bus_t *bus = sts_servo_get_bus(id);
+        
+        sts_protocol_lock(bus);
+        int64_t t0 = esp_timer_get_time();
+        bool ok = sts_read_register(bus, id, STS_PRESENT_POSITION_L, 2, data);
+        uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+        sts_protocol_unlock(bus);
+        
+        if (ok) {
+            metric_add(&m, dt);
+        } else {
+            m.fail++;
+        }
+        vTaskDelay(pdMS_TO_TICKS(DOG_BENCH_GAP_MS));
+    }
+    metric_report(&m);
+}
+
+// ═══════════════════════════════════════════════════════
+// IMU
+// ═══════════════════════════════════════════════════════
+
+static void bench_imu(void)
+{
+    bench_metric_t m;
+    metric_reset(&m, "imu_read_raw", s_samples);
+    
+    // The IMU task drains the FIFO over the same I2C bus
+    if (!dog_imu_pause()) {
+        ESP_LOGW(TAG, "IMU task busy, skipping imu_read_raw");
+        dog_imu_resume();
+        return;
+    }
+    
+    for (int i = 0; i < DOG_BENCH_SAMPLES; i++) {
+        qmi8658a_raw_data_t raw;
+        
+        int64_t t0 = esp_timer_get_time();
+        bool ok = qmi8658a_read_raw(&raw);
+        uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+        
+        if (ok) {
+            metric_add(&m, dt);
+        } else {
+            m.fail++;
+            if (m.n == 0) {
+                break;      // IMU absent, don't repeat the driver's error log
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(DOG_BENCH_GAP_MS));
+    }
+    dog_imu_resume();
+    metric_report(&m);
+}
+
+static void bench_imu_dsp(void)
+{
+    static qmi8658a_fixed_data_t batch[32];
+    static int32_t axis[32];
+    static float rate[32];
+    dog_dsp_biquad_t bq;
+    bench_metric_t m;
+    metric_reset(&m, "imu_dsp_32", s_samples);
+    
+    dog_dsp_biquad_lowpass(&bq, 3.0f, 448.4f, 0.7071f);
+    for (int i = 0; i < 32; i++) {
+        batch[i].gyro_x = QMI8658A_Q16(6.0f) * (i % 3 - 1);
+        batch[i].gyro_y = QMI8658A_Q16(2.0f) * (i % 5 - 2);
+    }
+    
+    for (int i = 0; i < DOG_BENCH_SAMPLES; i++) {
+        int64_t t0 = esp_timer_get_time();
+        dog_dsp_unpack(batch, 32, DOG_DSP_GYRO_X, axis);
+        int edge = dog_dsp_find_above(axis, 32, QMI8658A_Q16(150.0f));
+        dog_dsp_unpack(batch, 32, DOG_DSP_GYRO_Y, axis);
+        dog_dsp_q16_to_float(axis, rate, 32);
+        dog_dsp_deadzone(rate, 32, 0.5f);
+        dog_dsp_biquad_run(&bq, rate, rate, 32);
+        uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+        
+        metric_add(&m, dt);
+        if (edge < 32) {
+            m.fail++;       // Keeps the scan from being optimised away
+        }
+        if (i % 50 == 49) {
+            vTaskDelay(1);
+        }
+    }
+    metric_report(&m);
+}
+
+// ═══════════════════════════════════════════════════════
+// KINEMATICS
+// ═══════════════════════════════════════════════════════
+
+static void bench_ik(void)
+{
+    // Two joints is the expensive case; the robot's own legs only need the aim
+    const dog_leg_geometry_t leg = {
+        .joints = 2, .upper_mm = 40.0f, .lower_mm = 40.0f, .height_mm = 60.0f,
+        .hip_limit_deg = 90.0f, .knee_min_deg = 0.0f, .knee_max_deg = 150.0f,
+    };
+    bench_metric_t m;
+    metric_reset(&m, "leg_ik_4", s_samples);
+    
+    for (int i = 0; i < DOG_BENCH_SAMPLES; i++) {
+        dog_leg_joints_t joints[DOG_SERVO_COUNT];
+        float x = (float)(i % 41 - 20);
+        
+        int64_t t0 = esp_timer_get_time();
+        for (int leg_i = 0; leg_i < DOG_SERVO_COUNT; leg_i++) {
+            dog_leg_ik(&leg, x + leg_i, -leg.height_mm, &joints[leg_i]);
+        }
+        uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+        
+        metric_add(&m, dt);
+        if (i % 50 == 49) {
+            vTaskDelay(1);      // Let lower priority tasks run
+        }
+    }
+    metric_report(&m);
+}
+
+// ═══════════════════════════════════════════════════════
+// CONTROL LOOP
+// ═══════════════════════════════════════════════════════
+
+static void loop_tick(void *ctx, int64_t tick_us)
+{
+    bench_metric_t *m = (bench_metric_t *)ctx;
+    
+    if (m->n < DOG_BENCH_SAMPLES) {
+        metric_add(m, (uint32_t)(esp_timer_get_time() - tick_us));
+        if (m->n == DOG_BENCH_SAMPLES) {
+            xTaskNotifyGive(s_task);
+        }
+    }
+}
+
+static void bench_loop(void)
+{
+    bench_metric_t m;
+    metric_reset(&m, "loop_wake", s_samples);
+    
+    if (!control_loop_is_running()) {
+        ESP_LOGW(TAG, "Control loop not running, skipping loop_wake");
+        metric_report(&m);
+        return;
+    }
+    
+    int handle = control_loop_register("bench", loop_tick, &m);
+    if (handle < 0) {
+        ESP_LOGW(TAG, "Control loop full, skipping loop_wake");
+        metric_report(&m);
+        return;
+    }
+    
+    uint32_t wait_ms = DOG_BENCH_SAMPLES * 1000 / control_loop_get_rate_hz() + 1000;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms));
+    control_loop_unregister(handle);
+    metric_report(&m);
+}
+
+// ═══════════════════════════════════════════════════════
+// BLE
+// ═══════════════════════════════════════════════════════
+
+void dog_bench_ble_rx(void)
+{
+    int64_t now = esp_timer_get_time();
+    
+    portENTER_CRITICAL(&s_ble_lock);
+    s_ble_rx_us = now;
+    portEXIT_CRITICAL(&s_ble_lock);
+}
+
+void dog_bench_bus_write(void)
+{
+    int64_t now = esp_timer_get_time();
+    
+    portENTER_CRITICAL(&s_ble_lock);
+    if (s_ble_rx_us != 0) {
+        int64_t dt = now - s_ble_rx_us;
+        s_ble_rx_us = 0;
+        if (dt <= DOG_BENCH_BLE_TIMEOUT_US) {
+            metric_add(&s_ble_metric, (uint32_t)dt);
+        }
+    }
+    portEXIT_CRITICAL(&s_ble_lock);
+}
+
+/**
+ * @brief Report the live BLE metric and start a new collection
+ */
+static void report_ble(void)
+{
+    bench_metric_t m;
+    
+    portENTER_CRITICAL(&s_ble_lock);
+    m = s_ble_metric;
+    memcpy(s_samples, s_ble_samples, sizeof(s_samples));
+    metric_reset(&s_ble_metric, "ble_to_bus", s_ble_samples);
+    portEXIT_CRITICAL(&s_ble_lock);
+    
+    m.samples = s_samples;
+    metric_report(&m);
+}
+
+// ═══════════════════════════════════════════════════════
+// SUITE
+// ═══════════════════════════════════════════════════════
+
+static void bench_task(void *param)
+{
+    ESP_LOGI(TAG, "Benchmark started (%d samples per metric)", DOG_BENCH_SAMPLES);
+    printf("BENCH {\"suite\":\"dog\",\"v\":%d,\"idf\":\"%s\",\"built\":\"%s %s\",\"samples\":%d}\n",
+           BENCH_REPORT_VERSION, esp_get_idf_version(), __DATE__, __TIME__, DOG_BENCH_SAMPLES);
+    
+    bool goals_ok = read_goals();
+    bench_bus_write("sts_write_1", write_one, goals_ok);
+    bench_bus_write("sts_write_4", write_four, goals_ok);
+    bench_bus_write("sts_sync_write_4", sync_write_four, goals_ok);
+    bench_bus_read();
+    bench_imu();
+    bench_imu_dsp();
+    bench_ik();
+    bench_loop();
+    report_ble();
+    
+    printf("BENCH_END\n");
+    ESP_LOGI(TAG, "Benchmark finished");
+    
+    s_task = NULL;
+    s_running = false;
+    vTaskDelete(NULL);
+}
+
+bool dog_bench_start(void)
+{
+    if (s_running) {
+        return false;
+    }
+    
+    s_running = true;
+    if (xTaskCreatePinnedToCore(bench_task, "dog_bench", DOG_BENCH_TASK_STACK, NULL,
+                                DOG_BENCH_TASK_PRIORITY, &s_task, DOG_COMMS_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create benchmark task");
+        s_task = NULL;
+        s_running = false;
+        return false;
+    }
+    return true;
+}
+
+bool dog_bench_is_running(void)
+{
+    return s_running;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file dog_bench.h
+ * @brief On-Target Benchmark Suite
+ * 
+ * Built only with CONFIG_DOG_BENCHMARK. Measures the transactions the
+ * motion path is made of with esp_timer timestamps:
+ * 
+ *   sts_write_1      one WRITE packet (goal block of one servo)
+ *   sts_write_4      four WRITE packets (one per servo)
+ *   sts_sync_write_4 one SYNC WRITE of all four goal blocks
+ *   sts_read_reg     READ round trip (present position)
+ *   imu_read_raw     qmi8658a_read_raw() I2C transaction
+ *   imu_dsp_32       one 32-sample batch through the balance filters
+ *                    (unpack, deadzone, biquad, gesture edge scan)
+ *   leg_ik_4         dog_leg_ik() for four two-joint legs (eight joints)
+ *   loop_wake        control loop wake-up vs ideal tick time
+ *   ble_to_bus       BLE write received -> next servo goal on the bus
+ * 
+ * Bus benchmarks write back the goal registers the servos already hold,
+ * so nothing moves. ble_to_bus is collected live from real traffic (send
+ * move commands while no gait runs) and reset by each report.
+ * 
+ * The report is one line per metric on the console, easy to grep and
+ * diff between firmware builds:
+ * 
+ *   BENCH {"suite":"dog","v":1,"idf":"v5.5","built":"..."}
+ *   BENCH {"name":"sts_read_reg","unit":"us","n":200,"fail":0,"min":..,
+ *          "mean":..,"p50":..,"p90":..,"p99":..,"max":..,"hist":[...]}
+ *   BENCH_END
+ * 
+ * hist[k] counts samples in [2^k, 2^(k+1)) µs (hist[0] also holds 0).
+ */
+
+#ifndef DOG_BENCH_H
+#define DOG_BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#ifdef CONFIG_DOG_BENCHMARK_SAMPLES
+#define DOG_BENCH_SAMPLES           CONFIG_DOG_BENCHMARK_SAMPLES
+#else
+#define DOG_BENCH_SAMPLES           200     // Samples per metric
+#endif
+
+#define DOG_BENCH_HIST_BUCKETS      20      // Up to ~1 s
+#define DOG_BENCH_GAP_MS            10      // Pause between bus samples (lets other traffic through)
+#define DOG_BENCH_BLE_TIMEOUT_US    500000  // BLE write with no bus write after this is not counted
+#define DOG_BENCH_TASK_STACK        4096
+#define DOG_BENCH_TASK_PRIORITY     3       // Below telemetry (4) and the motion executor (5)
+
+// ═══════════════════════════════════════════════════════
+// HOOKS
+// ═══════════════════════════════════════════════════════
+
+#if CONFIG_DOG_BENCHMARK
+#define DOG_BENCH_BLE_RX()          dog_bench_ble_rx()
+#define DOG_BENCH_BUS_WRITE()       dog_bench_bus_write()
+#else
+#define DOG_BENCH_BLE_RX()          do { } while (0)
+#define DOG_BENCH_BUS_WRITE()       do { } while (0)
+#endif
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Run the whole suite in a background task and print the report
+ * @return false if a run is already in progress or the task failed
+ */
+bool dog_bench_start(void);
+
+/**
+ * @brief Check if a run is in progress
+ */
+bool dog_bench_is_running(void);
+
+/**
+ * @brief A BLE command write arrived (BLE host task; use DOG_BENCH_BLE_RX)
+ */
+void dog_bench_ble_rx(void);
+
+/**
+ * @brief Servo goals were written to the bus (bus task; use DOG_BENCH_BUS_WRITE)
+ */
+void dog_bench_bus_write(void);
+
+#endif // DOG_BENCH_H
@@ -0,0 +1,91 @@
+/**
+ * @file ble_json.c
+ * @brief Arena Allocator for Command JSON Implementation
+ * 
+ * Only the task that started the current parse allocates from the arena;
+ * cJSON hooks are global, so anything else gets the heap as before.
+ */
+
+#include "ble_json.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static uint8_t s_arena[BLE_JSON_ARENA_SIZE] __attribute__((aligned(8)));
+static size_t s_used = 0;
+static int s_live = 0;                  // Trees parsed and not yet deleted
+static TaskHandle_t s_owner = NULL;     // Task allowed to use the arena
+static ble_json_stats_t s_stats;
+
+// ═══════════════════════════════════════════════════════
+// CJSON HOOKS
+// ═══════════════════════════════════════════════════════
+
+static void* arena_malloc(size_t size) {
+    size_t need = (size + 7) & ~(size_t)7;     // cJSON nodes hold a double
+    
+    if (xTaskGetCurrentTaskHandle() == s_owner && need <= sizeof(s_arena) - s_used) {
+        void* p = &s_arena[s_used];
+        s_used += need;
+        if (s_used > s_stats.peak_bytes) s_stats.peak_bytes = (uint32_t)s_used;
+        return p;
+    }
+    
+    s_stats.heap_allocs++;
+    s_stats.heap_bytes += (uint32_t)size;
+    return malloc(size);
+}
+
+static void arena_free(void* p) {
+    if ((uint8_t*)p >= s_arena && (uint8_t*)p < s_arena + sizeof(s_arena)) {
+        return;     // Reclaimed by the next rewind
+    }
+    free(p);
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+void ble_json_init(void) {
+    cJSON_Hooks hooks = {
+        .malloc_fn = arena_malloc,
+        .free_fn = arena_free,
+    };
+    cJSON_InitHooks(&hooks);
+}
+
+cJSON* ble_json_parse(const char* data, size_t len) {
+    if (s_live == 0) {
+        s_used = 0;
+        s_owner = xTaskGetCurrentTaskHandle();
+    }
+    s_stats.parses++;
+    
+    cJSON* json = cJSON_ParseWithLength(data, len);
+    if (json) {
+        s_live++;
+    }
+    return json;
+}
+
+void ble_json_delete(cJSON* json) {
+    if (json == NULL) {
+        return;
+    }
+    cJSON_Delete(json);     // Frees heap fallbacks; arena nodes are a no-op
+    if (s_live > 0) {
+        s_live--;
+    }
+}
+
+void ble_json_get_stats(ble_json_stats_t* stats) {
+    if (stats) {
+        *stats = s_stats;
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * @file ble_json.h
+ * @brief Arena Allocator for Command JSON
+ * 
+ * Installs cJSON hooks that hand out memory from a static bump arena
+ * instead of the heap. The arena is rewound when a parse starts with no
+ * other tree alive, so a command's nodes cost a pointer bump and freeing
+ * them costs nothing. Allocations that do not fit, or that come from a
+ * task other than the one parsing, fall back to the heap and are counted.
+ * 
+ *   cJSON* json = ble_json_parse(data, len);
+ *   ...
+ *   ble_json_delete(json);
+ * 
+ * Trees live until the next top-level parse at most: anything a command
+ * needs afterwards must be copied out (see the offset gait pool in
+ * ble_servo.c).
+ */
+
+#ifndef BLE_JSON_H
+#define BLE_JSON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cJSON.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define BLE_JSON_ARENA_SIZE     16384   // Bytes; ~400 nodes, about 1.2 KB of keyframe JSON
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    uint32_t parses;
+    uint32_t peak_bytes;        // Most arena bytes one command used
+    uint32_t heap_allocs;       // Allocations that missed the arena
+    uint32_t heap_bytes;
+} ble_json_stats_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Install the cJSON hooks (before the first parse)
+ */
+void ble_json_init(void);
+
+/**
+ * @brief Parse a document into the arena
+ * @return Tree, or NULL if the JSON is invalid
+ */
+cJSON* ble_json_parse(const char* data, size_t len);
+
+/**
+ * @brief Release a tree from ble_json_parse() (NULL is ignored)
+ */
+void ble_json_delete(cJSON* json);
+
+/**
+ * @brief Get the allocation counters
+ */
+void ble_json_get_stats(ble_json_stats_t* stats);
+
+#endif // BLE_JSON_H
@@ -0,0 +1,144 @@
+/**
+ * @file ble_robot.c
+ * @brief BLE Robot Control Implementation
+ * 
+ * Adapts the ble_servo callbacks to the per-command callbacks of
+ * ble_robot.h. Nothing is allocated per message: commands arrive as the
+ * transport's typed values and are forwarded as they are.
+ */
+
+#include "ble_robot.h"
+#include "ble_servo.h"
+#include "dog_config.h"
+#include "esp_log.h"
+#include <stdio.h>
+
+static const char* TAG = "BLE_ROBOT";
+
+static bool s_started = false;
+static bool s_active = false;
+
+// Callback storage
+static ble_servo_all_cb_t s_servo_all_cb = NULL;
+static ble_servo_single_cb_t s_servo_single_cb = NULL;
+static ble_connection_cb_t s_connection_cb = NULL;
+static ble_message_cb_t s_message_cb = NULL;
+
+// ═══════════════════════════════════════════════════════
+// TRANSPORT ADAPTERS
+// ═══════════════════════════════════════════════════════
+
+static void on_move(float fr, float fl, float br, float bl,
+                    uint16_t speed, uint16_t delay_ms) {
+    ble_servo_all_cb_t cb = s_servo_all_cb;
+    if (s_active && cb) {
+        cb(fr, fl, br, bl, speed, delay_ms);
+    }
+}
+
+/**
+ * @brief Per-leg moves become one single-servo call per leg that moves
+ */
+static void on_leg_move(ble_leg_move_t fr, ble_leg_move_t fl,
+                        ble_leg_move_t br, ble_leg_move_t bl) {
+    ble_servo_single_cb_t cb = s_servo_single_cb;
+    if (!s_active || !cb) return;
+    
+    const ble_leg_move_t legs[DOG_SERVO_COUNT] = { fr, fl, br, bl };
+    for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+        if (legs[i].angle >= 0) {
+            cb((uint8_t)(DOG_SERVO_FR + i), legs[i].angle, legs[i].speed, legs[i].delay_ms);
+        }
+    }
+}
+
+static void on_connect(bool connected) {
+    ESP_LOGI(TAG, "BLE connection state: %s", connected ? "connected" : "disconnected");
+    ble_connection_cb_t cb = s_connection_cb;
+    if (s_active && cb) {
+        cb(connected);
+    }
+}
+
+static void on_message(const char* text) {
+    ble_message_cb_t cb = s_message_cb;
+    if (s_active && cb) {
+        cb(text);
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// INITIALIZATION
+// ═══════════════════════════════════════════════════════
+
+bool ble_robot_init(void) {
+    ESP_LOGI(TAG, "Initializing BLE robot control");
+    
+    if (s_started) {
+        s_active = true;
+        return true;
+    }
+    
+    ble_servo_set_message_cb(on_message);
+    if (!ble_servo_init(on_move, on_leg_move, NULL, on_connect)) {
+        ESP_LOGE(TAG, "Failed to start BLE transport");
+        ble_servo_set_message_cb(NULL);
+        return false;
+    }
+    
+    s_started = true;
+    s_active = true;
+    ESP_LOGI(TAG, "BLE robot control initialized - Device: %s", ble_robot_get_device_name());
+    return true;
+}
+
+void ble_robot_stop(void) {
+    if (s_active) {
+        s_active = false;
+        ESP_LOGI(TAG, "BLE robot control stopped");
+    }
+}
+
+bool ble_robot_is_connected(void) {
+    return s_active && ble_servo_is_connected();
+}
+
+// ═══════════════════════════════════════════════════════
+// CALLBACK REGISTRATION
+// ═══════════════════════════════════════════════════════
+
+void ble_robot_on_servo_all(ble_servo_all_cb_t callback) {
+    s_servo_all_cb = callback;
+}
+
+void ble_robot_on_servo_single(ble_servo_single_cb_t callback) {
+    s_servo_single_cb = callback;
+}
+
+void ble_robot_on_connection(ble_connection_cb_t callback) {
+    s_connection_cb = callback;
+}
+
+void ble_robot_on_message(ble_message_cb_t callback) {
+    s_message_cb = callback;
+}
+
+// ═══════════════════════════════════════════════════════
+// SENDING DATA TO CLIENT
+// ═══════════════════════════════════════════════════════
+
+bool ble_robot_send_servo_state(float fr, float fl, float br, float bl) {
+    char buf[96];
+    snprintf(buf, sizeof(buf),
+             "{\"type\":\"servo_state\",\"fr\":%.1f,\"fl\":%.1f,\"br\":%.1f,\"bl\":%.1f}",
+             fr, fl, br, bl);
+    return s_active && ble_servo_send_response(buf);
+}
+
+bool ble_robot_send_response(const char* response) {
+    return s_active && response && ble_servo_send_response(response);
+}
+
+const char* ble_robot_get_device_name(void) {
+    return BLE_SERVO_DEVICE_NAME;
+}
@@ -1,9 +1,14 @@
 /**
  * @file ble_robot.h
- * @brief C-compatible BLE Robot Control Interface
+ * @brief BLE Robot Control Interface
  * 
- * Provides a C interface for the C++ BLE protocol class,
- * allowing main.c to use BLE for robot control.
+ * Callback-per-command interface on top of the ble_servo transport (one
+ * NimBLE stack, one set of buffers). Clients send the long-form commands
+ * ({"cmd":"servos"|"servo"|"msg"}, see ble_servo.h); the short forms keep
+ * working too. Long responses are chunked by the transport.
+ * 
+ * Use either this interface or ble_servo_init(), not both: both start
+ * the same stack.
  */
 
 #ifndef BLE_ROBOT_H
@@ -61,12 +66,18 @@ typedef void (*ble_message_cb_t)(const char* message);
 
 /**
  * @brief Initialize and start the BLE robot control interface
+ * 
+ * Callbacks may be registered before or after; they run in the motion
+ * executor (servo commands) or the NimBLE host task (connection, messages).
+ * 
  * @return true if successful
  */
 bool ble_robot_init(void);
 
 /**
  * @brief Stop the BLE interface
+ * 
+ * Drops the callbacks; the stack keeps advertising (NimBLE is not torn down).
  */
 void ble_robot_stop(void);
 
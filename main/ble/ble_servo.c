@@ -3,13 +3,36 @@
  * @brief Minimal BLE Servo Controller Implementation
  * 
  * Uses NimBLE for Web Bluetooth compatible servo control.
+ * Writes land in a static buffer and are dispatched by their first byte:
+ * '{' is JSON (parsed once), anything else is a binary frame decoded in
+ * place without allocating. Chunk frames skip the receive buffer and are
+ * copied from the mbuf straight into the ble_stream arena.
  */
 
 #include "ble_servo.h"
+#include "control_loop.h"
+#include "dog_bus.h"
+#include "dog_config.h"
+#include "esp_timer.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "cJSON.h"
+#include "ble_stream.h"
+#include "ble_json.h"
+#include "ble_telemetry.h"
+#include "dog_trace.h"
+#include "dog_bench.h"
+#include "motion_timeline.h"
+#include "motion_primitives.h"
+#include "gait_manager.h"
+#include "dog_tracking.h"
+#include "dog_tasks.h"
+#include "dog_imu_cal.h"
+#include "dog_params.h"
+#include "dog_kinematics.h"
 #include <string.h>
 
 static const char* TAG = "BLE_SERVO";
@@ -23,9 +46,14 @@ static const char* TAG = "BLE_SERVO";
 #include "services/gap/ble_svc_gap.h"
 #include "services/gatt/ble_svc_gatt.h"
 
+#if !CONFIG_FREERTOS_UNICORE && CONFIG_BT_NIMBLE_PINNED_TO_CORE != DOG_COMMS_CORE
+#warning "NimBLE host runs off the comms core (CONFIG_BT_NIMBLE_PINNED_TO_CORE vs CONFIG_DOG_COMMS_CORE)"
+#endif
+
 // UUIDs for Web Bluetooth
 // Service: 0d9be2a0-4757-43d9-83df-704ae274b8df
 // Char:    8116d8c0-d45d-4fdf-998e-33ab8c471d59
+// Telem:   8116d8c1-d45d-4fdf-998e-33ab8c471d59 (notify only, see ble_telemetry.h)
 #define SERVICE_UUID_128 \
     0xdf, 0xb8, 0x74, 0xe2, 0x4a, 0x70, 0xdf, 0x83, \
     0xd9, 0x43, 0x57, 0x47, 0xa0, 0xe2, 0x9b, 0x0d
@@ -34,26 +62,71 @@ static const char* TAG = "BLE_SERVO";
     0x59, 0x1d, 0x47, 0x8c, 0xab, 0x33, 0x8e, 0x99, \
     0xdf, 0x4f, 0x5d, 0xd4, 0xc0, 0xd8, 0x16, 0x81
 
+#define TELEM_UUID_128 \
+    0x59, 0x1d, 0x47, 0x8c, 0xab, 0x33, 0x8e, 0x99, \
+    0xdf, 0x4f, 0x5d, 0xd4, 0xc1, 0xd8, 0x16, 0x81
+
 static const ble_uuid128_t svc_uuid = BLE_UUID128_INIT(SERVICE_UUID_128);
 static const ble_uuid128_t chr_uuid = BLE_UUID128_INIT(CHAR_UUID_128);
+static const ble_uuid128_t telem_uuid = BLE_UUID128_INIT(TELEM_UUID_128);
 
 // State
 static uint16_t s_conn_handle = BLE_HS_CONN_HANDLE_NONE;
 static uint16_t s_chr_handle;
+static uint16_t s_telem_handle;
 static bool s_connected = false;
 
-// Chunked message buffer
-#define CHUNK_BUFFER_SIZE 2048
-static char s_chunk_buffer[CHUNK_BUFFER_SIZE];
-static size_t s_chunk_len = 0;
+// Receive buffer (one ATT attribute; writes arrive on the host task only)
+#define RX_BUFFER_SIZE 512
+static uint8_t s_rx_buffer[RX_BUFFER_SIZE + 1];
+
+// Chunk sequence (payloads are reassembled by ble_stream)
 static uint8_t s_chunk_expected = 0;
 static uint8_t s_chunk_received = 0;
 
+// Motion executor (GATT writes only enqueue; exec_task runs them)
+typedef enum {
+    EXEC_MOVE,
+    EXEC_LEG_MOVE,
+    EXEC_STANCE,
+    EXEC_OFFSET_GAIT,
+    EXEC_TIMELINE_PLAY,
+    EXEC_WALK,
+} exec_cmd_type_t;
+
+typedef struct {
+    exec_cmd_type_t type;
+    union {
+        struct {
+            float fr, fl, br, bl;
+            uint16_t speed;
+            uint16_t delay_ms;
+        } move;
+        ble_leg_move_t legs[4];     // FR, FL, BR, BL
+        struct offset_gait* gait;   // Pool slot, released by the executor
+        uint8_t timeline_id;        // Stored timeline slot
+        struct {
+            gait_type_t type;
+            gait_direction_t direction;
+        } walk;                     // Gait manager request
+    };
+} exec_cmd_t;
+
+static QueueHandle_t s_exec_queue = NULL;
+static TaskHandle_t s_exec_task = NULL;
+static StaticQueue_t s_exec_queue_buf;
+static uint8_t s_exec_queue_storage[BLE_SERVO_QUEUE_LEN * sizeof(exec_cmd_t)];
+static StaticTask_t s_exec_tcb;
+static StackType_t s_exec_stack[BLE_SERVO_EXEC_STACK];
+static volatile bool s_backpressure = false;
+static uint32_t s_exec_rejected = 0;
+
 // Callbacks
 static ble_servo_move_cb_t s_move_cb = NULL;
 static ble_servo_leg_move_cb_t s_leg_move_cb = NULL;
 static ble_servo_stance_cb_t s_stance_cb = NULL;
 static ble_servo_connect_cb_t s_connect_cb = NULL;
+static ble_servo_message_cb_t s_message_cb = NULL;
 
 // Forward declarations
 static int chr_access_cb(uint16_t conn_handle, uint16_t attr_handle,
@@ -63,7 +136,440 @@ static void on_sync(void);
 static void on_reset(int reason);
 static void host_task(void *param);
 static void start_advertising(void);
-static void process_command(const char* cmd, size_t len);
+static void process_command(cJSON* json);
+static uint16_t current_mtu(void);
+static size_t chunk_escape(const char* msg, size_t len, size_t* pos, char* out, size_t max);
+
+// ═══════════════════════════════════════════════════════
+// FRAME HELPERS
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021); start with crc = 0xFFFF
+ */
+static uint16_t frame_crc16(uint16_t crc, const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static inline uint16_t frame_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// ═══════════════════════════════════════════════════════
+// OFFSET GAIT SCHEDULER
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief One leg of an offset gait, in "d" order
+ */
+typedef struct {
+    uint8_t servo_id;
+    uint8_t column;             // Angle index in each keyframe
+    const char* name;
+} offset_leg_t;
+
+// "d" lists FL, BR, FR, BL (diagonal pairs first); keyframes are FR, FL, BR, BL
+static const offset_leg_t s_offset_legs[] = {
+    { DOG_SERVO_FL, 1, "FL" },
+    { DOG_SERVO_BR, 2, "BR" },
+    { DOG_SERVO_FR, 0, "FR" },
+    { DOG_SERVO_BL, 3, "BL" },
+};
+#define OFFSET_GAIT_MAX_LEGS    (sizeof(s_offset_legs) / sizeof(s_offset_legs[0]))
+#define OFFSET_GAIT_TIMEOUT_US  (30 * 1000000LL)
+#define OFFSET_GAIT_MAX_KEYFRAMES   64
+#define OFFSET_GAIT_SLOTS           2       // Offset gaits queued at once
+
+/**
+ * @brief A parsed offset gait (command JSON does not outlive the command)
+ */
+typedef struct offset_gait {
+    bool used;
+    uint8_t leg_count;
+    uint16_t speed;
+    uint16_t kf_count;
+    int32_t delays[OFFSET_GAIT_MAX_LEGS];   // ms, in "d" order
+    struct {
+        float angles[4];                    // FR, FL, BR, BL
+        uint16_t hold_ms;
+    } kf[OFFSET_GAIT_MAX_KEYFRAMES];
+} offset_gait_t;
+
+static offset_gait_t s_offset_pool[OFFSET_GAIT_SLOTS];
+static portMUX_TYPE s_offset_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief A leg's next keyframe, ordered by due time in a min-heap
+ */
+typedef struct {
+    int64_t due_us;
+    uint8_t leg;                // Index into s_offset_legs
+    uint16_t step;              // Keyframe to apply (== count: leg finished)
+} gait_event_t;
+
+static void heap_push(gait_event_t* heap, int* n, gait_event_t ev) {
+    int i = (*n)++;
+    while (i > 0 && heap[(i - 1) / 2].due_us > ev.due_us) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = ev;
+}
+
+static gait_event_t heap_pop(gait_event_t* heap, int* n) {
+    gait_event_t top = heap[0];
+    gait_event_t last = heap[--(*n)];
+    int i = 0;
+    
+    while (2 * i + 1 < *n) {
+        int child = 2 * i + 1;
+        if (child + 1 < *n && heap[child + 1].due_us < heap[child].due_us) {
+            child++;
+        }
+        if (heap[child].due_us >= last.due_us) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+static int keyframe_duration(cJSON* kf, int fallback) {
+    return (cJSON_GetArraySize(kf) > 4) ? cJSON_GetArrayItem(kf, 4)->valueint : fallback;
+}
+
+static void offset_gait_release(offset_gait_t* g) {
+    portENTER_CRITICAL(&s_offset_lock);
+    g->used = false;
+    portEXIT_CRITICAL(&s_offset_lock);
+}
+
+/**
+ * @brief Copy an "o" object into a free pool slot (host task)
+ * 
+ * Replies {"err":"offset_fmt"} for a malformed gait or more than
+ * OFFSET_GAIT_MAX_KEYFRAMES keyframes, {"err":"busy"} when every slot
+ * is queued.
+ * 
+ * @return Slot for the executor, NULL on error
+ */
+static offset_gait_t* offset_gait_parse(cJSON* o) {
+    cJSON* delays = cJSON_GetObjectItem(o, "d");
+    cJSON* speed_val = cJSON_GetObjectItem(o, "s");
+    cJSON* keyframes = cJSON_GetObjectItem(o, "k");
+    int leg_count = delays ? cJSON_GetArraySize(delays) : 0;
+    int kf_count = keyframes ? cJSON_GetArraySize(keyframes) : 0;
+    
+    bool valid = cJSON_IsArray(delays) && leg_count >= 1 && leg_count <= (int)OFFSET_GAIT_MAX_LEGS &&
+                 cJSON_IsNumber(speed_val) && cJSON_IsArray(keyframes) &&
+                 kf_count >= 1 && kf_count <= OFFSET_GAIT_MAX_KEYFRAMES;
+    cJSON* kf;
+    cJSON_ArrayForEach(kf, keyframes) {
+        valid = valid && cJSON_IsArray(kf) && cJSON_GetArraySize(kf) >= 4;
+    }
+    if (!valid) {
+        ESP_LOGW(TAG, "Invalid offset gait format (max %d keyframes)", OFFSET_GAIT_MAX_KEYFRAMES);
+        ble_servo_send_response("{\"err\":\"offset_fmt\"}");
+        return NULL;
+    }
+    
+    offset_gait_t* g = NULL;
+    portENTER_CRITICAL(&s_offset_lock);
+    for (int i = 0; i < OFFSET_GAIT_SLOTS; i++) {
+        if (!s_offset_pool[i].used) {
+            g = &s_offset_pool[i];
+            g->used = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_offset_lock);
+    if (g == NULL) {
+        ESP_LOGW(TAG, "Offset gait slots full, command dropped");
+        ble_servo_send_response("{\"err\":\"busy\"}");
+        return NULL;
+    }
+    
+    g->leg_count = (uint8_t)leg_count;
+    g->speed = (uint16_t)speed_val->valueint;
+    g->kf_count = (uint16_t)kf_count;
+    for (int leg = 0; leg < leg_count; leg++) {
+        g->delays[leg] = cJSON_GetArrayItem(delays, leg)->valueint;
+    }
+    
+    int default_duration = keyframe_duration(cJSON_GetArrayItem(keyframes, 0), 100);
+    int i = 0;
+    cJSON_ArrayForEach(kf, keyframes) {
+        cJSON* value = kf->child;
+        for (int col = 0; col < 4; col++, value = value->next) {
+            g->kf[i].angles[col] = (float)value->valuedouble;
+        }
+        g->kf[i].hold_ms = (uint16_t)keyframe_duration(kf, default_duration);
+        i++;
+    }
+    return g;
+}
+
+/**
+ * @brief Run an offset gait (executor task; releases the slot)
+ * 
+ * Format: {"d":[fl,br,fr,bl],"s":speed,"k":[[fr,fl,br,bl,delay],...]}
+ * d = start delays for each leg (in order FL, BR, FR, BL for diagonal gait)
+ * s = servo speed
+ * k = keyframes array with angles for all 4 legs, plus an optional hold
+ *     time (default: the first keyframe's, else 100 ms)
+ * 
+ * Diagonal gait pairing (matching KTurtle):
+ *   Pair 1: FL + BR (front-left and back-right)
+ *   Pair 2: FR + BL (front-right and back-left)
+ * The offset determines when Pair 2 starts after Pair 1
+ * 
+ * Each leg's next keyframe sits in a min-heap keyed by due time. The task
+ * sleeps until the earliest one, then applies every keyframe due within
+ * the same tick as one bus write.
+ */
+static void run_offset_gait(offset_gait_t* g) {
+    uint16_t speed = g->speed;
+    int kf_count = g->kf_count;
+    const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+    int64_t start_us = esp_timer_get_time();
+    
+    gait_event_t heap[OFFSET_GAIT_MAX_LEGS];
+    int pending = 0;
+    for (int leg = 0; leg < g->leg_count; leg++) {
+        heap_push(heap, &pending, (gait_event_t) {
+            .due_us = start_us + (int64_t)g->delays[leg] * 1000, .leg = (uint8_t)leg, .step = 0 });
+    }
+    
+    ESP_LOGI(TAG, "Offset gait: %d legs, spd=%u kfs=%d step=%u ms",
+             g->leg_count, speed, kf_count, g->kf[0].hold_ms);
+    
+    while (pending > 0) {
+        int64_t now = esp_timer_get_time();
+        if (now - start_us > OFFSET_GAIT_TIMEOUT_US) {
+            ESP_LOGW(TAG, "Offset gait timeout");
+            break;
+        }
+        
+        int64_t wait_us = heap[0].due_us - now;
+        if (wait_us >= tick_us) {
+            vTaskDelay((TickType_t)(wait_us / tick_us));
+            continue;
+        }
+        
+        // Everything due before the next tick goes out in one write
+        uint8_t ids[OFFSET_GAIT_MAX_LEGS];
+        float angles[OFFSET_GAIT_MAX_LEGS];
+        uint16_t speeds[OFFSET_GAIT_MAX_LEGS];
+        int count = 0;
+        
+        while (pending > 0 && heap[0].due_us < now + tick_us) {
+            gait_event_t ev = heap_pop(heap, &pending);
+            if (ev.step >= kf_count) {
+                continue;   // Final keyframe's hold time is over
+            }
+            
+            const offset_leg_t* leg = &s_offset_legs[ev.leg];
+            float angle = g->kf[ev.step].angles[leg->column];
+            ESP_LOGD(TAG, "%s -> step %u, angle %.0f", leg->name, ev.step, angle);
+            
+            ids[count] = leg->servo_id;
+            angles[count] = DOG_IS_RIGHT_SIDE(leg->servo_id) ? DOG_REVERSE_ANGLE(angle) : angle;
+            speeds[count] = speed;
+            count++;
+            
+            ev.due_us += (int64_t)g->kf[ev.step].hold_ms * 1000;
+            ev.step++;
+            heap_push(heap, &pending, ev);
+        }
+        
+        if (count > 0) {
+            dog_servo_move_raw(ids, angles, speeds, count, DOG_BUS_PRIO_BLE);
+        }
+    }
+    
+    if (pending == 0) {
+        ESP_LOGI(TAG, "Offset gait complete");
+    }
+    ble_servo_send_response("{\"ok\":1}");
+    offset_gait_release(g);
+}
+
+// ═══════════════════════════════════════════════════════
+// MOTION EXECUTOR
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Free motion queue slots
+ */
+static unsigned exec_free(void) {
+    return s_exec_queue ? (unsigned)uxQueueSpacesAvailable(s_exec_queue) : 0;
+}
+
+/**
+ * @brief Reply {"ok":1,"q":<free slots>}
+ */
+static void send_ok(void) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "{\"ok\":1,\"q\":%u}", exec_free());
+    ble_servo_send_response(buf);
+}
+
+/**
+ * @brief Queue a command for the executor (host task; never blocks)
+ * 
+ * Raises backpressure ({"bp":1}) once the queue reaches the high mark.
+ * 
+ * @return false if the queue is full (the command is dropped)
+ */
+static bool exec_post(const exec_cmd_t* cmd) {
+    if (s_exec_queue == NULL || xQueueSend(s_exec_queue, cmd, 0) != pdTRUE) {
+        s_exec_rejected++;
+        DOG_TRACE(DOG_TRACE_QUEUE_FULL, 0, s_exec_rejected);
+        ESP_LOGW(TAG, "Motion queue full, command dropped (%lu total)",
+                 (unsigned long)s_exec_rejected);
+        ble_servo_send_response("{\"err\":\"busy\",\"q\":0}");
+        return false;
+    }
+    
+    unsigned free_slots = exec_free();
+    if (!s_backpressure && BLE_SERVO_QUEUE_LEN - free_slots >= BLE_SERVO_QUEUE_HIGH) {
+        s_backpressure = true;
+        char buf[32];
+        snprintf(buf, sizeof(buf), "{\"bp\":1,\"q\":%u}", free_slots);
+        ble_servo_send_response(buf);
+    }
+    return true;
+}
+
+/**
+ * @brief Queue a return to stance, dropping any motion still pending
+ */
+static void post_stance(void) {
+    ESP_LOGI(TAG, "Return to stance");
+    
+    exec_cmd_t pending;
+    while (s_exec_queue && xQueueReceive(s_exec_queue, &pending, 0) == pdTRUE) {
+        if (pending.type == EXEC_OFFSET_GAIT) {
+            offset_gait_release(pending.gait);
+        }
+    }
+    
+    exec_cmd_t cmd = { .type = EXEC_STANCE };
+    if (exec_post(&cmd)) {
+        send_ok();
+    }
+}
+
+/**
+ * @brief Start a stored timeline (executor task; reads it from NVS)
+ */
+static void run_timeline_play(uint8_t id) {
+    esp_err_t ret = motion_timeline_play(id);
+    if (ret == ESP_OK) {
+        send_ok();
+    } else if (ret == ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "Timeline %u not stored", id);
+        ble_servo_send_response("{\"err\":\"nf\"}");
+    } else {
+        ESP_LOGW(TAG, "Timeline %u failed to load: %s", id, esp_err_to_name(ret));
+        ble_servo_send_response("{\"err\":\"tl\"}");
+    }
+}
+
+/**
+ * @brief Queue playback of a stored timeline
+ */
+static void post_timeline_play(uint8_t id) {
+    exec_cmd_t cmd = { .type = EXEC_TIMELINE_PLAY, .timeline_id = id };
+    exec_post(&cmd);
+}
+
+/**
+ * @brief Hand a gait request to the gait manager (executor task; may ping servos)
+ */
+static void run_walk(gait_type_t type, gait_direction_t direction) {
+    if (gait_manager_start(type, direction)) {
+        send_ok();
+    } else {
+        ble_servo_send_response("{\"err\":\"gait\"}");
+    }
+}
+
+/**
+ * @brief Executor task: runs queued motion so the host task never waits
+ */
+static void exec_task(void* param) {
+    exec_cmd_t cmd;
+    
+    while (1) {
+        if (xQueueReceive(s_exec_queue, &cmd, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        DOG_TRACE(DOG_TRACE_EXEC, cmd.type, uxQueueMessagesWaiting(s_exec_queue));
+        
+        switch (cmd.type) {
+        case EXEC_MOVE:
+            DOG_HOT_LOGD(TAG, "Move: FR=%.0f FL=%.0f BR=%.0f BL=%.0f spd=%u dly=%u",
+                         cmd.move.fr, cmd.move.fl, cmd.move.br, cmd.move.bl,
+                         cmd.move.speed, cmd.move.delay_ms);
+            if (s_move_cb) {
+                s_move_cb(cmd.move.fr, cmd.move.fl, cmd.move.br, cmd.move.bl,
+                          cmd.move.speed, cmd.move.delay_ms);
+            }
+            if (cmd.move.delay_ms > 0) {
+                vTaskDelay(pdMS_TO_TICKS(cmd.move.delay_ms));
+            }
+            break;
+            
+        case EXEC_LEG_MOVE:
+            DOG_HOT_LOGD(TAG, "Leg move: FR=%.0f/%u/%u FL=%.0f/%u/%u BR=%.0f/%u/%u BL=%.0f/%u/%u",
+                         cmd.legs[0].angle, cmd.legs[0].speed, cmd.legs[0].delay_ms,
+                         cmd.legs[1].angle, cmd.legs[1].speed, cmd.legs[1].delay_ms,
+                         cmd.legs[2].angle, cmd.legs[2].speed, cmd.legs[2].delay_ms,
+                         cmd.legs[3].angle, cmd.legs[3].speed, cmd.legs[3].delay_ms);
+            if (s_leg_move_cb) {
+                s_leg_move_cb(cmd.legs[0], cmd.legs[1], cmd.legs[2], cmd.legs[3]);
+            }
+            break;
+            
+        case EXEC_STANCE:
+            motion_timeline_stop();
+            if (s_stance_cb) {
+                s_stance_cb();
+            }
+            break;
+            
+        case EXEC_OFFSET_GAIT:
+            run_offset_gait(cmd.gait);
+            break;
+            
+        case EXEC_TIMELINE_PLAY:
+            run_timeline_play(cmd.timeline_id);
+            break;
+            
+        case EXEC_WALK:
+            run_walk(cmd.walk.type, cmd.walk.direction);
+            break;
+        }
+        
+        // Lift backpressure once the queue has drained to the low mark
+        unsigned free_slots = exec_free();
+        if (s_backpressure && BLE_SERVO_QUEUE_LEN - free_slots <= BLE_SERVO_QUEUE_LOW) {
+            s_backpressure = false;
+            char buf[32];
+            snprintf(buf, sizeof(buf), "{\"bp\":0,\"q\":%u}", free_slots);
+            ble_servo_send_response(buf);
+        }
+    }
+}
 
 // ═══════════════════════════════════════════════════════
 // CHUNKED MESSAGE HANDLING
@@ -73,20 +579,128 @@ static void process_command(const char* cmd, size_t len);
  * Reset chunk buffer state
  */
 static void chunk_reset(void) {
-    s_chunk_len = 0;
     s_chunk_expected = 0;
     s_chunk_received = 0;
-    s_chunk_buffer[0] = '\0';
+    ble_stream_reset();
+}
+
+/**
+ * @brief Check that a chunk continues the current message
+ */
+static bool chunk_accept(uint8_t chunk_num, uint8_t total) {
+    // First chunk - reset buffer
+    if (chunk_num == 1) {
+        chunk_reset();
+        s_chunk_expected = total;
+    }
+    
+    // Validate sequence
+    if (chunk_num != s_chunk_received + 1 || total != s_chunk_expected) {
+        ESP_LOGW(TAG, "Chunk sequence error, resetting");
+        chunk_reset();
+        ble_servo_send_response("{\"err\":\"chunk_seq\"}");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Hand a chunk already written to the arena to the parser
+ * 
+ * Keyframes of streamed sequences run here, as soon as they are complete.
+ */
+static void chunk_landed(uint8_t chunk_num, size_t len) {
+    s_chunk_received = chunk_num;
+    ble_stream_commit(len);
+    
+    // Send ack for this chunk, with the room left in the motion queue
+    char ack[32];
+    snprintf(ack, sizeof(ack), "{\"ack\":%d,\"q\":%u}", chunk_num, exec_free());
+    ble_servo_send_response(ack);
+    
+    // All chunks received - finish the message
+    if (s_chunk_received == s_chunk_expected) {
+        bool streamed = false;
+        uint16_t frames = ble_stream_finish(&streamed);
+        if (streamed) {
+            ESP_LOGI(TAG, "Streamed sequence complete: %u moves", frames);
+            send_ok();
+        }
+        chunk_reset();
+    }
+}
+
+/**
+ * @brief Reject a chunk that does not fit the arena
+ */
+static void chunk_overflow(void) {
+    ESP_LOGE(TAG, "Chunk buffer overflow");
+    chunk_reset();
+    ble_servo_send_response("{\"err\":\"overflow\"}");
+}
+
+/**
+ * @brief Binary chunk: [CHUNK][num][total][data][crc16], copied from the mbuf
+ */
+static void process_chunk_mbuf(struct os_mbuf* om, uint16_t len) {
+    if (len < BLE_FRAME_CHUNK_OVERHEAD) {
+        ble_servo_send_response("{\"err\":\"len\"}");
+        return;
+    }
+    
+    uint8_t head[3];
+    uint8_t crc_le[2];
+    size_t payload_len = len - BLE_FRAME_CHUNK_OVERHEAD;
+    os_mbuf_copydata(om, 0, sizeof(head), head);
+    os_mbuf_copydata(om, len - 2, sizeof(crc_le), crc_le);
+    
+    ESP_LOGD(TAG, "Chunk %d/%d (%zu bytes)", head[1], head[2], payload_len);
+    
+    if (!chunk_accept(head[1], head[2])) {
+        return;
+    }
+    
+    uint8_t* dst = ble_stream_reserve(payload_len);
+    if (dst == NULL) {
+        chunk_overflow();
+        return;
+    }
+    os_mbuf_copydata(om, sizeof(head), payload_len, dst);
+    
+    uint16_t crc = frame_crc16(0xFFFF, head, sizeof(head));
+    crc = frame_crc16(crc, dst, payload_len);
+    if (crc != frame_u16(crc_le)) {
+        ESP_LOGW(TAG, "Chunk %d CRC mismatch, resetting", head[1]);
+        chunk_reset();
+        ble_servo_send_response("{\"err\":\"crc\"}");
+        return;
+    }
+    
+    chunk_landed(head[1], payload_len);
+}
+
+/**
+ * @brief Parse and run a reassembled non-streamed command
+ */
+static void process_document(const char* data, size_t len) {
+    ESP_LOGI(TAG, "All chunks received, total %zu bytes", len);
+    cJSON* json = ble_json_parse(data, len);
+    if (!json) {
+        ESP_LOGW(TAG, "Invalid JSON");
+        return;
+    }
+    process_command(json);
+    ble_json_delete(json);
 }
 
 /**
  * Handle incoming data - either chunked or regular
- * Chunk format: {"k":<num>,"t":<total>,"d":"<data>"}
- * When all chunks received, concatenates and processes as single command
+ * Chunk format: {"k":<num>,"t":<total>,"d":"<data>"} (JSON fallback for
+ * BLE_FRAME_OP_CHUNK; both feed the same reassembly)
  */
 static void handle_incoming_data(const char* data, size_t len) {
     // Try to parse as chunk header
-    cJSON* json = cJSON_ParseWithLength(data, len);
+    cJSON* json = ble_json_parse(data, len);
     if (!json) {
         ESP_LOGW(TAG, "Invalid JSON");
         return;
@@ -103,60 +717,54 @@ static void handle_incoming_data(const char* data, size_t len) {
         const char* payload = d->valuestring;
         size_t payload_len = strlen(payload);
         
-        ESP_LOGI(TAG, "Chunk %d/%d (%zu bytes)", chunk_num, total, payload_len);
+        ESP_LOGD(TAG, "Chunk %d/%d (%zu bytes)", chunk_num, total, payload_len);
         
-        // First chunk - reset buffer
-        if (chunk_num == 1) {
-            chunk_reset();
-            s_chunk_expected = total;
-        }
-        
-        // Validate sequence
-        if (chunk_num != s_chunk_received + 1 || total != s_chunk_expected) {
-            ESP_LOGW(TAG, "Chunk sequence error, resetting");
-            chunk_reset();
-            ble_servo_send_response("{\"err\":\"chunk_seq\"}");
-            cJSON_Delete(json);
-            return;
-        }
-        
-        // Append to buffer if there's room
-        if (s_chunk_len + payload_len < CHUNK_BUFFER_SIZE - 1) {
-            memcpy(s_chunk_buffer + s_chunk_len, payload, payload_len);
-            s_chunk_len += payload_len;
-            s_chunk_buffer[s_chunk_len] = '\0';
-            s_chunk_received = chunk_num;
-            
-            // Send ack for this chunk
-            char ack[32];
-            snprintf(ack, sizeof(ack), "{\"ack\":%d}", chunk_num);
-            ble_servo_send_response(ack);
-            
-            // All chunks received - process complete message
-            if (s_chunk_received == s_chunk_expected) {
-                ESP_LOGI(TAG, "All chunks received, total %zu bytes", s_chunk_len);
-                process_command(s_chunk_buffer, s_chunk_len);
-                chunk_reset();
+        if (chunk_accept(chunk_num, total)) {
+            uint8_t* dst = ble_stream_reserve(payload_len);
+            if (dst) {
+                memcpy(dst, payload, payload_len);
+                chunk_landed(chunk_num, payload_len);
+            } else {
+                chunk_overflow();
             }
-        } else {
-            ESP_LOGE(TAG, "Chunk buffer overflow");
-            chunk_reset();
-            ble_servo_send_response("{\"err\":\"overflow\"}");
         }
         
-        cJSON_Delete(json);
+        ble_json_delete(json);
         return;
     }
     
     // Not a chunk - process as regular command
-    cJSON_Delete(json);
-    process_command(data, len);
+    DOG_HOT_LOGD(TAG, "Cmd: %.*s", (int)len, data);
+    DOG_TRACE(DOG_TRACE_BLE_JSON, len, 0);
+    process_command(json);
+    ble_json_delete(json);
 }
 
 // ═══════════════════════════════════════════════════════
 // COMMAND PROCESSING
 // ═══════════════════════════════════════════════════════
 
+/**
+ * @brief Queue one unified move
+ */
+static void post_move(float fr, float fl, float br, float bl,
+                      uint16_t speed, uint16_t delay_ms) {
+    exec_cmd_t cmd = {
+        .type = EXEC_MOVE,
+        .move = { .fr = fr, .fl = fl, .br = br, .bl = bl, .speed = speed, .delay_ms = delay_ms },
+    };
+    exec_post(&cmd);
+}
+
+/**
+ * @brief Queue one per-leg move
+ */
+static void post_leg_move(ble_leg_move_t fr, ble_leg_move_t fl,
+                          ble_leg_move_t br, ble_leg_move_t bl) {
+    exec_cmd_t cmd = { .type = EXEC_LEG_MOVE, .legs = { fr, fl, br, bl } };
+    exec_post(&cmd);
+}
+
 static void process_move_array(cJSON* arr) {
     if (!cJSON_IsArray(arr) || cJSON_GetArraySize(arr) < 5) return;
     
@@ -170,16 +778,7 @@ static void process_move_array(cJSON* arr) {
         delay_ms = (uint16_t)cJSON_GetArrayItem(arr, 5)->valueint;
     }
     
-    ESP_LOGI(TAG, "Move: FR=%.0f FL=%.0f BR=%.0f BL=%.0f spd=%u dly=%u",
-             fr, fl, br, bl, speed, delay_ms);
-    
-    if (s_move_cb) {
-        s_move_cb(fr, fl, br, bl, speed, delay_ms);
-    }
-    
-    if (delay_ms > 0) {
-        vTaskDelay(pdMS_TO_TICKS(delay_ms));
-    }
+    post_move(fr, fl, br, bl, speed, delay_ms);
 }
 
 /**
@@ -194,48 +793,513 @@ static bool parse_leg_params(cJSON* arr, ble_leg_move_t* out) {
 }
 
 /**
- * @brief Process per-leg move array: [[fr_angle,fr_spd,fr_dly], [fl...], [br...], [bl...]]
+ * @brief Process per-leg move array: [[fr_angle,fr_spd,fr_dly], [fl...], [br...], [bl...]]
+ */
+static void process_leg_move_array(cJSON* arr) {
+    if (!cJSON_IsArray(arr) || cJSON_GetArraySize(arr) != 4) {
+        ESP_LOGW(TAG, "Per-leg move requires 4 leg arrays");
+        return;
+    }
+    
+    ble_leg_move_t fr, fl, br, bl;
+    if (!parse_leg_params(cJSON_GetArrayItem(arr, 0), &fr) ||
+        !parse_leg_params(cJSON_GetArrayItem(arr, 1), &fl) ||
+        !parse_leg_params(cJSON_GetArrayItem(arr, 2), &br) ||
+        !parse_leg_params(cJSON_GetArrayItem(arr, 3), &bl)) {
+        ESP_LOGW(TAG, "Invalid leg params format");
+        return;
+    }
+    
+    post_leg_move(fr, fl, br, bl);
+}
+
+/**
+ * @brief Foot-space move: {"f":[[x,z,spd,dly],[fl...],[br...],[bl...]]}
+ * 
+ * Solved here, so the executor and the bus only ever see hip angles.
+ * All or nothing: if any foot is out of reach, the reply is
+ * {"err":"ik"} and no leg moves.
+ */
+static void process_foot_move(cJSON* arr) {
+    if (cJSON_GetArraySize(arr) != DOG_SERVO_COUNT) {
+        ESP_LOGW(TAG, "Foot move requires 4 leg arrays");
+        return;
+    }
+    
+    ble_leg_move_t legs[DOG_SERVO_COUNT];
+    bool exact = true;
+    int i = 0;
+    cJSON* item;
+    cJSON_ArrayForEach(item, arr) {
+        if (!cJSON_IsArray(item) || cJSON_GetArraySize(item) < 4) {
+            ESP_LOGW(TAG, "Invalid foot params format");
+            return;
+        }
+        ble_foot_move_t foot = {
+            .x_mm = (float)cJSON_GetArrayItem(item, 0)->valuedouble,
+            .z_mm = (float)cJSON_GetArrayItem(item, 1)->valuedouble,
+            .speed = (uint16_t)cJSON_GetArrayItem(item, 2)->valueint,
+            .delay_ms = (uint16_t)cJSON_GetArrayItem(item, 3)->valueint,
+        };
+        legs[i].speed = foot.speed;
+        legs[i].delay_ms = foot.delay_ms;
+        exact &= dog_foot_to_angle((uint8_t)(DOG_SERVO_FR + i), foot.x_mm, foot.z_mm, &legs[i].angle);
+        i++;
+    }
+    
+    if (!exact) {
+        ble_servo_send_response("{\"err\":\"ik\"}");
+        return;
+    }
+    post_leg_move(legs[0], legs[1], legs[2], legs[3]);
+}
+
+/**
+ * @brief Switch every gait between angle and foot-space strokes
+ */
+static void process_foot_space(bool enabled) {
+    for (int t = 0; t < GAIT_TYPE_COUNT; t++) {
+        gait_config_t config;
+        gait_manager_get_config((gait_type_t)t, &config);
+        config.foot_space = enabled;
+        gait_manager_set_config((gait_type_t)t, &config);
+    }
+    ble_servo_send_response("{\"ok\":1}");
+}
+
+/**
+ * @brief Number field of a long-form command (fallback if missing)
+ */
+static double json_number(const cJSON* json, const char* key, double fallback) {
+    const cJSON* item = cJSON_GetObjectItem(json, key);
+    return cJSON_IsNumber(item) ? item->valuedouble : fallback;
+}
+
+/**
+ * @brief Long-form commands: {"cmd":"servos"|"servo"|"msg",...}
+ */
+static void process_named_command(const char* name, const cJSON* json) {
+    if (strcmp(name, "servos") == 0) {
+        ble_servo_all_command_t c = {
+            .angle_fr = (float)json_number(json, "fr", 0),
+            .angle_fl = (float)json_number(json, "fl", 0),
+            .angle_br = (float)json_number(json, "br", 0),
+            .angle_bl = (float)json_number(json, "bl", 0),
+            .speed = (uint16_t)json_number(json, "speed", 1000),
+            .delay_ms = (uint16_t)json_number(json, "delay", 0),
+        };
+        post_move(c.angle_fr, c.angle_fl, c.angle_br, c.angle_bl, c.speed, c.delay_ms);
+        return;
+    }
+    
+    if (strcmp(name, "servo") == 0) {
+        ble_servo_single_command_t c = {
+            .id = (uint8_t)json_number(json, "id", 0),
+            .angle = (float)json_number(json, "angle", 0),
+            .speed = (uint16_t)json_number(json, "speed", 1000),
+            .delay_ms = (uint16_t)json_number(json, "delay", 0),
+        };
+        if (c.id < DOG_SERVO_FR || c.id > DOG_SERVO_BL) {
+            ESP_LOGW(TAG, "Invalid servo ID %u", c.id);
+            ble_servo_send_response("{\"err\":\"id\"}");
+            return;
+        }
+        
+        // Legs with angle -1 are not part of the move
+        ble_leg_move_t legs[DOG_SERVO_COUNT];
+        for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+            legs[i] = (ble_leg_move_t){ .angle = -1 };
+        }
+        legs[c.id - 1] = (ble_leg_move_t){ .angle = c.angle, .speed = c.speed, .delay_ms = c.delay_ms };
+        post_leg_move(legs[0], legs[1], legs[2], legs[3]);
+        return;
+    }
+    
+    if (strcmp(name, "msg") == 0 || strcmp(name, "message") == 0) {
+        const cJSON* text = cJSON_GetObjectItem(json, "text");
+        if (cJSON_IsString(text)) {
+            DOG_HOT_LOGI(TAG, "Message: %s", text->valuestring);
+            if (s_message_cb) s_message_cb(text->valuestring);
+        }
+        ble_servo_send_response("{\"ok\":1}");
+        return;
+    }
+    
+    ESP_LOGW(TAG, "Unknown command '%s'", name);
+}
+
+/**
+ * @brief Report control loop and servo bus timing as compact notifications
+ * 
+ *   {"cl":[rate_hz,ticks,overruns,missed,jitter_max_us,jitter_avg_us,wcet_us,last_us]}
+ *   {"cc":[name,calls,wcet_us,last_us]}   (one per active client)
+ *   {"bus":[ticks,sync_writes,commands,coalesced,rejected,dropped]}
+ *   {"sc":[sent,suppressed,invalidated]}   (servo shadow register cache)
+ *   {"tk":[speed_level,stroke_level,reads,lag,stall,overload,overheat]}
+ *   {"ts":[id,samples,err_mean,err_max,err_last,load_max,temp_max,faults,events]}
+ *                                         (servo tracking, one per servo)
+ *   {"heap":[free,min_free,largest_block,json_parses,json_peak,json_heap_allocs]}
+ *   {"imu":[idle,idle_entries,motion_wakes,idle_ms]}   (IMU low-power idle)
+ *   {"cpu":[core0_load,core1_load]}       (0.1%, since the previous {"st":1})
+ *   {"task":[name,core,prio,load,stack_free]}   (one per task, core -1 = unpinned)
+ * 
+ * The task lines need CONFIG_DOG_TASK_STATS.
+ */
+static void process_stats(void) {
+    char buf[128];
+    
+    control_loop_stats_t cl;
+    control_loop_get_stats(&cl);
+    snprintf(buf, sizeof(buf), "{\"cl\":[%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu]}",
+             (unsigned long)cl.rate_hz, (unsigned long)cl.ticks,
+             (unsigned long)cl.overruns, (unsigned long)cl.missed,
+             (unsigned long)cl.jitter_max_us, (unsigned long)cl.jitter_avg_us,
+             (unsigned long)cl.wcet_us, (unsigned long)cl.last_exec_us);
+    ble_servo_send_response(buf);
+    
+    control_client_stats_t cc;
+    for (int i = 0; i < CONTROL_LOOP_MAX_CLIENTS; i++) {
+        if (!control_loop_get_client_stats(i, &cc) || !cc.active) continue;
+        snprintf(buf, sizeof(buf), "{\"cc\":[\"%s\",%lu,%lu,%lu]}",
+                 cc.name, (unsigned long)cc.calls,
+                 (unsigned long)cc.wcet_us, (unsigned long)cc.last_us);
+        ble_servo_send_response(buf);
+    }
+    
+    dog_bus_stats_t bus;
+    dog_bus_get_stats(&bus);
+    snprintf(buf, sizeof(buf), "{\"bus\":[%lu,%lu,%lu,%lu,%lu,%lu]}",
+             (unsigned long)bus.ticks, (unsigned long)bus.sync_writes,
+             (unsigned long)bus.commands, (unsigned long)bus.coalesced,
+             (unsigned long)bus.rejected, (unsigned long)bus.dropped);
+    ble_servo_send_response(buf);
+    
+    sts_servo_cache_stats_t sc;
+    sts_servo_cache_get_stats(&sc);
+    snprintf(buf, sizeof(buf), "{\"sc\":[%lu,%lu,%lu]}",
+             (unsigned long)sc.sent, (unsigned long)sc.suppressed,
+             (unsigned long)sc.invalidated);
+    ble_servo_send_response(buf);
+    
+    dog_tracking_stats_t tk;
+    dog_tracking_get_stats(&tk);
+    snprintf(buf, sizeof(buf), "{\"tk\":[%u,%u,%lu,%lu,%lu,%lu,%lu]}",
+             tk.speed_level, tk.amplitude_level, (unsigned long)tk.reads,
+             (unsigned long)tk.lag_events, (unsigned long)tk.stall_events,
+             (unsigned long)tk.overload_events, (unsigned long)tk.overheat_events);
+    ble_servo_send_response(buf);
+    
+    for (int i = 0; i < 4; i++) {
+        const dog_tracking_servo_stats_t* ts = &tk.servo[i];
+        snprintf(buf, sizeof(buf), "{\"ts\":[%d,%lu,%lu,%u,%u,%d,%u,%u,%u]}",
+                 i + 1, (unsigned long)ts->samples,
+                 (unsigned long)(ts->samples ? ts->error_sum / ts->samples : 0),
+                 ts->error_max, ts->error_last, ts->load_max, ts->temperature_max,
+                 ts->faults, ts->fault_events);
+        ble_servo_send_response(buf);
+    }
+    
+    ble_json_stats_t js;
+    ble_json_get_stats(&js);
+    snprintf(buf, sizeof(buf), "{\"heap\":[%u,%u,%u,%lu,%lu,%lu]}",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT),
+             (unsigned long)js.parses, (unsigned long)js.peak_bytes,
+             (unsigned long)js.heap_allocs);
+    ble_servo_send_response(buf);
+    
+    dog_imu_power_stats_t imu;
+    dog_imu_get_power_stats(&imu);
+    snprintf(buf, sizeof(buf), "{\"imu\":[%d,%lu,%lu,%lu]}",
+             imu.idle ? 1 : 0, (unsigned long)imu.idle_entries,
+             (unsigned long)imu.motion_wakes, (unsigned long)imu.idle_ms);
+    ble_servo_send_response(buf);
+    
+    // Only called from the NimBLE host task, so one buffer is enough
+    static dog_task_stats_t tasks[DOG_TASKS_MAX];
+    uint16_t core_load[2];
+    int n = dog_tasks_get_stats(tasks, DOG_TASKS_MAX, core_load);
+    if (n == 0) return;
+    
+    snprintf(buf, sizeof(buf), "{\"cpu\":[%u,%u]}", core_load[0], core_load[1]);
+    ble_servo_send_response(buf);
+    for (int i = 0; i < n; i++) {
+        const dog_task_stats_t* t = &tasks[i];
+        snprintf(buf, sizeof(buf), "{\"task\":[\"%s\",%d,%u,%u,%lu]}",
+                 t->name, t->core == DOG_TASK_CORE_ANY ? -1 : t->core, t->priority,
+                 t->load, (unsigned long)t->stack_free);
+        ble_servo_send_response(buf);
+    }
+}
+
+/**
+ * @brief Reply to a ping with the negotiated MTU (clients size writes by it)
+ */
+static void send_pong(void) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "{\"p\":1,\"mtu\":%u}", current_mtu());
+    ble_servo_send_response(buf);
+}
+
+/**
+ * @brief Start an IMU calibration (1 = gyro, 2 = gyro and level) or report it (0)
+ * 
+ * A started calibration runs for about half a second and is stored in
+ * NVS; the robot must stand still (and level for 2). The report is
+ * 
+ *   {"cal":[status,gx,gy,gz,ax,ay,az]}
+ * 
+ * with the dog_imu_cal_status_t of the last run, gyro offsets in
+ * 0.001 °/s and accel offsets in mm/s².
+ */
+static void process_calibration(int mode) {
+    if (mode == 1 || mode == 2) {
+        uint8_t flags = DOG_IMU_CAL_GYRO | DOG_IMU_CAL_STORE;
+        if (mode == 2) flags |= DOG_IMU_CAL_LEVEL;
+        ble_servo_send_response(dog_imu_cal_start(flags) ? "{\"ok\":1}" : "{\"err\":\"busy\"}");
+        return;
+    }
+    
+    qmi8658a_calibration_t cal;
+    dog_imu_cal_status_t status = dog_imu_cal_get_status(&cal);
+    long v[6];
+    for (int axis = 0; axis < 3; axis++) {
+        v[axis] = (long)(((int64_t)cal.gyro_offset[axis] * 1000) >> QMI8658A_Q16_SHIFT);
+        v[3 + axis] = (long)(((int64_t)cal.accel_offset[axis] * 1000) >> QMI8658A_Q16_SHIFT);
+    }
+    
+    char buf[96];
+    snprintf(buf, sizeof(buf), "{\"cal\":[%d,%ld,%ld,%ld,%ld,%ld,%ld]}",
+             (int)status, v[0], v[1], v[2], v[3], v[4], v[5]);
+    ble_servo_send_response(buf);
+}
+
+/**
+ * @brief Set tuning parameters as one batch
+ * 
+ *   {"pset":{"trot.step_ms":180,"trot.amp":28,"bal.kp":1.2}}
+ *   {"pset":{...},"save":1}   - Also store the whole set in NVS
+ * 
+ * Either every value is accepted and they all apply from the same control
+ * tick, or none is and the reply names the first bad one:
+ * {"err":"param","name":"..."}.
+ */
+static void process_params_set(const cJSON* values, const cJSON* save) {
+    dog_param_value_t batch[DOG_PARAMS_BATCH_MAX];
+    int count = 0;
+    
+    const cJSON* item;
+    cJSON_ArrayForEach(item, values) {
+        int id = dog_params_find(item->string);
+        if (id < 0 || !cJSON_IsNumber(item) || count == DOG_PARAMS_BATCH_MAX) {
+            // The name comes from the client; escape it (and cut it at 40 bytes)
+            const char* key = item->string ? item->string : "";
+            char name[41];
+            size_t pos = 0;
+            name[chunk_escape(key, strlen(key), &pos, name, sizeof(name) - 1)] = '\0';
+            
+            char buf[80];
+            snprintf(buf, sizeof(buf), "{\"err\":\"param\",\"name\":\"%s\"}", name);
+            ble_servo_send_response(buf);
+            return;
+        }
+        batch[count++] = (dog_param_value_t) { .id = id, .value = (float)item->valuedouble };
+    }
+    
+    int bad;
+    if (!dog_params_set(batch, count, &bad)) {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "{\"err\":\"param\",\"name\":\"%s\"}",
+                 dog_params_info(batch[bad].id)->name);
+        ble_servo_send_response(buf);
+        return;
+    }
+    
+    if (save && cJSON_IsNumber(save) && save->valueint && dog_params_save() != ESP_OK) {
+        ble_servo_send_response("{\"err\":\"nvs\"}");
+        return;
+    }
+    ble_servo_send_response("{\"ok\":1}");
+}
+
+/**
+ * @brief Report tuning parameters
+ * 
+ *   {"pget":1}                       - Every parameter
+ *   {"pget":["trot.step_ms","bal.kp"]} - Only these (unknown names are skipped)
+ * 
+ * Replies {"pget":{"name":value,...}} with the last accepted values (chunked
+ * when longer than one notification).
+ */
+static void process_params_get(const cJSON* names) {
+    static char buf[1024];      // Host task only; too big for its 4 KB stack
+    dog_params_t params;
+    dog_params_get(&params);
+    
+    size_t len = (size_t)snprintf(buf, sizeof(buf), "{\"pget\":{");
+    bool all = !cJSON_IsArray(names);
+    int n = all ? dog_params_count() : cJSON_GetArraySize(names);
+    bool first = true;
+    
+    for (int i = 0; i < n && len < sizeof(buf); i++) {
+        int id = i;
+        if (!all) {
+            const cJSON* name = cJSON_GetArrayItem(names, i);
+            id = cJSON_IsString(name) ? dog_params_find(name->valuestring) : -1;
+            if (id < 0) continue;
+        }
+        len += (size_t)snprintf(buf + len, sizeof(buf) - len, "%s\"%s\":%g", first ? "" : ",",
+                                dog_params_info(id)->name, (double)dog_params_read(&params, id));
+        first = false;
+    }
+    if (len + 3 > sizeof(buf)) {
+        ble_servo_send_response("{\"err\":\"size\"}");
+        return;
+    }
+    memcpy(buf + len, "}}", 3);
+    ble_servo_send_response(buf);
+}
+
+/**
+ * @brief Send the trace ring as {"tr":[[t_us,id,a,b],...]} notifications
+ * 
+ * Each notification holds as many events as fit the MTU; the last one is
+ * followed by {"tr_end":<events>}.
+ */
+static void process_trace_dump(void) {
+    char buf[BLE_SERVO_PREFERRED_MTU];
+    size_t limit = current_mtu() - 3;
+    if (limit > sizeof(buf)) limit = sizeof(buf);
+    
+    uint32_t cursor = dog_trace_oldest();
+    dog_trace_event_t ev;
+    unsigned total = 0;
+    size_t len = 0;
+    
+    while (dog_trace_read(&cursor, &ev, 1) == 1) {
+        char item[48];
+        int n = snprintf(item, sizeof(item), "[%lu,%u,%u,%lu]", (unsigned long)ev.t_us,
+                         ev.id, ev.a, (unsigned long)ev.b);
+        
+        // Room for the item, a comma and the closing "]}"
+        if (len > 0 && len + n + 3 > limit) {
+            memcpy(buf + len, "]}", 3);
+            ble_servo_send_response(buf);
+            len = 0;
+        }
+        if (len == 0) {
+            len = (size_t)snprintf(buf, sizeof(buf), "{\"tr\":[");
+        } else {
+            buf[len++] = ',';
+        }
+        memcpy(buf + len, item, (size_t)n);
+        len += (size_t)n;
+        total++;
+    }
+    if (len > 0) {
+        memcpy(buf + len, "]}", 3);
+        ble_servo_send_response(buf);
+    }
+    
+    snprintf(buf, sizeof(buf), "{\"tr_end\":%u}", total);
+    ble_servo_send_response(buf);
+}
+
+/**
+ * @brief Play, blend or store a motion primitive
+ * 
+ *   {"prim":"turn_right","n":3}                        - Play n cycles (default 1)
+ *   {"prim":"crawl_forward","mix":"turn_right","w":50} - Blend w% of mix in
+ *   {"prim":"turn_left","save":id}                     - Store as timeline id
+ *   {"prim":"stop"}                                    - Stop the playing clip
+ * 
+ * Playback starts at once (motion player), ahead of any queued moves.
  */
-static void process_leg_move_array(cJSON* arr) {
-    if (!cJSON_IsArray(arr) || cJSON_GetArraySize(arr) != 4) {
-        ESP_LOGW(TAG, "Per-leg move requires 4 leg arrays");
+static void process_primitive(const char* name, const cJSON* json) {
+    if (strcmp(name, "stop") == 0) {
+        motion_cancel();
+        send_ok();
         return;
     }
     
-    ble_leg_move_t fr, fl, br, bl;
-    if (!parse_leg_params(cJSON_GetArrayItem(arr, 0), &fr) ||
-        !parse_leg_params(cJSON_GetArrayItem(arr, 1), &fl) ||
-        !parse_leg_params(cJSON_GetArrayItem(arr, 2), &br) ||
-        !parse_leg_params(cJSON_GetArrayItem(arr, 3), &bl)) {
-        ESP_LOGW(TAG, "Invalid leg params format");
+    int id = motion_prim_find(name);
+    if (id < 0) {
+        ESP_LOGW(TAG, "Unknown primitive '%s'", name);
+        ble_servo_send_response("{\"err\":\"prim\"}");
+        return;
+    }
+    
+    cJSON* save = cJSON_GetObjectItem(json, "save");
+    if (save && cJSON_IsNumber(save)) {
+        motion_event_t events[MOTION_PRIM_BLEND_FRAMES * MOTION_TIMELINE_LEGS];
+        uint32_t duration_ms = 0;
+        uint16_t n = motion_prim_to_events((motion_prim_id_t)id, events,
+                                           sizeof(events) / sizeof(events[0]), &duration_ms);
+        bool ok = n > 0 && motion_timeline_upload_begin((uint8_t)save->valueint, n, 0, duration_ms) &&
+                  motion_timeline_upload_events(0, events, n) &&
+                  motion_timeline_upload_commit() == ESP_OK;
+        ble_servo_send_response(ok ? "{\"ok\":1}" : "{\"err\":\"tl\"}");
         return;
     }
     
-    ESP_LOGI(TAG, "Leg move: FR=%.0f/%u/%u FL=%.0f/%u/%u BR=%.0f/%u/%u BL=%.0f/%u/%u",
-             fr.angle, fr.speed, fr.delay_ms,
-             fl.angle, fl.speed, fl.delay_ms,
-             br.angle, br.speed, br.delay_ms,
-             bl.angle, bl.speed, bl.delay_ms);
+    cJSON* n = cJSON_GetObjectItem(json, "n");
+    uint8_t cycles = (n && cJSON_IsNumber(n) && n->valueint > 0) ? (uint8_t)n->valueint : 1;
     
-    if (s_leg_move_cb) {
-        s_leg_move_cb(fr, fl, br, bl);
+    bool ok;
+    cJSON* mix = cJSON_GetObjectItem(json, "mix");
+    if (mix && cJSON_IsString(mix)) {
+        int other = motion_prim_find(mix->valuestring);
+        cJSON* w = cJSON_GetObjectItem(json, "w");
+        float weight = (w && cJSON_IsNumber(w)) ? (float)w->valuedouble / 100.0f : 0.5f;
+        ok = other >= 0 && motion_prim_play_blend((motion_prim_id_t)id, (motion_prim_id_t)other,
+                                                  weight, cycles);
+    } else {
+        ok = motion_prim_play((motion_prim_id_t)id, cycles);
     }
+    ble_servo_send_response(ok ? "{\"ok\":1}" : "{\"err\":\"busy\"}");
 }
 
-static void process_command(const char* cmd, size_t len) {
-    ESP_LOGI(TAG, "Cmd: %.*s", (int)len, cmd);
+/**
+ * @brief Parse a gait request and queue it behind the motion already queued
+ */
+static void process_walk(const char* name, const cJSON* d) {
+    exec_cmd_t cmd = { .type = EXEC_WALK };
     
-    cJSON* json = cJSON_ParseWithLength(cmd, len);
-    if (!json) {
-        ESP_LOGW(TAG, "Invalid JSON");
+    if (strcmp(name, "stop") == 0) {
+        // Keep the gait, park at the next step boundary
+        gait_manager_state_t state;
+        gait_manager_get_state(&state);
+        cmd.walk.type = state.type;
+        cmd.walk.direction = GAIT_DIRECTION_STOP;
+    } else if (gait_manager_type_from_name(name, &cmd.walk.type)) {
+        const char* dir = (d && cJSON_IsString(d)) ? d->valuestring : "f";
+        switch (dir[0]) {
+        case 'f': cmd.walk.direction = GAIT_DIRECTION_FORWARD; break;
+        case 'b': cmd.walk.direction = GAIT_DIRECTION_BACKWARD; break;
+        case 'l': cmd.walk.direction = GAIT_DIRECTION_TURN_LEFT; break;
+        case 'r': cmd.walk.direction = GAIT_DIRECTION_TURN_RIGHT; break;
+        default:
+            ble_servo_send_response("{\"err\":\"gait\"}");
+            return;
+        }
+    } else {
+        ESP_LOGW(TAG, "Unknown gait '%s'", name);
+        ble_servo_send_response("{\"err\":\"gait\"}");
         return;
     }
     
+    exec_post(&cmd);
+}
+
+/**
+ * @brief Dispatch a parsed JSON command (the caller owns and frees json)
+ */
+static void process_command(cJSON* json) {
     // Single move: {"s":[fr,fl,br,bl,speed,delay]}
     cJSON* s = cJSON_GetObjectItem(json, "s");
     if (s && cJSON_IsArray(s)) {
         process_move_array(s);
-        cJSON_Delete(json);
         return;
     }
     
@@ -243,15 +1307,14 @@ static void process_command(const char* cmd, size_t len) {
     cJSON* m = cJSON_GetObjectItem(json, "m");
     if (m && cJSON_IsArray(m)) {
         int count = cJSON_GetArraySize(m);
-        ESP_LOGI(TAG, "Sequence: %d moves", count);
+        DOG_HOT_LOGI(TAG, "Sequence: %d moves", count);
         for (int i = 0; i < count; i++) {
             cJSON* move = cJSON_GetArrayItem(m, i);
             if (cJSON_IsArray(move)) {
                 process_move_array(move);
             }
         }
-        ble_servo_send_response("{\"ok\":1}");
-        cJSON_Delete(json);
+        send_ok();
         return;
     }
     
@@ -259,7 +1322,6 @@ static void process_command(const char* cmd, size_t len) {
     cJSON* l = cJSON_GetObjectItem(json, "l");
     if (l && cJSON_IsArray(l)) {
         process_leg_move_array(l);
-        cJSON_Delete(json);
         return;
     }
     
@@ -267,241 +1329,326 @@ static void process_command(const char* cmd, size_t len) {
     cJSON* L = cJSON_GetObjectItem(json, "L");
     if (L && cJSON_IsArray(L)) {
         int count = cJSON_GetArraySize(L);
-        ESP_LOGI(TAG, "Per-leg sequence: %d moves", count);
+        DOG_HOT_LOGI(TAG, "Per-leg sequence: %d moves", count);
         for (int i = 0; i < count; i++) {
             cJSON* legMove = cJSON_GetArrayItem(L, i);
             if (cJSON_IsArray(legMove)) {
                 process_leg_move_array(legMove);
             }
         }
-        ble_servo_send_response("{\"ok\":1}");
-        cJSON_Delete(json);
+        send_ok();
+        return;
+    }
+    
+    // Foot-space move: {"f":[[x,z,spd,dly],[fl...],[br...],[bl...]]}
+    cJSON* f = cJSON_GetObjectItem(json, "f");
+    if (f && cJSON_IsArray(f)) {
+        process_foot_move(f);
+        return;
+    }
+    
+    // Foot-space gaits: {"fs":1} straight foot stroke, {"fs":0} angle sweep
+    cJSON* fs = cJSON_GetObjectItem(json, "fs");
+    if (fs && cJSON_IsNumber(fs)) {
+        process_foot_space(fs->valueint != 0);
         return;
     }
     
     // Offset gait: {"o":{"d":[fl,br,fr,bl],"s":speed,"k":[[fr,fl,br,bl],...]}}
-    // d = start delays for each leg (in order FL, BR, FR, BL for diagonal gait)
-    // s = servo speed
-    // k = keyframes array with angles for all 4 legs
-    //
-    // Diagonal gait pairing (matching KTurtle):
-    //   Pair 1: FL + BR (front-left and back-right)
-    //   Pair 2: FR + BL (front-right and back-left)
-    // The offset determines when Pair 2 starts after Pair 1
+    // (copied into a pool slot that the executor releases)
     cJSON* o = cJSON_GetObjectItem(json, "o");
     if (o && cJSON_IsObject(o)) {
-        cJSON* delays = cJSON_GetObjectItem(o, "d");
-        cJSON* speed_val = cJSON_GetObjectItem(o, "s");
-        cJSON* keyframes = cJSON_GetObjectItem(o, "k");
-        
-        if (delays && cJSON_IsArray(delays) && cJSON_GetArraySize(delays) == 4 &&
-            speed_val && cJSON_IsNumber(speed_val) &&
-            keyframes && cJSON_IsArray(keyframes) && cJSON_GetArraySize(keyframes) > 0) {
-            
-            // Parse offsets: [FL offset, BR offset, FR offset, BL offset]
-            // These determine when each leg starts its keyframe sequence
-            int fl_delay = cJSON_GetArrayItem(delays, 0)->valueint;
-            int br_delay = cJSON_GetArrayItem(delays, 1)->valueint;
-            int fr_delay = cJSON_GetArrayItem(delays, 2)->valueint;
-            int bl_delay = cJSON_GetArrayItem(delays, 3)->valueint;
-            uint16_t speed = (uint16_t)speed_val->valueint;
-            int kf_count = cJSON_GetArraySize(keyframes);
-            
-            ESP_LOGI(TAG, "Offset gait: FL=%d BR=%d FR=%d BL=%d spd=%u kfs=%d",
-                     fl_delay, br_delay, fr_delay, bl_delay, speed, kf_count);
-            
-            // Get step duration from first keyframe (index 4 if present)
-            cJSON* first_kf = cJSON_GetArrayItem(keyframes, 0);
-            int step_duration = 100; // default 100ms per keyframe
-            if (cJSON_GetArraySize(first_kf) > 4) {
-                step_duration = cJSON_GetArrayItem(first_kf, 4)->valueint;
-            }
-            
-            // Calculate total animation length
-            int max_offset = fl_delay;
-            if (br_delay > max_offset) max_offset = br_delay;
-            if (fr_delay > max_offset) max_offset = fr_delay;
-            if (bl_delay > max_offset) max_offset = bl_delay;
-            int total_duration = max_offset + (kf_count * step_duration);
-            
-            ESP_LOGI(TAG, "Total gait duration: %d ms, step: %d ms", total_duration, step_duration);
-            
-            // Track current step index for each leg (-1 = not started yet)
-            int fl_step = -1, br_step = -1, fr_step = -1, bl_step = -1;
-            // Track elapsed time for each leg (negative = waiting to start)
-            int fl_elapsed = -fl_delay;
-            int br_elapsed = -br_delay;
-            int fr_elapsed = -fr_delay;
-            int bl_elapsed = -bl_delay;
-            // Track time within current step for each leg
-            int fl_step_time = 0, br_step_time = 0, fr_step_time = 0, bl_step_time = 0;
-            
-            int64_t start_time = esp_timer_get_time();
-            int last_tick = 0;
-            
-            // Run the gait animation
-            while (1) {
-                int64_t now = esp_timer_get_time();
-                int current_tick = (now - start_time) / 1000;  // Convert to ms
-                int delta = current_tick - last_tick;
-                
-                if (delta < 10) {  // Update every 10ms minimum
-                    vTaskDelay(pdMS_TO_TICKS(5));
-                    continue;
-                }
-                
-                last_tick = current_tick;
-                
-                // Update elapsed time for each leg
-                fl_elapsed += delta;
-                br_elapsed += delta;
-                fr_elapsed += delta;
-                bl_elapsed += delta;
-                fl_step_time += delta;
-                br_step_time += delta;
-                fr_step_time += delta;
-                bl_step_time += delta;
-                
-                // FL leg update
-                if (fl_elapsed >= 0 && fl_step < kf_count) {
-                    // Check if we need to advance to next step (or start first step)
-                    int kf_duration = step_duration;
-                    if (fl_step >= 0) {
-                        cJSON* kf = cJSON_GetArrayItem(keyframes, fl_step);
-                        if (cJSON_GetArraySize(kf) > 4) {
-                            kf_duration = cJSON_GetArrayItem(kf, 4)->valueint;
-                        }
-                    }
-                    
-                    if (fl_step < 0 || fl_step_time >= kf_duration) {
-                        fl_step++;
-                        fl_step_time = 0;
-                        
-                        if (fl_step < kf_count) {
-                            cJSON* kf = cJSON_GetArrayItem(keyframes, fl_step);
-                            float angle = (float)cJSON_GetArrayItem(kf, 1)->valuedouble;
-                            ESP_LOGI(TAG, "FL -> step %d, angle %.0f", fl_step, angle);
-                            if (s_move_cb) s_move_cb(-1, angle, -1, -1, speed, 0);
-                        }
-                    }
-                }
-                
-                // BR leg update
-                if (br_elapsed >= 0 && br_step < kf_count) {
-                    int kf_duration = step_duration;
-                    if (br_step >= 0) {
-                        cJSON* kf = cJSON_GetArrayItem(keyframes, br_step);
-                        if (cJSON_GetArraySize(kf) > 4) {
-                            kf_duration = cJSON_GetArrayItem(kf, 4)->valueint;
-                        }
-                    }
-                    
-                    if (br_step < 0 || br_step_time >= kf_duration) {
-                        br_step++;
-                        br_step_time = 0;
-                        
-                        if (br_step < kf_count) {
-                            cJSON* kf = cJSON_GetArrayItem(keyframes, br_step);
-                            float angle = (float)cJSON_GetArrayItem(kf, 2)->valuedouble;
-                            ESP_LOGI(TAG, "BR -> step %d, angle %.0f", br_step, angle);
-                            if (s_move_cb) s_move_cb(-1, -1, angle, -1, speed, 0);
-                        }
-                    }
-                }
-                
-                // FR leg update
-                if (fr_elapsed >= 0 && fr_step < kf_count) {
-                    int kf_duration = step_duration;
-                    if (fr_step >= 0) {
-                        cJSON* kf = cJSON_GetArrayItem(keyframes, fr_step);
-                        if (cJSON_GetArraySize(kf) > 4) {
-                            kf_duration = cJSON_GetArrayItem(kf, 4)->valueint;
-                        }
-                    }
-                    
-                    if (fr_step < 0 || fr_step_time >= kf_duration) {
-                        fr_step++;
-                        fr_step_time = 0;
-                        
-                        if (fr_step < kf_count) {
-                            cJSON* kf = cJSON_GetArrayItem(keyframes, fr_step);
-                            float angle = (float)cJSON_GetArrayItem(kf, 0)->valuedouble;
-                            ESP_LOGI(TAG, "FR -> step %d, angle %.0f", fr_step, angle);
-                            if (s_move_cb) s_move_cb(angle, -1, -1, -1, speed, 0);
-                        }
-                    }
-                }
-                
-                // BL leg update
-                if (bl_elapsed >= 0 && bl_step < kf_count) {
-                    int kf_duration = step_duration;
-                    if (bl_step >= 0) {
-                        cJSON* kf = cJSON_GetArrayItem(keyframes, bl_step);
-                        if (cJSON_GetArraySize(kf) > 4) {
-                            kf_duration = cJSON_GetArrayItem(kf, 4)->valueint;
-                        }
-                    }
-                    
-                    if (bl_step < 0 || bl_step_time >= kf_duration) {
-                        bl_step++;
-                        bl_step_time = 0;
-                        
-                        if (bl_step < kf_count) {
-                            cJSON* kf = cJSON_GetArrayItem(keyframes, bl_step);
-                            float angle = (float)cJSON_GetArrayItem(kf, 3)->valuedouble;
-                            ESP_LOGI(TAG, "BL -> step %d, angle %.0f", bl_step, angle);
-                            if (s_move_cb) s_move_cb(-1, -1, -1, angle, speed, 0);
-                        }
-                    }
-                }
-                
-                // Check if all legs finished
-                if (fl_step >= kf_count && br_step >= kf_count && 
-                    fr_step >= kf_count && bl_step >= kf_count) {
-                    ESP_LOGI(TAG, "Offset gait complete");
-                    break;
-                }
-                
-                // Safety timeout (30 seconds max)
-                if (current_tick > 30000) {
-                    ESP_LOGW(TAG, "Offset gait timeout");
-                    break;
-                }
-                
-                vTaskDelay(pdMS_TO_TICKS(10));
-            }
-            
-            ble_servo_send_response("{\"ok\":1}");
-        } else {
-            ESP_LOGW(TAG, "Invalid offset gait format");
-            ble_servo_send_response("{\"err\":\"offset_fmt\"}");
+        exec_cmd_t cmd = { .type = EXEC_OFFSET_GAIT };
+        cmd.gait = offset_gait_parse(o);
+        if (cmd.gait && !exec_post(&cmd)) {
+            offset_gait_release(cmd.gait);
         }
-        cJSON_Delete(json);
+        return;
+    }
+    
+    // Stored timeline: {"play":id}
+    cJSON* play = cJSON_GetObjectItem(json, "play");
+    if (play && cJSON_IsNumber(play)) {
+        post_timeline_play((uint8_t)play->valueint);
+        return;
+    }
+    
+    // Gait manager: {"g":"trot","d":"f"} (d = f|b|l|r, default f), {"g":"stop"}
+    cJSON* g = cJSON_GetObjectItem(json, "g");
+    if (g && cJSON_IsString(g)) {
+        process_walk(g->valuestring, cJSON_GetObjectItem(json, "d"));
+        return;
+    }
+    
+    // Motion primitive: {"prim":"turn_right","n":3} (see process_primitive)
+    cJSON* prim = cJSON_GetObjectItem(json, "prim");
+    if (prim && cJSON_IsString(prim)) {
+        process_primitive(prim->valuestring, json);
+        return;
+    }
+    
+    // Delete a stored timeline: {"tl_del":id}
+    cJSON* tl_del = cJSON_GetObjectItem(json, "tl_del");
+    if (tl_del && cJSON_IsNumber(tl_del)) {
+        esp_err_t ret = motion_timeline_erase((uint8_t)tl_del->valueint);
+        ble_servo_send_response(ret == ESP_OK ? "{\"ok\":1}" :
+                                ret == ESP_ERR_NOT_FOUND ? "{\"err\":\"nf\"}" : "{\"err\":\"tl\"}");
         return;
     }
     
     // Ping: {"p":1}
     cJSON* p = cJSON_GetObjectItem(json, "p");
     if (p) {
-        ble_servo_send_response("{\"p\":1}");
-        cJSON_Delete(json);
+        send_pong();
         return;
     }
     
     // Stance: {"r":1}
     cJSON* r = cJSON_GetObjectItem(json, "r");
     if (r) {
-        ESP_LOGI(TAG, "Return to stance");
-        if (s_stance_cb) {
-            s_stance_cb();
+        post_stance();
+        return;
+    }
+    
+    // Benchmark suite: {"bench":1} (report on the console)
+    cJSON* bench = cJSON_GetObjectItem(json, "bench");
+    if (bench && cJSON_IsNumber(bench)) {
+#if CONFIG_DOG_BENCHMARK
+        ble_servo_send_response(dog_bench_start() ? "{\"ok\":1}" : "{\"err\":\"busy\"}");
+#else
+        ble_servo_send_response("{\"err\":\"bench disabled\"}");
+#endif
+        return;
+    }
+    
+    // Trace dump: {"tr":1} over BLE, {"tr":2} on the console
+    cJSON* tr = cJSON_GetObjectItem(json, "tr");
+    if (tr && cJSON_IsNumber(tr)) {
+        if (tr->valueint == 2) {
+            dog_trace_dump_log();
+            ble_servo_send_response("{\"ok\":1}");
+        } else {
+            process_trace_dump();
         }
+        return;
+    }
+    
+    // Telemetry rate: {"tm":hz} (the stream runs while subscribed)
+    cJSON* tm = cJSON_GetObjectItem(json, "tm");
+    if (tm && cJSON_IsNumber(tm)) {
+        ble_telemetry_set_rate((uint16_t)tm->valueint);
         ble_servo_send_response("{\"ok\":1}");
-        cJSON_Delete(json);
+        return;
+    }
+    
+    // IMU calibration: {"cal":1} gyro, {"cal":2} gyro and level, {"cal":0} report
+    cJSON* cal = cJSON_GetObjectItem(json, "cal");
+    if (cal && cJSON_IsNumber(cal)) {
+        process_calibration(cal->valueint);
+        return;
+    }
+    
+    // Tuning parameters: {"pset":{"name":value,...},"save":1}, {"pget":1}
+    cJSON* pset = cJSON_GetObjectItem(json, "pset");
+    if (pset && cJSON_IsObject(pset)) {
+        process_params_set(pset, cJSON_GetObjectItem(json, "save"));
+        return;
+    }
+    cJSON* pget = cJSON_GetObjectItem(json, "pget");
+    if (pget) {
+        process_params_get(pget);
+        return;
+    }
+    
+    // IMU low-power idle: {"lp":1} on (default), {"lp":0} always full rate
+    cJSON* lp = cJSON_GetObjectItem(json, "lp");
+    if (lp && cJSON_IsNumber(lp)) {
+        dog_imu_set_low_power(lp->valueint != 0);
+        ble_servo_send_response("{\"ok\":1}");
+        return;
+    }
+    
+    // Timing stats: {"st":1}
+    cJSON* st = cJSON_GetObjectItem(json, "st");
+    if (st) {
+        process_stats();
+        return;
+    }
+    
+    // Long form: {"cmd":"servos",...}, {"cmd":"servo",...}, {"cmd":"msg",...}
+    cJSON* name = cJSON_GetObjectItem(json, "cmd");
+    if (name && cJSON_IsString(name)) {
+        process_named_command(name->valuestring, json);
         return;
     }
     
     ESP_LOGW(TAG, "Unknown command");
-    cJSON_Delete(json);
+}
+
+// ═══════════════════════════════════════════════════════
+// BINARY FRAMES
+// ═══════════════════════════════════════════════════════
+
+static inline float frame_angle(const uint8_t* p) {
+    return (int16_t)frame_u16(p) / (float)BLE_FRAME_ANGLE_SCALE;
+}
+
+/**
+ * @brief Decode and execute one MOVE payload
+ */
+static void frame_move(const uint8_t* p) {
+    post_move(frame_angle(p), frame_angle(p + 2), frame_angle(p + 4), frame_angle(p + 6),
+              frame_u16(p + 8), frame_u16(p + 10));
+}
+
+/**
+ * @brief Decode and execute one LEG_MOVE payload
+ */
+static void frame_leg_move(const uint8_t* p) {
+    ble_leg_move_t legs[4];
+    for (int i = 0; i < 4; i++, p += 6) {
+        legs[i].angle = frame_angle(p);
+        legs[i].speed = frame_u16(p + 2);
+        legs[i].delay_ms = frame_u16(p + 4);
+    }
+    post_leg_move(legs[0], legs[1], legs[2], legs[3]);
+}
+
+static inline uint32_t frame_u32(const uint8_t* p) {
+    return (uint32_t)frame_u16(p) | ((uint32_t)frame_u16(p + 2) << 16);
+}
+
+/**
+ * @brief Decode a TL_EVENTS payload into the timeline upload
+ */
+static bool frame_timeline_events(const uint8_t* p, size_t n) {
+    motion_event_t events[(RX_BUFFER_SIZE - BLE_FRAME_OVERHEAD) / BLE_FRAME_TL_EVENT_SIZE];
+    uint16_t first = frame_u16(p);
+    uint16_t count = (uint16_t)((n - 2) / BLE_FRAME_TL_EVENT_SIZE);
+    
+    p += 2;
+    for (uint16_t i = 0; i < count; i++, p += BLE_FRAME_TL_EVENT_SIZE) {
+        events[i].t_ms = frame_u32(p);
+        events[i].leg = p[4];
+        events[i].interp = p[5];
+        events[i].angle_x10 = (int16_t)frame_u16(p + 6);
+        events[i].speed = frame_u16(p + 8);
+    }
+    return motion_timeline_upload_events(first, events, count);
+}
+
+/**
+ * @brief Check a payload length, replying with an error if it is wrong
+ */
+static bool frame_length_ok(uint8_t op, size_t len, size_t expected) {
+    if (len == expected) {
+        return true;
+    }
+    ESP_LOGW(TAG, "Frame 0x%02x: %zu byte payload, expected %zu", op, len, expected);
+    ble_servo_send_response("{\"err\":\"len\"}");
+    return false;
+}
+
+/**
+ * @brief Validate and execute a binary frame
+ */
+static void process_frame(const uint8_t* frame, size_t len) {
+    if (len < BLE_FRAME_OVERHEAD) {
+        ble_servo_send_response("{\"err\":\"len\"}");
+        return;
+    }
+    
+    size_t body_len = len - 2;
+    if (frame_crc16(0xFFFF, frame, body_len) != frame_u16(frame + body_len)) {
+        ESP_LOGW(TAG, "Frame CRC mismatch");
+        ble_servo_send_response("{\"err\":\"crc\"}");
+        return;
+    }
+    
+    uint8_t op = frame[0];
+    const uint8_t* p = frame + 1;
+    size_t n = body_len - 1;
+    DOG_TRACE(DOG_TRACE_BLE_FRAME, op, n);
+    
+    switch (op) {
+    case BLE_FRAME_OP_MOVE:
+        if (frame_length_ok(op, n, BLE_FRAME_MOVE_SIZE)) {
+            frame_move(p);
+        }
+        break;
+        
+    case BLE_FRAME_OP_SEQUENCE:
+        if (n > 0 && frame_length_ok(op, n, 1 + (size_t)p[0] * BLE_FRAME_MOVE_SIZE)) {
+            DOG_HOT_LOGI(TAG, "Sequence: %d moves", p[0]);
+            for (int i = 0; i < p[0]; i++) {
+                frame_move(p + 1 + i * BLE_FRAME_MOVE_SIZE);
+            }
+            send_ok();
+        }
+        break;
+        
+    case BLE_FRAME_OP_LEG_MOVE:
+        if (frame_length_ok(op, n, BLE_FRAME_LEG_MOVE_SIZE)) {
+            frame_leg_move(p);
+        }
+        break;
+        
+    case BLE_FRAME_OP_LEG_SEQUENCE:
+        if (n > 0 && frame_length_ok(op, n, 1 + (size_t)p[0] * BLE_FRAME_LEG_MOVE_SIZE)) {
+            DOG_HOT_LOGI(TAG, "Per-leg sequence: %d moves", p[0]);
+            for (int i = 0; i < p[0]; i++) {
+                frame_leg_move(p + 1 + i * BLE_FRAME_LEG_MOVE_SIZE);
+            }
+            send_ok();
+        }
+        break;
+        
+    case BLE_FRAME_OP_PING:
+        send_pong();
+        break;
+        
+    case BLE_FRAME_OP_STANCE:
+        post_stance();
+        break;
+        
+    case BLE_FRAME_OP_STATS:
+        process_stats();
+        break;
+        
+    case BLE_FRAME_OP_TL_BEGIN:
+        if (frame_length_ok(op, n, 8)) {
+            bool ok = motion_timeline_upload_begin(p[0], frame_u16(p + 2), p[1], frame_u32(p + 4));
+            ble_servo_send_response(ok ? "{\"ok\":1}" : "{\"err\":\"tl\"}");
+        }
+        break;
+        
+    case BLE_FRAME_OP_TL_EVENTS:
+        if (n >= 2 && frame_length_ok(op, n, 2 + (n - 2) / BLE_FRAME_TL_EVENT_SIZE * BLE_FRAME_TL_EVENT_SIZE)) {
+            ble_servo_send_response(frame_timeline_events(p, n) ? "{\"ok\":1}" : "{\"err\":\"tl\"}");
+        }
+        break;
+        
+    case BLE_FRAME_OP_TL_COMMIT:
+        if (frame_length_ok(op, n, 0)) {
+            esp_err_t ret = motion_timeline_upload_commit();
+            if (ret != ESP_OK) {
+                ESP_LOGW(TAG, "Timeline upload rejected: %s", esp_err_to_name(ret));
+            }
+            ble_servo_send_response(ret == ESP_OK ? "{\"ok\":1}" : "{\"err\":\"tl\"}");
+        }
+        break;
+        
+    case BLE_FRAME_OP_TL_PLAY:
+        if (frame_length_ok(op, n, 1)) {
+            post_timeline_play(p[0]);
+        }
+        break;
+        
+    default:
+        ESP_LOGW(TAG, "Unknown frame opcode 0x%02x", op);
+        ble_servo_send_response("{\"err\":\"op\"}");
+        break;
+    }
 }
 
 // ═══════════════════════════════════════════════════════
@@ -511,14 +1658,30 @@ static void process_command(const char* cmd, size_t len) {
 static int chr_access_cb(uint16_t conn_handle, uint16_t attr_handle,
                          struct ble_gatt_access_ctxt *ctxt, void *arg) {
     if (ctxt->op == BLE_GATT_ACCESS_OP_WRITE_CHR) {
-        if (ctxt->om && ctxt->om->om_len > 0) {
-            char* buf = malloc(ctxt->om->om_len + 1);
-            if (buf) {
-                ble_hs_mbuf_to_flat(ctxt->om, buf, ctxt->om->om_len, NULL);
-                buf[ctxt->om->om_len] = '\0';
-                handle_incoming_data(buf, ctxt->om->om_len);
-                free(buf);
-            }
+        uint16_t len = 0;
+        uint8_t op = 0;
+        if (ctxt->om == NULL || OS_MBUF_PKTLEN(ctxt->om) == 0) {
+            return 0;
+        }
+        DOG_BENCH_BLE_RX();
+        
+        // Chunks go straight from the mbuf into the reassembly arena
+        os_mbuf_copydata(ctxt->om, 0, 1, &op);
+        if (op == BLE_FRAME_OP_CHUNK) {
+            process_chunk_mbuf(ctxt->om, OS_MBUF_PKTLEN(ctxt->om));
+            return 0;
+        }
+        
+        if (OS_MBUF_PKTLEN(ctxt->om) > RX_BUFFER_SIZE ||
+            ble_hs_mbuf_to_flat(ctxt->om, s_rx_buffer, RX_BUFFER_SIZE, &len) != 0) {
+            return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        s_rx_buffer[len] = '\0';
+        
+        if (s_rx_buffer[0] == '{') {
+            handle_incoming_data((const char*)s_rx_buffer, len);
+        } else {
+            process_frame(s_rx_buffer, len);
         }
     }
     return 0;
@@ -534,6 +1697,11 @@ static const struct ble_gatt_svc_def gatt_svcs[] = {
             .access_cb = chr_access_cb,
             .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_NOTIFY,
             .val_handle = &s_chr_handle,
+        }, {
+            .uuid = &telem_uuid.u,
+            .access_cb = chr_access_cb,
+            .flags = BLE_GATT_CHR_F_NOTIFY,
+            .val_handle = &s_telem_handle,
         }, { 0 } }
     },
     { 0 },
@@ -565,6 +1733,48 @@ static void start_advertising(void) {
     ESP_LOGI(TAG, "Advertising as '%s'", ble_svc_gap_device_name());
 }
 
+static uint16_t current_mtu(void) {
+    uint16_t mtu = s_connected ? ble_att_mtu(s_conn_handle) : 0;
+    return mtu ? mtu : BLE_ATT_MTU_DFLT;
+}
+
+/**
+ * @brief Ask the central for a fast, wide link (each request is optional)
+ */
+static void request_low_latency(uint16_t conn_handle) {
+#if BLE_SERVO_LOW_LATENCY
+    struct ble_gap_upd_params params = {
+        .itvl_min = BLE_SERVO_CONN_ITVL_MIN,
+        .itvl_max = BLE_SERVO_CONN_ITVL_MAX,
+        .latency = BLE_SERVO_CONN_LATENCY,
+        .supervision_timeout = BLE_SERVO_SUPERVISION_TMO,
+    };
+    int rc = ble_gap_update_params(conn_handle, &params);
+    if (rc != 0) {
+        ESP_LOGW(TAG, "Connection parameter request failed: %d", rc);
+    }
+    
+#if CONFIG_BT_NIMBLE_LL_CFG_FEAT_LE_2M_PHY
+    rc = ble_gap_set_prefered_le_phy(conn_handle, BLE_GAP_LE_PHY_2M_MASK,
+                                     BLE_GAP_LE_PHY_2M_MASK, 0);
+    if (rc != 0) {
+        ESP_LOGW(TAG, "2M PHY request failed: %d", rc);
+    }
+#endif
+    
+    rc = ble_hs_hci_util_set_data_len(conn_handle, BLE_SERVO_DATA_LEN_OCTETS,
+                                      BLE_SERVO_DATA_LEN_TIME_US);
+    if (rc != 0) {
+        ESP_LOGW(TAG, "Data length request failed: %d", rc);
+    }
+    
+    rc = ble_gattc_exchange_mtu(conn_handle, NULL, NULL);
+    if (rc != 0) {
+        ESP_LOGW(TAG, "MTU exchange failed: %d", rc);
+    }
+#endif
+}
+
 static int gap_event_cb(struct ble_gap_event *event, void *arg) {
     switch (event->type) {
     case BLE_GAP_EVENT_CONNECT:
@@ -572,6 +1782,7 @@ static int gap_event_cb(struct ble_gap_event *event, void *arg) {
             s_conn_handle = event->connect.conn_handle;
             s_connected = true;
             ESP_LOGI(TAG, "Connected");
+            request_low_latency(s_conn_handle);
             if (s_connect_cb) s_connect_cb(true);
         } else {
             start_advertising();
@@ -581,6 +1792,8 @@ static int gap_event_cb(struct ble_gap_event *event, void *arg) {
     case BLE_GAP_EVENT_DISCONNECT:
         s_conn_handle = BLE_HS_CONN_HANDLE_NONE;
         s_connected = false;
+        ble_telemetry_set_enabled(false);
+        ble_telemetry_set_mtu(BLE_ATT_MTU_DFLT);
         ESP_LOGI(TAG, "Disconnected");
         if (s_connect_cb) s_connect_cb(false);
         start_advertising();
@@ -589,6 +1802,35 @@ static int gap_event_cb(struct ble_gap_event *event, void *arg) {
     case BLE_GAP_EVENT_ADV_COMPLETE:
         start_advertising();
         break;
+        
+    case BLE_GAP_EVENT_CONN_UPDATE: {
+        struct ble_gap_conn_desc desc;
+        if (event->conn_update.status == 0 &&
+            ble_gap_conn_find(event->conn_update.conn_handle, &desc) == 0) {
+            ESP_LOGI(TAG, "Connection interval %u.%02u ms, latency %u",
+                     desc.conn_itvl * 125 / 100, desc.conn_itvl * 125 % 100, desc.conn_latency);
+        }
+        break;
+    }
+        
+    case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+        ESP_LOGI(TAG, "PHY tx=%u rx=%u", event->phy_updated.tx_phy, event->phy_updated.rx_phy);
+        break;
+        
+    case BLE_GAP_EVENT_SUBSCRIBE:
+        if (event->subscribe.attr_handle == s_telem_handle) {
+            ble_telemetry_set_enabled(event->subscribe.cur_notify);
+        } else if (event->subscribe.attr_handle == s_chr_handle && event->subscribe.cur_notify) {
+            char buf[16];
+            snprintf(buf, sizeof(buf), "{\"mtu\":%u}", current_mtu());
+            ble_servo_send_response(buf);
+        }
+        break;
+        
+    case BLE_GAP_EVENT_MTU:
+        ESP_LOGI(TAG, "MTU %u", event->mtu.value);
+        ble_telemetry_set_mtu(event->mtu.value);
+        break;
     }
     return 0;
 }
@@ -608,6 +1850,98 @@ static void on_reset(int reason) {
     ESP_LOGE(TAG, "BLE reset: %d", reason);
 }
 
+/**
+ * @brief Send one notification on the command characteristic
+ */
+static bool notify_flat(const void* data, size_t len) {
+    struct os_mbuf *om = ble_hs_mbuf_from_flat(data, len);
+    if (!om) return false;
+    
+    int rc = ble_gatts_notify_custom(s_conn_handle, s_chr_handle, om);
+    return rc == 0;
+}
+
+/**
+ * @brief JSON-escape msg from *pos into out until max bytes are used
+ * @return Bytes written; *pos is left at the first byte not taken
+ */
+static size_t chunk_escape(const char* msg, size_t len, size_t* pos, char* out, size_t max) {
+    size_t n = 0;
+    
+    while (*pos < len) {
+        unsigned char c = (unsigned char)msg[*pos];
+        char esc[7];
+        size_t esc_len;
+        
+        switch (c) {
+            case '"':  memcpy(esc, "\\\"", 2); esc_len = 2; break;
+            case '\\': memcpy(esc, "\\\\", 2); esc_len = 2; break;
+            case '\n': memcpy(esc, "\\n", 2); esc_len = 2; break;
+            case '\r': memcpy(esc, "\\r", 2); esc_len = 2; break;
+            case '\t': memcpy(esc, "\\t", 2); esc_len = 2; break;
+            default:
+                if (c < 0x20) {
+                    esc_len = (size_t)snprintf(esc, sizeof(esc), "\\u%04x", c);
+                } else {
+                    esc[0] = (char)c;
+                    esc_len = 1;
+                }
+                break;
+        }
+        if (n + esc_len > max) break;      // Never split an escape
+        if (out) memcpy(out + n, esc, esc_len);
+        n += esc_len;
+        (*pos)++;
+    }
+    return n;
+}
+
+/**
+ * @brief Send a long response as {"chunk":{"id","index","total","data"}} notifications
+ * 
+ * The first pass only counts chunks, so the message is never copied
+ * whole: each chunk is escaped straight into one MTU-sized stack buffer.
+ */
+static bool send_chunked(const char* msg, size_t len, size_t limit) {
+    static uint16_t s_chunk_id = 0;
+    char buf[BLE_SERVO_PREFERRED_MTU];
+    if (limit > sizeof(buf)) limit = sizeof(buf);
+    size_t data_max = limit - BLE_SERVO_CHUNK_OVERHEAD;
+    
+    unsigned total = 0;
+    for (size_t pos = 0; pos < len; total++) {
+        chunk_escape(msg, len, &pos, NULL, data_max);
+    }
+    
+    uint16_t id = ++s_chunk_id;
+    size_t pos = 0;
+    for (unsigned index = 0; index < total; index++) {
+        size_t n = (size_t)snprintf(buf, sizeof(buf),
+                                    "{\"chunk\":{\"id\":%u,\"index\":%u,\"total\":%u,\"data\":\"",
+                                    id, index, total);
+        n += chunk_escape(msg, len, &pos, buf + n, data_max);
+        memcpy(buf + n, "\"}}", 3);
+        n += 3;
+        if (!notify_flat(buf, n)) {
+            ESP_LOGW(TAG, "Chunk %u/%u of message %u not sent", index + 1, total, id);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Notify one telemetry frame on the telemetry characteristic
+ */
+static bool send_telemetry(const uint8_t* data, size_t len) {
+    if (!s_connected || s_conn_handle == BLE_HS_CONN_HANDLE_NONE) return false;
+    
+    struct os_mbuf *om = ble_hs_mbuf_from_flat(data, len);
+    if (!om) return false;
+    
+    return ble_gatts_notify_custom(s_conn_handle, s_telem_handle, om) == 0;
+}
+
 static void host_task(void *param) {
     ESP_LOGI(TAG, "NimBLE host task started");
     nimble_port_run();
@@ -629,12 +1963,32 @@ bool ble_servo_init(ble_servo_move_cb_t move_cb,
     s_stance_cb = stance_cb;
     s_connect_cb = connect_cb;
     
+    ble_json_init();
+    ble_stream_init(post_move, post_leg_move, process_document);
+    ble_telemetry_init(send_telemetry);
+    
+    if (s_exec_queue == NULL) {
+        s_exec_queue = xQueueCreateStatic(BLE_SERVO_QUEUE_LEN, sizeof(exec_cmd_t),
+                                          s_exec_queue_storage, &s_exec_queue_buf);
+        s_exec_task = xTaskCreateStaticPinnedToCore(exec_task, "ble_exec", BLE_SERVO_EXEC_STACK,
+                                                    NULL, BLE_SERVO_EXEC_PRIORITY, s_exec_stack,
+                                                    &s_exec_tcb, DOG_COMMS_CORE);
+        if (s_exec_task == NULL) {
+            ESP_LOGE(TAG, "Failed to create motion executor");
+            return false;
+        }
+    }
+    
     esp_err_t ret = nimble_port_init();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "nimble_port_init failed: %d", ret);
         return false;
     }
     
+#if BLE_SERVO_LOW_LATENCY
+    ble_att_set_preferred_mtu(BLE_SERVO_PREFERRED_MTU);
+#endif
+    
     ble_hs_cfg.reset_cb = on_reset;
     ble_hs_cfg.sync_cb = on_sync;
     
@@ -649,6 +2003,10 @@ bool ble_servo_init(ble_servo_move_cb_t move_cb,
     return true;
 }
 
+void ble_servo_set_message_cb(ble_servo_message_cb_t message_cb) {
+    s_message_cb = message_cb;
+}
+
 bool ble_servo_is_connected(void) {
     return s_connected;
 }
@@ -656,11 +2014,12 @@ bool ble_servo_is_connected(void) {
 bool ble_servo_send_response(const char* msg) {
     if (!s_connected || s_conn_handle == BLE_HS_CONN_HANDLE_NONE) return false;
     
-    struct os_mbuf *om = ble_hs_mbuf_from_flat(msg, strlen(msg));
-    if (!om) return false;
-    
-    int rc = ble_gatts_notify_custom(s_conn_handle, s_chr_handle, om);
-    return rc == 0;
+    size_t len = strlen(msg);
+    size_t limit = current_mtu() - 3;
+    if (len > limit && limit >= BLE_SERVO_CHUNK_OVERHEAD + BLE_SERVO_CHUNK_MIN_DATA) {
+        return send_chunked(msg, len, limit);
+    }
+    return notify_flat(msg, len);
 }
 
 bool ble_servo_send_state(float fr, float fl, float br, float bl) {
@@ -679,6 +2038,7 @@ bool ble_servo_init(ble_servo_move_cb_t move_cb,
     return false;
 }
 
+void ble_servo_set_message_cb(ble_servo_message_cb_t message_cb) {}
 bool ble_servo_is_connected(void) { return false; }
 bool ble_servo_send_response(const char* msg) { return false; }
 bool ble_servo_send_state(float fr, float fl, float br, float bl) { return false; }
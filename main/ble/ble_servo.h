@@ -11,8 +11,72 @@
  *   {"l":[[fr,fr_spd,fr_dly],[fl,fl_spd,fl_dly],[br,br_spd,br_dly],[bl,bl_spd,bl_dly]]}
  *        - Per-leg move with individual speed/delay per leg
  *   {"L":[<leg1>,<leg2>,...]}  - Sequence of per-leg moves
- *   {"p":1}  - Ping (returns {"p":1})
+ *   {"f":[[x,z,spd,dly],[fl...],[br...],[bl...]]}
+ *        - Per-leg move to foot positions (mm from the hip axis, x forward,
+ *          z up; see dog_kinematics.h); {"err":"ik"} and no move at all
+ *          if any foot is out of reach
+ *   {"fs":1}/{"fs":0} - Gaits sweep the feet in a straight line / sweep the angle
+ *   {"p":1}  - Ping (returns {"p":1,"mtu":n})
  *   {"r":1}  - Return to stance
+ *   {"st":1} - Timing stats (replies {"cl":[...]}, one {"cc":[...]} per
+ *              control loop client, {"bus":[...]}, {"sc":[...]},
+ *              {"tk":[...]} and one {"ts":[...]} per servo for servo
+ *              tracking, {"heap":[...]}, {"imu":[...]}, {"cpu":[...]}
+ *              and one {"task":[...]} per task; see process_stats,
+ *              dog_tracking.h and dog_tasks.h)
+ *   {"g":"trot","d":"f"} - Walk a gait (trot|walk|creep|crawl) forward,
+ *                   back, left or right (f|b|l|r); switches happen at the
+ *                   next step boundary (see gait_manager.h)
+ *   {"g":"stop"}  - Park at stance at the next step boundary
+ *   {"play":id}   - Replay a stored timeline (uploaded with TL_* frames)
+ *   {"tl_del":id} - Delete a stored timeline
+ *   {"prim":"turn_right","n":3} - Play a built-in motion primitive n times
+ *                   (crawl_forward|turn_right|turn_left|walk_forward|
+ *                   walk_backward); "mix":name,"w":0-100 blends in a
+ *                   second one, "save":id stores it as a timeline and
+ *                   {"prim":"stop"} stops it (see motion_primitives.h)
+ *   {"tm":hz}     - Telemetry sample rate (stream: see ble_telemetry.h)
+ *   {"cal":1}     - Calibrate the gyro bias (robot still), {"cal":2} also
+ *                   the accel offsets (still and level); stored in NVS.
+ *                   {"cal":0} replies {"cal":[status,offsets...]}
+ *                   (see process_calibration, dog_imu_cal.h)
+ *   {"pset":{"trot.step_ms":180,"bal.kp":1.2}} - Set tuning parameters
+ *                   as one batch, applied from the same control tick; "save":1
+ *                   also stores them in NVS. {"err":"param","name":...} if a
+ *                   name is unknown or a value out of range (nothing changes)
+ *   {"pget":1}    - Report all parameters as {"pget":{name:value,...}};
+ *                   {"pget":[names]} only those (see dog_params.h)
+ *   {"lp":1}/{"lp":0} - Let the IMU drop to its idle rate when nothing
+ *                   moves (default) / keep it at the full rate
+ *   {"tr":1}      - Dump the event trace as {"tr":[[t_us,id,a,b],...]}
+ *                   notifications and {"tr_end":n}; {"tr":2} prints it on
+ *                   the console (see dog_trace.h)
+ *   {"bench":1}   - Run the benchmark suite, report on the console
+ *                   (CONFIG_DOG_BENCHMARK, see dog_bench.h)
+ * 
+ * Commands (long form, kept for ble_robot.h clients):
+ *   {"cmd":"servos","fr":a,"fl":a,"br":a,"bl":a,"speed":s,"delay":d}
+ *        - Move all 4 servos (= "s"; speed defaults to 1000, delay to 0)
+ *   {"cmd":"servo","id":1-4,"angle":a,"speed":s,"delay":d}
+ *        - Move one servo, the others hold (= "l" with one leg)
+ *   {"cmd":"msg","text":"..."}  - Text for the message callback
+ * 
+ * Commands (binary frames, same characteristic):
+ *   [opcode][payload][crc16]  - little-endian, CRC-16/CCITT-FALSE over
+ *                               opcode + payload. JSON always starts with
+ *                               '{', which is never a valid opcode.
+ *   Angles are int16 tenths of a degree; speed and delay are uint16.
+ *   Replies are the same JSON notifications as for the JSON commands.
+ * 
+ * Responses longer than one notification (MTU - 3) are split into
+ *   {"chunk":{"id":n,"index":i,"total":t,"data":"<escaped JSON>"}}
+ * notifications; the client joins the data of index 0..t-1 and parses it.
+ * 
+ * Motion commands only queue; "ok"/"ack" mean accepted, not finished.
+ * Replies include "q" (free queue slots), {"bp":1}/{"bp":0} pause and
+ * resume the client, and {"err":"busy"} reports a dropped command.
+ * A stance command drops queued motion and stops any timeline before
+ * returning to stance.
  */
 
 #ifndef BLE_SERVO_H
@@ -31,6 +95,57 @@ extern "C" {
 
 #define BLE_SERVO_DEVICE_NAME   "MicroPupper"
 
+// Motion commands are queued by the GATT callback and run by an executor
+// task. Replies carry "q" (free slots); {"bp":1} asks the client to pause
+// at the high mark and {"bp":0} lets it resume at the low mark.
+#define BLE_SERVO_QUEUE_LEN     64      // Queued moves
+#define BLE_SERVO_QUEUE_HIGH    48      // Raise backpressure at this many queued
+#define BLE_SERVO_QUEUE_LOW     16      // Lift backpressure at this many queued
+#define BLE_SERVO_EXEC_STACK    4096
+#define BLE_SERVO_EXEC_PRIORITY 5       // Comms core, below the NimBLE host
+
+// Low-latency link: right after connecting the robot asks for a short
+// connection interval, the 2M PHY, data-length extension and a large MTU.
+// The central may refuse any of them; the MTU it settles on is reported
+// as {"mtu":n} when the client subscribes and in the ping reply.
+#define BLE_SERVO_LOW_LATENCY       1
+#define BLE_SERVO_CONN_ITVL_MIN     6       // 7.5 ms (1.25 ms units)
+#define BLE_SERVO_CONN_ITVL_MAX     12      // 15 ms
+#define BLE_SERVO_CONN_LATENCY      0       // Connection events the peripheral may skip
+#define BLE_SERVO_SUPERVISION_TMO   400     // 4 s (10 ms units)
+#define BLE_SERVO_PREFERRED_MTU     517     // Largest ATT MTU (512-byte attribute + header)
+#define BLE_SERVO_DATA_LEN_OCTETS   251     // Largest LL payload
+#define BLE_SERVO_DATA_LEN_TIME_US  2120    // Air time of 251 octets at 1M PHY
+
+// Chunked responses: worst-case {"chunk":{...,"data":""}} wrapper around
+// the escaped data, with 5-digit id, index and total
+#define BLE_SERVO_CHUNK_OVERHEAD    60
+#define BLE_SERVO_CHUNK_MIN_DATA    8       // Smaller MTUs send one truncated notification
+
+// ═══════════════════════════════════════════════════════
+// BINARY PROTOCOL
+// ═══════════════════════════════════════════════════════
+
+#define BLE_FRAME_OP_MOVE           0x01    // fr,fl,br,bl,speed,delay (= "s")
+#define BLE_FRAME_OP_SEQUENCE       0x02    // count:u8, count x MOVE payload (= "m")
+#define BLE_FRAME_OP_LEG_MOVE       0x03    // 4 x angle,speed,delay, FR FL BR BL (= "l")
+#define BLE_FRAME_OP_LEG_SEQUENCE   0x04    // count:u8, count x LEG_MOVE payload (= "L")
+#define BLE_FRAME_OP_PING           0x05    // no payload (= "p")
+#define BLE_FRAME_OP_STANCE         0x06    // no payload (= "r")
+#define BLE_FRAME_OP_STATS          0x07    // no payload (= "st")
+#define BLE_FRAME_OP_CHUNK          0x08    // num:u8 (1-based), total:u8, JSON bytes (= "k"/"t"/"d")
+#define BLE_FRAME_OP_TL_BEGIN       0x09    // id:u8, flags:u8, count:u16, duration_ms:u32
+#define BLE_FRAME_OP_TL_EVENTS      0x0A    // first:u16, n x TL event (see below)
+#define BLE_FRAME_OP_TL_COMMIT      0x0B    // no payload; sorts and stores the timeline
+#define BLE_FRAME_OP_TL_PLAY        0x0C    // id:u8 (= "play")
+
+#define BLE_FRAME_ANGLE_SCALE       10      // int16 units per degree
+#define BLE_FRAME_MOVE_SIZE         12      // Bytes per MOVE payload
+#define BLE_FRAME_LEG_MOVE_SIZE     24      // Bytes per LEG_MOVE payload
+#define BLE_FRAME_TL_EVENT_SIZE     10      // t_ms:u32, leg:u8, interp:u8, angle:i16, speed:u16
+#define BLE_FRAME_OVERHEAD          3       // Opcode + CRC
+#define BLE_FRAME_CHUNK_OVERHEAD    5       // Opcode + num + total + CRC
+
 // ═══════════════════════════════════════════════════════
 // CALLBACKS
 // ═══════════════════════════════════════════════════════
@@ -67,6 +182,38 @@ typedef struct {
 typedef void (*ble_servo_leg_move_cb_t)(ble_leg_move_t fr, ble_leg_move_t fl,
                                          ble_leg_move_t br, ble_leg_move_t bl);
 
+/**
+ * @brief Per-leg foot target ({"f"} command)
+ */
+typedef struct {
+    float x_mm;         ///< Forward of the hip axis
+    float z_mm;         ///< Above the hip axis (negative = below)
+    uint16_t speed;     ///< Servo speed (0-4095)
+    uint16_t delay_ms;  ///< Delay after moving this leg
+} ble_foot_move_t;
+
+/**
+ * @brief {"cmd":"servos"} command
+ */
+typedef struct {
+    float angle_fr;
+    float angle_fl;
+    float angle_br;
+    float angle_bl;
+    uint16_t speed;
+    uint16_t delay_ms;
+} ble_servo_all_command_t;
+
+/**
+ * @brief {"cmd":"servo"} command
+ */
+typedef struct {
+    uint8_t id;         ///< Servo ID (1-4 = FR, FL, BR, BL)
+    float angle;
+    uint16_t speed;
+    uint16_t delay_ms;
+} ble_servo_single_command_t;
+
 /**
  * @brief Callback for return to stance
  */
@@ -77,6 +224,11 @@ typedef void (*ble_servo_stance_cb_t)(void);
  */
 typedef void (*ble_servo_connect_cb_t)(bool connected);
 
+/**
+ * @brief Callback for {"cmd":"msg"} text (only valid during the call)
+ */
+typedef void (*ble_servo_message_cb_t)(const char* text);
+
 // ═══════════════════════════════════════════════════════
 // INITIALIZATION
 // ═══════════════════════════════════════════════════════
@@ -94,6 +246,13 @@ bool ble_servo_init(ble_servo_move_cb_t move_cb,
                     ble_servo_stance_cb_t stance_cb,
                     ble_servo_connect_cb_t connect_cb);
 
+/**
+ * @brief Set the callback for {"cmd":"msg"} (NULL to ignore messages)
+ * 
+ * Called from the NimBLE host task.
+ */
+void ble_servo_set_message_cb(ble_servo_message_cb_t message_cb);
+
 /**
  * @brief Check if BLE is connected
  */
@@ -105,7 +264,7 @@ bool ble_servo_is_connected(void);
 bool ble_servo_send_state(float fr, float fl, float br, float bl);
 
 /**
- * @brief Send a simple response message
+ * @brief Send a response message, chunked if it exceeds one notification
  */
 bool ble_servo_send_response(const char* msg);
 
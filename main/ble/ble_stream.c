@@ -0,0 +1,246 @@
+/**
+ * @file ble_stream.c
+ * @brief Chunked Command Reassembly Implementation
+ * 
+ * The parser only needs bracket depth: after the {"m":[ / {"L":[ prefix
+ * every depth-2 array is one keyframe, and its numbers are read in order
+ * once its closing bracket is in the arena. Numbers split across chunks
+ * are therefore never parsed half-received.
+ */
+
+#include "ble_stream.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char* TAG = "BLE_STREAM";
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+typedef enum {
+    STREAM_DETECT,          // Waiting for the command prefix
+    STREAM_MOVES,           // Inside {"m":[ ... ]}
+    STREAM_LEG_MOVES,       // Inside {"L":[ ... ]}
+    STREAM_DOCUMENT,        // Anything else: keep it whole
+    STREAM_DONE,            // Sequence closed; ignore the rest
+} stream_mode_t;
+
+static uint8_t s_arena[BLE_STREAM_ARENA_SIZE + 1];  // +1 keeps a NUL after the data
+static size_t s_len = 0;            // Bytes held
+static size_t s_scan = 0;           // Bytes already scanned
+static size_t s_elem_start = 0;     // Start of the keyframe being received
+static int s_depth = 0;             // Bracket depth at s_scan
+static stream_mode_t s_mode = STREAM_DETECT;
+static uint16_t s_frames = 0;       // Keyframes produced by this message
+
+static ble_stream_move_fn s_move_fn = NULL;
+static ble_stream_leg_move_fn s_leg_move_fn = NULL;
+static ble_stream_document_fn s_document_fn = NULL;
+
+// ═══════════════════════════════════════════════════════
+// HELPER FUNCTIONS
+// ═══════════════════════════════════════════════════════
+
+static bool is_space(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * @brief Match {"<key>":[ at the start of the arena
+ * @return Offset just past the '[', 0 if more bytes are needed, -1 if no match
+ */
+static int match_prefix(char* key_out) {
+    static const char pattern[] = "{\"?\":[";
+    size_t pos = 0;
+    
+    for (const char* p = pattern; *p; p++) {
+        while (pos < s_len && is_space(s_arena[pos])) {
+            pos++;
+        }
+        if (pos >= s_len) {
+            return 0;
+        }
+        
+        uint8_t c = s_arena[pos++];
+        if (*p == '?') {
+            *key_out = (char)c;
+        } else if (c != (uint8_t)*p) {
+            return -1;
+        }
+    }
+    return (int)pos;
+}
+
+/**
+ * @brief Read up to max numbers from a completed keyframe
+ */
+static int parse_numbers(const char* p, const char* end, float* out, int max) {
+    int n = 0;
+    
+    while (p < end && n < max) {
+        if (*p == '-' || *p == '.' || (*p >= '0' && *p <= '9')) {
+            char* next;
+            out[n++] = strtof(p, &next);
+            p = (next > p) ? next : p + 1;
+        } else {
+            p++;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Decode one keyframe spanning [start, end] and run its callback
+ */
+static void emit_frame(size_t start, size_t end) {
+    float v[12];
+    int n = parse_numbers((const char*)s_arena + start, (const char*)s_arena + end, v, 12);
+    
+    if (s_mode == STREAM_MOVES) {
+        if (n < 5) {
+            ESP_LOGW(TAG, "Keyframe %u: %d values, need 5-6", s_frames + 1, n);
+            return;
+        }
+        s_frames++;
+        if (s_move_fn) {
+            s_move_fn(v[0], v[1], v[2], v[3], (uint16_t)v[4], (n > 5) ? (uint16_t)v[5] : 0);
+        }
+    } else {
+        if (n != 12) {
+            ESP_LOGW(TAG, "Per-leg keyframe %u: %d values, need 12", s_frames + 1, n);
+            return;
+        }
+        ble_leg_move_t legs[4];
+        for (int i = 0; i < 4; i++) {
+            legs[i].angle = v[i * 3];
+            legs[i].speed = (uint16_t)v[i * 3 + 1];
+            legs[i].delay_ms = (uint16_t)v[i * 3 + 2];
+        }
+        s_frames++;
+        if (s_leg_move_fn) {
+            s_leg_move_fn(legs[0], legs[1], legs[2], legs[3]);
+        }
+    }
+}
+
+/**
+ * @brief Scan new bytes for completed keyframes
+ */
+static void scan_frames(void) {
+    while (s_scan < s_len && (s_mode == STREAM_MOVES || s_mode == STREAM_LEG_MOVES)) {
+        uint8_t c = s_arena[s_scan];
+        
+        if (c == '[') {
+            if (++s_depth == 2) {
+                s_elem_start = s_scan;
+            }
+        } else if (c == ']') {
+            if (--s_depth == 1) {
+                emit_frame(s_elem_start, s_scan);
+            } else if (s_depth == 0) {
+                s_mode = STREAM_DONE;
+            }
+        }
+        s_scan++;
+    }
+}
+
+/**
+ * @brief Drop scanned bytes, keeping only a partly received keyframe
+ */
+static void compact(void) {
+    size_t keep = (s_depth >= 2 && s_mode != STREAM_DONE) ? s_elem_start : s_scan;
+    
+    if (keep == 0) {
+        return;
+    }
+    
+    memmove(s_arena, s_arena + keep, s_len - keep);
+    s_len -= keep;
+    s_scan -= keep;
+    s_elem_start = (s_elem_start >= keep) ? s_elem_start - keep : 0;
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+void ble_stream_init(ble_stream_move_fn move_fn,
+                     ble_stream_leg_move_fn leg_move_fn,
+                     ble_stream_document_fn document_fn) {
+    s_move_fn = move_fn;
+    s_leg_move_fn = leg_move_fn;
+    s_document_fn = document_fn;
+    ble_stream_reset();
+}
+
+void ble_stream_reset(void) {
+    s_len = 0;
+    s_scan = 0;
+    s_elem_start = 0;
+    s_depth = 0;
+    s_mode = STREAM_DETECT;
+    s_frames = 0;
+}
+
+uint8_t* ble_stream_reserve(size_t len) {
+    if (len > BLE_STREAM_ARENA_SIZE - s_len) {
+        return NULL;
+    }
+    return s_arena + s_len;
+}
+
+void ble_stream_commit(size_t len) {
+    if (len > BLE_STREAM_ARENA_SIZE - s_len) {
+        return;
+    }
+    s_len += len;
+    
+    if (s_mode == STREAM_DETECT) {
+        char key = 0;
+        int start = match_prefix(&key);
+        if (start == 0) {
+            return;
+        }
+        
+        if (start > 0 && (key == 'm' || key == 'L')) {
+            s_mode = (key == 'm') ? STREAM_MOVES : STREAM_LEG_MOVES;
+            s_scan = (size_t)start;
+            s_depth = 1;
+            ESP_LOGI(TAG, "Streaming \"%c\" sequence", key);
+        } else {
+            s_mode = STREAM_DOCUMENT;
+        }
+    }
+    
+    if (s_mode == STREAM_DOCUMENT) {
+        return;
+    }
+    
+    scan_frames();
+    compact();
+}
+
+uint16_t ble_stream_finish(bool* streamed) {
+    uint16_t frames = s_frames;
+    bool was_streamed = (s_mode == STREAM_MOVES || s_mode == STREAM_LEG_MOVES ||
+                         s_mode == STREAM_DONE);
+    
+    if (s_mode == STREAM_MOVES || s_mode == STREAM_LEG_MOVES) {
+        ESP_LOGW(TAG, "Sequence ended without closing bracket (%u keyframes)", frames);
+    } else if (s_mode == STREAM_DOCUMENT || s_mode == STREAM_DETECT) {
+        s_arena[s_len] = '\0';
+        if (s_document_fn && s_len > 0) {
+            s_document_fn((const char*)s_arena, s_len);
+        }
+    }
+    
+    if (streamed) {
+        *streamed = was_streamed;
+    }
+    
+    ble_stream_reset();
+    return frames;
+}
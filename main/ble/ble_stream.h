@@ -0,0 +1,95 @@
+/**
+ * @file ble_stream.h
+ * @brief Chunked Command Reassembly with Incremental Sequence Parsing
+ * 
+ * Chunk payloads are written straight into a preallocated arena. For
+ * {"m":[...]} and {"L":[...]} commands each keyframe is parsed and handed
+ * to its callback as soon as its closing bracket arrives, and consumed
+ * bytes are dropped, so those sequences have no size ceiling and frame 1
+ * runs while later chunks are still in flight. Any other command is kept
+ * whole (up to BLE_STREAM_ARENA_SIZE) and handed over when the last chunk
+ * lands.
+ */
+
+#ifndef BLE_STREAM_H
+#define BLE_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ble_servo.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define BLE_STREAM_ARENA_SIZE   4096    // Bytes; bounds whole (non-streamed) commands only
+
+// ═══════════════════════════════════════════════════════
+// CALLBACKS
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief One keyframe of an "m" sequence
+ */
+typedef void (*ble_stream_move_fn)(float fr, float fl, float br, float bl,
+                                   uint16_t speed, uint16_t delay_ms);
+
+/**
+ * @brief One keyframe of an "L" sequence
+ */
+typedef void (*ble_stream_leg_move_fn)(ble_leg_move_t fr, ble_leg_move_t fl,
+                                       ble_leg_move_t br, ble_leg_move_t bl);
+
+/**
+ * @brief A complete non-streamed command (NUL-terminated JSON)
+ */
+typedef void (*ble_stream_document_fn)(const char* json, size_t len);
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Set the callbacks that receive parsed data
+ */
+void ble_stream_init(ble_stream_move_fn move_fn,
+                     ble_stream_leg_move_fn leg_move_fn,
+                     ble_stream_document_fn document_fn);
+
+/**
+ * @brief Drop any partial message and start over
+ */
+void ble_stream_reset(void);
+
+/**
+ * @brief Get arena space for the next chunk payload
+ * 
+ * Write the payload here, then call ble_stream_commit(). Nothing is
+ * consumed until commit, so an abandoned reservation costs nothing.
+ * 
+ * @param len Payload length
+ * @return Write pointer, or NULL if the arena cannot take len more bytes
+ */
+uint8_t* ble_stream_reserve(size_t len);
+
+/**
+ * @brief Accept the bytes written after ble_stream_reserve()
+ * 
+ * Runs the callbacks for every keyframe that is now complete.
+ * 
+ * @param len Bytes written (at most the reserved length)
+ */
+void ble_stream_commit(size_t len);
+
+/**
+ * @brief Finish the message after its last chunk
+ * 
+ * Hands a non-streamed command to the document callback.
+ * 
+ * @param streamed Set to true if the message was a streamed sequence
+ * @return Number of keyframes the message produced (streamed sequences)
+ */
+uint16_t ble_stream_finish(bool* streamed);
+
+#endif // BLE_STREAM_H
@@ -0,0 +1,261 @@
+/**
+ * @file ble_telemetry.c
+ * @brief Delta-Encoded Telemetry Stream Implementation
+ * 
+ * Values are zigzag varints, so the small sample-to-sample changes of a
+ * 50 Hz stream cost one byte per field and a notification carries several
+ * samples instead of one JSON string each.
+ */
+
+#include "ble_telemetry.h"
+#include "dog_config.h"
+#include "attitude.h"
+#include "control_loop.h"
+#include "dog_tracking.h"
+#include "dog_tasks.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char* TAG = "BLE_TELEM";
+
+#define TELEM_HEADER_SIZE   3       // version, seq, count
+#define TELEM_MAX_VARINT    5       // Bytes per zigzag-encoded int32
+#define ATT_NOTIFY_OVERHEAD 3       // Opcode + attribute handle
+
+// ═══════════════════════════════════════════════════════
+// FIELDS
+// ═══════════════════════════════════════════════════════
+
+typedef enum {
+    FIELD_T_MS = 0,
+    FIELD_VALID_MASK,
+    FIELD_SERVO_BASE,                               // 4 per servo, FR FL BR BL
+    FIELD_ROLL = FIELD_SERVO_BASE + DOG_SERVO_COUNT * 4,
+    FIELD_PITCH,
+    FIELD_ROLL_RATE,
+    FIELD_PITCH_RATE,
+    FIELD_LOOP_JITTER_AVG,
+    FIELD_LOOP_EXEC,
+    FIELD_LOOP_OVERRUNS,
+    FIELD_COUNT
+} telemetry_field_t;
+
+_Static_assert(FIELD_COUNT == BLE_TELEMETRY_FIELD_COUNT, "update BLE_TELEMETRY_FIELD_COUNT");
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static ble_telemetry_send_fn s_send_fn = NULL;
+static TaskHandle_t s_task = NULL;
+static StaticTask_t s_task_tcb;
+static StackType_t s_task_stack[BLE_TELEMETRY_TASK_STACK];
+static volatile bool s_enabled = false;
+static volatile uint16_t s_rate_hz = BLE_TELEMETRY_DEFAULT_HZ;
+static volatile uint16_t s_mtu = 23;               // ATT default until exchanged
+
+// Notification being filled (telemetry task only)
+static uint8_t s_frame[BLE_TELEMETRY_MAX_PAYLOAD];
+static size_t s_len = TELEM_HEADER_SIZE;
+static uint8_t s_count = 0;
+static uint8_t s_seq = 0;
+static int64_t s_first_us = 0;                      // Time of the frame's first sample
+static int32_t s_prev[FIELD_COUNT];                 // Last sample in the frame
+static sts_servo_telemetry_t s_servo[DOG_SERVO_COUNT];  // Held when a servo misses a read
+
+// ═══════════════════════════════════════════════════════
+// ENCODING
+// ═══════════════════════════════════════════════════════
+
+static size_t put_varint(uint8_t* p, int32_t value) {
+    uint32_t z = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    size_t n = 0;
+    
+    while (z >= 0x80) {
+        p[n++] = (uint8_t)(z | 0x80);
+        z >>= 7;
+    }
+    p[n++] = (uint8_t)z;
+    return n;
+}
+
+/**
+ * @brief Encode a sample, as deltas from s_prev unless it opens the frame
+ */
+static size_t encode_sample(const int32_t* sample, uint8_t* out) {
+    size_t n = 0;
+    for (int i = 0; i < FIELD_COUNT; i++) {
+        // Wrapping difference, so t_ms and counters roll over cleanly
+        int32_t value = (s_count == 0) ? sample[i]
+                                       : (int32_t)((uint32_t)sample[i] - (uint32_t)s_prev[i]);
+        n += put_varint(out + n, value);
+    }
+    return n;
+}
+
+static size_t payload_limit(void) {
+    size_t limit = (size_t)s_mtu - ATT_NOTIFY_OVERHEAD;
+    return (limit < BLE_TELEMETRY_MAX_PAYLOAD) ? limit : BLE_TELEMETRY_MAX_PAYLOAD;
+}
+
+static void frame_reset(void) {
+    s_len = TELEM_HEADER_SIZE;
+    s_count = 0;
+}
+
+static void frame_flush(void) {
+    if (s_count == 0) {
+        return;
+    }
+    
+    s_frame[0] = BLE_TELEMETRY_VERSION;
+    s_frame[1] = s_seq++;
+    s_frame[2] = s_count;
+    if (s_send_fn) {
+        s_send_fn(s_frame, s_len);
+    }
+    frame_reset();
+}
+
+/**
+ * @brief Add a sample, sending the frame first if it would not fit
+ */
+static void frame_append(const int32_t* sample, int64_t now_us) {
+    uint8_t encoded[FIELD_COUNT * TELEM_MAX_VARINT];
+    size_t n = encode_sample(sample, encoded);
+    
+    if (s_len + n > payload_limit() || s_count == UINT8_MAX) {
+        frame_flush();
+        n = encode_sample(sample, encoded);     // Now absolute
+        if (s_len + n > payload_limit()) {
+            static uint16_t warned_mtu = 0;
+            if (warned_mtu != s_mtu) {
+                warned_mtu = s_mtu;
+                ESP_LOGW(TAG, "Sample (%u bytes) exceeds MTU %u, dropping samples",
+                         (unsigned)n, s_mtu);
+            }
+            return;
+        }
+    }
+    
+    if (s_count == 0) {
+        s_first_us = now_us;
+    }
+    memcpy(s_frame + s_len, encoded, n);
+    s_len += n;
+    s_count++;
+    memcpy(s_prev, sample, sizeof(s_prev));
+}
+
+// ═══════════════════════════════════════════════════════
+// SAMPLING
+// ═══════════════════════════════════════════════════════
+
+static void take_sample(int32_t* sample, int64_t now_us) {
+    sts_servo_telemetry_t servo[DOG_SERVO_COUNT];
+    bool valid[DOG_SERVO_COUNT];
+    int32_t mask = 0;
+    
+    // Shares the tracking monitor's SYNC READ instead of making its own
+    int64_t read_us = dog_tracking_get_telemetry(servo, valid);
+    bool fresh = read_us != 0 && now_us - read_us < BLE_TELEMETRY_SERVO_AGE_MS * 1000LL;
+    for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+        if (fresh && valid[i]) {
+            s_servo[i] = servo[i];
+            mask |= (1 << i);
+        }
+        int32_t* s = &sample[FIELD_SERVO_BASE + i * 4];
+        s[0] = s_servo[i].position;
+        s[1] = s_servo[i].speed;
+        s[2] = s_servo[i].load;
+        s[3] = s_servo[i].temperature;
+    }
+    
+    attitude_t att;
+    attitude_get(&att);
+    
+    control_loop_stats_t loop;
+    control_loop_get_stats(&loop);
+    
+    sample[FIELD_T_MS] = (int32_t)(now_us / 1000);
+    sample[FIELD_VALID_MASK] = mask;
+    sample[FIELD_ROLL] = (int32_t)(att.roll * 100.0f);
+    sample[FIELD_PITCH] = (int32_t)(att.pitch * 100.0f);
+    sample[FIELD_ROLL_RATE] = (int32_t)(att.roll_rate * 10.0f);
+    sample[FIELD_PITCH_RATE] = (int32_t)(att.pitch_rate * 10.0f);
+    sample[FIELD_LOOP_JITTER_AVG] = (int32_t)loop.jitter_avg_us;
+    sample[FIELD_LOOP_EXEC] = (int32_t)loop.last_exec_us;
+    sample[FIELD_LOOP_OVERRUNS] = (int32_t)loop.overruns;
+}
+
+static void telemetry_task(void* param) {
+    TickType_t last_wake = xTaskGetTickCount();
+    
+    while (1) {
+        if (!s_enabled) {
+            frame_reset();
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            last_wake = xTaskGetTickCount();
+            continue;
+        }
+        
+        TickType_t period = pdMS_TO_TICKS(1000 / s_rate_hz);
+        vTaskDelayUntil(&last_wake, period > 0 ? period : 1);
+        
+        int64_t now_us = esp_timer_get_time();
+        int32_t sample[FIELD_COUNT];
+        take_sample(sample, now_us);
+        frame_append(sample, now_us);
+        
+        if (now_us - s_first_us >= BLE_TELEMETRY_FLUSH_MS * 1000LL) {
+            frame_flush();
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool ble_telemetry_init(ble_telemetry_send_fn send_fn) {
+    s_send_fn = send_fn;
+    
+    if (s_task == NULL) {
+        s_task = xTaskCreateStaticPinnedToCore(telemetry_task, "ble_telem", BLE_TELEMETRY_TASK_STACK,
+                                               NULL, BLE_TELEMETRY_TASK_PRIORITY, s_task_stack,
+                                               &s_task_tcb, DOG_COMMS_CORE);
+        if (s_task == NULL) {
+            ESP_LOGE(TAG, "Failed to create telemetry task");
+            return false;
+        }
+    }
+    return true;
+}
+
+void ble_telemetry_set_enabled(bool enabled) {
+    if (enabled == s_enabled) {
+        return;
+    }
+    
+    s_enabled = enabled;
+    ESP_LOGI(TAG, "Telemetry %s (%u Hz)", enabled ? "started" : "stopped", s_rate_hz);
+    if (enabled && s_task) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+void ble_telemetry_set_rate(uint16_t rate_hz) {
+    if (rate_hz < 1) {
+        rate_hz = 1;
+    } else if (rate_hz > BLE_TELEMETRY_MAX_HZ) {
+        rate_hz = BLE_TELEMETRY_MAX_HZ;
+    }
+    s_rate_hz = rate_hz;
+}
+
+void ble_telemetry_set_mtu(uint16_t mtu) {
+    s_mtu = mtu;
+}
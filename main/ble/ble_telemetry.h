@@ -0,0 +1,81 @@
+/**
+ * @file ble_telemetry.h
+ * @brief Delta-Encoded Telemetry Stream
+ * 
+ * While the client is subscribed to the telemetry characteristic, a task
+ * samples servo feedback, IMU attitude and control loop timing at
+ * BLE_TELEMETRY_DEFAULT_HZ and packs the samples into binary
+ * notifications that fill the negotiated MTU.
+ * 
+ * Servo feedback is the tracking monitor's latest read
+ * (dog_tracking_get_telemetry), so the stream adds no traffic to the
+ * servo bus. It updates every DOG_TRACKING_PERIOD_MS; faster streams
+ * repeat it.
+ * 
+ * Notification layout:
+ *   [version:u8][seq:u8][count:u8] then count samples of
+ *   BLE_TELEMETRY_FIELD_COUNT zigzag varints. The first sample of every
+ *   notification holds absolute values and the others hold the difference
+ *   from the sample before, so each notification decodes on its own.
+ * 
+ * Field order (see telemetry_field_t in ble_telemetry.c):
+ *   t_ms, valid_mask,
+ *   4 x (position, speed, load, temperature) for FR, FL, BR, BL,
+ *   roll, pitch (0.01°), roll_rate, pitch_rate (0.1 °/s),
+ *   loop jitter_avg_us, loop last_exec_us, loop overruns
+ */
+
+#ifndef BLE_TELEMETRY_H
+#define BLE_TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define BLE_TELEMETRY_VERSION       1
+#define BLE_TELEMETRY_DEFAULT_HZ    50
+#define BLE_TELEMETRY_MAX_HZ        100     // Control loop rate
+#define BLE_TELEMETRY_SERVO_AGE_MS  100     // Older tracking reads count as invalid
+#define BLE_TELEMETRY_FLUSH_MS      100     // Longest a sample waits for a full notification
+#define BLE_TELEMETRY_MAX_PAYLOAD   244     // Notification bytes (2M PHY / 247 MTU sized)
+#define BLE_TELEMETRY_FIELD_COUNT   25
+#define BLE_TELEMETRY_TASK_STACK    3072
+#define BLE_TELEMETRY_TASK_PRIORITY 4       // Below the motion executor (5)
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Sends one notification on the telemetry characteristic
+ */
+typedef bool (*ble_telemetry_send_fn)(const uint8_t* data, size_t len);
+
+/**
+ * @brief Create the sampling task (idle until a client subscribes)
+ * @param send_fn Notification sender
+ * @return true if the task is running
+ */
+bool ble_telemetry_init(ble_telemetry_send_fn send_fn);
+
+/**
+ * @brief Start or stop the stream (client subscribed / unsubscribed)
+ */
+void ble_telemetry_set_enabled(bool enabled);
+
+/**
+ * @brief Set the sample rate
+ * @param rate_hz 1 to BLE_TELEMETRY_MAX_HZ (clamped)
+ */
+void ble_telemetry_set_rate(uint16_t rate_hz);
+
+/**
+ * @brief Record the negotiated ATT MTU (bounds the notification size)
+ */
+void ble_telemetry_set_mtu(uint16_t mtu);
+
+#endif // BLE_TELEMETRY_H
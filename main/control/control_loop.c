@@ -0,0 +1,302 @@
+/**
+ * @file control_loop.c
+ * @brief Fixed-Rate Control Loop Runtime Implementation
+ */
+
+#include "control_loop.h"
+#include "dog_trace.h"
+#include "dog_tasks.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "CTRL_LOOP";
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    const char *name;
+    control_tick_fn_t fn;
+    void *ctx;
+    uint32_t calls;
+    uint32_t wcet_us;
+    uint32_t last_us;
+} client_t;
+
+static client_t s_clients[CONTROL_LOOP_MAX_CLIENTS];
+static SemaphoreHandle_t s_mutex = NULL;     // Guards the registry; held while ticking
+static StaticSemaphore_t s_mutex_buf;
+
+static TaskHandle_t s_task_handle = NULL;
+static StaticTask_t s_task_tcb;
+static StackType_t s_task_stack[CONTROL_LOOP_TASK_STACK];
+static esp_timer_handle_t s_timer = NULL;
+static portMUX_TYPE s_tick_done_lock = portMUX_INITIALIZER_UNLOCKED;
+static control_tick_fn_t s_tick_done = NULL;    // Run after the clients of every tick (s_tick_done_lock)
+static void *s_tick_done_ctx = NULL;
+static uint32_t s_rate_hz = 0;
+static uint32_t s_period_us = 0;
+static int64_t s_start_us = 0;           // Timer start; tick N is ideally at start + N * period
+
+static control_loop_stats_t s_stats;
+static uint64_t s_jitter_sum_us = 0;
+
+// ═══════════════════════════════════════════════════════
+// TIMER AND TASK
+// ═══════════════════════════════════════════════════════
+
+static void timer_cb(void *arg)
+{
+    // Runs in the esp_timer task; just wake the control task
+    xTaskNotifyGive(s_task_handle);
+}
+
+static void run_clients(int64_t tick_us)
+{
+    xSemaphoreTakeRecursive(s_mutex, portMAX_DELAY);
+    
+    for (int i = 0; i < CONTROL_LOOP_MAX_CLIENTS; i++) {
+        client_t *c = &s_clients[i];
+        if (c->fn == NULL) {
+            continue;
+        }
+        
+        int64_t t0 = esp_timer_get_time();
+        c->fn(c->ctx, tick_us);
+        uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+        
+        c->calls++;
+        c->last_us = dt;
+        if (dt > c->wcet_us) {
+            c->wcet_us = dt;
+        }
+    }
+    
+    xSemaphoreGiveRecursive(s_mutex);
+}
+
+static void control_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Control loop running at %lu Hz", (unsigned long)s_rate_hz);
+    
+    uint64_t tick_index = 0;
+    
+    while (1) {
+        uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        int64_t wake_us = esp_timer_get_time();
+        
+        // More than one notification means periods elapsed while we were busy
+        if (pending > 1) {
+            s_stats.missed += pending - 1;
+        }
+        tick_index += pending;
+        
+        int64_t ideal_us = s_start_us + (int64_t)tick_index * s_period_us;
+        int64_t deviation = wake_us - ideal_us;
+        uint32_t jitter = (uint32_t)(deviation < 0 ? -deviation : deviation);
+        
+        run_clients(ideal_us);
+        
+        // Callback and context as one pair (set from any task)
+        portENTER_CRITICAL(&s_tick_done_lock);
+        control_tick_fn_t done = s_tick_done;
+        void *done_ctx = s_tick_done_ctx;
+        portEXIT_CRITICAL(&s_tick_done_lock);
+        if (done != NULL) {
+            done(done_ctx, ideal_us);
+        }
+        
+        uint32_t exec_us = (uint32_t)(esp_timer_get_time() - wake_us);
+        
+        s_stats.ticks++;
+        s_stats.last_exec_us = exec_us;
+        if (exec_us > s_stats.wcet_us) {
+            s_stats.wcet_us = exec_us;
+        }
+        if (exec_us > s_period_us) {
+            s_stats.overruns++;
+            DOG_TRACE(DOG_TRACE_LOOP_OVERRUN, 0, exec_us);
+        }
+        if (jitter > s_stats.jitter_max_us) {
+            s_stats.jitter_max_us = jitter;
+        }
+        s_jitter_sum_us += jitter;
+        s_stats.jitter_avg_us = (uint32_t)(s_jitter_sum_us / s_stats.ticks);
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool control_loop_start(uint32_t rate_hz)
+{
+    if (s_task_handle != NULL) {
+        return true;
+    }
+    
+    if (rate_hz == 0) {
+        rate_hz = CONTROL_LOOP_DEFAULT_HZ;
+    }
+    if (rate_hz > CONTROL_LOOP_MAX_HZ) {
+        ESP_LOGW(TAG, "Rate %lu Hz too high, clamping to %d Hz",
+                 (unsigned long)rate_hz, CONTROL_LOOP_MAX_HZ);
+        rate_hz = CONTROL_LOOP_MAX_HZ;
+    }
+    
+    if (s_mutex == NULL) {
+        s_mutex = xSemaphoreCreateRecursiveMutexStatic(&s_mutex_buf);
+        if (s_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create mutex");
+            return false;
+        }
+    }
+    
+    s_rate_hz = rate_hz;
+    s_period_us = 1000000UL / rate_hz;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_jitter_sum_us = 0;
+    
+    s_task_handle = xTaskCreateStaticPinnedToCore(control_task, "control_loop", CONTROL_LOOP_TASK_STACK,
+                                                  NULL, CONTROL_LOOP_TASK_PRIORITY, s_task_stack,
+                                                  &s_task_tcb, DOG_CONTROL_CORE);
+    if (s_task_handle == NULL) {
+        ESP_LOGE(TAG, "Failed to create control task");
+        return false;
+    }
+    
+    const esp_timer_create_args_t timer_args = {
+        .callback = timer_cb,
+        .name = "control_loop",
+    };
+    
+    esp_err_t err = esp_timer_create(&timer_args, &s_timer);
+    if (err == ESP_OK) {
+        s_start_us = esp_timer_get_time();
+        err = esp_timer_start_periodic(s_timer, s_period_us);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start control timer: %s", esp_err_to_name(err));
+        vTaskDelete(s_task_handle);
+        s_task_handle = NULL;
+        return false;
+    }
+    
+    return true;
+}
+
+bool control_loop_is_running(void)
+{
+    return s_task_handle != NULL;
+}
+
+uint32_t control_loop_get_rate_hz(void)
+{
+    return s_rate_hz;
+}
+
+int control_loop_register(const char *name, control_tick_fn_t fn, void *ctx)
+{
+    if (fn == NULL) {
+        return -1;
+    }
+    
+    if (!control_loop_start(0)) {
+        return -1;
+    }
+    
+    int handle = -1;
+    
+    xSemaphoreTakeRecursive(s_mutex, portMAX_DELAY);
+    for (int i = 0; i < CONTROL_LOOP_MAX_CLIENTS; i++) {
+        if (s_clients[i].fn == NULL) {
+            s_clients[i] = (client_t) {
+                .name = name,
+                .fn = fn,
+                .ctx = ctx,
+            };
+            handle = i;
+            break;
+        }
+    }
+    xSemaphoreGiveRecursive(s_mutex);
+    
+    if (handle < 0) {
+        ESP_LOGE(TAG, "No free client slot for '%s'", name);
+    } else {
+        ESP_LOGI(TAG, "Client '%s' registered (slot %d)", name, handle);
+    }
+    
+    return handle;
+}
+
+void control_loop_unregister(int handle)
+{
+    if (handle < 0 || handle >= CONTROL_LOOP_MAX_CLIENTS || s_mutex == NULL) {
+        return;
+    }
+    
+    // Taking the mutex waits out a tick in progress
+    xSemaphoreTakeRecursive(s_mutex, portMAX_DELAY);
+    s_clients[handle].fn = NULL;
+    s_clients[handle].ctx = NULL;
+    xSemaphoreGiveRecursive(s_mutex);
+}
+
+void control_loop_set_tick_done(control_tick_fn_t fn, void *ctx)
+{
+    portENTER_CRITICAL(&s_tick_done_lock);
+    s_tick_done = fn;
+    s_tick_done_ctx = ctx;
+    portEXIT_CRITICAL(&s_tick_done_lock);
+}
+
+void control_loop_get_stats(control_loop_stats_t *stats)
+{
+    if (stats != NULL) {
+        *stats = s_stats;
+        stats->rate_hz = s_rate_hz;
+        stats->period_us = s_period_us;
+    }
+}
+
+bool control_loop_get_client_stats(int index, control_client_stats_t *stats)
+{
+    if (index < 0 || index >= CONTROL_LOOP_MAX_CLIENTS || stats == NULL) {
+        return false;
+    }
+    
+    const client_t *c = &s_clients[index];
+    if (c->name == NULL) {
+        return false;
+    }
+    
+    stats->name = c->name;
+    stats->active = (c->fn != NULL);
+    stats->calls = c->calls;
+    stats->wcet_us = c->wcet_us;
+    stats->last_us = c->last_us;
+    return true;
+}
+
+void control_loop_reset_stats(void)
+{
+    if (s_mutex == NULL) {
+        return;
+    }
+    
+    xSemaphoreTakeRecursive(s_mutex, portMAX_DELAY);
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_jitter_sum_us = 0;
+    for (int i = 0; i < CONTROL_LOOP_MAX_CLIENTS; i++) {
+        s_clients[i].calls = 0;
+        s_clients[i].wcet_us = 0;
+        s_clients[i].last_us = 0;
+    }
+    xSemaphoreGiveRecursive(s_mutex);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file control_loop.h
+ * @brief Fixed-Rate Control Loop Runtime
+ * 
+ * One high-priority task ticked by a periodic esp_timer. Registered clients
+ * (gaits, players, filters) are called back every tick with the ideal tick
+ * timestamp, so their timing does not drift with how long the previous
+ * tick or the servo bus took.
+ * 
+ * The FreeRTOS tick is 10 ms (CONFIG_FREERTOS_HZ=100), so vTaskDelay and
+ * vTaskDelayUntil cannot pace anything faster than 100 Hz or measure
+ * jitter below a tick; the hardware timer can.
+ * 
+ * Per tick the runtime records jitter (wake-up vs ideal time), execution
+ * time and worst case execution time (WCET), overruns (execution longer
+ * than the period) and missed ticks (timer fired while still busy).
+ */
+
+#ifndef CONTROL_LOOP_H
+#define CONTROL_LOOP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define CONTROL_LOOP_DEFAULT_HZ         100
+#define CONTROL_LOOP_MAX_HZ             1000
+#define CONTROL_LOOP_MAX_CLIENTS        8
+
+#define CONTROL_LOOP_TASK_STACK         4096
+#define CONTROL_LOOP_TASK_PRIORITY      7       // Above bus scheduler (6) and gait/IMU tasks (5)
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Client tick callback
+ * @param ctx User context given at registration
+ * @param tick_us Ideal timestamp of this tick (esp_timer time base, µs)
+ */
+typedef void (*control_tick_fn_t)(void *ctx, int64_t tick_us);
+
+typedef struct {
+    uint32_t rate_hz;
+    uint32_t period_us;
+    uint32_t ticks;             // Ticks executed
+    uint32_t overruns;          // Ticks whose execution exceeded the period
+    uint32_t missed;            // Timer periods skipped while a tick was still running
+    uint32_t jitter_max_us;     // Worst wake-up deviation from the ideal tick time
+    uint32_t jitter_avg_us;     // Running average wake-up deviation
+    uint32_t wcet_us;           // Worst case execution time of a whole tick
+    uint32_t last_exec_us;      // Execution time of the last tick
+} control_loop_stats_t;
+
+typedef struct {
+    const char *name;
+    bool active;
+    uint32_t calls;
+    uint32_t wcet_us;           // Worst case execution time of this client
+    uint32_t last_us;           // Execution time of the last call
+} control_client_stats_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Start the control loop (idempotent)
+ * @param rate_hz Tick rate, 1..CONTROL_LOOP_MAX_HZ (0 = default)
+ * @return true if running
+ */
+bool control_loop_start(uint32_t rate_hz);
+
+/**
+ * @brief Check if the control loop is running
+ */
+bool control_loop_is_running(void);
+
+/**
+ * @brief Current tick rate in Hz
+ */
+uint32_t control_loop_get_rate_hz(void);
+
+/**
+ * @brief Register a tick callback (starts the loop at the default rate if needed)
+ * @param name Short client name, must stay valid (used in stats)
+ * @param fn Callback run on every tick
+ * @param ctx User context passed to @p fn
+ * @return Client handle (>= 0), or -1 if the registry is full
+ */
+int control_loop_register(const char *name, control_tick_fn_t fn, void *ctx);
+
+/**
+ * @brief Remove a client
+ * 
+ * Returns after any tick currently running has finished, so the client's
+ * state can be touched safely afterwards.
+ */
+void control_loop_unregister(int handle);
+
+/**
+ * @brief Set a callback run after the last client of every tick (NULL to clear)
+ * 
+ * For work that must see everything the clients produced in a tick, such
+ * as waking the bus scheduler to send it. Runs in the control task and
+ * counts towards the tick's execution time, so keep it short.
+ */
+void control_loop_set_tick_done(control_tick_fn_t fn, void *ctx);
+
+/**
+ * @brief Get loop-wide timing stats
+ */
+void control_loop_get_stats(control_loop_stats_t *stats);
+
+/**
+ * @brief Get per-client stats
+ * @param index Registry slot (0..CONTROL_LOOP_MAX_CLIENTS-1)
+ * @param stats Output
+ * @return false if the slot has never been used
+ */
+bool control_loop_get_client_stats(int index, control_client_stats_t *stats);
+
+/**
+ * @brief Clear all counters and worst-case values
+ */
+void control_loop_reset_stats(void);
+
+#endif // CONTROL_LOOP_H
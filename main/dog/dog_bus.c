@@ -0,0 +1,367 @@
+/**
+ * @file dog_bus.c
+ * @brief Servo Bus Scheduler Implementation
+ * 
+ * The command queue is a bounded multi-producer / single-consumer ring
+ * (per-slot sequence numbers, producers reserve a slot with one CAS).
+ * Producers never take a lock, so a BLE callback cannot stall the balance
+ * loop and vice versa.
+ */
+
+#include "dog_bus.h"
+#include "dog_config.h"
+#include "dog_trace.h"
+#include "dog_bench.h"
+#include "dog_tasks.h"
+#include "control_loop.h"
+#include "sts3032_driver.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "DOG_BUS";
+
+#define QUEUE_MASK  (DOG_BUS_QUEUE_LEN - 1)
+
+_Static_assert((DOG_BUS_QUEUE_LEN & QUEUE_MASK) == 0, "DOG_BUS_QUEUE_LEN must be a power of two");
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef enum {
+    BUS_CMD_GOAL = 0,
+    BUS_CMD_RELEASE,
+} bus_cmd_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t prio;
+    uint8_t mask;
+    uint16_t positions[DOG_BUS_SERVO_COUNT];
+    uint16_t speeds[DOG_BUS_SERVO_COUNT];
+} bus_cmd_t;
+
+typedef struct {
+    atomic_uint seq;
+    bus_cmd_t cmd;
+} bus_slot_t;
+
+/**
+ * @brief Latest accepted goal and ownership of one servo
+ */
+typedef struct {
+    bool pending;               // Goal not yet sent
+    uint16_t position;
+    uint16_t speed;
+    uint8_t owner;              // Priority of the last accepted writer
+    TickType_t claim_until;     // Owner protection expiry
+} servo_goal_t;
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static bus_slot_t s_ring[DOG_BUS_QUEUE_LEN];
+static atomic_uint s_enqueue_pos;
+static unsigned s_dequeue_pos;          // Only touched by the bus task
+
+static servo_goal_t s_goals[DOG_BUS_SERVO_COUNT];
+static TaskHandle_t s_task_handle = NULL;
+static StaticTask_t s_task_tcb;
+static StackType_t s_task_stack[DOG_BUS_TASK_STACK];
+
+static dog_bus_stats_t s_stats;
+static atomic_uint s_dropped;
+static atomic_uint s_sent[DOG_BUS_SERVO_COUNT];     // Last goal on the wire | SENT_VALID
+
+#define SENT_VALID  (1u << 16)
+
+static const uint8_t s_servo_ids[DOG_BUS_SERVO_COUNT] = {
+    DOG_SERVO_FR, DOG_SERVO_FL, DOG_SERVO_BR, DOG_SERVO_BL
+};
+
+// ═══════════════════════════════════════════════════════
+// LOCK-FREE QUEUE
+// ═══════════════════════════════════════════════════════
+
+static void queue_init(void)
+{
+    for (unsigned i = 0; i < DOG_BUS_QUEUE_LEN; i++) {
+        atomic_init(&s_ring[i].seq, i);
+    }
+    atomic_init(&s_enqueue_pos, 0);
+    atomic_init(&s_dropped, 0);
+    s_dequeue_pos = 0;
+}
+
+static bool queue_push(const bus_cmd_t *cmd)
+{
+    unsigned pos = atomic_load_explicit(&s_enqueue_pos, memory_order_relaxed);
+    bus_slot_t *slot;
+    
+    while (1) {
+        slot = &s_ring[pos & QUEUE_MASK];
+        unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+        
+        if (diff == 0) {
+            // Slot free for this position; try to reserve it
+            if (atomic_compare_exchange_weak_explicit(&s_enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // Full
+        } else {
+            pos = atomic_load_explicit(&s_enqueue_pos, memory_order_relaxed);
+        }
+    }
+    
+    slot->cmd = *cmd;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+static bool queue_pop(bus_cmd_t *cmd)
+{
+    bus_slot_t *slot = &s_ring[s_dequeue_pos & QUEUE_MASK];
+    unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    
+    if ((int)(seq - (s_dequeue_pos + 1)) < 0) {
+        return false;  // Empty
+    }
+    
+    *cmd = slot->cmd;
+    atomic_store_explicit(&slot->seq, s_dequeue_pos + DOG_BUS_QUEUE_LEN, memory_order_release);
+    s_dequeue_pos++;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════
+// SCHEDULING
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Merge one command into the per-servo goal slots
+ */
+static void apply_command(const bus_cmd_t *cmd, TickType_t now)
+{
+    if (cmd->type == BUS_CMD_RELEASE) {
+        for (int i = 0; i < DOG_BUS_SERVO_COUNT; i++) {
+            if (s_goals[i].owner == cmd->prio) {
+                s_goals[i].claim_until = now;
+            }
+        }
+        return;
+    }
+    
+    for (int i = 0; i < DOG_BUS_SERVO_COUNT; i++) {
+        if (!(cmd->mask & (1u << i))) {
+            continue;
+        }
+        
+        servo_goal_t *goal = &s_goals[i];
+        bool claim_active = (int32_t)(goal->claim_until - now) > 0;
+        
+        if (claim_active && cmd->prio < goal->owner) {
+            s_stats.rejected++;
+            continue;
+        }
+        
+        if (goal->pending) {
+            s_stats.coalesced++;
+        }
+        
+        goal->pending = true;
+        goal->position = cmd->positions[i];
+        goal->speed = cmd->speeds[i];
+        goal->owner = cmd->prio;
+        goal->claim_until = now + pdMS_TO_TICKS(DOG_BUS_CLAIM_MS);
+    }
+}
+
+/**
+ * @brief Send every pending goal in one SYNC WRITE
+ */
+static void flush_goals(void)
+{
+    uint8_t ids[DOG_BUS_SERVO_COUNT];
+    uint16_t positions[DOG_BUS_SERVO_COUNT];
+    uint16_t speeds[DOG_BUS_SERVO_COUNT];
+    uint16_t mask = 0;
+    int count = 0;
+    
+    for (int i = 0; i < DOG_BUS_SERVO_COUNT; i++) {
+        if (s_goals[i].pending) {
+            ids[count] = s_servo_ids[i];
+            positions[count] = s_goals[i].position;
+            speeds[count] = s_goals[i].speed;
+            s_goals[i].pending = false;
+            atomic_store_explicit(&s_sent[i], s_goals[i].position | SENT_VALID, memory_order_relaxed);
+            mask |= 1u << i;
+            count++;
+        }
+    }
+    
+    if (count > 0) {
+        sts_servo_sync_set_positions(ids, positions, speeds, count);
+        s_stats.sync_writes++;
+        DOG_TRACE(DOG_TRACE_BUS_WRITE, mask, positions[0]);
+        DOG_BENCH_BUS_WRITE();
+    }
+}
+
+/**
+ * @brief Control loop: every client of the tick has run, send what they queued
+ */
+static void tick_done(void *ctx, int64_t tick_us)
+{
+    xTaskNotifyGive(s_task_handle);
+}
+
+static void bus_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Bus task started (flushes at the end of each control tick)");
+    
+    TickType_t idle_period = pdMS_TO_TICKS(DOG_BUS_IDLE_FLUSH_MS);
+    if (idle_period == 0) {
+        idle_period = 1;
+    }
+    
+    while (1) {
+        // Only time out while no control tick will wake us
+        ulTaskNotifyTake(pdTRUE, control_loop_is_running() ? portMAX_DELAY : idle_period);
+        
+        TickType_t now = xTaskGetTickCount();
+        bus_cmd_t cmd;
+        bool work = false;
+        
+        while (queue_pop(&cmd)) {
+            apply_command(&cmd, now);
+            s_stats.commands++;
+            work = true;
+        }
+        
+        if (work) {
+            s_stats.ticks++;
+            flush_goals();
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool dog_bus_start(void)
+{
+    if (s_task_handle != NULL) {
+        return true;
+    }
+    
+    queue_init();
+    memset(s_goals, 0, sizeof(s_goals));
+    memset(&s_stats, 0, sizeof(s_stats));
+    
+    s_task_handle = xTaskCreateStaticPinnedToCore(bus_task, "dog_bus", DOG_BUS_TASK_STACK, NULL,
+                                                  DOG_BUS_TASK_PRIORITY, s_task_stack, &s_task_tcb,
+                                                  DOG_CONTROL_CORE);
+    if (s_task_handle == NULL) {
+        ESP_LOGE(TAG, "Failed to create bus task");
+        return false;
+    }
+    control_loop_set_tick_done(tick_done, NULL);
+    
+    return true;
+}
+
+bool dog_bus_is_running(void)
+{
+    return s_task_handle != NULL;
+}
+
+bool dog_bus_submit(uint8_t mask, const uint16_t *positions,
+                    const uint16_t *speeds, dog_bus_prio_t prio)
+{
+    if (mask == 0 || positions == NULL || speeds == NULL) {
+        return true;
+    }
+    
+    if (s_task_handle == NULL) {
+        // No scheduler yet (early init): write directly
+        uint8_t ids[DOG_BUS_SERVO_COUNT];
+        uint16_t pos[DOG_BUS_SERVO_COUNT];
+        uint16_t spd[DOG_BUS_SERVO_COUNT];
+        int count = 0;
+        
+        for (int i = 0; i < DOG_BUS_SERVO_COUNT; i++) {
+            if (mask & (1u << i)) {
+                ids[count] = s_servo_ids[i];
+                pos[count] = positions[i];
+                spd[count] = speeds[i];
+                atomic_store_explicit(&s_sent[i], positions[i] | SENT_VALID, memory_order_relaxed);
+                count++;
+            }
+        }
+        sts_servo_sync_set_positions(ids, pos, spd, count);
+        return true;
+    }
+    
+    bus_cmd_t cmd = {
+        .type = BUS_CMD_GOAL,
+        .prio = prio,
+        .mask = mask,
+    };
+    memcpy(cmd.positions, positions, sizeof(cmd.positions));
+    memcpy(cmd.speeds, speeds, sizeof(cmd.speeds));
+    
+    if (!queue_push(&cmd)) {
+        atomic_fetch_add_explicit(&s_dropped, 1, memory_order_relaxed);
+        ESP_LOGW(TAG, "Command queue full, dropping goal (prio %d)", prio);
+        return false;
+    }
+    
+    return true;
+}
+
+void dog_bus_release(dog_bus_prio_t prio)
+{
+    if (s_task_handle == NULL) {
+        return;
+    }
+    
+    bus_cmd_t cmd = {
+        .type = BUS_CMD_RELEASE,
+        .prio = prio,
+    };
+    
+    if (!queue_push(&cmd)) {
+        atomic_fetch_add_explicit(&s_dropped, 1, memory_order_relaxed);
+    }
+}
+
+uint8_t dog_bus_get_sent(uint16_t *positions)
+{
+    uint8_t mask = 0;
+    
+    for (int i = 0; i < DOG_BUS_SERVO_COUNT; i++) {
+        unsigned sent = atomic_load_explicit(&s_sent[i], memory_order_relaxed);
+        if (sent & SENT_VALID) {
+            positions[i] = (uint16_t)sent;
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+void dog_bus_get_stats(dog_bus_stats_t *stats)
+{
+    if (stats != NULL) {
+        *stats = s_stats;
+        stats->dropped = atomic_load_explicit(&s_dropped, memory_order_relaxed);
+    }
+}
@@ -0,0 +1,118 @@
+/**
+ * @file dog_bus.h
+ * @brief Servo Bus Scheduler
+ * 
+ * Single task that owns the servo bus for goal-position traffic.
+ * Producers (gaits, reactions, balance, BLE callbacks) push goal commands
+ * into a bounded lock-free queue and return immediately. The control loop
+ * wakes the bus task at the end of every tick, after all its clients
+ * have run, and the bus task then:
+ *   1. Drains the queue, keeping only the newest target per servo
+ *   2. Resolves conflicts by priority (balance > reaction > gait > BLE)
+ *   3. Sends every changed goal in one SYNC WRITE
+ * 
+ * A stream that writes a servo claims it for DOG_BUS_CLAIM_MS, so lower
+ * priority traffic cannot fight an active higher priority loop. Claims
+ * expire on their own or can be dropped with dog_bus_release().
+ * 
+ * So each control tick's goals go out together in one SYNC WRITE, phase
+ * locked to the esp_timer tick. Until the control loop runs, the task
+ * flushes every DOG_BUS_IDLE_FLUSH_MS instead.
+ * 
+ * Positions are raw servo units: angle reversal and conversion are done
+ * by the caller (see dog_servo_move_all).
+ */
+
+#ifndef DOG_BUS_H
+#define DOG_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define DOG_BUS_SERVO_COUNT     4       // FR, FL, BR, BL (servo ID - 1 = index)
+#define DOG_BUS_QUEUE_LEN       32      // Command ring size (power of two)
+#define DOG_BUS_IDLE_FLUSH_MS   10      // Flush period while the control loop is not running
+#define DOG_BUS_CLAIM_MS        200     // How long a write protects a servo from lower priorities
+
+#define DOG_BUS_TASK_STACK      4096
+#define DOG_BUS_TASK_PRIORITY   6       // Above gait/IMU tasks (5)
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Command source priority (higher wins)
+ */
+typedef enum {
+    DOG_BUS_PRIO_BLE = 0,       // Web Bluetooth keyframes
+    DOG_BUS_PRIO_GAIT,          // Gait generators, stance
+    DOG_BUS_PRIO_REACTION,      // IMU-triggered animations
+    DOG_BUS_PRIO_BALANCE,       // Closed-loop balance
+    DOG_BUS_PRIO_COUNT
+} dog_bus_prio_t;
+
+typedef struct {
+    uint32_t ticks;             // Control ticks that found work
+    uint32_t sync_writes;       // SYNC WRITE packets sent
+    uint32_t commands;          // Commands dequeued
+    uint32_t coalesced;         // Goals overwritten before they were sent
+    uint32_t rejected;          // Goals refused because a higher priority held the servo
+    uint32_t dropped;           // Commands lost because the queue was full
+} dog_bus_stats_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Start the bus task (call after sts_protocol_init)
+ * @return true if the task is running
+ */
+bool dog_bus_start(void);
+
+/**
+ * @brief Check if the bus task is running
+ */
+bool dog_bus_is_running(void);
+
+/**
+ * @brief Queue goal positions for a subset of servos
+ * 
+ * Safe to call from any task. Never blocks on the bus. Falls back to a
+ * direct SYNC WRITE if the bus task is not running.
+ * 
+ * @param mask Bit (servo ID - 1) set for every servo to move
+ * @param positions Raw goal positions (0-4095), indexed by servo ID - 1
+ * @param speeds Goal speeds, indexed by servo ID - 1
+ * @param prio Source priority
+ * @return false if the queue was full and the command was dropped
+ */
+bool dog_bus_submit(uint8_t mask, const uint16_t *positions,
+                    const uint16_t *speeds, dog_bus_prio_t prio);
+
+/**
+ * @brief Drop all servo claims held by a priority level
+ * 
+ * Ordered with the command stream: goals queued after the release are
+ * judged without the released claims.
+ */
+void dog_bus_release(dog_bus_prio_t prio);
+
+/**
+ * @brief Goal positions last sent to the servos (what they are tracking)
+ * @param positions Output, indexed by servo ID - 1 (only bits in the result are written)
+ * @return Bit (servo ID - 1) set for every servo that has been sent a goal
+ */
+uint8_t dog_bus_get_sent(uint16_t *positions);
+
+/**
+ * @brief Get scheduler counters
+ */
+void dog_bus_get_stats(dog_bus_stats_t *stats);
+
+#endif // DOG_BUS_H
@@ -7,14 +7,20 @@
  */
 
 #include "dog_config.h"
+#include "dog_bus.h"
+#include "dog_servo_map.h"
+#include "control_loop.h"
 #include "sts3032_driver.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <math.h>
+#include <stdatomic.h>
 
 static const char *TAG = "DOG";
 
+#define ALL_SERVOS_MASK     ((1u << DOG_SERVO_COUNT) - 1)
+
 // ═══════════════════════════════════════════════════════
 // INTERNAL STATE
 // ═══════════════════════════════════════════════════════
@@ -22,6 +28,18 @@ static const char *TAG = "DOG";
 static dog_config_t s_config;
 static bool s_initialized = false;
 
+// Servo buses: [0] carries the front legs (and every leg on a single bus), [1] the back legs
+static sts_bus_t s_buses[2];
+
+// Servos known to answer (bit = servo ID - 1) and whether torque is on
+static atomic_uint s_online_mask;
+static bool s_torque_on = false;
+
+// Servo IDs in FR, FL, BR, BL order for batched bus transactions
+static const uint8_t s_servo_ids[DOG_SERVO_COUNT] = {
+    DOG_SERVO_FR, DOG_SERVO_FL, DOG_SERVO_BR, DOG_SERVO_BL
+};
+
 // ═══════════════════════════════════════════════════════
 // INTERNAL HELPERS
 // ═══════════════════════════════════════════════════════
@@ -52,6 +70,77 @@ static float get_base_stance(uint8_t servo_id)
     }
 }
 
+/**
+ * @brief Bring up the servo bus(es) and route the back legs to theirs
+ */
+static bool init_buses(void)
+{
+    sts_protocol_config_t front = {
+        .uart_num = s_config.uart_num,
+        .tx_pin = s_config.tx_pin,
+        .rx_pin = s_config.rx_pin,
+        .txen_pin = s_config.txen_pin,
+        .baud_rate = s_config.baud_rate,
+        .timing_mode = DOG_SERVO_TIMING_MODE,
+    };
+    
+    esp_err_t ret = sts_protocol_init(&s_buses[0], &front);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize servo protocol: %s", esp_err_to_name(ret));
+        return false;
+    }
+    sts_servo_add_bus(&s_buses[0], NULL, 0);
+    
+    if (s_config.bus_count < 2) {
+        return true;
+    }
+    
+    sts_protocol_config_t rear = {
+        .uart_num = s_config.rear_uart_num,
+        .tx_pin = s_config.rear_tx_pin,
+        .rx_pin = s_config.rear_rx_pin,
+        .txen_pin = s_config.rear_txen_pin,
+        .baud_rate = s_config.baud_rate,
+        .timing_mode = DOG_SERVO_TIMING_MODE,
+    };
+    const uint8_t rear_ids[] = { DOG_SERVO_BR, DOG_SERVO_BL };
+    
+    ret = sts_protocol_init(&s_buses[1], &rear);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize rear servo bus: %s", esp_err_to_name(ret));
+        return false;
+    }
+    return sts_servo_add_bus(&s_buses[1], rear_ids, sizeof(rear_ids));
+}
+
+/**
+ * @brief Confirm the leg servos at boot
+ * 
+ * One SYNC READ when the stored map already lists them; a fast scan of
+ * the whole bus (stored for the next boot) when it does not, or when one
+ * of them stopped answering.
+ */
+static bool verify_servos(void)
+{
+    bool known = (dog_servo_map_load() == ESP_OK);
+    for (int i = 0; known && i < DOG_SERVO_COUNT; i++) {
+        known = dog_servo_map_contains(s_servo_ids[i]);
+    }
+    
+    if (known) {
+        sts_servo_telemetry_t telemetry[DOG_SERVO_COUNT];
+        if (dog_read_telemetry(telemetry, NULL) == DOG_SERVO_COUNT) {
+            atomic_store(&s_online_mask, ALL_SERVOS_MASK);
+            ESP_LOGI(TAG, "All %d servos answered (known map)", DOG_SERVO_COUNT);
+            return true;
+        }
+        ESP_LOGW(TAG, "Known servos missing, rescanning the bus");
+    }
+    
+    dog_servo_map_scan();
+    return dog_check_servos();
+}
+
 // ═══════════════════════════════════════════════════════
 // INITIALIZATION
 // ═══════════════════════════════════════════════════════
@@ -71,27 +160,28 @@ bool dog_init(const dog_config_t *config)
     ESP_LOGI(TAG, "UART: %d, TX: %d, RX: %d, TXEN: %d, Baud: %lu",
              s_config.uart_num, s_config.tx_pin, s_config.rx_pin,
              s_config.txen_pin, (unsigned long)s_config.baud_rate);
+    if (s_config.bus_count >= 2) {
+        ESP_LOGI(TAG, "Rear UART: %d, TX: %d, RX: %d, TXEN: %d",
+                 s_config.rear_uart_num, s_config.rear_tx_pin, s_config.rear_rx_pin,
+                 s_config.rear_txen_pin);
+    }
     
     // Initialize the servo protocol
-    sts_protocol_config_t protocol_config = {
-        .uart_num = s_config.uart_num,
-        .tx_pin = s_config.tx_pin,
-        .rx_pin = s_config.rx_pin,
-        .txen_pin = s_config.txen_pin,
-        .baud_rate = s_config.baud_rate,
-    };
-    
-    esp_err_t ret = sts_protocol_init(&protocol_config);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize servo protocol: %s", esp_err_to_name(ret));
+    if (!init_buses()) {
         return false;
     }
     
-    ESP_LOGI(TAG, "Servo protocol initialized");
+    ESP_LOGI(TAG, "Servo protocol initialized (%d bus%s)", sts_servo_bus_count(),
+             sts_servo_bus_count() > 1 ? "es" : "");
+    
+    // All goal-position traffic goes through the bus scheduler from here on
+    if (!dog_bus_start()) {
+        ESP_LOGW(TAG, "Bus scheduler not running, servo writes will go direct");
+    }
     vTaskDelay(pdMS_TO_TICKS(100));
     
     // Check all servos
-    bool all_ok = dog_check_servos();
+    bool all_ok = verify_servos();
     if (!all_ok) {
         ESP_LOGW(TAG, "Some servos not responding, continuing anyway...");
     }
@@ -122,27 +212,115 @@ const dog_config_t* dog_get_config(void)
 // ═══════════════════════════════════════════════════════
 
 void dog_servo_move(uint8_t servo_id, float angle, uint16_t speed)
+{
+    dog_servo_move_prio(servo_id, angle, speed, DOG_BUS_PRIO_GAIT);
+}
+
+void dog_servo_move_prio(uint8_t servo_id, float angle, uint16_t speed, dog_bus_prio_t prio)
 {
     float actual_angle = apply_reversal(servo_id, angle);
-    sts_servo_set_angle(servo_id, actual_angle, speed);
+    dog_servo_move_raw(&servo_id, &actual_angle, &speed, 1, prio);
 }
 
 void dog_servo_move_all(float angle_fr, float angle_fl, 
                         float angle_br, float angle_bl, uint16_t speed)
 {
-    // Apply reversal to right-side servos
-    float actual_fr = apply_reversal(DOG_SERVO_FR, angle_fr);
-    float actual_br = apply_reversal(DOG_SERVO_BR, angle_br);
-    
-    // Left side uses angles directly
-    float actual_fl = angle_fl;
-    float actual_bl = angle_bl;
-    
-    // Move all servos
-    sts_servo_set_angle(DOG_SERVO_FR, actual_fr, speed);
-    sts_servo_set_angle(DOG_SERVO_FL, actual_fl, speed);
-    sts_servo_set_angle(DOG_SERVO_BR, actual_br, speed);
-    sts_servo_set_angle(DOG_SERVO_BL, actual_bl, speed);
+    dog_servo_move_all_prio(angle_fr, angle_fl, angle_br, angle_bl, speed, DOG_BUS_PRIO_GAIT);
+}
+
+void dog_servo_move_all_prio(float angle_fr, float angle_fl,
+                             float angle_br, float angle_bl, uint16_t speed,
+                             dog_bus_prio_t prio)
+{
+    // Apply reversal to right-side servos, left side uses angles directly
+    const float angles[DOG_SERVO_COUNT] = {
+        apply_reversal(DOG_SERVO_FR, angle_fr),
+        angle_fl,
+        apply_reversal(DOG_SERVO_BR, angle_br),
+        angle_bl
+    };
+    const uint16_t speeds[DOG_SERVO_COUNT] = { speed, speed, speed, speed };
+    
+    // All four goals leave in the same SYNC WRITE so the legs start together
+    dog_servo_move_raw(s_servo_ids, angles, speeds, DOG_SERVO_COUNT, prio);
+}
+
+void dog_servo_move_raw(const uint8_t *ids, const float *angles,
+                        const uint16_t *speeds, int count, dog_bus_prio_t prio)
+{
+    uint16_t positions[DOG_SERVO_COUNT] = {0};
+    uint16_t goal_speeds[DOG_SERVO_COUNT] = {0};
+    uint8_t mask = 0;
+    
+    for (int i = 0; i < count; i++) {
+        if (ids[i] < 1 || ids[i] > DOG_SERVO_COUNT) {
+            ESP_LOGW(TAG, "Ignoring move for unknown servo %d", ids[i]);
+            continue;
+        }
+        int idx = ids[i] - 1;
+        positions[idx] = sts_angle_to_position(angles[i]);
+        goal_speeds[idx] = speeds[i];
+        mask |= (1u << idx);
+    }
+    
+    dog_bus_submit(mask, positions, goal_speeds, prio);
+}
+
+/**
+ * @brief Submit goals with per-servo speeds that share one arrival time
+ * @param from Start positions, one per servo
+ * @param valid Servos whose start is known; the others move at the default speed
+ */
+static void move_raw_from(const uint8_t *ids, const uint16_t *from, const bool *valid,
+                          const float *angles, int count, uint32_t duration_ms,
+                          dog_bus_prio_t prio)
+{
+    uint16_t speeds[DOG_SERVO_COUNT];
+    
+    if (count > DOG_SERVO_COUNT) {
+        count = DOG_SERVO_COUNT;
+    }
+    for (int i = 0; i < count; i++) {
+        speeds[i] = valid[i]
+            ? sts_speed_for_time(from[i], sts_angle_to_position(angles[i]), duration_ms)
+            : s_config.default_speed;
+    }
+    
+    dog_servo_move_raw(ids, angles, speeds, count, prio);
+}
+
+bool dog_servo_move_raw_timed(const uint8_t *ids, const float *angles, int count,
+                              uint32_t duration_ms, dog_bus_prio_t prio)
+{
+    sts_servo_telemetry_t telemetry[DOG_SERVO_COUNT];
+    uint16_t from[DOG_SERVO_COUNT];
+    bool valid[DOG_SERVO_COUNT] = {0};
+    
+    if (count > DOG_SERVO_COUNT) {
+        count = DOG_SERVO_COUNT;
+    }
+    
+    int answered = sts_servo_sync_read_telemetry(ids, count, telemetry, valid);
+    for (int i = 0; i < count; i++) {
+        from[i] = telemetry[i].position;
+    }
+    
+    move_raw_from(ids, from, valid, angles, count, duration_ms, prio);
+    return answered == count;
+}
+
+bool dog_servo_move_all_timed(float angle_fr, float angle_fl,
+                              float angle_br, float angle_bl,
+                              uint32_t duration_ms, dog_bus_prio_t prio)
+{
+    const float angles[DOG_SERVO_COUNT] = {
+        apply_reversal(DOG_SERVO_FR, angle_fr),
+        angle_fl,
+        apply_reversal(DOG_SERVO_BR, angle_br),
+        angle_bl
+    };
+    
+    return dog_servo_move_raw_timed(s_servo_ids, angles, DOG_SERVO_COUNT, duration_ms, prio);
 }
 
 void dog_goto_stance(void)
@@ -189,14 +367,8 @@ void dog_goto_stance_smooth(void)
         s_config.stance_back    // BL - no reversal
     };
     
-    // Try to read current angles
-    bool angles_read = true;
-    for (uint8_t i = 0; i < 4; i++) {
-        if (!sts_servo_get_angle(i + 1, &current_angles[i])) {
-            angles_read = false;
-            break;
-        }
-    }
+    // Read current angles of all four servos in one SYNC READ
+    bool angles_read = sts_servo_sync_get_angles(s_servo_ids, DOG_SERVO_COUNT, current_angles);
     
     // If we couldn't read angles, fall back to default speed
     if (!angles_read) {
@@ -206,26 +378,34 @@ void dog_goto_stance_smooth(void)
     
     // Calculate max delta across all servos
     float max_delta = 0.0f;
+    uint16_t from[4];
+    const bool valid[4] = { true, true, true, true };
     for (uint8_t i = 0; i < 4; i++) {
         float delta = fabsf(target_angles[i] - current_angles[i]);
         if (delta > max_delta) {
             max_delta = delta;
         }
+        from[i] = sts_angle_to_position(current_angles[i]);
     }
     
-    // Calculate dynamic speed based on largest movement needed
+    // The largest movement sets the speed, and with it the arrival time
     uint16_t dynamic_speed = calculate_dynamic_speed(max_delta);
+    uint32_t max_steps = sts_angle_to_position(max_delta);
+    uint32_t duration_ms = max_steps * 1000u / dynamic_speed;
     
-    ESP_LOGD(TAG, "Stance smooth: max_delta=%.1f° speed=%d", max_delta, dynamic_speed);
+    // A tiny correction would round to 0 ms, which sts_speed_for_time
+    // turns into full speed; give it at least one control tick instead
+    uint32_t rate_hz = control_loop_get_rate_hz();
+    uint32_t tick_ms = 1000u / (rate_hz ? rate_hz : CONTROL_LOOP_DEFAULT_HZ);
+    if (duration_ms < tick_ms) {
+        duration_ms = tick_ms;
+    }
     
-    // Move all servos with calculated speed
-    dog_servo_move_all(
-        s_config.stance_front,  // FR
-        s_config.stance_front,  // FL
-        s_config.stance_back,   // BR
-        s_config.stance_back,   // BL
-        dynamic_speed
-    );
+    ESP_LOGD(TAG, "Stance smooth: max_delta=%.1f° speed=%d time=%lums",
+             max_delta, dynamic_speed, (unsigned long)duration_ms);
+    
+    move_raw_from(s_servo_ids, from, valid, target_angles, DOG_SERVO_COUNT,
+                  duration_ms, DOG_BUS_PRIO_GAIT);
 }
 
 float dog_get_stance_angle(uint8_t servo_id)
@@ -251,6 +431,7 @@ float dog_get_push_back_angle(uint8_t servo_id)
 bool dog_check_servos(void)
 {
     bool all_ok = true;
+    unsigned online = 0;
     
     ESP_LOGI(TAG, "Checking servos...");
     
@@ -265,19 +446,53 @@ bool dog_check_servos(void)
                 default: name = "Unknown"; break;
             }
             ESP_LOGI(TAG, "  ✓ Servo %d (%s) OK", id, name);
+            online |= 1u << (id - 1);
         } else {
             ESP_LOGE(TAG, "  ✗ Servo %d NOT responding", id);
             all_ok = false;
         }
     }
     
+    atomic_store(&s_online_mask, online);
     return all_ok;
 }
 
-void dog_set_torque(bool enable)
+int dog_read_telemetry(sts_servo_telemetry_t *telemetry, bool *valid)
 {
-    for (uint8_t id = 1; id <= DOG_SERVO_COUNT; id++) {
-        sts_servo_enable_torque(id, enable);
+    bool ok[DOG_SERVO_COUNT];
+    int found = sts_servo_sync_read_telemetry(s_servo_ids, DOG_SERVO_COUNT, telemetry, ok);
+    
+    unsigned lost = 0;
+    for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+        if (!ok[i]) {
+            lost |= 1u << (s_servo_ids[i] - 1);
+        }
+        if (valid) {
+            valid[i] = ok[i];
+        }
+    }
+    if (lost) {
+        atomic_fetch_and(&s_online_mask, ~lost);
     }
+    
+    return found;
+}
+
+void dog_set_torque(bool enable)
+{
+    sts_servo_sync_enable_torque(s_servo_ids, DOG_SERVO_COUNT, enable);
+    s_torque_on = enable;
     ESP_LOGI(TAG, "Torque %s on all servos", enable ? "enabled" : "disabled");
 }
+
+bool dog_prepare_servos(void)
+{
+    if (s_torque_on && atomic_load(&s_online_mask) == ALL_SERVOS_MASK) {
+        ESP_LOGI(TAG, "Servos ready, skipping ping/torque round");
+        return true;
+    }
+    
+    bool all_ok = dog_check_servos();
+    dog_set_torque(true);
+    return all_ok;
+}
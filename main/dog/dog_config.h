@@ -3,10 +3,11 @@
  * @brief Dog Hardware Configuration
  * 
  * Centralizes all hardware-specific configuration for the quadruped robot:
- *   - UART and GPIO pin definitions
+ *   - UART and GPIO pin definitions (one bus, or front and rear buses)
  *   - Servo ID assignments
  *   - Angle reversal for right-side servos (360 - angle)
  *   - Stance and swing angle definitions
+ *   - Leg geometry for foot-space commands (see dog_kinematics.h)
  * 
  * Servo Layout (viewed from above):
  *   Front: [FL=2]  [FR=1]
@@ -25,7 +26,11 @@
 #include <stdbool.h>
 #include "driver/uart.h"
 #include "driver/gpio.h"
+#include "sdkconfig.h"
 #include "qmi8658a.h"
+#include "sts3032_servo.h"
+#include "dog_bus.h"
+#include "dog_kinematics.h"
 
 // ═══════════════════════════════════════════════════════
 // UART CONFIGURATION
@@ -36,6 +41,19 @@
 #define DOG_SERVO_RX_PIN        GPIO_NUM_11
 #define DOG_SERVO_TXEN_PIN      GPIO_NUM_3
 #define DOG_SERVO_BAUD_RATE     1000000
+#define DOG_SERVO_TIMING_MODE   STS_TIMING_RS485  // TXEN driven by UART RTS, baud-derived timeouts
+
+// Back legs on their own UART (CONFIG_DOG_SERVO_REAR_BUS); front legs stay on the one above
+#if CONFIG_DOG_SERVO_REAR_BUS
+#define DOG_SERVO_BUS_COUNT     2
+#else
+#define DOG_SERVO_BUS_COUNT     1
+#endif
+
+#define DOG_SERVO_REAR_UART_NUM UART_NUM_2
+#define DOG_SERVO_REAR_TX_PIN   GPIO_NUM_12
+#define DOG_SERVO_REAR_RX_PIN   GPIO_NUM_13
+#define DOG_SERVO_REAR_TXEN_PIN GPIO_NUM_14
 
 // ═══════════════════════════════════════════════════════
 // SERVO ID DEFINITIONS
@@ -127,6 +145,13 @@
 // IMU logging configuration (change threshold before logging)
 #define DOG_IMU_ACCEL_CHANGE_THRESHOLD  1.5f    // m/s² change before logging
 #define DOG_IMU_GYRO_CHANGE_THRESHOLD   5.0f    // dps change before logging
+#define DOG_IMU_LOG_INTERVAL_MS         50      // Logger checks the newest sample this often
+
+// IMU tasks (reader on the control core, logger on the comms core)
+#define DOG_IMU_TASK_STACK              4096
+#define DOG_IMU_TASK_PRIORITY           5
+#define DOG_IMU_LOG_TASK_STACK          3072
+#define DOG_IMU_LOG_TASK_PRIORITY       2
 
 /**
  * @brief Default IMU configuration for the dog
@@ -143,6 +168,51 @@
     .gyro_odr = DOG_IMU_GYRO_ODR                        \
 }
 
+// IMU FIFO acquisition
+// INT wiring is board-specific; GPIO_NUM_NC drains the FIFO on a timer instead
+#define DOG_IMU_INT_PIN             GPIO_NUM_NC
+#define DOG_IMU_INT_LINE            QMI8658A_INT2
+#define DOG_IMU_FIFO_SIZE           QMI8658A_FIFO_SIZE_64
+#define DOG_IMU_FIFO_WATERMARK      8       // 16 ms of samples at 500 Hz
+#define DOG_IMU_FIFO_TIMEOUT_MS     50      // Fall back to draining if the interrupt is lost
+#define DOG_IMU_BATCH_MAX           64      // Samples acquired per wakeup
+#define DOG_IMU_PAUSE_WAIT_MS       (DOG_IMU_IDLE_FIFO_TIMEOUT_MS + 100)    // Longest dog_imu_pause() waits
+
+/**
+ * @brief Default IMU FIFO configuration for the dog
+ */
+#define DOG_IMU_FIFO_DEFAULT_CONFIG() {                 \
+    .size = DOG_IMU_FIFO_SIZE,                          \
+    .mode = QMI8658A_FIFO_MODE_STREAM,                  \
+    .watermark = DOG_IMU_FIFO_WATERMARK,                \
+    .int_line = DOG_IMU_INT_LINE,                       \
+    .int_pin = DOG_IMU_INT_PIN                          \
+}
+
+// IMU power management: full rate while a gait, balance or a clip needs
+// the attitude, a low rate once the dog has been idle and still for a while.
+// The on-chip any-motion engine brings the full rate back at the first bump.
+#define DOG_IMU_IDLE_ACCEL_ODR      QMI8658A_ACCEL_ODR_31
+#define DOG_IMU_IDLE_GYRO_ODR       QMI8658A_GYRO_ODR_31
+#define DOG_IMU_IDLE_AFTER_MS       3000    // Idle and motionless this long before dropping the rate
+#define DOG_IMU_IDLE_FIFO_TIMEOUT_MS 500    // Longest sleep between FIFO drains when idle
+#define DOG_IMU_MOTION_INT_LINE     QMI8658A_INT1
+#define DOG_IMU_WAKE_THRESHOLD_G    0.15f   // Any-motion: per-axis change that wakes the IMU
+#define DOG_IMU_WAKE_WINDOW         2       // Samples above the threshold
+#define DOG_IMU_STILL_THRESHOLD_G   0.05f   // No-motion: every axis within this
+#define DOG_IMU_STILL_WINDOW        16      // Samples within the threshold
+
+/**
+ * @brief Default IMU motion engine configuration for the dog
+ */
+#define DOG_IMU_MOTION_DEFAULT_CONFIG() {               \
+    .any_threshold_g = DOG_IMU_WAKE_THRESHOLD_G,        \
+    .any_window = DOG_IMU_WAKE_WINDOW,                  \
+    .no_threshold_g = DOG_IMU_STILL_THRESHOLD_G,        \
+    .no_window = DOG_IMU_STILL_WINDOW,                  \
+    .int_line = DOG_IMU_MOTION_INT_LINE                 \
+}
+
 // ═══════════════════════════════════════════════════════
 // DOG CONFIGURATION STRUCTURE
 // ═══════════════════════════════════════════════════════
@@ -158,11 +228,21 @@ typedef struct {
     gpio_num_t txen_pin;
     uint32_t baud_rate;
     
+    // Rear bus, used for the back legs when bus_count is 2 (same baud rate)
+    uint8_t bus_count;
+    uart_port_t rear_uart_num;
+    gpio_num_t rear_tx_pin;
+    gpio_num_t rear_rx_pin;
+    gpio_num_t rear_txen_pin;
+    
     // Stance angles (before reversal applied)
     float stance_front;         // Front legs neutral angle
     float stance_back;          // Back legs neutral angle
     float swing_amplitude;      // Max deviation from stance
     
+    // Leg geometry for foot-space commands (see dog_kinematics.h)
+    dog_leg_geometry_t leg;
+    
     // Default servo speed
     uint16_t default_speed;
 } dog_config_t;
@@ -176,9 +256,15 @@ typedef struct {
     .rx_pin = DOG_SERVO_RX_PIN,                 \
     .txen_pin = DOG_SERVO_TXEN_PIN,             \
     .baud_rate = DOG_SERVO_BAUD_RATE,           \
+    .bus_count = DOG_SERVO_BUS_COUNT,           \
+    .rear_uart_num = DOG_SERVO_REAR_UART_NUM,   \
+    .rear_tx_pin = DOG_SERVO_REAR_TX_PIN,       \
+    .rear_rx_pin = DOG_SERVO_REAR_RX_PIN,       \
+    .rear_txen_pin = DOG_SERVO_REAR_TXEN_PIN,   \
     .stance_front = DOG_STANCE_FRONT,           \
     .stance_back = DOG_STANCE_BACK,             \
     .swing_amplitude = DOG_SWING_AMPLITUDE,     \
+    .leg = DOG_LEG_DEFAULT_GEOMETRY(),          \
     .default_speed = DOG_SPEED_FAST             \
 }
 
@@ -213,6 +299,10 @@ void dog_servo_move(uint8_t servo_id, float angle, uint16_t speed);
 
 /**
  * @brief Move all servos at once (auto-reverses right side)
+ * 
+ * All four goals are queued to the bus scheduler as one command and sent
+ * in one SYNC WRITE packet, so the legs start moving at the same time.
+ * 
  * @param angle_fr Front-right angle (left perspective, will be reversed)
  * @param angle_fl Front-left angle
  * @param angle_br Back-right angle (left perspective, will be reversed)
@@ -222,6 +312,62 @@ void dog_servo_move(uint8_t servo_id, float angle, uint16_t speed);
 void dog_servo_move_all(float angle_fr, float angle_fl, 
                         float angle_br, float angle_bl, uint16_t speed);
 
+/**
+ * @brief dog_servo_move with an explicit bus priority
+ */
+void dog_servo_move_prio(uint8_t servo_id, float angle, uint16_t speed, dog_bus_prio_t prio);
+
+/**
+ * @brief dog_servo_move_all with an explicit bus priority
+ * 
+ * Gait-level helpers use DOG_BUS_PRIO_GAIT; balance, reactions and BLE
+ * pass their own level so the bus scheduler can arbitrate.
+ */
+void dog_servo_move_all_prio(float angle_fr, float angle_fl,
+                             float angle_br, float angle_bl, uint16_t speed,
+                             dog_bus_prio_t prio);
+
+/**
+ * @brief Move servos using raw servo angles (no right-side reversal)
+ * 
+ * For callers that already work in servo-space angles. Goes through the
+ * bus scheduler like the other move functions.
+ * 
+ * @param ids Servo IDs (1-4)
+ * @param angles Raw servo angles in degrees, one per servo
+ * @param speeds Speeds, one per servo
+ * @param count Number of servos
+ * @param prio Bus priority
+ */
+void dog_servo_move_raw(const uint8_t *ids, const float *angles,
+                        const uint16_t *speeds, int count, dog_bus_prio_t prio);
+
+/**
+ * @brief Move servos so that they all arrive after the same time
+ * 
+ * Reads the present positions in one SYNC READ and gives every servo the
+ * speed that covers its own distance in duration_ms, so short and long
+ * moves finish together. A servo that does not answer moves at the
+ * default speed.
+ * 
+ * @param ids Servo IDs (1-4)
+ * @param angles Raw servo angles in degrees, one per servo
+ * @param count Number of servos
+ * @param duration_ms Time to arrive
+ * @param prio Bus priority
+ * @return false if some present position could not be read
+ */
+bool dog_servo_move_raw_timed(const uint8_t *ids, const float *angles, int count,
+                              uint32_t duration_ms, dog_bus_prio_t prio);
+
+/**
+ * @brief Move all servos to arrive together (auto-reverses right side)
+ * @see dog_servo_move_raw_timed
+ */
+bool dog_servo_move_all_timed(float angle_fr, float angle_fl,
+                              float angle_br, float angle_bl,
+                              uint32_t duration_ms, dog_bus_prio_t prio);
+
 /**
  * @brief Move all servos to stance position
  */
@@ -231,7 +377,8 @@ void dog_goto_stance(void);
  * @brief Move all servos to stance with dynamic speed
  * 
  * Uses slower speed for small corrections to prevent shaking,
- * faster speed for large movements.
+ * faster speed for large movements. The leg with the largest move sets
+ * the time; the others are slowed down to arrive with it.
  */
 void dog_goto_stance_smooth(void);
 
@@ -263,11 +410,36 @@ float dog_get_push_back_angle(uint8_t servo_id);
 bool dog_check_servos(void);
 
 /**
- * @brief Enable/disable torque on all servos
+ * @brief Read telemetry of all servos in one SYNC READ round trip
+ * 
+ * Cheap enough to call from a 50-100 Hz monitoring or control loop.
+ * A servo that does not answer is no longer considered ready.
+ * 
+ * @param telemetry Output array of DOG_SERVO_COUNT entries (FR, FL, BR, BL)
+ * @param valid Optional output array of DOG_SERVO_COUNT flags (NULL to ignore)
+ * @return Number of servos that answered
+ */
+int dog_read_telemetry(sts_servo_telemetry_t *telemetry, bool *valid);
+
+/**
+ * @brief Enable/disable torque on all servos (one SYNC WRITE)
  * @param enable true to enable torque
  */
 void dog_set_torque(bool enable);
 
+/**
+ * @brief Make sure every servo answers and holds torque before a gait starts
+ * 
+ * gait_manager_start calls this whenever walking starts from stance; no
+ * other gait path needs its own check. Free if nothing changed since boot
+ * or the last call: the ping and torque round only runs after a servo
+ * stopped answering (see dog_read_telemetry) or torque was switched off.
+ * The gait starts even if some servo is missing.
+ * 
+ * @return true if all servos are ready
+ */
+bool dog_prepare_servos(void);
+
 // ═══════════════════════════════════════════════════════
 // IMU FUNCTIONS
 // ═══════════════════════════════════════════════════════
@@ -291,4 +463,44 @@ bool dog_imu_read(qmi8658a_data_t *out_data);
  */
 void dog_imu_task_start(void);
 
+/**
+ * @brief Stop the IMU task from touching the sensor (blocks until it has)
+ * 
+ * For direct sensor access, such as the benchmark's raw reads, that would
+ * otherwise race the task for the I2C bus and the FIFO. The attitude is
+ * not updated while paused. The task stops between two FIFO drains, never
+ * inside one, so this can take up to DOG_IMU_PAUSE_WAIT_MS.
+ * 
+ * @return false if the task did not stop in time (then call dog_imu_resume)
+ */
+bool dog_imu_pause(void);
+
+/**
+ * @brief Let the IMU task drain the FIFO again
+ */
+void dog_imu_resume(void);
+
+/**
+ * @brief IMU power management counters
+ */
+typedef struct {
+    bool idle;                  // Running at the idle ODR now
+    uint32_t idle_entries;      // Times the rate was dropped
+    uint32_t motion_wakes;      // Full rate restored by the motion engine
+    uint32_t idle_ms;           // Total time spent at the idle ODR
+} dog_imu_power_stats_t;
+
+/**
+ * @brief Let the IMU drop to its idle ODR when nothing needs it (default on)
+ * 
+ * Turning it off restores the full rate at the next IMU wakeup. Useful
+ * while streaming raw IMU telemetry.
+ */
+void dog_imu_set_low_power(bool enabled);
+
+/**
+ * @brief Get the power management counters
+ */
+void dog_imu_get_power_stats(dog_imu_power_stats_t *stats);
+
 #endif // DOG_CONFIG_H
@@ -0,0 +1,108 @@
+/**
+ * @file dog_dsp.c
+ * @brief Block DSP Implementation
+ * 
+ * Every loop walks plain arrays with the loop-carried state in locals, so
+ * the compiler keeps it in registers for the whole block. About 5 float
+ * multiply-adds per biquad sample on the S3 FPU.
+ */
+
+#include "dog_dsp.h"
+#include <math.h>
+#include <stddef.h>
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+void dog_dsp_unpack(const qmi8658a_fixed_data_t *samples, int count, dog_dsp_axis_t axis, int32_t *out)
+{
+    static const size_t offsets[] = {
+        offsetof(qmi8658a_fixed_data_t, accel_x),
+        offsetof(qmi8658a_fixed_data_t, accel_y),
+        offsetof(qmi8658a_fixed_data_t, accel_z),
+        offsetof(qmi8658a_fixed_data_t, gyro_x),
+        offsetof(qmi8658a_fixed_data_t, gyro_y),
+        offsetof(qmi8658a_fixed_data_t, gyro_z),
+    };
+    const uint8_t *src = (const uint8_t *)samples + offsets[axis];
+    
+    for (int i = 0; i < count; i++) {
+        out[i] = *(const int32_t *)(src + i * sizeof(qmi8658a_fixed_data_t));
+    }
+}
+
+void dog_dsp_q16_to_float(const int32_t *in, float *out, int count)
+{
+    for (int i = 0; i < count; i++) {
+        out[i] = QMI8658A_Q16_TO_FLOAT(in[i]);
+    }
+}
+
+void dog_dsp_deadzone(float *x, int count, float zone)
+{
+    for (int i = 0; i < count; i++) {
+        if (fabsf(x[i]) < zone) {
+            x[i] = 0.0f;
+        }
+    }
+}
+
+void dog_dsp_biquad_lowpass(dog_dsp_biquad_t *bq, float cutoff_hz, float sample_hz, float q)
+{
+    float w0 = 2.0f * (float)M_PI * cutoff_hz / sample_hz;
+    float cw = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    float inv_a0 = 1.0f / (1.0f + alpha);
+    
+    bq->coef[0] = (1.0f - cw) * 0.5f * inv_a0;
+    bq->coef[1] = (1.0f - cw) * inv_a0;
+    bq->coef[2] = bq->coef[0];
+    bq->coef[3] = -2.0f * cw * inv_a0;
+    bq->coef[4] = (1.0f - alpha) * inv_a0;
+    dog_dsp_biquad_reset(bq);
+}
+
+void dog_dsp_biquad_reset(dog_dsp_biquad_t *bq)
+{
+    bq->w[0] = 0.0f;
+    bq->w[1] = 0.0f;
+}
+
+void dog_dsp_biquad_run(dog_dsp_biquad_t *bq, const float *in, float *out, int count)
+{
+    const float b0 = bq->coef[0], b1 = bq->coef[1], b2 = bq->coef[2];
+    const float a1 = bq->coef[3], a2 = bq->coef[4];
+    float w0 = bq->w[0], w1 = bq->w[1];
+    
+    for (int i = 0; i < count; i++) {
+        float x = in[i];
+        float y = b0 * x + w0;
+        w0 = b1 * x - a1 * y + w1;
+        w1 = b2 * x - a2 * y;
+        out[i] = y;
+    }
+    
+    bq->w[0] = w0;
+    bq->w[1] = w1;
+}
+
+int dog_dsp_find_above(const int32_t *x, int count, int32_t threshold)
+{
+    for (int i = 0; i < count; i++) {
+        if (x[i] >= threshold || x[i] <= -threshold) {
+            return i;
+        }
+    }
+    return count;
+}
+
+int dog_dsp_find_below(const int32_t *x, int count, int32_t threshold)
+{
+    for (int i = 0; i < count; i++) {
+        if (x[i] < threshold && x[i] > -threshold) {
+            return i;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file dog_dsp.h
+ * @brief Block DSP for IMU Sample Batches
+ * 
+ * Consumers drain the IMU ring in batches of up to a FIFO watermark. The
+ * helpers here work on one channel of a whole batch at a time: a batch is
+ * first split into contiguous per-axis arrays, then filtered and scanned
+ * in tight loops with no per-sample calls or branches on state.
+ * 
+ *   int32_t gx[32];
+ *   dog_dsp_unpack(batch, count, DOG_DSP_GYRO_X, gx);
+ *   int i = dog_dsp_find_above(gx, count, threshold);   // first edge, or count
+ * 
+ * The biquad keeps its coefficients and state in the layout esp-dsp's
+ * dsps_biquad_f32() uses (b0 b1 b2 a1 a2, w[2]), so a block can be handed
+ * to the PIE-optimised routine unchanged if that component is added.
+ */
+
+#ifndef DOG_DSP_H
+#define DOG_DSP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "qmi8658a.h"
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief One channel of a qmi8658a_fixed_data_t sample
+ */
+typedef enum {
+    DOG_DSP_ACCEL_X,
+    DOG_DSP_ACCEL_Y,
+    DOG_DSP_ACCEL_Z,
+    DOG_DSP_GYRO_X,
+    DOG_DSP_GYRO_Y,
+    DOG_DSP_GYRO_Z,
+} dog_dsp_axis_t;
+
+/**
+ * @brief Second-order IIR section (transposed direct form II)
+ */
+typedef struct {
+    float coef[5];              // b0, b1, b2, a1, a2 (a0 normalised to 1)
+    float w[2];                 // State, carried from one block to the next
+} dog_dsp_biquad_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Copy one channel of a batch into a contiguous Q16.16 array
+ */
+void dog_dsp_unpack(const qmi8658a_fixed_data_t *samples, int count, dog_dsp_axis_t axis, int32_t *out);
+
+/**
+ * @brief Convert a Q16.16 block to float
+ */
+void dog_dsp_q16_to_float(const int32_t *in, float *out, int count);
+
+/**
+ * @brief Zero every value with |x| < zone (in place)
+ */
+void dog_dsp_deadzone(float *x, int count, float zone);
+
+/**
+ * @brief Design a low-pass biquad (RBJ cookbook) and clear its state
+ * @param cutoff_hz -3 dB frequency, below sample_hz / 2
+ * @param sample_hz Rate the blocks are sampled at
+ * @param q Quality factor (0.7071 = Butterworth)
+ */
+void dog_dsp_biquad_lowpass(dog_dsp_biquad_t *bq, float cutoff_hz, float sample_hz, float q);
+
+/**
+ * @brief Clear the state, keeping the coefficients
+ */
+void dog_dsp_biquad_reset(dog_dsp_biquad_t *bq);
+
+/**
+ * @brief Filter a block (in and out may be the same array)
+ */
+void dog_dsp_biquad_run(dog_dsp_biquad_t *bq, const float *in, float *out, int count);
+
+/**
+ * @brief Index of the first value with |x| >= threshold
+ * @return Index, or count if there is none
+ */
+int dog_dsp_find_above(const int32_t *x, int count, int32_t threshold);
+
+/**
+ * @brief Index of the first value with |x| < threshold
+ * @return Index, or count if there is none
+ */
+int dog_dsp_find_below(const int32_t *x, int count, int32_t threshold);
+
+#endif // DOG_DSP_H
@@ -4,14 +4,32 @@
  * 
  * Uses the qmi8658a driver with project-specific configuration
  * and implements smart logging that only logs when values change.
+ * 
+ * Samples are drained from the sensor FIFO in batches, so every sample
+ * at the configured ODR reaches the reaction and balance filters.
+ * The IMU task only acquires, fuses attitude and publishes to the
+ * sample ring; consumers read the ring from their own tasks.
+ * 
+ * The IMU task also picks the output data rate: the configured one while
+ * a gait, balance or a clip runs, DOG_IMU_IDLE_*_ODR after
+ * DOG_IMU_IDLE_AFTER_MS without any of them and without a flag from the
+ * on-chip any-motion engine. A flag (a bump, being picked up) restores
+ * the full rate at the next wakeup.
  */
 
 #include "dog_config.h"
 #include "reaction/reaction_config.h"
+#include "reaction/attitude.h"
+#include "reaction/gyro_balance.h"
+#include "gait_manager.h"
+#include "motion_player.h"
+#include "dog_imu_ring.h"
+#include "dog_imu_cal.h"
+#include "dog_tasks.h"
+#include "esp_timer.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include <math.h>
 
 static const char *TAG = "DOG_IMU";
 
@@ -19,34 +37,140 @@ static const char *TAG = "DOG_IMU";
 // SMART LOGGING STATE
 // ═══════════════════════════════════════════════════════
 
-static qmi8658a_data_t g_last_logged_data = {0};
+static qmi8658a_fixed_data_t g_last_logged_data = {0};
 static bool g_first_log = true;
+static bool g_fifo_enabled = false;
+
+// Statically allocated task memory
+static TaskHandle_t s_imu_task = NULL;
+static StaticTask_t s_imu_tcb;
+static StackType_t s_imu_stack[DOG_IMU_TASK_STACK];
+static StaticTask_t s_log_tcb;
+static StackType_t s_log_stack[DOG_IMU_LOG_TASK_STACK];
+
+// ═══════════════════════════════════════════════════════
+// POWER MANAGEMENT STATE
+// ═══════════════════════════════════════════════════════
+
+// Owned by the IMU task
+static bool s_motion_engine = false;
+static int64_t s_active_us = 0;         // Last time something needed the IMU or it moved
+
+// Shared with readers (s_power_lock)
+static portMUX_TYPE s_power_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_low_power = true;
+static dog_imu_power_stats_t s_power;
+static int64_t s_idle_since_us;
+
+// Direct sensor access handshake (dog_imu_pause)
+static volatile bool s_pause_request = false;
+static volatile bool s_paused = false;
 
 // ═══════════════════════════════════════════════════════
 // HELPER FUNCTIONS
 // ═══════════════════════════════════════════════════════
 
+static inline int32_t abs_diff(int32_t a, int32_t b)
+{
+    return (a > b) ? a - b : b - a;
+}
+
 /**
  * @brief Check if data has changed significantly since last log
  */
-static bool has_significant_change(const qmi8658a_data_t *current, const qmi8658a_data_t *previous)
+static bool has_significant_change(const qmi8658a_fixed_data_t *current, const qmi8658a_fixed_data_t *previous)
 {
-    float accel_threshold = DOG_IMU_ACCEL_CHANGE_THRESHOLD;
-    float gyro_threshold = DOG_IMU_GYRO_CHANGE_THRESHOLD;
+    const int32_t accel_threshold = QMI8658A_Q16(DOG_IMU_ACCEL_CHANGE_THRESHOLD);
+    const int32_t gyro_threshold = QMI8658A_Q16(DOG_IMU_GYRO_CHANGE_THRESHOLD);
     
     // Check accelerometer changes
-    if (fabsf(current->accel_x - previous->accel_x) > accel_threshold) return true;
-    if (fabsf(current->accel_y - previous->accel_y) > accel_threshold) return true;
-    if (fabsf(current->accel_z - previous->accel_z) > accel_threshold) return true;
+    if (abs_diff(current->accel_x, previous->accel_x) > accel_threshold) return true;
+    if (abs_diff(current->accel_y, previous->accel_y) > accel_threshold) return true;
+    if (abs_diff(current->accel_z, previous->accel_z) > accel_threshold) return true;
     
     // Check gyroscope changes
-    if (fabsf(current->gyro_x - previous->gyro_x) > gyro_threshold) return true;
-    if (fabsf(current->gyro_y - previous->gyro_y) > gyro_threshold) return true;
-    if (fabsf(current->gyro_z - previous->gyro_z) > gyro_threshold) return true;
+    if (abs_diff(current->gyro_x, previous->gyro_x) > gyro_threshold) return true;
+    if (abs_diff(current->gyro_y, previous->gyro_y) > gyro_threshold) return true;
+    if (abs_diff(current->gyro_z, previous->gyro_z) > gyro_threshold) return true;
     
     return false;
 }
 
+// ═══════════════════════════════════════════════════════
+// POWER MANAGEMENT
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief True while something consumes the attitude at full rate
+ */
+static bool imu_in_use(void)
+{
+    return gait_manager_is_walking() || gyro_balance_is_enabled() || motion_is_playing() ||
+           dog_imu_cal_is_running();
+}
+
+/**
+ * @brief Switch between the configured and the idle ODR (IMU task only)
+ */
+static void set_idle(bool idle, bool motion_wake, int64_t now_us)
+{
+    bool ok = idle
+        ? qmi8658a_set_odr(DOG_IMU_IDLE_ACCEL_ODR, DOG_IMU_IDLE_GYRO_ODR)
+        : qmi8658a_set_odr(DOG_IMU_ACCEL_ODR, DOG_IMU_GYRO_ODR);
+    if (!ok) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_power_lock);
+    s_power.idle = idle;
+    if (idle) {
+        s_power.idle_entries++;
+        s_idle_since_us = now_us;
+    } else {
+        s_power.idle_ms += (uint32_t)((now_us - s_idle_since_us) / 1000);
+        if (motion_wake) {
+            s_power.motion_wakes++;
+        }
+    }
+    portEXIT_CRITICAL(&s_power_lock);
+    
+    ESP_LOGI(TAG, "%s ODR (%lu us period)%s", idle ? "Idle" : "Full",
+             (unsigned long)qmi8658a_get_sample_period_us(), motion_wake ? ", motion" : "");
+}
+
+/**
+ * @brief Pick the ODR for what the dog is doing (IMU task, after each drain)
+ */
+static void update_power(void)
+{
+    int64_t now_us = esp_timer_get_time();
+    
+    portENTER_CRITICAL(&s_power_lock);
+    bool low_power = s_low_power;
+    bool idle = s_power.idle;
+    portEXIT_CRITICAL(&s_power_lock);
+    
+    bool in_use = !low_power || imu_in_use();
+    bool moving = false;
+    
+    // The motion flags only matter when nothing else keeps the rate up
+    if (!in_use) {
+        uint8_t status = 0;
+        moving = qmi8658a_motion_read(&status) && (status & QMI8658A_STATUS1_ANY_MOTION);
+    }
+    if (in_use || moving) {
+        s_active_us = now_us;
+    }
+    
+    if (idle) {
+        if (in_use || moving) {
+            set_idle(false, moving && !in_use, now_us);
+        }
+    } else if (now_us - s_active_us >= (int64_t)DOG_IMU_IDLE_AFTER_MS * 1000) {
+        set_idle(true, false, now_us);
+    }
+}
+
 // ═══════════════════════════════════════════════════════
 // PUBLIC API
 // ═══════════════════════════════════════════════════════
@@ -65,7 +189,32 @@ bool dog_imu_init(void)
     // Run diagnostics
     qmi8658a_debug_status();
     
-    // Initialize reaction system
+    esp_err_t cal_ret = dog_imu_cal_load();
+    if (cal_ret != ESP_OK && cal_ret != ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "Failed to load IMU calibration: %s", esp_err_to_name(cal_ret));
+    }
+#if DOG_IMU_CAL_AT_BOOT
+    dog_imu_cal_start(DOG_IMU_CAL_GYRO);
+#endif
+    
+    qmi8658a_fifo_config_t fifo = DOG_IMU_FIFO_DEFAULT_CONFIG();
+    g_fifo_enabled = qmi8658a_fifo_enable(&fifo);
+    if (!g_fifo_enabled) {
+        ESP_LOGW(TAG, "FIFO unavailable, falling back to 20 Hz polling");
+    }
+    
+    // The idle ODR needs the motion engine to come back from it
+    if (g_fifo_enabled) {
+        qmi8658a_motion_config_t motion = DOG_IMU_MOTION_DEFAULT_CONFIG();
+        s_motion_engine = qmi8658a_motion_enable(&motion);
+    }
+    if (!s_motion_engine) {
+        ESP_LOGW(TAG, "Motion engine unavailable, IMU stays at full rate");
+    }
+    s_active_us = esp_timer_get_time();
+    
+    // Initialize attitude estimation and the reaction system
+    attitude_init();
     reaction_init();
     
     ESP_LOGI(TAG, "IMU initialized successfully");
@@ -83,33 +232,132 @@ bool dog_imu_read(qmi8658a_data_t *out_data)
 
 static void imu_task(void *pvParameters)
 {
-    ESP_LOGI(TAG, "IMU task started (smart logging enabled)");
+    ESP_LOGI(TAG, "IMU task started (%s)", g_fifo_enabled ? "FIFO batches" : "polling");
+    
+    static qmi8658a_fixed_data_t batch[DOG_IMU_BATCH_MAX];
+    
+    while (1) {
+        int count;
+        
+        if (s_pause_request) {
+            // Off the sensor until dog_imu_resume
+            s_paused = true;
+            while (s_pause_request) {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+            s_paused = false;
+            continue;
+        }
+        
+        if (g_fifo_enabled) {
+            // Reading the flag unlocked is fine: only this task changes it
+            qmi8658a_fifo_wait(s_power.idle ? DOG_IMU_IDLE_FIFO_TIMEOUT_MS : DOG_IMU_FIFO_TIMEOUT_MS);
+            count = qmi8658a_fifo_read_fixed(batch, DOG_IMU_BATCH_MAX);
+            if (s_motion_engine) {
+                update_power();
+            }
+        } else {
+            count = qmi8658a_read_fixed(&batch[0]) ? 1 : 0;
+            vTaskDelay(pdMS_TO_TICKS(50));  // Read at 20Hz
+        }
+        
+        if (count <= 0) {
+            if (count < 0) {
+                vTaskDelay(pdMS_TO_TICKS(DOG_IMU_FIFO_TIMEOUT_MS));
+            }
+            continue;
+        }
+        
+        dog_imu_cal_feed(batch, count);
+        
+        // Fuse every sample first so balance sees the freshest attitude
+        attitude_update(batch, count);
+        
+        // Publish; consumers never hold up acquisition
+        dog_imu_ring_push(batch, count);
+    }
+}
+
+/**
+ * @brief Low-priority consumer: smart logging of the newest sample
+ */
+static void imu_log_task(void *pvParameters)
+{
     ESP_LOGI(TAG, "Log thresholds: Accel=%.2f m/s², Gyro=%.1f dps",
              DOG_IMU_ACCEL_CHANGE_THRESHOLD, DOG_IMU_GYRO_CHANGE_THRESHOLD);
     
-    qmi8658a_data_t data;
+    qmi8658a_fixed_data_t data;
     
     while (1) {
-        if (dog_imu_read(&data)) {
-            // Check for user interaction reactions first
-            reaction_process_imu(&data);
-            
-            // Log if first reading or significant change
-            if (g_first_log || has_significant_change(&data, &g_last_logged_data)) {
-                ESP_LOGI(TAG, "ACCEL: X=%+7.2f Y=%+7.2f Z=%+7.2f m/s² | GYRO: X=%+7.1f Y=%+7.1f Z=%+7.1f dps",
-                         data.accel_x, data.accel_y, data.accel_z,
-                         data.gyro_x, data.gyro_y, data.gyro_z);
-                
-                g_last_logged_data = data;
-                g_first_log = false;
-            }
+        vTaskDelay(pdMS_TO_TICKS(DOG_IMU_LOG_INTERVAL_MS));
+        
+        if (!dog_imu_ring_latest(&data)) {
+            continue;
         }
         
-        vTaskDelay(pdMS_TO_TICKS(50));  // Read at 20Hz
+        // Log if first reading or significant change
+        if (g_first_log || has_significant_change(&data, &g_last_logged_data)) {
+            ESP_LOGI(TAG, "ACCEL: X=%+7.2f Y=%+7.2f Z=%+7.2f m/s² | GYRO: X=%+7.1f Y=%+7.1f Z=%+7.1f dps",
+                     QMI8658A_Q16_TO_FLOAT(data.accel_x), QMI8658A_Q16_TO_FLOAT(data.accel_y),
+                     QMI8658A_Q16_TO_FLOAT(data.accel_z), QMI8658A_Q16_TO_FLOAT(data.gyro_x),
+                     QMI8658A_Q16_TO_FLOAT(data.gyro_y), QMI8658A_Q16_TO_FLOAT(data.gyro_z));
+            
+            g_last_logged_data = data;
+            g_first_log = false;
+        }
+    }
+}
+
+void dog_imu_set_low_power(bool enabled)
+{
+    portENTER_CRITICAL(&s_power_lock);
+    s_low_power = enabled;
+    portEXIT_CRITICAL(&s_power_lock);
+}
+
+void dog_imu_get_power_stats(dog_imu_power_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    
+    int64_t now_us = esp_timer_get_time();
+    
+    portENTER_CRITICAL(&s_power_lock);
+    *stats = s_power;
+    if (s_power.idle) {
+        stats->idle_ms += (uint32_t)((now_us - s_idle_since_us) / 1000);
+    }
+    portEXIT_CRITICAL(&s_power_lock);
+}
+
+bool dog_imu_pause(void)
+{
+    if (s_imu_task == NULL) {
+        return true;
+    }
+    
+    s_pause_request = true;
+    for (int waited = 0; !s_paused && waited < DOG_IMU_PAUSE_WAIT_MS; waited += portTICK_PERIOD_MS) {
+        vTaskDelay(1);
+    }
+    return s_paused;
+}
+
+void dog_imu_resume(void)
+{
+    if (s_imu_task == NULL) {
+        return;
     }
+    
+    s_pause_request = false;
+    xTaskNotifyGive(s_imu_task);
 }
 
 void dog_imu_task_start(void)
 {
-    xTaskCreate(imu_task, "imu_task", 4096, NULL, 5, NULL);
+    s_imu_task = xTaskCreateStaticPinnedToCore(imu_task, "imu_task", DOG_IMU_TASK_STACK, NULL,
+                                  DOG_IMU_TASK_PRIORITY, s_imu_stack, &s_imu_tcb, DOG_CONTROL_CORE);
+    xTaskCreateStaticPinnedToCore(imu_log_task, "imu_log", DOG_IMU_LOG_TASK_STACK, NULL,
+                                  DOG_IMU_LOG_TASK_PRIORITY, s_log_stack, &s_log_tcb, DOG_COMMS_CORE);
 }
@@ -0,0 +1,259 @@
+/**
+ * @file dog_imu_cal.c
+ * @brief IMU Calibration Implementation
+ * 
+ * The driver's output is averaged, so the mean of each channel is what is
+ * still left over after the calibration in use: adding it to the offsets
+ * refines them, and a calibration never needs raw samples.
+ */
+
+#include "dog_imu_cal.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "IMU_CAL";
+
+#define CHANNELS        6       // accel X Y Z, gyro X Y Z
+#define GRAVITY_Q16     QMI8658A_Q16(9.81f)
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    uint8_t version;
+    uint8_t flags;                  // DOG_IMU_CAL_GYRO / LEVEL parts ever measured
+    qmi8658a_calibration_t cal;
+} stored_cal_t;
+
+// Owned by the IMU task
+static uint8_t s_flags;             // Calibration being collected (0 = none)
+static int s_count;
+static int64_t s_sum[CHANNELS];
+static int32_t s_min[CHANNELS];
+static int32_t s_max[CHANNELS];
+static uint8_t s_stored_flags;
+
+// Shared with other tasks (s_lock)
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t s_pending;           // Queued by dog_imu_cal_start()
+static dog_imu_cal_status_t s_status = DOG_IMU_CAL_STATUS_NONE;
+static qmi8658a_calibration_t s_cal_copy;
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL HELPERS
+// ═══════════════════════════════════════════════════════
+
+static esp_err_t cal_store(const qmi8658a_calibration_t *cal, uint8_t flags)
+{
+    stored_cal_t blob = {
+        .version = DOG_IMU_CAL_VERSION,
+        .flags = flags,
+        .cal = *cal,
+    };
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(DOG_IMU_CAL_NVS_NS, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    ret = nvs_set_blob(handle, DOG_IMU_CAL_NVS_KEY, &blob, sizeof(blob));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return ret;
+}
+
+static void publish(dog_imu_cal_status_t status, const qmi8658a_calibration_t *cal)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_status = status;
+    if (cal) {
+        s_cal_copy = *cal;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void begin(uint8_t flags)
+{
+    s_flags = flags;
+    s_count = 0;
+    for (int c = 0; c < CHANNELS; c++) {
+        s_sum[c] = 0;
+        s_min[c] = INT32_MAX;
+        s_max[c] = INT32_MIN;
+    }
+}
+
+/**
+ * @brief Check the collected samples and apply the new calibration
+ */
+static dog_imu_cal_status_t finish(qmi8658a_calibration_t *cal)
+{
+    const int32_t accel_spread = QMI8658A_Q16(DOG_IMU_CAL_ACCEL_SPREAD);
+    const int32_t gyro_spread = QMI8658A_Q16(DOG_IMU_CAL_GYRO_SPREAD);
+    const int32_t level_tilt = QMI8658A_Q16(DOG_IMU_CAL_LEVEL_TILT);
+    int32_t mean[CHANNELS];
+    
+    for (int c = 0; c < CHANNELS; c++) {
+        int32_t spread = (c < 3) ? accel_spread : gyro_spread;
+        if (s_max[c] - s_min[c] > spread) {
+            ESP_LOGW(TAG, "Sensor moved (channel %d spread %.2f), calibration discarded",
+                     c, QMI8658A_Q16_TO_FLOAT(s_max[c] - s_min[c]));
+            return DOG_IMU_CAL_STATUS_MOVED;
+        }
+        mean[c] = (int32_t)(s_sum[c] / s_count);
+    }
+    
+    if ((s_flags & DOG_IMU_CAL_LEVEL) &&
+        (mean[0] > level_tilt || mean[0] < -level_tilt ||
+         mean[1] > level_tilt || mean[1] < -level_tilt)) {
+        ESP_LOGW(TAG, "Body not level (X %.2f, Y %.2f m/s²), calibration discarded",
+                 QMI8658A_Q16_TO_FLOAT(mean[0]), QMI8658A_Q16_TO_FLOAT(mean[1]));
+        return DOG_IMU_CAL_STATUS_NOT_LEVEL;
+    }
+    
+    qmi8658a_get_calibration(cal);
+    for (int axis = 0; axis < 3; axis++) {
+        if (s_flags & DOG_IMU_CAL_GYRO) {
+            cal->gyro_offset[axis] += mean[3 + axis];
+        }
+        if (s_flags & DOG_IMU_CAL_LEVEL) {
+            cal->accel_offset[axis] += mean[axis] - (axis == 2 ? GRAVITY_Q16 : 0);
+        }
+    }
+    qmi8658a_set_calibration(cal);
+    
+    ESP_LOGI(TAG, "Gyro offsets %+.2f %+.2f %+.2f dps, accel offsets %+.2f %+.2f %+.2f m/s²",
+             QMI8658A_Q16_TO_FLOAT(cal->gyro_offset[0]), QMI8658A_Q16_TO_FLOAT(cal->gyro_offset[1]),
+             QMI8658A_Q16_TO_FLOAT(cal->gyro_offset[2]), QMI8658A_Q16_TO_FLOAT(cal->accel_offset[0]),
+             QMI8658A_Q16_TO_FLOAT(cal->accel_offset[1]), QMI8658A_Q16_TO_FLOAT(cal->accel_offset[2]));
+    
+    if (s_flags & DOG_IMU_CAL_STORE) {
+        s_stored_flags |= s_flags & (DOG_IMU_CAL_GYRO | DOG_IMU_CAL_LEVEL);
+        esp_err_t ret = cal_store(cal, s_stored_flags);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to store calibration: %s", esp_err_to_name(ret));
+            return DOG_IMU_CAL_STATUS_STORE_FAILED;
+        }
+    }
+    return DOG_IMU_CAL_STATUS_DONE;
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+esp_err_t dog_imu_cal_load(void)
+{
+    stored_cal_t blob;
+    size_t size = sizeof(blob);
+    nvs_handle_t handle;
+    
+    qmi8658a_get_calibration(&s_cal_copy);
+    
+    esp_err_t ret = nvs_open(DOG_IMU_CAL_NVS_NS, NVS_READONLY, &handle);
+    if (ret != ESP_OK) {
+        return (ret == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : ret;
+    }
+    ret = nvs_get_blob(handle, DOG_IMU_CAL_NVS_KEY, &blob, &size);
+    nvs_close(handle);
+    
+    if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (size != sizeof(blob) || blob.version != DOG_IMU_CAL_VERSION) {
+        ESP_LOGW(TAG, "Ignoring stored calibration (size %u, version %u)", (unsigned)size, blob.version);
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    qmi8658a_set_calibration(&blob.cal);
+    s_stored_flags = blob.flags;
+    publish(DOG_IMU_CAL_STATUS_NONE, &blob.cal);
+    ESP_LOGI(TAG, "Loaded calibration (%s%s)", (blob.flags & DOG_IMU_CAL_GYRO) ? "gyro " : "",
+             (blob.flags & DOG_IMU_CAL_LEVEL) ? "level" : "");
+    return ESP_OK;
+}
+
+bool dog_imu_cal_start(uint8_t flags)
+{
+    bool started = false;
+    
+    if (!(flags & (DOG_IMU_CAL_GYRO | DOG_IMU_CAL_LEVEL))) {
+        return false;
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    if (s_status != DOG_IMU_CAL_STATUS_RUNNING) {
+        s_pending = flags;
+        s_status = DOG_IMU_CAL_STATUS_RUNNING;
+        started = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    
+    return started;
+}
+
+void dog_imu_cal_feed(const qmi8658a_fixed_data_t *samples, int count)
+{
+    if (s_flags == 0) {
+        portENTER_CRITICAL(&s_lock);
+        uint8_t pending = s_pending;
+        s_pending = 0;
+        portEXIT_CRITICAL(&s_lock);
+        
+        if (pending == 0) {
+            return;
+        }
+        begin(pending);
+    }
+    
+    for (int i = 0; i < count && s_count < DOG_IMU_CAL_SAMPLES; i++) {
+        const qmi8658a_fixed_data_t *s = &samples[i];
+        const int32_t v[CHANNELS] = {
+            s->accel_x, s->accel_y, s->accel_z, s->gyro_x, s->gyro_y, s->gyro_z
+        };
+        for (int c = 0; c < CHANNELS; c++) {
+            s_sum[c] += v[c];
+            if (v[c] < s_min[c]) s_min[c] = v[c];
+            if (v[c] > s_max[c]) s_max[c] = v[c];
+        }
+        s_count++;
+    }
+    if (s_count < DOG_IMU_CAL_SAMPLES) {
+        return;
+    }
+    
+    qmi8658a_calibration_t cal;
+    dog_imu_cal_status_t status = finish(&cal);
+    s_flags = 0;
+    publish(status, (status == DOG_IMU_CAL_STATUS_MOVED || status == DOG_IMU_CAL_STATUS_NOT_LEVEL)
+                    ? NULL : &cal);
+}
+
+bool dog_imu_cal_is_running(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    bool running = (s_status == DOG_IMU_CAL_STATUS_RUNNING);
+    portEXIT_CRITICAL(&s_lock);
+    
+    return running;
+}
+
+dog_imu_cal_status_t dog_imu_cal_get_status(qmi8658a_calibration_t *cal)
+{
+    portENTER_CRITICAL(&s_lock);
+    dog_imu_cal_status_t status = s_status;
+    if (cal) {
+        *cal = s_cal_copy;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    
+    return status;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file dog_imu_cal.h
+ * @brief IMU Calibration
+ * 
+ * Averages DOG_IMU_CAL_SAMPLES of the still sensor and hands the result to
+ * the driver, which subtracts it in the Q16.16 conversion, so every IMU
+ * consumer sees corrected samples:
+ *   - GYRO:  per-axis zero-rate offsets (the bias a still gyro reads)
+ *   - LEVEL: per-axis accel offsets, assuming the body stands level:
+ *            X and Y should read 0 and Z +1 g
+ * 
+ * The samples come from the IMU task (dog_imu_cal_feed), so starting a
+ * calibration from another task only queues it. A calibration that sees
+ * the sensor move is thrown away and the previous one stays in use.
+ * 
+ * Offsets and per-axis accel scales are stored in NVS and applied at
+ * boot; the gyro bias is then re-estimated (not stored) if the robot
+ * holds still for the first moment, since it wanders with temperature.
+ */
+
+#ifndef DOG_IMU_CAL_H
+#define DOG_IMU_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "qmi8658a.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define DOG_IMU_CAL_NVS_NS          "dog"
+#define DOG_IMU_CAL_NVS_KEY         "imu_cal"
+#define DOG_IMU_CAL_VERSION         1
+#define DOG_IMU_CAL_SAMPLES         256     // Averaged per calibration (~0.6 s at 448 Hz)
+#define DOG_IMU_CAL_GYRO_SPREAD     3.0f    // dps; max - min of a gyro axis a still sensor stays within
+#define DOG_IMU_CAL_ACCEL_SPREAD    0.5f    // m/s², same for an accel axis
+#define DOG_IMU_CAL_LEVEL_TILT      2.0f    // m/s² of gravity on X or Y still accepted as level (~12°)
+#define DOG_IMU_CAL_AT_BOOT         1       // Re-estimate the gyro bias at boot
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef enum {
+    DOG_IMU_CAL_GYRO  = 1 << 0,     // Gyro zero-rate offsets
+    DOG_IMU_CAL_LEVEL = 1 << 1,     // Accel offsets (body level)
+    DOG_IMU_CAL_STORE = 1 << 2,     // Write the result to NVS
+} dog_imu_cal_flags_t;
+
+typedef enum {
+    DOG_IMU_CAL_STATUS_NONE,        // Nothing measured since boot
+    DOG_IMU_CAL_STATUS_RUNNING,
+    DOG_IMU_CAL_STATUS_DONE,
+    DOG_IMU_CAL_STATUS_MOVED,       // Sensor moved, result discarded
+    DOG_IMU_CAL_STATUS_NOT_LEVEL,   // LEVEL asked for but the body is tilted
+    DOG_IMU_CAL_STATUS_STORE_FAILED,    // Applied, but not written to NVS
+} dog_imu_cal_status_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Apply the calibration stored in NVS (after qmi8658a_init)
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if nothing valid is stored, or an NVS error
+ */
+esp_err_t dog_imu_cal_load(void);
+
+/**
+ * @brief Queue a calibration over the next samples (any task)
+ * @param flags dog_imu_cal_flags_t bits
+ * @return false if one is already running
+ */
+bool dog_imu_cal_start(uint8_t flags);
+
+/**
+ * @brief Feed converted samples (IMU task, every batch)
+ */
+void dog_imu_cal_feed(const qmi8658a_fixed_data_t *samples, int count);
+
+/**
+ * @brief True while a calibration is queued or collecting samples
+ */
+bool dog_imu_cal_is_running(void);
+
+/**
+ * @brief Outcome of the last calibration and the calibration in use
+ * @param cal Output, may be NULL
+ */
+dog_imu_cal_status_t dog_imu_cal_get_status(qmi8658a_calibration_t *cal);
+
+#endif // DOG_IMU_CAL_H
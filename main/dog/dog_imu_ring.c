@@ -0,0 +1,151 @@
+/**
+ * @file dog_imu_ring.c
+ * @brief IMU Sample Ring Implementation
+ * 
+ * Two counters bracket the producer's writes, seqlock style: s_reserve
+ * is raised before slots are overwritten and s_head after they are
+ * complete. Readers copy what s_head says is published, then re-check
+ * s_reserve to throw away any slot the producer started reusing
+ * mid-copy. Nobody takes a lock and the producer never waits.
+ */
+
+#include "dog_imu_ring.h"
+#include <stdatomic.h>
+#include <string.h>
+
+#define RING_MASK   (DOG_IMU_RING_CAPACITY - 1)
+
+_Static_assert((DOG_IMU_RING_CAPACITY & RING_MASK) == 0, "DOG_IMU_RING_CAPACITY must be a power of two");
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static qmi8658a_fixed_data_t s_samples[DOG_IMU_RING_CAPACITY];
+static atomic_uint s_head;          // Samples fully written
+static atomic_uint s_reserve;       // Samples the producer has started writing
+
+// ═══════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Number of samples from seq onward that may have been overwritten
+ * 
+ * Call after copying; the acquire fence orders the copy before the check.
+ */
+static uint32_t overwritten_since(uint32_t seq)
+{
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t reserve = atomic_load_explicit(&s_reserve, memory_order_relaxed);
+    uint32_t oldest_intact = reserve - DOG_IMU_RING_CAPACITY;
+    
+    if ((int32_t)(oldest_intact - seq) > 0) {
+        return oldest_intact - seq;
+    }
+    return 0;
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+void dog_imu_ring_push(const qmi8658a_fixed_data_t *samples, int count)
+{
+    if (samples == NULL || count <= 0) {
+        return;
+    }
+    
+    // Only the newest CAPACITY samples of an oversized batch can survive
+    if (count > DOG_IMU_RING_CAPACITY) {
+        samples += count - DOG_IMU_RING_CAPACITY;
+        count = DOG_IMU_RING_CAPACITY;
+    }
+    
+    uint32_t head = atomic_load_explicit(&s_head, memory_order_relaxed);
+    
+    // Announce the slots about to be reused before touching them
+    atomic_store_explicit(&s_reserve, head + count, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    
+    for (int i = 0; i < count; i++) {
+        s_samples[(head + i) & RING_MASK] = samples[i];
+    }
+    
+    atomic_store_explicit(&s_head, head + count, memory_order_release);
+}
+
+void dog_imu_ring_reader_init(dog_imu_ring_reader_t *reader)
+{
+    if (reader == NULL) {
+        return;
+    }
+    
+    reader->cursor = atomic_load_explicit(&s_head, memory_order_acquire);
+    reader->dropped = 0;
+}
+
+int dog_imu_ring_read(dog_imu_ring_reader_t *reader, qmi8658a_fixed_data_t *out, int max_samples)
+{
+    if (reader == NULL || out == NULL || max_samples <= 0) {
+        return 0;
+    }
+    
+    uint32_t head = atomic_load_explicit(&s_head, memory_order_acquire);
+    uint32_t cursor = reader->cursor;
+    uint32_t available = head - cursor;
+    
+    // Lapped: skip to the oldest sample still in the ring
+    if (available > DOG_IMU_RING_CAPACITY) {
+        reader->dropped += available - DOG_IMU_RING_CAPACITY;
+        cursor = head - DOG_IMU_RING_CAPACITY;
+        available = DOG_IMU_RING_CAPACITY;
+    }
+    
+    uint32_t n = (available < (uint32_t)max_samples) ? available : (uint32_t)max_samples;
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = s_samples[(cursor + i) & RING_MASK];
+    }
+    
+    // Drop the front of the copy if the producer lapped us meanwhile
+    uint32_t lost = overwritten_since(cursor);
+    if (lost >= n) {
+        reader->dropped += lost;
+        reader->cursor = cursor + lost;
+        return 0;
+    }
+    if (lost > 0) {
+        memmove(out, out + lost, (n - lost) * sizeof(out[0]));
+        reader->dropped += lost;
+    }
+    
+    reader->cursor = cursor + n;
+    return (int)(n - lost);
+}
+
+bool dog_imu_ring_latest(qmi8658a_fixed_data_t *out)
+{
+    if (out == NULL) {
+        return false;
+    }
+    
+    // A retry only happens if the producer laps the whole ring mid-copy
+    for (int attempt = 0; attempt < 3; attempt++) {
+        uint32_t head = atomic_load_explicit(&s_head, memory_order_acquire);
+        if (head == 0) {
+            return false;
+        }
+        
+        *out = s_samples[(head - 1) & RING_MASK];
+        if (overwritten_since(head - 1) == 0) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+uint32_t dog_imu_ring_total(void)
+{
+    return atomic_load_explicit(&s_head, memory_order_relaxed);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file dog_imu_ring.h
+ * @brief IMU Sample Ring (single producer, multiple consumers)
+ * 
+ * The IMU task pushes every FIFO sample here and never waits on anyone.
+ * Each consumer (balance, reactions, logging, telemetry) owns a reader
+ * cursor and drains at its own pace. A consumer that falls more than
+ * DOG_IMU_RING_CAPACITY samples behind loses the oldest ones; the count
+ * is kept in its reader rather than slowing the producer down.
+ */
+
+#ifndef DOG_IMU_RING_H
+#define DOG_IMU_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "qmi8658a.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define DOG_IMU_RING_CAPACITY   128     // Samples (power of two), ~285 ms at 448 Hz
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Per-consumer read position (owned by the consumer)
+ */
+typedef struct {
+    uint32_t cursor;            // Sequence number of the next sample to read
+    uint32_t dropped;           // Samples overwritten before this reader got to them
+} dog_imu_ring_reader_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Publish samples (IMU task only)
+ * @param samples Q16.16 samples, oldest first
+ * @param count Number of samples
+ */
+void dog_imu_ring_push(const qmi8658a_fixed_data_t *samples, int count);
+
+/**
+ * @brief Start a reader at the newest sample (older samples are skipped)
+ * @param reader Reader to initialize
+ */
+void dog_imu_ring_reader_init(dog_imu_ring_reader_t *reader);
+
+/**
+ * @brief Copy unread samples, oldest first
+ * @param reader Consumer cursor (advanced past the returned samples)
+ * @param out Output buffer
+ * @param max_samples Capacity of out
+ * @return Number of samples copied (0 if nothing new)
+ */
+int dog_imu_ring_read(dog_imu_ring_reader_t *reader, qmi8658a_fixed_data_t *out, int max_samples);
+
+/**
+ * @brief Copy the newest sample without a cursor
+ * @param out Output sample
+ * @return false if nothing has been published yet
+ */
+bool dog_imu_ring_latest(qmi8658a_fixed_data_t *out);
+
+/**
+ * @brief Total samples published since boot
+ */
+uint32_t dog_imu_ring_total(void);
+
+#endif // DOG_IMU_RING_H
@@ -0,0 +1,90 @@
+/**
+ * @file dog_kinematics.c
+ * @brief Leg Kinematics Implementation
+ */
+
+#include "dog_kinematics.h"
+#include "dog_config.h"
+#include <math.h>
+
+#define DEG_TO_RAD      0.017453293f
+#define RAD_TO_DEG      57.29577951f
+
+// ═══════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════
+
+static float clampf(float v, float lo, float hi, bool *clamped)
+{
+    if (v < lo) {
+        *clamped = true;
+        return lo;
+    }
+    if (v > hi) {
+        *clamped = true;
+        return hi;
+    }
+    return v;
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool dog_leg_ik(const dog_leg_geometry_t *leg, float x_mm, float z_mm, dog_leg_joints_t *joints)
+{
+    bool clamped = false;
+    
+    // Direction from the hip axis to the foot, 0 = straight down
+    float aim = atan2f(x_mm, -z_mm);
+    
+    if (leg->joints < 2) {
+        joints->hip_deg = clampf(aim * RAD_TO_DEG, -leg->hip_limit_deg, leg->hip_limit_deg, &clamped);
+        joints->knee_deg = 0.0f;
+        return !clamped && z_mm < 0.0f;
+    }
+    
+    // Law of cosines on the hip-knee-foot triangle
+    float a = leg->upper_mm;
+    float b = leg->lower_mm;
+    float c = (x_mm * x_mm + z_mm * z_mm - a * a - b * b) / (2.0f * a * b);
+    c = clampf(c, -1.0f, 1.0f, &clamped);
+    
+    float knee = clampf(acosf(c) * RAD_TO_DEG, leg->knee_min_deg, leg->knee_max_deg, &clamped);
+    float k = knee * DEG_TO_RAD;
+    float hip = aim - atan2f(b * sinf(k), a + b * cosf(k));
+    
+    joints->hip_deg = clampf(hip * RAD_TO_DEG, -leg->hip_limit_deg, leg->hip_limit_deg, &clamped);
+    joints->knee_deg = knee;
+    return !clamped;
+}
+
+void dog_leg_fk(const dog_leg_geometry_t *leg, const dog_leg_joints_t *joints,
+                float *x_mm, float *z_mm)
+{
+    float h = joints->hip_deg * DEG_TO_RAD;
+    float x = leg->upper_mm * sinf(h);
+    float z = -leg->upper_mm * cosf(h);
+    
+    if (leg->joints >= 2) {
+        float hk = h + joints->knee_deg * DEG_TO_RAD;
+        x += leg->lower_mm * sinf(hk);
+        z -= leg->lower_mm * cosf(hk);
+    }
+    
+    *x_mm = x;
+    *z_mm = z;
+}
+
+bool dog_foot_to_angle(uint8_t servo_id, float x_mm, float z_mm, float *angle)
+{
+    const dog_config_t *config = dog_get_config();
+    dog_leg_joints_t joints;
+    
+    bool exact = dog_leg_ik(&config->leg, x_mm, z_mm, &joints);
+    float stance = DOG_IS_FRONT_LEG(servo_id) ? config->stance_front : config->stance_back;
+    
+    // Forward is a positive offset from stance on every leg (before reversal)
+    *angle = stance + joints.hip_deg;
+    return exact;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file dog_kinematics.h
+ * @brief Leg Kinematics
+ * 
+ * Closed-form inverse and forward kinematics of one planar leg, so BLE
+ * clients and gaits can place feet instead of turning servos. Foot
+ * positions are in mm in the leg's sagittal plane, measured from the hip
+ * axis: x forward, z up (a foot on the ground has z < 0).
+ * 
+ * Joint angles are in degrees:
+ *   hip  - upper leg from straight down, positive = forward
+ *   knee - lower leg bend relative to the upper leg (0 = straight)
+ * 
+ * A one-joint leg (this robot: one hip servo per leg) can only point its
+ * foot, not set its height: the IK aims the leg at (x, z) and ignores the
+ * distance. A two-joint leg solves hip and knee with the law of cosines.
+ * Knee angles are computed but not driven yet; there are no knee servos.
+ * 
+ * One solve is a few float operations and two atan2f, well within a
+ * control tick for 12 joints (dog_bench reports leg_ik_4).
+ */
+
+#ifndef DOG_KINEMATICS_H
+#define DOG_KINEMATICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+// Default geometry (MicroPupper: rigid leg, one hip servo)
+#define DOG_LEG_JOINTS              1
+#define DOG_LEG_UPPER_MM            40.0f   // Hip axis to knee (to foot with one joint)
+#define DOG_LEG_LOWER_MM            0.0f    // Knee to foot
+#define DOG_LEG_HEIGHT_MM           40.0f   // Hip axis above the ground at stance
+#define DOG_LEG_HIP_LIMIT_DEG       90.0f   // Largest |hip| the IK returns
+#define DOG_LEG_KNEE_MIN_DEG        0.0f
+#define DOG_LEG_KNEE_MAX_DEG        150.0f
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    uint8_t joints;             ///< 1 = hip only, 2 = hip + knee
+    float upper_mm;             ///< Hip axis to knee (to foot with one joint)
+    float lower_mm;             ///< Knee to foot (two joints only)
+    float height_mm;            ///< Hip axis above the ground at stance
+    float hip_limit_deg;        ///< Largest |hip| angle
+    float knee_min_deg;
+    float knee_max_deg;
+} dog_leg_geometry_t;
+
+typedef struct {
+    float hip_deg;
+    float knee_deg;             ///< 0 with one joint
+} dog_leg_joints_t;
+
+/**
+ * @brief Default leg geometry
+ */
+#define DOG_LEG_DEFAULT_GEOMETRY() {            \
+    .joints = DOG_LEG_JOINTS,                   \
+    .upper_mm = DOG_LEG_UPPER_MM,               \
+    .lower_mm = DOG_LEG_LOWER_MM,               \
+    .height_mm = DOG_LEG_HEIGHT_MM,             \
+    .hip_limit_deg = DOG_LEG_HIP_LIMIT_DEG,     \
+    .knee_min_deg = DOG_LEG_KNEE_MIN_DEG,       \
+    .knee_max_deg = DOG_LEG_KNEE_MAX_DEG        \
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Joint angles that put the foot at (x, z)
+ * 
+ * Out-of-reach targets and joint limits are clamped: joints always holds
+ * the closest pose, and the return value says whether it is exact.
+ * 
+ * @param leg Geometry
+ * @param x_mm Foot forward of the hip axis
+ * @param z_mm Foot above the hip axis (negative below)
+ * @param joints Output angles
+ * @return false if the target was out of reach or past a joint limit
+ */
+bool dog_leg_ik(const dog_leg_geometry_t *leg, float x_mm, float z_mm, dog_leg_joints_t *joints);
+
+/**
+ * @brief Foot position of a pose (inverse of dog_leg_ik)
+ */
+void dog_leg_fk(const dog_leg_geometry_t *leg, const dog_leg_joints_t *joints,
+                float *x_mm, float *z_mm);
+
+/**
+ * @brief Hip servo angle that puts a leg's foot at (x, z)
+ * 
+ * Uses the geometry and stance angles of the active dog configuration.
+ * x = 0, z = -height_mm is the stance pose.
+ * 
+ * @param servo_id Servo ID (1-4)
+ * @param angle Output angle from the left-side perspective (reversed by dog_servo_move)
+ * @return false if the target was clamped (angle still holds the closest pose)
+ */
+bool dog_foot_to_angle(uint8_t servo_id, float x_mm, float z_mm, float *angle);
+
+#endif // DOG_KINEMATICS_H
@@ -0,0 +1,353 @@
+/**
+ * @file dog_params.c
+ * @brief Live Tuning Parameter Registry Implementation
+ * 
+ * The registry is a table of field offsets into dog_params_t, so get, set,
+ * range checks and NVS all work on one struct. Writers only touch the
+ * pending set (s_lock); the active set is written by the latch, which
+ * runs in the control loop task, so the clients that read it never race
+ * a copy.
+ */
+
+#include "dog_params.h"
+#include "gyro_balance.h"
+#include "trot_gait.h"
+#include "walk_gait.h"
+#include "creep_gait.h"
+#include "crawl_gait.h"
+#include "control_loop.h"
+#include "dog_trace.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+static const char *TAG = "PARAMS";
+
+#define GAIT_FIELD(t, f)    (offsetof(dog_params_t, gait) + (t) * sizeof(dog_gait_params_t) + \
+                             offsetof(dog_gait_params_t, f))
+#define BAL_FIELD(f)        (offsetof(dog_params_t, balance) + offsetof(dog_balance_params_t, f))
+
+#define GAIT_PARAMS(t, name)                                                                    \
+    { name ".step_ms", DOG_PARAM_U16,   GAIT_FIELD(t, step_duration_ms), 50.0f, 2000.0f },      \
+    { name ".amp",     DOG_PARAM_FLOAT, GAIT_FIELD(t, swing_amplitude),  0.0f,  90.0f },        \
+    { name ".speed",   DOG_PARAM_U16,   GAIT_FIELD(t, servo_speed),      0.0f,  DOG_SPEED_MAX }
+
+static const dog_param_info_t s_info[] = {
+    GAIT_PARAMS(GAIT_TYPE_TROT,  "trot"),
+    GAIT_PARAMS(GAIT_TYPE_WALK,  "walk"),
+    GAIT_PARAMS(GAIT_TYPE_CREEP, "creep"),
+    GAIT_PARAMS(GAIT_TYPE_CRAWL, "crawl"),
+    { "bal.kp",       DOG_PARAM_FLOAT, BAL_FIELD(kp),             0.0f,   10.0f },
+    { "bal.kd",       DOG_PARAM_FLOAT, BAL_FIELD(kd),             0.0f,   2.0f },
+    { "bal.dz",       DOG_PARAM_FLOAT, BAL_FIELD(deadzone),       0.0f,   20.0f },
+    { "bal.rate_hz",  DOG_PARAM_FLOAT, BAL_FIELD(rate_cutoff_hz), 0.5f,   50.0f },
+    { "bal.front",    DOG_PARAM_FLOAT, BAL_FIELD(front_gain),     0.0f,   4.0f },
+    { "bal.back",     DOG_PARAM_FLOAT, BAL_FIELD(back_gain),      0.0f,   4.0f },
+    { "bal.pitch0",   DOG_PARAM_FLOAT, BAL_FIELD(pitch_offset),   -30.0f, 30.0f },
+    { "bal.max",      DOG_PARAM_FLOAT, BAL_FIELD(max_correction), 0.0f,   GYRO_BALANCE_MAX_CORRECTION },
+    { "bal.stance_f", DOG_PARAM_FLOAT, BAL_FIELD(stance_front),   0.0f,   360.0f },
+    { "bal.stance_b", DOG_PARAM_FLOAT, BAL_FIELD(stance_back),    0.0f,   360.0f },
+};
+
+#define PARAM_COUNT     ((int)(sizeof(s_info) / sizeof(s_info[0])))
+
+_Static_assert(PARAM_COUNT <= DOG_PARAMS_BATCH_MAX, "dog_params_load sets every parameter in one batch");
+
+// The balance defaults are constants, so gyro_balance can run before
+// dog_params_init (the gait part is filled in by it)
+#define BALANCE_DEFAULTS() {                                \
+    .kp = GYRO_BALANCE_KP,                                  \
+    .kd = GYRO_BALANCE_KD,                                  \
+    .deadzone = GYRO_BALANCE_DEADZONE,                      \
+    .rate_cutoff_hz = GYRO_BALANCE_RATE_CUTOFF_HZ,          \
+    .front_gain = GYRO_BALANCE_FRONT_GAIN,                  \
+    .back_gain = GYRO_BALANCE_BACK_GAIN,                    \
+    .pitch_offset = GYRO_BALANCE_PITCH_OFFSET,              \
+    .max_correction = GYRO_BALANCE_MAX_CORRECTION,          \
+    .stance_front = DOG_STANCE_FRONT,                       \
+    .stance_back = DOG_STANCE_BACK,                         \
+}
+
+typedef struct {
+    uint8_t version;
+    dog_params_t params;
+} stored_params_t;
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+// Shared with writers (s_lock)
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static dog_params_t s_pending = { .balance = BALANCE_DEFAULTS() };
+static volatile uint32_t s_pending_seq;     // Bumped by every accepted batch
+
+// Written by the latch (control loop task), read by control loop clients
+static dog_params_t s_active = { .balance = BALANCE_DEFAULTS() };
+static uint32_t s_active_seq;
+static volatile uint32_t s_generation;
+
+static int s_loop_client = -1;
+
+// ═══════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════
+
+static void *field(dog_params_t *params, int id)
+{
+    return (uint8_t *)params + s_info[id].offset;
+}
+
+static void write_value(dog_params_t *params, int id, float value)
+{
+    if (s_info[id].type == DOG_PARAM_U16) {
+        *(uint16_t *)field(params, id) = (uint16_t)lroundf(value);
+    } else {
+        *(float *)field(params, id) = value;
+    }
+}
+
+static bool value_ok(int id, float value)
+{
+    return id >= 0 && id < PARAM_COUNT && !isnan(value) &&
+           value >= s_info[id].min && value <= s_info[id].max;
+}
+
+/**
+ * @brief Copy the pending set into the active one if it changed
+ */
+static void latch(void)
+{
+    if (s_pending_seq == s_active_seq) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    s_active = s_pending;
+    s_active_seq = s_pending_seq;
+    portEXIT_CRITICAL(&s_lock);
+    
+    s_generation++;
+    DOG_TRACE(DOG_TRACE_PARAMS, 0, s_generation);
+}
+
+/**
+ * @brief Control loop tick: take a staged batch at the tick boundary
+ */
+static void latch_tick(void *ctx, int64_t tick_us)
+{
+    latch();
+}
+
+/**
+ * @brief Without a running loop nothing reads the active set; apply now
+ */
+static void latch_if_idle(void)
+{
+    if (s_loop_client < 0 || !control_loop_is_running()) {
+        latch();
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool dog_params_init(void)
+{
+    if (s_loop_client >= 0) {
+        return true;
+    }
+    
+    static const gait_ops_t *const ops[GAIT_TYPE_COUNT] = {
+        [GAIT_TYPE_TROT]  = &TROT_GAIT_OPS,
+        [GAIT_TYPE_WALK]  = &WALK_GAIT_OPS,
+        [GAIT_TYPE_CREEP] = &CREEP_GAIT_OPS,
+        [GAIT_TYPE_CRAWL] = &CRAWL_GAIT_OPS,
+    };
+    for (int t = 0; t < GAIT_TYPE_COUNT; t++) {
+        dog_params_set_gait((gait_type_t)t, &ops[t]->default_config);
+    }
+    
+    s_loop_client = control_loop_register("params", latch_tick, NULL);
+    if (s_loop_client < 0) {
+        ESP_LOGE(TAG, "Failed to register with control loop");
+        return false;
+    }
+    if (s_loop_client > 0) {
+        ESP_LOGW(TAG, "Latch in slot %d: clients registered earlier see batches a tick late",
+                 s_loop_client);
+    }
+    
+    ESP_LOGI(TAG, "%d tunable parameters", PARAM_COUNT);
+    return true;
+}
+
+esp_err_t dog_params_load(void)
+{
+    stored_params_t blob;
+    size_t size = sizeof(blob);
+    nvs_handle_t handle;
+    
+    esp_err_t ret = nvs_open(DOG_PARAMS_NVS_NS, NVS_READONLY, &handle);
+    if (ret != ESP_OK) {
+        return (ret == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : ret;
+    }
+    ret = nvs_get_blob(handle, DOG_PARAMS_NVS_KEY, &blob, &size);
+    nvs_close(handle);
+    
+    if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (size != sizeof(blob) || blob.version != DOG_PARAMS_VERSION) {
+        ESP_LOGW(TAG, "Ignoring stored parameters (size %u, version %u)", (unsigned)size, blob.version);
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    // Through the range checks, in case they tightened since the store
+    dog_param_value_t values[PARAM_COUNT];
+    for (int id = 0; id < PARAM_COUNT; id++) {
+        values[id].id = id;
+        values[id].value = dog_params_read(&blob.params, id);
+    }
+    int bad;
+    if (!dog_params_set(values, PARAM_COUNT, &bad)) {
+        ESP_LOGW(TAG, "Ignoring stored parameters (%s out of range)", s_info[bad].name);
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    ESP_LOGI(TAG, "Loaded stored parameters");
+    return ESP_OK;
+}
+
+esp_err_t dog_params_save(void)
+{
+    stored_params_t blob = { .version = DOG_PARAMS_VERSION };
+    dog_params_get(&blob.params);
+    
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(DOG_PARAMS_NVS_NS, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    ret = nvs_set_blob(handle, DOG_PARAMS_NVS_KEY, &blob, sizeof(blob));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return ret;
+}
+
+bool dog_params_set(const dog_param_value_t *values, int count, int *bad)
+{
+    if (values == NULL || count < 0) {
+        return false;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        if (!value_ok(values[i].id, values[i].value)) {
+            if (bad) {
+                *bad = i;
+            }
+            return false;
+        }
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < count; i++) {
+        write_value(&s_pending, values[i].id, values[i].value);
+    }
+    s_pending_seq++;
+    portEXIT_CRITICAL(&s_lock);
+    
+    latch_if_idle();
+    return true;
+}
+
+void dog_params_set_gait(gait_type_t type, const gait_config_t *config)
+{
+    if (type >= GAIT_TYPE_COUNT || config == NULL) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    s_pending.gait[type] = (dog_gait_params_t) {
+        .swing_amplitude = config->swing_amplitude,
+        .step_duration_ms = config->step_duration_ms,
+        .servo_speed = config->servo_speed,
+    };
+    s_pending_seq++;
+    portEXIT_CRITICAL(&s_lock);
+    
+    latch_if_idle();
+}
+
+const dog_params_t *dog_params_active(void)
+{
+    return &s_active;
+}
+
+void dog_params_get(dog_params_t *params)
+{
+    if (params == NULL) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    *params = s_pending;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void dog_params_apply_gait(const dog_params_t *params, gait_type_t type, gait_config_t *config)
+{
+    const dog_gait_params_t *g = &params->gait[type];
+    config->swing_amplitude = g->swing_amplitude;
+    config->step_duration_ms = g->step_duration_ms;
+    config->servo_speed = g->servo_speed;
+}
+
+int dog_params_count(void)
+{
+    return PARAM_COUNT;
+}
+
+const dog_param_info_t *dog_params_info(int id)
+{
+    return (id >= 0 && id < PARAM_COUNT) ? &s_info[id] : NULL;
+}
+
+int dog_params_find(const char *name)
+{
+    if (name == NULL) {
+        return -1;
+    }
+    
+    for (int id = 0; id < PARAM_COUNT; id++) {
+        if (strcmp(name, s_info[id].name) == 0) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+float dog_params_read(const dog_params_t *params, int id)
+{
+    if (id < 0 || id >= PARAM_COUNT) {
+        return 0.0f;
+    }
+    
+    const void *p = (const uint8_t *)params + s_info[id].offset;
+    return (s_info[id].type == DOG_PARAM_U16) ? (float)*(const uint16_t *)p : *(const float *)p;
+}
+
+uint32_t dog_params_generation(void)
+{
+    return s_generation;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file dog_params.h
+ * @brief Live Tuning Parameter Registry
+ * 
+ * Named, range-checked parameters for the gait configs (step duration,
+ * stroke, servo speed per gait) and the balance loop (gains, deadzone,
+ * stance), so they can be swept over BLE without a rebuild.
+ * 
+ * The values are double-buffered:
+ *   - Writers (any task) stage a whole batch at once: every value is
+ *     checked first, and either all of them go into the pending set or
+ *     none do.
+ *   - A control loop client copies the pending set into the active one.
+ *     Clients run in slot order, so the latch must hold the first slot:
+ *     dog_params_init() is called right after control_loop_start(),
+ *     before any reader registers. Every client that reads the active
+ *     set (dog_params_active) then sees a batch from the same tick on,
+ *     and never half of one. A reader registered before the latch would
+ *     see it one tick late (logged at init).
+ * 
+ * The pending set can be stored in NVS and loaded at boot.
+ * 
+ *   dog_param_value_t batch[] = {
+ *       { dog_params_find("trot.step_ms"), 180 },
+ *       { dog_params_find("trot.amp"), 28 },
+ *   };
+ *   dog_params_set(batch, 2, NULL);      // Both from the same tick on
+ */
+
+#ifndef DOG_PARAMS_H
+#define DOG_PARAMS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "gait_manager.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define DOG_PARAMS_NVS_NS           "dog"
+#define DOG_PARAMS_NVS_KEY          "params"
+#define DOG_PARAMS_VERSION          1
+#define DOG_PARAMS_BATCH_MAX        32      // Values per dog_params_set() from BLE
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Tunable part of one gait config (the rest stays in gait_manager)
+ */
+typedef struct {
+    float swing_amplitude;      ///< "<gait>.amp", degrees
+    uint16_t step_duration_ms;  ///< "<gait>.step_ms"
+    uint16_t servo_speed;       ///< "<gait>.speed", 0-4095
+} dog_gait_params_t;
+
+/**
+ * @brief Balance loop (defaults from gyro_balance.h)
+ */
+typedef struct {
+    float kp;                   ///< "bal.kp", leg degrees per degree of tilt
+    float kd;                   ///< "bal.kd", leg degrees per °/s of pitch rate
+    float deadzone;             ///< "bal.dz", pitch-rate deadzone (°/s)
+    float rate_cutoff_hz;       ///< "bal.rate_hz", D-term low-pass cutoff
+    float front_gain;           ///< "bal.front"
+    float back_gain;            ///< "bal.back"
+    float pitch_offset;         ///< "bal.pitch0", pitch of the level body (degrees)
+    float max_correction;       ///< "bal.max", degrees from stance
+    float stance_front;         ///< "bal.stance_f", unified angle the correction is added to
+    float stance_back;          ///< "bal.stance_b"
+} dog_balance_params_t;
+
+typedef struct {
+    dog_gait_params_t gait[GAIT_TYPE_COUNT];
+    dog_balance_params_t balance;
+} dog_params_t;
+
+typedef enum {
+    DOG_PARAM_FLOAT,
+    DOG_PARAM_U16,
+} dog_param_type_t;
+
+/**
+ * @brief One registry entry
+ */
+typedef struct {
+    const char *name;
+    dog_param_type_t type;
+    uint16_t offset;            ///< Field offset in dog_params_t
+    float min;
+    float max;
+} dog_param_info_t;
+
+/**
+ * @brief One value of a batch
+ */
+typedef struct {
+    int id;                     ///< Registry index (dog_params_find)
+    float value;                ///< Rounded for integer parameters
+} dog_param_value_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Load the defaults and register the control loop client (idempotent)
+ * 
+ * Call right after control_loop_start(), before any client that reads
+ * the active set registers (gait_manager_init also calls it, for setups
+ * without that). Does not read NVS (see dog_params_load).
+ * 
+ * @return false if the control loop has no free client slot
+ */
+bool dog_params_init(void);
+
+/**
+ * @brief Apply the set stored in NVS as one batch
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if nothing valid is stored, or an NVS error
+ */
+esp_err_t dog_params_load(void);
+
+/**
+ * @brief Store the pending set (the last accepted batch) in NVS
+ */
+esp_err_t dog_params_save(void);
+
+/**
+ * @brief Stage a batch (any task); all values apply from the same tick
+ * 
+ * Applies at once if the control loop is not running.
+ * 
+ * @param bad Index of the first rejected value, may be NULL
+ * @return false if any id is unknown or any value out of range (nothing changes)
+ */
+bool dog_params_set(const dog_param_value_t *values, int count, int *bad);
+
+/**
+ * @brief Set the tunable fields of one gait from a full config (one batch)
+ */
+void dog_params_set_gait(gait_type_t type, const gait_config_t *config);
+
+/**
+ * @brief Active set (control loop clients only; fixed for the whole tick)
+ */
+const dog_params_t *dog_params_active(void);
+
+/**
+ * @brief Copy of the pending set, the latest accepted values (any task)
+ */
+void dog_params_get(dog_params_t *params);
+
+/**
+ * @brief Overwrite the tunable fields of a gait config
+ */
+void dog_params_apply_gait(const dog_params_t *params, gait_type_t type, gait_config_t *config);
+
+/**
+ * @brief Number of registry entries (ids are 0..count-1)
+ */
+int dog_params_count(void);
+
+/**
+ * @brief Registry entry, NULL if the id is out of range
+ */
+const dog_param_info_t *dog_params_info(int id);
+
+/**
+ * @brief Look up a parameter by name
+ * @return Registry id, or -1 if unknown
+ */
+int dog_params_find(const char *name);
+
+/**
+ * @brief Value of one parameter in a set
+ */
+float dog_params_read(const dog_params_t *params, int id);
+
+/**
+ * @brief Batches latched into the active set since boot
+ */
+uint32_t dog_params_generation(void);
+
+#endif // DOG_PARAMS_H
@@ -0,0 +1,111 @@
+/**
+ * @file dog_servo_map.c
+ * @brief Known Servo Map Implementation
+ */
+
+#include "dog_servo_map.h"
+#include "sts3032_servo.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "SERVO_MAP";
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static dog_servo_map_t s_map;
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL HELPERS
+// ═══════════════════════════════════════════════════════
+
+static esp_err_t map_store(void)
+{
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(DOG_SERVO_MAP_NVS_NS, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    ret = nvs_set_blob(handle, DOG_SERVO_MAP_NVS_KEY, &s_map, sizeof(s_map));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return ret;
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+esp_err_t dog_servo_map_load(void)
+{
+    dog_servo_map_t map;
+    size_t size = sizeof(map);
+    nvs_handle_t handle;
+    
+    esp_err_t ret = nvs_open(DOG_SERVO_MAP_NVS_NS, NVS_READONLY, &handle);
+    if (ret != ESP_OK) {
+        return (ret == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : ret;
+    }
+    ret = nvs_get_blob(handle, DOG_SERVO_MAP_NVS_KEY, &map, &size);
+    nvs_close(handle);
+    
+    if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (size != sizeof(map) || map.version != DOG_SERVO_MAP_VERSION ||
+        map.count > DOG_SERVO_MAP_MAX) {
+        ESP_LOGW(TAG, "Ignoring stored map (size %u, version %u)", (unsigned)size, map.version);
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    s_map = map;
+    ESP_LOGI(TAG, "Loaded map: %u servo(s)", s_map.count);
+    return ESP_OK;
+}
+
+int dog_servo_map_scan(void)
+{
+    uint8_t ids[DOG_SERVO_MAP_MAX];
+    
+    ESP_LOGI(TAG, "Scanning IDs %d-%d", DOG_SERVO_SCAN_FIRST_ID, DOG_SERVO_SCAN_LAST_ID);
+    int found = sts_servo_scan_fast(DOG_SERVO_SCAN_FIRST_ID, DOG_SERVO_SCAN_LAST_ID,
+                                    ids, DOG_SERVO_MAP_MAX);
+    if (found > DOG_SERVO_MAP_MAX) {
+        ESP_LOGW(TAG, "%d servos found, keeping the first %d", found, DOG_SERVO_MAP_MAX);
+    }
+    
+    memset(&s_map, 0, sizeof(s_map));
+    s_map.version = DOG_SERVO_MAP_VERSION;
+    s_map.count = (found < DOG_SERVO_MAP_MAX) ? found : DOG_SERVO_MAP_MAX;
+    memcpy(s_map.ids, ids, s_map.count);
+    
+    esp_err_t ret = map_store();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to store map: %s", esp_err_to_name(ret));
+    }
+    
+    return found;
+}
+
+bool dog_servo_map_contains(uint8_t id)
+{
+    for (int i = 0; i < s_map.count; i++) {
+        if (s_map.ids[i] == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const dog_servo_map_t *dog_servo_map_get(void)
+{
+    return &s_map;
+}
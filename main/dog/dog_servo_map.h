@@ -0,0 +1,65 @@
+/**
+ * @file dog_servo_map.h
+ * @brief Known Servo Map
+ * 
+ * IDs found by the last bus scan, kept in RAM and in NVS so boot does not
+ * have to discover the bus again. A stored map that lists every leg servo
+ * is confirmed with one SYNC READ; only a missing or stale map (first
+ * boot, a servo swapped or re-IDed) costs a fast scan of the whole range.
+ */
+
+#ifndef DOG_SERVO_MAP_H
+#define DOG_SERVO_MAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define DOG_SERVO_MAP_NVS_NS        "dog"
+#define DOG_SERVO_MAP_NVS_KEY       "servo_map"
+#define DOG_SERVO_MAP_VERSION       1
+#define DOG_SERVO_MAP_MAX           16      // IDs remembered per scan
+#define DOG_SERVO_SCAN_FIRST_ID     1
+#define DOG_SERVO_SCAN_LAST_ID      253
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    uint8_t version;
+    uint8_t count;                      // Valid entries in ids
+    uint8_t ids[DOG_SERVO_MAP_MAX];     // Ascending
+} dog_servo_map_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Load the stored map into RAM
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if nothing valid is stored, or an NVS error
+ */
+esp_err_t dog_servo_map_load(void);
+
+/**
+ * @brief Fast-scan the whole ID range, keep the result and store it
+ * @return Number of servos found
+ */
+int dog_servo_map_scan(void);
+
+/**
+ * @brief Check if an ID is in the map
+ */
+bool dog_servo_map_contains(uint8_t id);
+
+/**
+ * @brief Current map (empty until loaded or scanned)
+ */
+const dog_servo_map_t *dog_servo_map_get(void);
+
+#endif // DOG_SERVO_MAP_H
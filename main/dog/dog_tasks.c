@@ -0,0 +1,132 @@
+/**
+ * @file dog_tasks.c
+ * @brief Task Runtime Statistics Implementation
+ * 
+ * Loads come from the FreeRTOS run time counters: each call keeps the
+ * counters it read so the next one can report the difference.
+ */
+
+#include "dog_tasks.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include <string.h>
+
+#if CONFIG_DOG_TASK_STATS
+
+static const char *TAG = "TASKS";
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    TaskHandle_t handle;
+    uint32_t run_time;
+} run_time_sample_t;
+
+static TaskStatus_t s_status[DOG_TASKS_MAX];
+static run_time_sample_t s_prev[DOG_TASKS_MAX];
+static int s_prev_count;
+static uint32_t s_prev_total;
+
+// ═══════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Run time counter of a task at the previous call (0 if it is new)
+ */
+static uint32_t prev_run_time(TaskHandle_t handle)
+{
+    for (int i = 0; i < s_prev_count; i++) {
+        if (s_prev[i].handle == handle) {
+            return s_prev[i].run_time;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Share of elapsed time in 0.1%
+ */
+static uint16_t permille(uint32_t part, uint32_t total)
+{
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t p = (uint64_t)part * 1000 / total;
+    return (uint16_t)(p > 1000 ? 1000 : p);
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+int dog_tasks_get_stats(dog_task_stats_t *tasks, int max, uint16_t core_load[2])
+{
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t count = uxTaskGetSystemState(s_status, DOG_TASKS_MAX, &total);
+    if (count == 0) {
+        ESP_LOGW(TAG, "More than %d tasks, no statistics", DOG_TASKS_MAX);
+        return 0;
+    }
+    
+    uint32_t elapsed = (uint32_t)total - s_prev_total;
+    int n = 0;
+    
+    if (core_load) {
+        core_load[0] = 0;
+        core_load[1] = 0;
+    }
+    
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t *st = &s_status[i];
+        uint32_t busy = (uint32_t)st->ulRunTimeCounter - prev_run_time(st->xHandle);
+        uint16_t load = permille(busy, elapsed);
+        
+        if (core_load) {
+            for (BaseType_t core = 0; core < configNUMBER_OF_CORES && core < 2; core++) {
+                if (st->xHandle == xTaskGetIdleTaskHandleForCore(core)) {
+                    core_load[core] = 1000 - load;
+                }
+            }
+        }
+        
+        if (tasks && n < max) {
+            dog_task_stats_t *t = &tasks[n++];
+            BaseType_t core = xTaskGetCoreID(st->xHandle);
+            
+            strncpy(t->name, st->pcTaskName, sizeof(t->name) - 1);
+            t->name[sizeof(t->name) - 1] = '\0';
+            t->core = (core == tskNO_AFFINITY) ? DOG_TASK_CORE_ANY : (uint8_t)core;
+            t->priority = (uint8_t)st->uxCurrentPriority;
+            t->load = load;
+            t->stack_free = st->usStackHighWaterMark;   // StackType_t is one byte on ESP-IDF
+        }
+    }
+    
+    for (UBaseType_t i = 0; i < count; i++) {
+        s_prev[i].handle = s_status[i].xHandle;
+        s_prev[i].run_time = (uint32_t)s_status[i].ulRunTimeCounter;
+    }
+    s_prev_count = (int)count;
+    s_prev_total = (uint32_t)total;
+    
+    return n;
+}
+
+#else
+
+int dog_tasks_get_stats(dog_task_stats_t *tasks, int max, uint16_t core_load[2])
+{
+    (void)tasks;
+    (void)max;
+    if (core_load) {
+        core_load[0] = 0;
+        core_load[1] = 0;
+    }
+    return 0;
+}
+
+#endif // CONFIG_DOG_TASK_STATS
@@ -0,0 +1,75 @@
+/**
+ * @file dog_tasks.h
+ * @brief Task Placement and Runtime Statistics
+ * 
+ * The firmware splits its tasks over the two ESP32-S3 cores so BLE radio
+ * bursts never delay a gait tick:
+ * 
+ *   Control core (DOG_CONTROL_CORE)       Comms core (DOG_COMMS_CORE)
+ *     7  control_loop                       21  NimBLE host (ESP-IDF)
+ *     6  dog_bus                             5  ble_exec
+ *     5  imu_task                            4  ble_telem
+ *     4  reaction                            3  dog_bench
+ *     3  dog_track                           2  imu_log
+ * 
+ * Priorities are strict per core: the control loop always preempts the
+ * bus scheduler, which always preempts the IMU reader. Each task keeps
+ * its priority next to its stack size in its own module header; stacks
+ * and control blocks are static, so none of them needs the heap.
+ * 
+ * With CONFIG_DOG_TASK_STATS the CPU load and stack high-water mark of
+ * every task can be read back (sent in the {"st":1} BLE reply).
+ */
+
+#ifndef DOG_TASKS_H
+#define DOG_TASKS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#if CONFIG_FREERTOS_UNICORE
+#define DOG_CONTROL_CORE    0
+#define DOG_COMMS_CORE      0
+#else
+#define DOG_CONTROL_CORE    CONFIG_DOG_CONTROL_CORE
+#define DOG_COMMS_CORE      CONFIG_DOG_COMMS_CORE
+#endif
+
+#define DOG_TASKS_MAX       24      // Tasks reported by dog_tasks_get_stats()
+#define DOG_TASK_CORE_ANY   0xFF    // Task not pinned to a core
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    char name[16];
+    uint8_t core;               // Pinned core or DOG_TASK_CORE_ANY
+    uint8_t priority;
+    uint16_t load;              // CPU time since the previous call, 0.1% of one core
+    uint32_t stack_free;        // Least free stack ever (bytes)
+} dog_task_stats_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Get the statistics of all tasks
+ * 
+ * Loads are measured over the time since the previous call (since boot
+ * on the first one). Call from one task only.
+ * 
+ * @param tasks Output, up to max entries
+ * @param max Size of tasks
+ * @param core_load Output: load of each core since the previous call (0.1%)
+ * @return Number of tasks written, 0 without CONFIG_DOG_TASK_STATS
+ */
+int dog_tasks_get_stats(dog_task_stats_t *tasks, int max, uint16_t core_load[2]);
+
+#endif // DOG_TASKS_H
@@ -0,0 +1,128 @@
+/**
+ * @file dog_trace.c
+ * @brief Binary Event Trace Implementation
+ * 
+ * Writers claim a record number with one atomic increment, so any number
+ * of tasks on either core can record at once. Each slot carries its own
+ * published sequence number: it is cleared before the slot is rewritten
+ * and set once the entry is complete, and readers re-check it after
+ * copying to drop entries that changed underneath them.
+ */
+
+#include "dog_trace.h"
+#include "esp_timer.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+static const char *TAG = "TRACE";
+
+#define TRACE_MASK  (DOG_TRACE_CAPACITY - 1)
+
+_Static_assert((DOG_TRACE_CAPACITY & TRACE_MASK) == 0, "DOG_TRACE_CAPACITY must be a power of two");
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static dog_trace_event_t s_events[DOG_TRACE_CAPACITY];
+static atomic_uint s_published[DOG_TRACE_CAPACITY];    // Record number held by each slot
+static atomic_uint s_next;                             // Last record number claimed
+
+static const char *const s_names[DOG_TRACE_EVENT_COUNT] = {
+    [DOG_TRACE_NONE]         = "none",
+    [DOG_TRACE_BLE_JSON]     = "ble_json",
+    [DOG_TRACE_BLE_FRAME]    = "ble_frame",
+    [DOG_TRACE_EXEC]         = "exec",
+    [DOG_TRACE_QUEUE_FULL]   = "queue_full",
+    [DOG_TRACE_MOVE]         = "move",
+    [DOG_TRACE_LEG_MOVE]     = "leg_move",
+    [DOG_TRACE_STANCE]       = "stance",
+    [DOG_TRACE_BUS_WRITE]    = "bus_write",
+    [DOG_TRACE_LOOP_OVERRUN] = "loop_overrun",
+    [DOG_TRACE_GAIT]         = "gait",
+    [DOG_TRACE_TRACKING]     = "tracking",
+    [DOG_TRACE_PARAMS]       = "params",
+};
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+void dog_trace_record(dog_trace_id_t id, uint16_t a, uint32_t b)
+{
+    uint32_t seq = atomic_fetch_add_explicit(&s_next, 1, memory_order_relaxed) + 1;
+    uint32_t slot = seq & TRACE_MASK;
+    
+    // Unpublish first so a reader never pairs the old number with new data
+    atomic_store_explicit(&s_published[slot], 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    
+    s_events[slot] = (dog_trace_event_t) {
+        .seq = seq,
+        .t_us = (uint32_t)esp_timer_get_time(),
+        .id = (uint16_t)id,
+        .a = a,
+        .b = b,
+    };
+    
+    atomic_store_explicit(&s_published[slot], seq, memory_order_release);
+}
+
+uint32_t dog_trace_oldest(void)
+{
+    uint32_t newest = atomic_load_explicit(&s_next, memory_order_relaxed);
+    return (newest > DOG_TRACE_CAPACITY) ? newest - DOG_TRACE_CAPACITY + 1 : 1;
+}
+
+int dog_trace_read(uint32_t *cursor, dog_trace_event_t *out, int max)
+{
+    if (cursor == NULL || out == NULL || max <= 0) {
+        return 0;
+    }
+    
+    uint32_t newest = atomic_load_explicit(&s_next, memory_order_relaxed);
+    uint32_t oldest = dog_trace_oldest();
+    if (*cursor < oldest) {
+        *cursor = oldest;
+    }
+    
+    int n = 0;
+    while (*cursor <= newest && n < max) {
+        uint32_t seq = (*cursor)++;
+        uint32_t slot = seq & TRACE_MASK;
+        
+        if (atomic_load_explicit(&s_published[slot], memory_order_acquire) != seq) {
+            continue;   // Still being written, or already reused
+        }
+        out[n] = s_events[slot];
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&s_published[slot], memory_order_relaxed) == seq) {
+            n++;
+        }
+    }
+    return n;
+}
+
+const char *dog_trace_name(uint16_t id)
+{
+    return (id < DOG_TRACE_EVENT_COUNT && s_names[id]) ? s_names[id] : "?";
+}
+
+void dog_trace_dump_log(void)
+{
+    dog_trace_event_t batch[16];
+    uint32_t cursor = dog_trace_oldest();
+    int total = 0;
+    int n;
+    
+    ESP_LOGI(TAG, "Trace dump (%d events max):", DOG_TRACE_CAPACITY);
+    while ((n = dog_trace_read(&cursor, batch, 16)) > 0) {
+        for (int i = 0; i < n; i++) {
+            ESP_LOGI(TAG, "%10lu us  %-12s a=%u b=%lu",
+                     (unsigned long)batch[i].t_us, dog_trace_name(batch[i].id),
+                     batch[i].a, (unsigned long)batch[i].b);
+        }
+        total += n;
+    }
+    ESP_LOGI(TAG, "Trace dump end (%d events)", total);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file dog_trace.h
+ * @brief Hot-Path Log Gating and Binary Event Trace
+ * 
+ * DOG_HOT_LOGI/D replace ESP_LOGx on paths that run per command or per
+ * tick; they compile to nothing unless CONFIG_DOG_HOT_PATH_LOG is set.
+ * DOG_TRACE() records a 16-byte event in a lock-free RAM ring instead, so
+ * production builds keep a history of what happened without formatting
+ * strings in the control path. Any task or core may record; the ring
+ * never blocks and simply overwrites its oldest events.
+ */
+
+#ifndef DOG_TRACE_H
+#define DOG_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#ifdef CONFIG_DOG_TRACE_CAPACITY
+#define DOG_TRACE_CAPACITY      CONFIG_DOG_TRACE_CAPACITY
+#else
+#define DOG_TRACE_CAPACITY      512     // Events (power of two)
+#endif
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Event IDs (arguments a / b)
+ */
+typedef enum {
+    DOG_TRACE_NONE = 0,
+    DOG_TRACE_BLE_JSON,         // length / -
+    DOG_TRACE_BLE_FRAME,        // opcode / length
+    DOG_TRACE_EXEC,             // exec command type / queued commands left
+    DOG_TRACE_QUEUE_FULL,       // - / commands rejected so far
+    DOG_TRACE_MOVE,             // speed / delay_ms
+    DOG_TRACE_LEG_MOVE,         // legs moved (bit per servo) / -
+    DOG_TRACE_STANCE,           // - / -
+    DOG_TRACE_BUS_WRITE,        // servos written (bit per servo) / first position
+    DOG_TRACE_LOOP_OVERRUN,     // - / tick execution time (µs)
+    DOG_TRACE_GAIT,             // gait type << 8 | direction / gait switches so far
+    DOG_TRACE_TRACKING,         // tracking faults (all servos) / speed level << 8 | stroke level
+    DOG_TRACE_PARAMS,           // - / parameter batches latched so far
+    DOG_TRACE_EVENT_COUNT
+} dog_trace_id_t;
+
+/**
+ * @brief One recorded event
+ */
+typedef struct {
+    uint32_t seq;               // Record number (0 = never written)
+    uint32_t t_us;              // esp_timer time, low 32 bits
+    uint16_t id;                // dog_trace_id_t
+    uint16_t a;
+    uint32_t b;
+} dog_trace_event_t;
+
+// ═══════════════════════════════════════════════════════
+// MACROS
+// ═══════════════════════════════════════════════════════
+
+#if CONFIG_DOG_HOT_PATH_LOG
+#define DOG_HOT_LOGI(tag, fmt, ...)     ESP_LOGI(tag, fmt, ##__VA_ARGS__)
+#define DOG_HOT_LOGD(tag, fmt, ...)     ESP_LOGD(tag, fmt, ##__VA_ARGS__)
+#else
+#define DOG_HOT_LOGI(tag, fmt, ...)     do { } while (0)
+#define DOG_HOT_LOGD(tag, fmt, ...)     do { } while (0)
+#endif
+
+#if CONFIG_DOG_TRACE
+#define DOG_TRACE(id, a, b)     dog_trace_record((id), (uint16_t)(a), (uint32_t)(b))
+#else
+#define DOG_TRACE(id, a, b)     do { } while (0)
+#endif
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Record an event (any task, any core; never blocks)
+ * 
+ * Use DOG_TRACE() so the call disappears when tracing is disabled.
+ */
+void dog_trace_record(dog_trace_id_t id, uint16_t a, uint32_t b);
+
+/**
+ * @brief Record number of the oldest event still in the ring
+ */
+uint32_t dog_trace_oldest(void);
+
+/**
+ * @brief Copy recorded events, oldest first
+ * 
+ * Events overwritten or still being written are skipped.
+ * 
+ * @param cursor Record number to start at (advanced past what was read)
+ * @param out Output buffer
+ * @param max Capacity of out
+ * @return Number of events copied (0 once the cursor reaches the newest)
+ */
+int dog_trace_read(uint32_t *cursor, dog_trace_event_t *out, int max);
+
+/**
+ * @brief Short name of an event ID (for dumps)
+ */
+const char *dog_trace_name(uint16_t id);
+
+/**
+ * @brief Print every event in the ring on the console
+ */
+void dog_trace_dump_log(void);
+
+#endif // DOG_TRACE_H
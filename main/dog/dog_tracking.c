@@ -0,0 +1,388 @@
+/**
+ * @file dog_tracking.c
+ * @brief Servo Tracking Monitor Implementation
+ * 
+ * The SYNC READ blocks for the RS485 reply timeout when a servo does not
+ * answer, so it never runs in the control loop: every
+ * DOG_TRACKING_PERIOD_MS the tick wakes the tracking task, which reads
+ * the servos and publishes the sample. The next tick that finds a new
+ * sample compares it. Detection state is owned by the tick; the
+ * statistics, levels and the sample itself are published under a
+ * spinlock.
+ */
+
+#include "dog_tracking.h"
+#include "dog_config.h"
+#include "dog_bus.h"
+#include "dog_trace.h"
+#include "dog_tasks.h"
+#include "control_loop.h"
+#include "sts3032_servo.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "TRACKING";
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief One read of all servos, with the goals sent at that time
+ */
+typedef struct {
+    int64_t t_us;               // Read start (esp_timer time)
+    sts_servo_telemetry_t telemetry[DOG_SERVO_COUNT];
+    bool valid[DOG_SERVO_COUNT];
+    uint16_t goals[DOG_SERVO_COUNT];
+    uint8_t sent;               // Servos with a goal (bit per servo)
+} tracking_sample_t;
+
+/**
+ * @brief When each condition of one servo started holding (0 = not holding)
+ */
+typedef struct {
+    int64_t lag_since_us;
+    int64_t stall_since_us;
+    int64_t load_since_us;
+} servo_watch_t;
+
+// Owned by the tick
+static int s_loop_client = -1;
+static int64_t s_next_us;
+static servo_watch_t s_watch[DOG_SERVO_COUNT];
+static int64_t s_adapt_us;              // Last derate step down
+static int64_t s_clean_since_us;        // All servos fault-free since (0 = not clean)
+static uint32_t s_sample_seen;          // Last s_sample_seq compared
+
+// Tracking task
+static TaskHandle_t s_task_handle = NULL;
+static StaticTask_t s_task_tcb;
+static StackType_t s_task_stack[DOG_TRACKING_TASK_STACK];
+
+// Shared with readers (s_lock)
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static dog_tracking_stats_t s_stats = {
+    .speed_level = DOG_TRACKING_LEVEL_FULL,
+    .amplitude_level = DOG_TRACKING_LEVEL_FULL,
+};
+static bool s_adapt = true;
+static tracking_sample_t s_sample;      // Latest read from the tracking task
+static uint32_t s_sample_seq;           // Bumped by every read
+
+// ═══════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief True once a condition has held for hold_ms (tracks its start time)
+ */
+static bool held(bool condition, int64_t *since_us, int64_t now_us, uint32_t hold_ms)
+{
+    if (!condition) {
+        *since_us = 0;
+        return false;
+    }
+    if (*since_us == 0) {
+        *since_us = now_us;
+    }
+    return now_us - *since_us >= (int64_t)hold_ms * 1000;
+}
+
+/**
+ * @brief Faults of one servo from one telemetry sample
+ */
+static uint8_t check_servo(int i, const sts_servo_telemetry_t *t, uint16_t goal, int64_t now_us)
+{
+    servo_watch_t *w = &s_watch[i];
+    int error = abs((int)goal - (int)t->position);
+    int speed = abs(t->speed);
+    uint8_t faults = 0;
+    
+    if (held(error > DOG_TRACKING_LAG_STEPS, &w->lag_since_us, now_us, DOG_TRACKING_LAG_MS)) {
+        faults |= DOG_TRACKING_LAG;
+    }
+    if (held(error > DOG_TRACKING_STALL_STEPS && speed < DOG_TRACKING_STALL_SPEED,
+             &w->stall_since_us, now_us, DOG_TRACKING_STALL_MS)) {
+        faults |= DOG_TRACKING_STALL;
+    }
+    if (held(abs(t->load) > DOG_TRACKING_LOAD_LIMIT, &w->load_since_us, now_us, DOG_TRACKING_LOAD_MS)) {
+        faults |= DOG_TRACKING_OVERLOAD;
+    }
+    if (t->temperature >= DOG_TRACKING_TEMP_LIMIT) {
+        faults |= DOG_TRACKING_OVERHEAT;
+    }
+    return faults;
+}
+
+/**
+ * @brief Move the derate levels for the faults active now (call under s_lock)
+ */
+static void adapt_levels(uint8_t faults, int64_t now_us)
+{
+    uint8_t *speed = &s_stats.speed_level;
+    uint8_t *amplitude = &s_stats.amplitude_level;
+    
+    if (!s_adapt) {
+        *speed = DOG_TRACKING_LEVEL_FULL;
+        *amplitude = DOG_TRACKING_LEVEL_FULL;
+        return;
+    }
+    
+    faults &= ~DOG_TRACKING_LOST;
+    if (faults == 0) {
+        if (s_clean_since_us == 0) {
+            s_clean_since_us = now_us;
+        } else if (now_us - s_clean_since_us >= (int64_t)DOG_TRACKING_RECOVER_MS * 1000) {
+            if (*speed < DOG_TRACKING_LEVEL_FULL) (*speed)++;
+            if (*amplitude < DOG_TRACKING_LEVEL_FULL) (*amplitude)++;
+            s_clean_since_us = now_us;
+        }
+        return;
+    }
+    s_clean_since_us = 0;
+    
+    if (faults & (DOG_TRACKING_STALL | DOG_TRACKING_OVERHEAT)) {
+        *speed = DOG_TRACKING_LEVEL_MIN;
+        *amplitude = DOG_TRACKING_LEVEL_MIN;
+        return;
+    }
+    
+    if (now_us - s_adapt_us < (int64_t)DOG_TRACKING_ADAPT_MS * 1000) {
+        return;
+    }
+    s_adapt_us = now_us;
+    if ((faults & DOG_TRACKING_LAG) && *speed > DOG_TRACKING_LEVEL_MIN) {
+        (*speed)--;
+    }
+    if ((faults & DOG_TRACKING_OVERLOAD) && *amplitude > DOG_TRACKING_LEVEL_MIN) {
+        (*amplitude)--;
+    }
+}
+
+/**
+ * @brief Count a servo's newly active faults (call under s_lock)
+ */
+static void count_events(dog_tracking_servo_stats_t *st, uint8_t faults)
+{
+    uint8_t rising = faults & ~st->faults;
+    
+    if (rising & ~DOG_TRACKING_LOST) {
+        st->fault_events++;
+    }
+    if (rising & DOG_TRACKING_LAG) s_stats.lag_events++;
+    if (rising & DOG_TRACKING_STALL) s_stats.stall_events++;
+    if (rising & DOG_TRACKING_OVERLOAD) s_stats.overload_events++;
+    if (rising & DOG_TRACKING_OVERHEAT) s_stats.overheat_events++;
+    st->faults = faults;
+}
+
+// ═══════════════════════════════════════════════════════
+// MONITOR
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Tracking task: one SYNC READ per wake-up from the tick
+ * 
+ * A read that waits out a missing servo only delays this task; wake-ups
+ * that arrive meanwhile collapse into the next read.
+ */
+static void tracking_task(void *param)
+{
+    tracking_sample_t sample;
+    
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        sample.t_us = esp_timer_get_time();
+        dog_read_telemetry(sample.telemetry, sample.valid);
+        sample.sent = dog_bus_get_sent(sample.goals);
+        
+        portENTER_CRITICAL(&s_lock);
+        s_sample = sample;
+        s_sample_seq++;
+        portEXIT_CRITICAL(&s_lock);
+    }
+}
+
+/**
+ * @brief Compare one sample with the goals and move the derate levels
+ */
+static void check_sample(const tracking_sample_t *sample)
+{
+    const sts_servo_telemetry_t *telemetry = sample->telemetry;
+    const bool *valid = sample->valid;
+    const uint16_t *goals = sample->goals;
+    uint8_t sent = sample->sent;
+    int64_t now_us = sample->t_us;
+    
+    uint8_t faults[DOG_SERVO_COUNT];
+    uint8_t all_faults = 0;
+    for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+        if (!valid[i]) {
+            faults[i] = DOG_TRACKING_LOST;
+        } else if (sent & (1u << i)) {
+            faults[i] = check_servo(i, &telemetry[i], goals[i], now_us);
+        } else {
+            faults[i] = 0;      // Never commanded, nothing to track
+        }
+        all_faults |= faults[i];
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    s_stats.reads++;
+    for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+        dog_tracking_servo_stats_t *st = &s_stats.servo[i];
+        count_events(st, faults[i]);
+        if (!valid[i] || !(sent & (1u << i))) {
+            continue;
+        }
+        
+        uint16_t error = (uint16_t)abs((int)goals[i] - (int)telemetry[i].position);
+        int16_t load = (int16_t)abs(telemetry[i].load);
+        st->samples++;
+        st->error_sum += error;
+        st->error_last = error;
+        if (error > st->error_max) st->error_max = error;
+        if (load > st->load_max) st->load_max = load;
+        if (telemetry[i].temperature > st->temperature_max) st->temperature_max = telemetry[i].temperature;
+    }
+    uint16_t old_levels = s_stats.speed_level << 8 | s_stats.amplitude_level;
+    adapt_levels(all_faults, now_us);
+    uint16_t levels = s_stats.speed_level << 8 | s_stats.amplitude_level;
+    portEXIT_CRITICAL(&s_lock);
+    
+    if (levels != old_levels) {
+        DOG_TRACE(DOG_TRACE_TRACKING, all_faults, levels);
+        DOG_HOT_LOGI(TAG, "Faults 0x%02x: speed %u/8, stroke %u/8",
+                     all_faults, levels >> 8, levels & 0xFF);
+    }
+}
+
+/**
+ * @brief Control loop tick: compare a new sample, wake the task every DOG_TRACKING_PERIOD_MS
+ */
+static void tracking_tick(void *ctx, int64_t tick_us)
+{
+    static tracking_sample_t sample;
+    bool fresh = false;
+    
+    portENTER_CRITICAL(&s_lock);
+    if (s_sample_seq != s_sample_seen) {
+        s_sample_seen = s_sample_seq;
+        sample = s_sample;
+        fresh = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    
+    if (fresh) {
+        check_sample(&sample);
+    }
+    
+    if (tick_us >= s_next_us) {
+        s_next_us = tick_us + (int64_t)DOG_TRACKING_PERIOD_MS * 1000;
+        xTaskNotifyGive(s_task_handle);
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool dog_tracking_init(void)
+{
+    if (s_loop_client >= 0) {
+        return true;
+    }
+    
+    memset(s_watch, 0, sizeof(s_watch));
+    
+    if (s_task_handle == NULL) {
+        s_task_handle = xTaskCreateStaticPinnedToCore(tracking_task, "dog_track", DOG_TRACKING_TASK_STACK,
+                                                      NULL, DOG_TRACKING_TASK_PRIORITY, s_task_stack,
+                                                      &s_task_tcb, DOG_CONTROL_CORE);
+        if (s_task_handle == NULL) {
+            ESP_LOGE(TAG, "Failed to create tracking task");
+            return false;
+        }
+    }
+    
+    s_loop_client = control_loop_register("track", tracking_tick, NULL);
+    if (s_loop_client < 0) {
+        ESP_LOGE(TAG, "Failed to register with control loop");
+        return false;
+    }
+    
+    ESP_LOGI(TAG, "Tracking monitor every %d ms", DOG_TRACKING_PERIOD_MS);
+    return true;
+}
+
+void dog_tracking_set_adapt(bool enabled)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_adapt = enabled;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void dog_tracking_get_levels(uint8_t *speed_level, uint8_t *amplitude_level)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (speed_level) *speed_level = s_stats.speed_level;
+    if (amplitude_level) *amplitude_level = s_stats.amplitude_level;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+uint32_t dog_tracking_get_faults(void)
+{
+    uint32_t faults = 0;
+    
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+        faults |= (uint32_t)s_stats.servo[i].faults << (8 * i);
+    }
+    portEXIT_CRITICAL(&s_lock);
+    
+    return faults;
+}
+
+int64_t dog_tracking_get_telemetry(sts_servo_telemetry_t telemetry[4], bool valid[4])
+{
+    portENTER_CRITICAL(&s_lock);
+    int64_t t_us = s_sample_seq ? s_sample.t_us : 0;
+    memcpy(telemetry, s_sample.telemetry, sizeof(s_sample.telemetry));
+    memcpy(valid, s_sample.valid, sizeof(s_sample.valid));
+    portEXIT_CRITICAL(&s_lock);
+    
+    return t_us;
+}
+
+void dog_tracking_get_stats(dog_tracking_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void dog_tracking_reset_stats(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < DOG_SERVO_COUNT; i++) {
+        uint8_t faults = s_stats.servo[i].faults;
+        memset(&s_stats.servo[i], 0, sizeof(s_stats.servo[i]));
+        s_stats.servo[i].faults = faults;
+    }
+    s_stats.reads = 0;
+    s_stats.lag_events = 0;
+    s_stats.stall_events = 0;
+    s_stats.overload_events = 0;
+    s_stats.overheat_events = 0;
+    portEXIT_CRITICAL(&s_lock);
+}
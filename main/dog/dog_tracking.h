@@ -0,0 +1,139 @@
+/**
+ * @file dog_tracking.h
+ * @brief Servo Tracking Monitor
+ * 
+ * Every DOG_TRACKING_PERIOD_MS the monitor reads position, speed, load
+ * and temperature of all four servos in one SYNC READ (in its own task,
+ * woken by a control loop client, so a missing servo's reply timeout
+ * never stalls a tick) and compares the present positions with the goals the bus
+ * scheduler last sent. A servo is flagged when, for longer than the
+ * matching hold time:
+ *   - LAG:      it is more than DOG_TRACKING_LAG_STEPS behind its goal
+ *   - STALL:    it is off its goal but not moving
+ *   - OVERLOAD: its load is above DOG_TRACKING_LOAD_LIMIT
+ *   - OVERHEAT: its temperature reaches DOG_TRACKING_TEMP_LIMIT (at once)
+ * 
+ * Active faults lower two derate levels that the gait manager applies:
+ * lag slows the steps down, overload shrinks the stroke, and a stall or
+ * overheating drops both to the minimum. Levels recover one step at a
+ * time once every servo has been clean for DOG_TRACKING_RECOVER_MS.
+ * 
+ * The latest read is also published (dog_tracking_get_telemetry), so
+ * other servo feedback consumers share it instead of adding their own
+ * SYNC READs to the bus.
+ */
+
+#ifndef DOG_TRACKING_H
+#define DOG_TRACKING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sts3032_servo.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define DOG_TRACKING_PERIOD_MS      20      // One SYNC READ per period
+#define DOG_TRACKING_TASK_STACK     3072
+#define DOG_TRACKING_TASK_PRIORITY  3       // Control core, below reaction (4)
+#define DOG_TRACKING_LAG_STEPS      150     // |goal - present| counted as lag (~13°)
+#define DOG_TRACKING_LAG_MS         200
+#define DOG_TRACKING_STALL_STEPS    40      // Distance to the goal a still servo must be off
+#define DOG_TRACKING_STALL_SPEED    20      // Below this present speed (steps/s) a servo is still
+#define DOG_TRACKING_STALL_MS       300
+#define DOG_TRACKING_LOAD_LIMIT     800     // 0.1% of max torque
+#define DOG_TRACKING_LOAD_MS        500
+#define DOG_TRACKING_TEMP_LIMIT     65      // °C
+
+#define DOG_TRACKING_LEVEL_FULL     8       // Derate levels are eighths of the configured value
+#define DOG_TRACKING_LEVEL_MIN      4       // Half speed / half stroke
+#define DOG_TRACKING_ADAPT_MS       500     // Time between derate steps down
+#define DOG_TRACKING_RECOVER_MS     2000    // Clean time before a derate step up
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef enum {
+    DOG_TRACKING_LAG      = 1 << 0,
+    DOG_TRACKING_STALL    = 1 << 1,
+    DOG_TRACKING_OVERLOAD = 1 << 2,
+    DOG_TRACKING_OVERHEAT = 1 << 3,
+    DOG_TRACKING_LOST     = 1 << 4,     // Did not answer the last read
+} dog_tracking_fault_t;
+
+/**
+ * @brief Tracking error statistics of one servo (since the last reset)
+ */
+typedef struct {
+    uint32_t samples;           // Reads compared against a goal
+    uint32_t error_sum;         // Sum of |goal - present| (steps), mean = error_sum / samples
+    uint16_t error_max;         // Largest |goal - present| (steps)
+    uint16_t error_last;
+    int16_t load_max;           // Largest |load| (0.1%)
+    uint8_t temperature_max;    // °C
+    uint8_t faults;             // Active dog_tracking_fault_t bits
+    uint16_t fault_events;      // Times any fault became active
+} dog_tracking_servo_stats_t;
+
+typedef struct {
+    dog_tracking_servo_stats_t servo[4];    // Index = servo ID - 1
+    uint8_t speed_level;        // Step rate in eighths of the configured one
+    uint8_t amplitude_level;    // Stroke in eighths of the configured one
+    uint32_t reads;             // SYNC READs made
+    uint32_t lag_events;
+    uint32_t stall_events;
+    uint32_t overload_events;
+    uint32_t overheat_events;
+} dog_tracking_stats_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Start the tracking task and register the monitor with the control loop
+ * @return false if the task cannot be created or the control loop has no free client slot
+ */
+bool dog_tracking_init(void);
+
+/**
+ * @brief Let faults lower the derate levels (default on)
+ * 
+ * With adaptation off, faults are still flagged and counted but the
+ * gaits run as configured. Useful when pushing a gait to its limit.
+ */
+void dog_tracking_set_adapt(bool enabled);
+
+/**
+ * @brief Current derate levels (DOG_TRACKING_LEVEL_MIN to DOG_TRACKING_LEVEL_FULL)
+ * @param speed_level Step rate in eighths (step duration = configured * 8 / level)
+ * @param amplitude_level Stroke in eighths (amplitude = configured * level / 8)
+ */
+void dog_tracking_get_levels(uint8_t *speed_level, uint8_t *amplitude_level);
+
+/**
+ * @brief Active faults of all servos, one byte per servo (servo ID - 1 = byte)
+ */
+uint32_t dog_tracking_get_faults(void);
+
+/**
+ * @brief Latest servo read (any task, no bus traffic)
+ * @param telemetry Present state per servo, index = servo ID - 1
+ * @param valid Servos that answered that read
+ * @return esp_timer time of the read, 0 if there was none yet
+ */
+int64_t dog_tracking_get_telemetry(sts_servo_telemetry_t telemetry[4], bool valid[4]);
+
+/**
+ * @brief Get the statistics
+ */
+void dog_tracking_get_stats(dog_tracking_stats_t *stats);
+
+/**
+ * @brief Clear the statistics (active faults and levels are kept)
+ */
+void dog_tracking_reset_stats(void);
+
+#endif // DOG_TRACKING_H
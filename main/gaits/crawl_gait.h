@@ -39,65 +39,12 @@ typedef gait_config_t crawl_gait_config_t;
 }
 
 // ═══════════════════════════════════════════════════════
-// INITIALIZATION
+// GAIT MANAGER
 // ═══════════════════════════════════════════════════════
 
 /**
- * @brief Initialize the crawl gait controller
- * @param config Pointer to gait configuration, or NULL for defaults
- * @return true if all servos responded successfully
+ * @brief Crawl for the gait manager (all directions)
  */
-bool crawl_gait_init(const crawl_gait_config_t *config);
-
-/**
- * @brief Update the gait configuration
- */
-void crawl_gait_set_config(const crawl_gait_config_t *config);
-
-/**
- * @brief Get the current gait configuration
- */
-void crawl_gait_get_config(crawl_gait_config_t *config);
-
-// ═══════════════════════════════════════════════════════
-// GAIT CONTROL
-// ═══════════════════════════════════════════════════════
-
-/**
- * @brief Start the crawl gait
- * @param direction Initial walking direction
- * @return true if task was created successfully
- */
-bool crawl_gait_start(gait_direction_t direction);
-
-/**
- * @brief Stop the crawl gait and return to stance
- */
-void crawl_gait_stop(void);
-
-/**
- * @brief Set the walking direction
- */
-void crawl_gait_set_direction(gait_direction_t direction);
-
-/**
- * @brief Get the current walking direction
- */
-gait_direction_t crawl_gait_get_direction(void);
-
-/**
- * @brief Check if the gait is currently running
- */
-bool crawl_gait_is_running(void);
-
-/**
- * @brief Move all servos to stance position
- */
-void crawl_gait_goto_stance(void);
-
-/**
- * @brief Execute a single crawl step
- */
-void crawl_gait_step(gait_direction_t direction);
+extern const gait_ops_t CRAWL_GAIT_OPS;
 
 #endif // CRAWL_GAIT_H
@@ -39,65 +39,12 @@ typedef gait_config_t creep_gait_config_t;
 }
 
 // ═══════════════════════════════════════════════════════
-// INITIALIZATION
+// GAIT MANAGER
 // ═══════════════════════════════════════════════════════
 
 /**
- * @brief Initialize the creep gait controller
- * @param config Pointer to gait configuration, or NULL for defaults
- * @return true if all servos responded successfully
+ * @brief Creep for the gait manager (forward and backward)
  */
-bool creep_gait_init(const creep_gait_config_t *config);
-
-/**
- * @brief Update the gait configuration
- */
-void creep_gait_set_config(const creep_gait_config_t *config);
-
-/**
- * @brief Get the current gait configuration
- */
-void creep_gait_get_config(creep_gait_config_t *config);
-
-// ═══════════════════════════════════════════════════════
-// GAIT CONTROL
-// ═══════════════════════════════════════════════════════
-
-/**
- * @brief Start the creep gait
- * @param direction Initial walking direction
- * @return true if task was created successfully
- */
-bool creep_gait_start(gait_direction_t direction);
-
-/**
- * @brief Stop the creep gait and return to stance
- */
-void creep_gait_stop(void);
-
-/**
- * @brief Set the walking direction
- */
-void creep_gait_set_direction(gait_direction_t direction);
-
-/**
- * @brief Get the current walking direction
- */
-gait_direction_t creep_gait_get_direction(void);
-
-/**
- * @brief Check if the gait is currently running
- */
-bool creep_gait_is_running(void);
-
-/**
- * @brief Move all servos to stance position
- */
-void creep_gait_goto_stance(void);
-
-/**
- * @brief Execute a single creep step
- */
-void creep_gait_step(gait_direction_t direction);
+extern const gait_ops_t CREEP_GAIT_OPS;
 
 #endif // CREEP_GAIT_H
@@ -50,6 +50,7 @@ typedef struct {
     float swing_amplitude;      ///< Maximum angle deviation from stance (degrees)
     uint16_t step_duration_ms;  ///< Duration of each step phase (milliseconds)
     uint16_t servo_speed;       ///< Servo movement speed (0-4095)
+    bool foot_space;            ///< Sweep the feet along a straight stroke (see gait_generator.h)
 } gait_config_t;
 
 /**
@@ -66,4 +67,54 @@ typedef struct {
     .servo_speed = DOG_SPEED_FAST                   \
 }
 
+// ═══════════════════════════════════════════════════════
+// GAIT PATTERNS (phase-offset tables)
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief A gait described as per-leg phase offsets within one cycle
+ * 
+ * Every leg follows the same normalized trajectory (swing, then stance);
+ * gaits only differ in when each leg starts its swing and how long it
+ * stays on the ground. Sampled continuously by gait_generator.
+ */
+typedef struct {
+    const char *name;
+    float phase_offset[4];      ///< Swing start per leg as a cycle fraction, index = servo ID - 1
+    float duty_factor;          ///< Fraction of the cycle each leg spends in stance
+    uint8_t steps_per_cycle;    ///< Cycle length in units of step_duration_ms
+} gait_pattern_t;
+
+extern const gait_pattern_t GAIT_PATTERN_TROT;              ///< FR+BL, then FL+BR
+extern const gait_pattern_t GAIT_PATTERN_WALK;              ///< FL, BR, FR, BL (3 legs down)
+extern const gait_pattern_t GAIT_PATTERN_CREEP;             ///< Walk order with 4-leg support between steps
+extern const gait_pattern_t GAIT_PATTERN_CRAWL;             ///< BL, FR, BR, FL (alternating sides)
+extern const gait_pattern_t GAIT_PATTERN_CRAWL_TURN_LEFT;   ///< BR, BL, FR, FL
+extern const gait_pattern_t GAIT_PATTERN_CRAWL_TURN_RIGHT;  ///< BL, BR, FL, FR
+
+// ═══════════════════════════════════════════════════════
+// GAIT OPERATIONS (see gait_manager.h)
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief How to drive one gait
+ * 
+ * Each gait module exports one of these. The gait manager owns the
+ * control loop client, the trajectory generator and the stance routine,
+ * so a gait only describes its motion.
+ */
+typedef struct {
+    const char *name;
+    gait_config_t default_config;
+    
+    /** Phase-offset table for a direction, NULL if the gait cannot move that way */
+    const gait_pattern_t *(*pattern)(gait_direction_t direction);
+    
+    /** True if the cycle runs backward in this direction */
+    bool (*reverse)(gait_direction_t direction);
+    
+    /** Raw servo stance angles for a config, index = servo ID - 1 */
+    void (*stance)(const gait_config_t *config, float stance[4]);
+} gait_ops_t;
+
 #endif // GAIT_COMMON_H
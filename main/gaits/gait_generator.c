@@ -0,0 +1,257 @@
+/**
+ * @file gait_generator.c
+ * @brief Continuous Gait Trajectory Generator Implementation
+ */
+
+#include "gait_generator.h"
+#include "dog_config.h"
+#include "dog_kinematics.h"
+#include "dog_bus.h"
+#include "sts3032_servo.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// ═══════════════════════════════════════════════════════
+// GAIT PATTERNS
+// ═══════════════════════════════════════════════════════
+// Offsets are indexed FR, FL, BR, BL (servo ID - 1). A leg starts its
+// swing when the cycle phase reaches its offset.
+
+const gait_pattern_t GAIT_PATTERN_TROT = {
+    .name = "trot",
+    .phase_offset = { 0.0f, 0.5f, 0.5f, 0.0f },
+    .duty_factor = 0.5f,
+    .steps_per_cycle = 2,
+};
+
+const gait_pattern_t GAIT_PATTERN_WALK = {
+    .name = "walk",
+    .phase_offset = { 0.5f, 0.0f, 0.25f, 0.75f },
+    .duty_factor = 0.75f,
+    .steps_per_cycle = 4,
+};
+
+// Same order as walk; the longer stance leaves all four feet down between swings
+const gait_pattern_t GAIT_PATTERN_CREEP = {
+    .name = "creep",
+    .phase_offset = { 0.5f, 0.0f, 0.25f, 0.75f },
+    .duty_factor = 0.8f,
+    .steps_per_cycle = 4,
+};
+
+const gait_pattern_t GAIT_PATTERN_CRAWL = {
+    .name = "crawl",
+    .phase_offset = { 0.25f, 0.75f, 0.5f, 0.0f },
+    .duty_factor = 0.75f,
+    .steps_per_cycle = 4,
+};
+
+const gait_pattern_t GAIT_PATTERN_CRAWL_TURN_LEFT = {
+    .name = "crawl_left",
+    .phase_offset = { 0.5f, 0.75f, 0.0f, 0.25f },
+    .duty_factor = 0.75f,
+    .steps_per_cycle = 4,
+};
+
+const gait_pattern_t GAIT_PATTERN_CRAWL_TURN_RIGHT = {
+    .name = "crawl_right",
+    .phase_offset = { 0.75f, 0.5f, 0.25f, 0.0f },
+    .duty_factor = 0.75f,
+    .steps_per_cycle = 4,
+};
+
+// Raw-angle sign of "forward": right legs are mounted mirrored
+static const float s_forward_sign[4] = { -1.0f, 1.0f, -1.0f, 1.0f };
+
+#define DEG_TO_RAD          0.017453293f
+
+// Fixed-point layout of the 32-bit cycle phase
+#define PHASE_INDEX_SHIFT   (32 - GAIT_TABLE_BITS)
+#define PHASE_FRAC_BITS     8
+#define PHASE_FRAC_SHIFT    (PHASE_INDEX_SHIFT - PHASE_FRAC_BITS)
+
+// ═══════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════
+
+static float wrap_phase(float phase)
+{
+    phase -= floorf(phase);
+    return (phase >= 1.0f) ? 0.0f : phase;
+}
+
+/**
+ * @brief Speed (steps/s) needed to cover delta_pos steps in dt_us
+ */
+static uint16_t tracking_speed(int delta_pos, int64_t dt_us)
+{
+    if (dt_us <= 0) {
+        return DOG_SPEED_MAX;
+    }
+    
+    uint32_t steps = (uint32_t)(delta_pos < 0 ? -delta_pos : delta_pos);
+    uint64_t steps_per_s = (uint64_t)steps * (uint64_t)(1000000.0f * GAIT_TRACKING_HEADROOM)
+                           / (uint64_t)dt_us;
+    
+    if (steps_per_s < GAIT_TRACKING_SPEED_MIN) return GAIT_TRACKING_SPEED_MIN;
+    if (steps_per_s > DOG_SPEED_MAX) return DOG_SPEED_MAX;
+    return (uint16_t)steps_per_s;
+}
+
+/**
+ * @brief Hip offset (degrees) that puts the foot at a stroke position on a straight line
+ */
+static float foot_space_offset(const dog_leg_geometry_t *leg, float half_stroke_mm, float stroke)
+{
+    dog_leg_joints_t joints;
+    dog_leg_ik(leg, half_stroke_mm * stroke, -leg->height_mm, &joints);
+    return joints.hip_deg;
+}
+
+/**
+ * @brief Fill the trajectory table for the current pattern
+ */
+static void build_table(gait_generator_t *gen, const float stance[4], float amplitude,
+                        bool foot_space)
+{
+    const gait_pattern_t *pattern = gen->pattern;
+    const dog_leg_geometry_t *leg = &dog_get_config()->leg;
+    float half_stroke_mm = leg->height_mm * tanf(amplitude * DEG_TO_RAD);
+    
+    for (int i = 0; i < 4; i++) {
+        for (int k = 0; k < GAIT_TABLE_SIZE; k++) {
+            float cycle_phase = (float)k / GAIT_TABLE_SIZE;
+            float leg_phase = wrap_phase(cycle_phase - pattern->phase_offset[i]);
+            float stroke = gait_trajectory(leg_phase, pattern->duty_factor);
+            float offset = foot_space ? foot_space_offset(leg, half_stroke_mm, stroke)
+                                      : amplitude * stroke;
+            gen->table[i][k] = sts_angle_to_position(stance[i] + s_forward_sign[i] * offset);
+        }
+        gen->table_stance[i] = stance[i];
+    }
+    
+    gen->table_pattern = pattern;
+    gen->table_amplitude = amplitude;
+    gen->table_foot_space = foot_space;
+}
+
+// ═══════════════════════════════════════════════════════
+// API
+// ═══════════════════════════════════════════════════════
+
+void gait_generator_reset(gait_generator_t *gen, const gait_pattern_t *pattern, int64_t now_us)
+{
+    gen->pattern = pattern;
+    gen->phase = 0;
+    gen->last_us = now_us;
+    gen->has_last = false;
+}
+
+void gait_generator_set_pattern(gait_generator_t *gen, const gait_pattern_t *pattern)
+{
+    gen->pattern = pattern;
+}
+
+float gait_trajectory(float leg_phase, float duty_factor)
+{
+    float swing = 1.0f - duty_factor;
+    
+    if (leg_phase < swing) {
+        // Cubic Bezier with control points (-1, -1, 1, 1): 3u^2 - 2u^3 scaled to the stroke
+        float u = leg_phase / swing;
+        return -1.0f + 2.0f * u * u * (3.0f - 2.0f * u);
+    }
+    
+    // Stance: linear from front to back
+    float u = (leg_phase - swing) / duty_factor;
+    return 1.0f - 2.0f * u;
+}
+
+void gait_generator_advance(gait_generator_t *gen, int64_t now_us,
+                            uint16_t step_duration_ms, bool reverse)
+{
+    int64_t dt_us = now_us - gen->last_us;
+    gen->last_us = now_us;
+    
+    if (dt_us <= 0 || step_duration_ms == 0) {
+        return;
+    }
+    
+    // Fraction of a cycle elapsed, scaled so 2^32 is one full cycle
+    uint64_t cycle_us = (uint64_t)step_duration_ms * 1000u * gen->pattern->steps_per_cycle;
+    uint32_t delta = (uint32_t)(((uint64_t)dt_us << 32) / cycle_us);
+    
+    gen->phase = reverse ? gen->phase - delta : gen->phase + delta;
+}
+
+void gait_generator_prepare(gait_generator_t *gen, const float stance[4], float amplitude,
+                            bool foot_space)
+{
+    if (gen->table_pattern == gen->pattern &&
+        gen->table_amplitude == amplitude &&
+        gen->table_foot_space == foot_space &&
+        gen->table_stance[0] == stance[0] && gen->table_stance[1] == stance[1] &&
+        gen->table_stance[2] == stance[2] && gen->table_stance[3] == stance[3]) {
+        return;
+    }
+    
+    build_table(gen, stance, amplitude, foot_space);
+}
+
+void gait_generator_sample(const gait_generator_t *gen, uint16_t positions[4])
+{
+    uint32_t index = gen->phase >> PHASE_INDEX_SHIFT;
+    uint32_t next = (index + 1) & (GAIT_TABLE_SIZE - 1);
+    int32_t frac = (int32_t)((gen->phase >> PHASE_FRAC_SHIFT) & ((1u << PHASE_FRAC_BITS) - 1));
+    
+    for (int i = 0; i < 4; i++) {
+        int32_t a = gen->table[i][index];
+        int32_t b = gen->table[i][next];
+        positions[i] = (uint16_t)(a + (((b - a) * frac) >> PHASE_FRAC_BITS));
+    }
+}
+
+uint32_t gait_generator_step_index(const gait_generator_t *gen)
+{
+    return (uint32_t)(((uint64_t)gen->phase * gen->pattern->steps_per_cycle) >> 32);
+}
+
+uint32_t gait_generator_match_phase(const gait_generator_t *gen, const uint16_t positions[4])
+{
+    uint32_t best_index = 0;
+    int best_error = INT32_MAX;
+    
+    for (uint32_t k = 0; k < GAIT_TABLE_SIZE; k++) {
+        int error = 0;
+        for (int i = 0; i < 4; i++) {
+            int d = abs((int)gen->table[i][k] - (int)positions[i]);
+            if (d > error) {
+                error = d;
+            }
+        }
+        if (error < best_error) {
+            best_error = error;
+            best_index = k;
+        }
+    }
+    
+    return best_index << PHASE_INDEX_SHIFT;
+}
+
+void gait_generator_send(gait_generator_t *gen, const uint16_t positions[4],
+                         int64_t dt_us, uint16_t first_speed)
+{
+    uint16_t speeds[4];
+    
+    for (int i = 0; i < 4; i++) {
+        speeds[i] = gen->has_last
+            ? tracking_speed((int)positions[i] - (int)gen->last_pos[i], dt_us)
+            : first_speed;
+        gen->last_pos[i] = positions[i];
+    }
+    gen->has_last = true;
+    
+    // Positions are final servo units; skip the angle path in dog_config
+    dog_bus_submit(0x0F, positions, speeds, DOG_BUS_PRIO_GAIT);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file gait_generator.h
+ * @brief Continuous Gait Trajectory Generator
+ * 
+ * Samples smooth per-leg trajectories at the control rate instead of
+ * commanding two endpoints per step and letting the servo speed register
+ * fill in the motion:
+ *   - Swing: cubic Bezier ease from the back to the front of the stroke
+ *            (zero velocity at lift-off and touch-down)
+ *   - Stance: linear sweep from front to back (constant ground speed)
+ * 
+ * Each leg runs on a normalized phase [0, 1) offset from the cycle phase
+ * by its entry in a gait_pattern_t table (see gait_common.h).
+ * 
+ * The trajectory of every leg over one cycle is precomputed into a table
+ * of servo positions (right-side reversal and angle conversion applied)
+ * whenever the pattern, stance or amplitude changes. Per tick, the
+ * generator only advances an integer phase, interpolates between two
+ * table entries and submits the positions to the bus.
+ * 
+ * Angles are raw servo angles: the forward direction is stance - offset
+ * for the right legs and stance + offset for the left legs.
+ * 
+ * In foot space (gait_config_t.foot_space) the stroke is a distance
+ * instead of an angle: the foot runs along a straight line at the stance
+ * height, from -h*tan(amplitude) to +h*tan(amplitude), and each table
+ * entry is solved with dog_leg_ik. The end points are the same; the
+ * stance sweep then moves the body at a constant speed. The IK runs only
+ * when the table is rebuilt, never per tick.
+ */
+
+#ifndef GAIT_GENERATOR_H
+#define GAIT_GENERATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gait_common.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define GAIT_TRACKING_HEADROOM      1.25f   // Speed margin so the servo reaches each setpoint in time
+#define GAIT_TRACKING_SPEED_MIN     50      // Floor for streamed servo speeds (steps/s)
+
+#define GAIT_TABLE_BITS             6       // log2 of trajectory samples per cycle
+#define GAIT_TABLE_SIZE             (1 << GAIT_TABLE_BITS)
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    const gait_pattern_t *pattern;
+    uint32_t phase;             ///< Cycle phase, full 32-bit range = one cycle (wraps naturally)
+    int64_t last_us;            ///< Time of the previous advance
+    uint16_t last_pos[4];       ///< Previous setpoints, index = servo ID - 1
+    bool has_last;              ///< last_pos is valid
+    
+    // Precomputed trajectory and the inputs it was built from
+    uint16_t table[4][GAIT_TABLE_SIZE];     ///< Servo positions over one cycle, index = servo ID - 1
+    const gait_pattern_t *table_pattern;
+    float table_stance[4];
+    float table_amplitude;
+    bool table_foot_space;
+} gait_generator_t;
+
+// ═══════════════════════════════════════════════════════
+// API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Restart the cycle at phase 0 with a pattern
+ * @param now_us Current time (esp_timer_get_time)
+ */
+void gait_generator_reset(gait_generator_t *gen, const gait_pattern_t *pattern, int64_t now_us);
+
+/**
+ * @brief Switch pattern without restarting the cycle phase
+ * 
+ * The trajectory table is rebuilt by the next gait_generator_prepare.
+ */
+void gait_generator_set_pattern(gait_generator_t *gen, const gait_pattern_t *pattern);
+
+/**
+ * @brief Normalized leg trajectory
+ * @param leg_phase Leg phase [0, 1), 0 = start of swing
+ * @param duty_factor Stance fraction of the cycle
+ * @return Stroke position, -1 = back, +1 = front
+ */
+float gait_trajectory(float leg_phase, float duty_factor);
+
+/**
+ * @brief Advance the cycle phase by the time elapsed since the last call
+ * @param reverse Run the cycle backward (walks backward)
+ */
+void gait_generator_advance(gait_generator_t *gen, int64_t now_us,
+                            uint16_t step_duration_ms, bool reverse);
+
+/**
+ * @brief Rebuild the trajectory table if the pattern, stance, amplitude or space changed
+ * @param stance Raw stance angles, index = servo ID - 1
+ * @param amplitude Half stroke in degrees
+ * @param foot_space Straight foot stroke instead of a linear angle sweep
+ */
+void gait_generator_prepare(gait_generator_t *gen, const float stance[4], float amplitude,
+                            bool foot_space);
+
+/**
+ * @brief Interpolate the current setpoint of every leg from the table
+ * @param positions Output servo positions, index = servo ID - 1
+ */
+void gait_generator_sample(const gait_generator_t *gen, uint16_t positions[4]);
+
+/**
+ * @brief Index of the step the cycle phase is in (0 to steps_per_cycle - 1)
+ * 
+ * Changes exactly when a leg touches down and the next one lifts off,
+ * which is where the gait manager switches patterns.
+ */
+uint32_t gait_generator_step_index(const gait_generator_t *gen);
+
+/**
+ * @brief Cycle phase whose table sample is closest to a set of positions
+ * 
+ * Call after gait_generator_prepare. Closest means the smallest largest
+ * per-leg difference, so starting there needs the least blending.
+ * 
+ * @param positions Servo positions, index = servo ID - 1
+ */
+uint32_t gait_generator_match_phase(const gait_generator_t *gen, const uint16_t positions[4]);
+
+/**
+ * @brief Send setpoints with tracking speeds and remember them for the next call
+ * @param positions Servo positions, index = servo ID - 1
+ * @param dt_us Sample period (time the servos get to reach the setpoints)
+ * @param first_speed Speed used when there is no previous setpoint
+ */
+void gait_generator_send(gait_generator_t *gen, const uint16_t positions[4],
+                         int64_t dt_us, uint16_t first_speed);
+
+#endif // GAIT_GENERATOR_H
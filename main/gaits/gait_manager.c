@@ -0,0 +1,433 @@
+/**
+ * @file gait_manager.c
+ * @brief Unified Gait Manager Implementation
+ * 
+ * Callers only publish requests (gait, direction, sequence number) under
+ * a spinlock. Everything that touches the trajectory happens in the
+ * control loop tick, which applies a request once the step index of the
+ * cycle changes, so there is never a second writer of the generator.
+ * 
+ * Step duration, stroke and servo speed come from the parameter registry
+ * (dog_params.h), whose latch runs ahead of this client in the tick when
+ * it was initialized first, so a tuning batch reaches the trajectory all
+ * at once.
+ */
+
+#include "gait_manager.h"
+#include "trot_gait.h"
+#include "walk_gait.h"
+#include "creep_gait.h"
+#include "crawl_gait.h"
+#include "gait_generator.h"
+#include "control_loop.h"
+#include "dog_config.h"
+#include "dog_bus.h"
+#include "dog_trace.h"
+#include "dog_params.h"
+#include "dog_tracking.h"
+#include "sts3032_servo.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "GAIT_MGR";
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static const gait_ops_t *const s_ops[GAIT_TYPE_COUNT] = {
+    [GAIT_TYPE_TROT]  = &TROT_GAIT_OPS,
+    [GAIT_TYPE_WALK]  = &WALK_GAIT_OPS,
+    [GAIT_TYPE_CREEP] = &CREEP_GAIT_OPS,
+    [GAIT_TYPE_CRAWL] = &CRAWL_GAIT_OPS,
+};
+
+typedef struct {
+    gait_type_t type;
+    gait_direction_t direction;
+    uint32_t seq;               // Bumped by every request
+} gait_request_t;
+
+// Shared with callers (s_lock)
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static gait_config_t s_configs[GAIT_TYPE_COUNT];
+static gait_request_t s_request = { .type = GAIT_TYPE_CRAWL, .direction = GAIT_DIRECTION_STOP };
+static uint32_t s_stop_seq;                 // Bumped by gait_manager_stop()
+static gait_manager_state_t s_state;
+static volatile uint32_t s_stop_done;       // Last stop the tick has parked for
+
+// Owned by the tick
+static int s_loop_client = -1;
+static gait_generator_t s_gen;
+static uint32_t s_applied_seq;
+static uint32_t s_applied_stop;
+static bool s_walking;
+static bool s_reverse;
+static gait_type_t s_type = GAIT_TYPE_CRAWL;
+static gait_config_t s_config;              // Copy of s_configs[s_type] for this tick
+static int32_t s_blend[4];                  // Offset still to blend out at s_blend_start_us
+static int64_t s_blend_start_us;
+static int64_t s_blend_us;
+
+// ═══════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════
+
+static void publish_state(bool walking, gait_direction_t direction, bool switched)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_state.type = s_type;
+    s_state.direction = direction;
+    s_state.walking = walking;
+    if (switched) {
+        s_state.transitions++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+/**
+ * @brief Send the stance of the current gait and forget the trajectory
+ * 
+ * From a known pose every leg arrives at stance after one step; from an
+ * unknown one (boot) they move at the configured servo speed.
+ */
+static void park(void)
+{
+    uint16_t positions[4];
+    uint16_t speeds[4];
+    float stance[4];
+    
+    s_ops[s_type]->stance(&s_config, stance);
+    for (int i = 0; i < 4; i++) {
+        positions[i] = sts_angle_to_position(stance[i]);
+        speeds[i] = s_gen.has_last
+            ? sts_speed_for_time(s_gen.last_pos[i], positions[i], s_config.step_duration_ms)
+            : s_config.servo_speed;
+    }
+    dog_bus_submit(0x0F, positions, speeds, DOG_BUS_PRIO_GAIT);
+    
+    s_walking = false;
+    s_gen.has_last = false;
+    publish_state(false, GAIT_DIRECTION_STOP, false);
+    DOG_HOT_LOGI(TAG, "Parked at %s stance", s_ops[s_type]->name);
+}
+
+/**
+ * @brief Slow down or shorten a gait while the tracking monitor reports faults
+ */
+static void apply_derate(gait_config_t *config, uint8_t speed_level, uint8_t amplitude_level)
+{
+    config->step_duration_ms = (uint16_t)((uint32_t)config->step_duration_ms *
+                                          DOG_TRACKING_LEVEL_FULL / speed_level);
+    config->swing_amplitude = config->swing_amplitude * amplitude_level / DOG_TRACKING_LEVEL_FULL;
+}
+
+/**
+ * @brief Current output: trajectory sample plus what is left of the blend
+ */
+static void blended_sample(int64_t now_us, uint16_t positions[4])
+{
+    gait_generator_sample(&s_gen, positions);
+    
+    int64_t left_us = s_blend_start_us + s_blend_us - now_us;
+    if (left_us <= 0) {
+        return;
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        int32_t offset = (int32_t)(s_blend[i] * left_us / s_blend_us);
+        positions[i] = (uint16_t)((int32_t)positions[i] + offset);
+    }
+}
+
+/**
+ * @brief Continue from a pose with another gait or direction
+ * 
+ * Starts the new pattern at its closest phase and blends out the
+ * remaining difference over one step of the new gait.
+ * 
+ * @param from Pose to continue from (servo positions, index = servo ID - 1)
+ */
+static void switch_to(const gait_request_t *req, const gait_config_t *config,
+                      const uint16_t from[4], int64_t now_us)
+{
+    s_type = req->type;
+    s_config = *config;
+    s_reverse = s_ops[s_type]->reverse(req->direction);
+    
+    float stance[4];
+    s_ops[s_type]->stance(&s_config, stance);
+    gait_generator_set_pattern(&s_gen, s_ops[s_type]->pattern(req->direction));
+    gait_generator_prepare(&s_gen, stance, s_config.swing_amplitude, s_config.foot_space);
+    s_gen.phase = gait_generator_match_phase(&s_gen, from);
+    s_gen.last_us = now_us;
+    
+    uint16_t target[4];
+    gait_generator_sample(&s_gen, target);
+    for (int i = 0; i < 4; i++) {
+        s_blend[i] = (int32_t)from[i] - (int32_t)target[i];
+    }
+    s_blend_start_us = now_us;
+    s_blend_us = (int64_t)s_config.step_duration_ms * 1000;
+}
+
+/**
+ * @brief Start walking from stance
+ */
+static void begin(const gait_request_t *req, const gait_config_t *config, int64_t now_us)
+{
+    float stance[4];
+    uint16_t from[4];
+    s_ops[req->type]->stance(config, stance);
+    for (int i = 0; i < 4; i++) {
+        from[i] = sts_angle_to_position(stance[i]);
+    }
+    
+    gait_generator_reset(&s_gen, s_ops[req->type]->pattern(req->direction), now_us);
+    switch_to(req, config, from, now_us);
+    
+    // The servos are at stance; track speeds from there
+    memcpy(s_gen.last_pos, from, sizeof(from));
+    s_gen.has_last = true;
+    s_walking = true;
+    
+    publish_state(true, req->direction, false);
+    DOG_HOT_LOGI(TAG, "Walking %s (%s)", s_ops[s_type]->name, s_gen.pattern->name);
+}
+
+// ═══════════════════════════════════════════════════════
+// GAIT EXECUTION
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Control loop tick: apply requests at step boundaries and sample
+ */
+static void manager_tick(void *ctx, int64_t tick_us)
+{
+    gait_request_t req;
+    gait_config_t req_config;
+    uint32_t stop_seq;
+    
+    portENTER_CRITICAL(&s_lock);
+    req = s_request;
+    req_config = s_configs[req.type];
+    stop_seq = s_stop_seq;
+    s_config = s_configs[s_type];
+    s_state.pending = (req.seq != s_applied_seq);
+    portEXIT_CRITICAL(&s_lock);
+    
+    const dog_params_t *params = dog_params_active();
+    dog_params_apply_gait(params, s_type, &s_config);
+    dog_params_apply_gait(params, req.type, &req_config);
+    
+    uint8_t speed_level, amplitude_level;
+    dog_tracking_get_levels(&speed_level, &amplitude_level);
+    apply_derate(&s_config, speed_level, amplitude_level);
+    apply_derate(&req_config, speed_level, amplitude_level);
+    
+    if (stop_seq != s_applied_stop) {
+        // A stop also drops whatever was requested before it
+        s_applied_stop = stop_seq;
+        s_applied_seq = req.seq;
+        park();
+        s_stop_done = stop_seq;
+        return;
+    }
+    
+    if (!s_walking) {
+        if (req.seq == s_applied_seq) {
+            return;
+        }
+        s_applied_seq = req.seq;
+        if (req.direction == GAIT_DIRECTION_STOP) {
+            return;
+        }
+        begin(&req, &req_config, tick_us);
+    }
+    
+    int64_t dt_us = tick_us - s_gen.last_us;
+    float stance[4];
+    s_ops[s_type]->stance(&s_config, stance);
+    gait_generator_prepare(&s_gen, stance, s_config.swing_amplitude, s_config.foot_space);
+    
+    uint32_t step = gait_generator_step_index(&s_gen);
+    gait_generator_advance(&s_gen, tick_us, s_config.step_duration_ms, s_reverse);
+    
+    if (req.seq != s_applied_seq && gait_generator_step_index(&s_gen) != step) {
+        s_applied_seq = req.seq;
+        
+        if (req.direction == GAIT_DIRECTION_STOP) {
+            park();
+            return;
+        }
+        
+        uint16_t from[4];
+        blended_sample(tick_us, from);
+        switch_to(&req, &req_config, from, tick_us);
+        
+        publish_state(true, req.direction, true);
+        DOG_TRACE(DOG_TRACE_GAIT, req.type << 8 | req.direction, s_state.transitions);
+        DOG_HOT_LOGI(TAG, "Switched to %s %s", s_ops[s_type]->name, s_gen.pattern->name);
+    }
+    
+    uint16_t positions[4];
+    blended_sample(tick_us, positions);
+    gait_generator_send(&s_gen, positions, dt_us, s_config.servo_speed);
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool gait_manager_init(void)
+{
+    if (s_loop_client >= 0) {
+        return true;
+    }
+    
+    // Normally done by app_main already; a no-op then
+    if (!dog_params_init()) {
+        ESP_LOGW(TAG, "Parameter registry unavailable, tuning applies unsynchronized");
+    }
+    
+    for (int i = 0; i < GAIT_TYPE_COUNT; i++) {
+        s_configs[i] = s_ops[i]->default_config;
+    }
+    s_config = s_configs[s_type];
+    
+    // The first tick parks the servos at stance
+    s_stop_seq++;
+    
+    s_loop_client = control_loop_register("gait", manager_tick, NULL);
+    if (s_loop_client < 0) {
+        ESP_LOGE(TAG, "Failed to register with control loop");
+        return false;
+    }
+    
+    ESP_LOGI(TAG, "Gait manager ready (trot, walk, creep, crawl)");
+    return true;
+}
+
+bool gait_manager_start(gait_type_t type, gait_direction_t direction)
+{
+    if (type >= GAIT_TYPE_COUNT) {
+        return false;
+    }
+    if (direction != GAIT_DIRECTION_STOP && s_ops[type]->pattern(direction) == NULL) {
+        ESP_LOGW(TAG, "%s cannot move in direction %d", s_ops[type]->name, direction);
+        return false;
+    }
+    
+    if (direction != GAIT_DIRECTION_STOP && !gait_manager_is_walking()) {
+        if (!dog_prepare_servos()) {
+            ESP_LOGW(TAG, "Some servos not responding");
+        }
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    s_request.type = type;
+    s_request.direction = direction;
+    s_request.seq++;
+    portEXIT_CRITICAL(&s_lock);
+    
+    ESP_LOGI(TAG, "Request: %s, direction %d", s_ops[type]->name, direction);
+    return true;
+}
+
+bool gait_manager_set_direction(gait_direction_t direction)
+{
+    portENTER_CRITICAL(&s_lock);
+    gait_type_t type = s_request.type;
+    portEXIT_CRITICAL(&s_lock);
+    
+    return gait_manager_start(type, direction);
+}
+
+void gait_manager_stop(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    uint32_t seq = ++s_stop_seq;
+    portEXIT_CRITICAL(&s_lock);
+    
+    if (s_loop_client < 0 || !control_loop_is_running()) {
+        return;
+    }
+    
+    for (int waited = 0; s_stop_done != seq && waited < GAIT_MANAGER_STOP_WAIT_MS; waited += portTICK_PERIOD_MS) {
+        vTaskDelay(1);
+    }
+}
+
+void gait_manager_set_config(gait_type_t type, const gait_config_t *config)
+{
+    if (type >= GAIT_TYPE_COUNT || config == NULL) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    s_configs[type] = *config;
+    portEXIT_CRITICAL(&s_lock);
+    
+    dog_params_set_gait(type, config);
+}
+
+void gait_manager_get_config(gait_type_t type, gait_config_t *config)
+{
+    if (type >= GAIT_TYPE_COUNT || config == NULL) {
+        return;
+    }
+    
+    dog_params_t params;
+    dog_params_get(&params);
+    
+    portENTER_CRITICAL(&s_lock);
+    *config = s_configs[type];
+    portEXIT_CRITICAL(&s_lock);
+    
+    dog_params_apply_gait(&params, type, config);
+}
+
+void gait_manager_get_state(gait_manager_state_t *state)
+{
+    if (state == NULL) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    *state = s_state;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool gait_manager_is_walking(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    bool walking = s_state.walking;
+    portEXIT_CRITICAL(&s_lock);
+    
+    return walking;
+}
+
+const char *gait_manager_type_name(gait_type_t type)
+{
+    return (type < GAIT_TYPE_COUNT) ? s_ops[type]->name : "?";
+}
+
+bool gait_manager_type_from_name(const char *name, gait_type_t *type)
+{
+    if (name == NULL) {
+        return false;
+    }
+    
+    for (int i = 0; i < GAIT_TYPE_COUNT; i++) {
+        if (strcmp(name, s_ops[i]->name) == 0) {
+            if (type) {
+                *type = (gait_type_t)i;
+            }
+            return true;
+        }
+    }
+    return false;
+}
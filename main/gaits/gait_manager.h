@@ -0,0 +1,133 @@
+/**
+ * @file gait_manager.h
+ * @brief Unified Gait Manager
+ * 
+ * Drives all four gaits (trot, walk, creep, crawl) from one control loop
+ * client that is registered once at boot and never removed. Each gait
+ * only supplies a gait_ops_t (pattern per direction, reverse flag,
+ * stance); the manager owns the trajectory generator.
+ * 
+ * Gait and direction changes are requests. While walking they take
+ * effect at the next step boundary (one leg touches down, the next lifts
+ * off): the new pattern starts at the cycle phase whose pose is closest
+ * to the current one, and the remaining difference is blended out over
+ * one step of the new gait, so the legs never jump.
+ * 
+ * Step duration, stroke and servo speed are live tunable (dog_params.h).
+ * 
+ * While the tracking monitor (dog_tracking.h) reports lag or overload,
+ * every gait runs with longer steps and a shorter stroke.
+ * 
+ *   gait_manager_start(GAIT_TYPE_CRAWL, GAIT_DIRECTION_FORWARD);
+ *   gait_manager_start(GAIT_TYPE_TROT, GAIT_DIRECTION_FORWARD);   // Next step boundary
+ *   gait_manager_set_direction(GAIT_DIRECTION_STOP);              // Park at a step boundary
+ *   gait_manager_stop();                                          // Park now
+ */
+
+#ifndef GAIT_MANAGER_H
+#define GAIT_MANAGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gait_common.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define GAIT_MANAGER_STOP_WAIT_MS   100     // Longest gait_manager_stop() waits for the loop to park
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef enum {
+    GAIT_TYPE_TROT,
+    GAIT_TYPE_WALK,
+    GAIT_TYPE_CREEP,
+    GAIT_TYPE_CRAWL,
+    GAIT_TYPE_COUNT
+} gait_type_t;
+
+/**
+ * @brief What the manager is doing (changes at step boundaries)
+ */
+typedef struct {
+    gait_type_t type;               ///< Gait walking, or the last one walked
+    gait_direction_t direction;     ///< GAIT_DIRECTION_STOP while parked
+    bool walking;
+    bool pending;                   ///< A request waits for the next step boundary
+    uint32_t transitions;           ///< Gait or direction switches made while walking
+} gait_manager_state_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Load the default configs and register the control loop client
+ * 
+ * The first tick moves the servos to the crawl stance.
+ * 
+ * @return false if the control loop has no free client slot
+ */
+bool gait_manager_init(void);
+
+/**
+ * @brief Walk a gait in a direction
+ * 
+ * Starts from stance when parked, otherwise switches at the next step
+ * boundary. GAIT_DIRECTION_STOP parks at the next step boundary.
+ * 
+ * @return false if the gait cannot move in that direction (e.g. trot turns)
+ */
+bool gait_manager_start(gait_type_t type, gait_direction_t direction);
+
+/**
+ * @brief Change direction, keeping the requested gait
+ */
+bool gait_manager_set_direction(gait_direction_t direction);
+
+/**
+ * @brief Park at stance immediately
+ * 
+ * Waits up to GAIT_MANAGER_STOP_WAIT_MS for the control loop to send the
+ * stance, so a move commanded afterwards is not overwritten by the gait.
+ */
+void gait_manager_stop(void);
+
+/**
+ * @brief Replace the config of one gait (used from its next tick on)
+ * 
+ * Step duration, stroke and servo speed go to the parameter registry
+ * (dog_params.h) as one batch, where BLE tuning can change them later.
+ */
+void gait_manager_set_config(gait_type_t type, const gait_config_t *config);
+
+/**
+ * @brief Get the config of one gait
+ */
+void gait_manager_get_config(gait_type_t type, gait_config_t *config);
+
+/**
+ * @brief Get the current state
+ */
+void gait_manager_get_state(gait_manager_state_t *state);
+
+/**
+ * @brief Check if a gait is walking
+ */
+bool gait_manager_is_walking(void);
+
+/**
+ * @brief Short gait name ("trot", "walk", "creep", "crawl")
+ */
+const char *gait_manager_type_name(gait_type_t type);
+
+/**
+ * @brief Look up a gait by its short name
+ * @return false if the name is unknown
+ */
+bool gait_manager_type_from_name(const char *name, gait_type_t *type);
+
+#endif // GAIT_MANAGER_H
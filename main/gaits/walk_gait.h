@@ -37,65 +37,12 @@ typedef gait_config_t walk_gait_config_t;
 }
 
 // ═══════════════════════════════════════════════════════
-// INITIALIZATION
+// GAIT MANAGER
 // ═══════════════════════════════════════════════════════
 
 /**
- * @brief Initialize the walk gait controller
- * @param config Pointer to gait configuration, or NULL for defaults
- * @return true if all servos responded successfully
+ * @brief Walk for the gait manager (forward and backward)
  */
-bool walk_gait_init(const walk_gait_config_t *config);
-
-/**
- * @brief Update the gait configuration
- */
-void walk_gait_set_config(const walk_gait_config_t *config);
-
-/**
- * @brief Get the current gait configuration
- */
-void walk_gait_get_config(walk_gait_config_t *config);
-
-// ═══════════════════════════════════════════════════════
-// GAIT CONTROL
-// ═══════════════════════════════════════════════════════
-
-/**
- * @brief Start the walk gait
- * @param direction Initial walking direction
- * @return true if task was created successfully
- */
-bool walk_gait_start(gait_direction_t direction);
-
-/**
- * @brief Stop the walk gait and return to stance
- */
-void walk_gait_stop(void);
-
-/**
- * @brief Set the walking direction
- */
-void walk_gait_set_direction(gait_direction_t direction);
-
-/**
- * @brief Get the current walking direction
- */
-gait_direction_t walk_gait_get_direction(void);
-
-/**
- * @brief Check if the gait is currently running
- */
-bool walk_gait_is_running(void);
-
-/**
- * @brief Move all servos to stance position
- */
-void walk_gait_goto_stance(void);
-
-/**
- * @brief Execute a single walk step
- */
-void walk_gait_step(gait_direction_t direction);
+extern const gait_ops_t WALK_GAIT_OPS;
 
 #endif // WALK_GAIT_H
@@ -13,6 +13,7 @@
  *   - Per-leg multi: {"L":[...per-leg moves...]}
  *   - Stance:        {"c":"stance"}
  *   - Ping:          {"c":"ping"}
+ *   - Gait:          {"g":"trot","d":"f"} / {"g":"stop"}
  */
 
 #include <stdio.h>
@@ -27,9 +28,20 @@
 // Minimal BLE servo control
 #include "ble/ble_servo.h"
 
-// Crawl gait algorithm
+// Gaits (one manager drives trot, walk, creep and crawl)
 #include "gait_common.h"
 #include "crawl_gait.h"
+#include "gait_manager.h"
+#include "dog_params.h"
+
+// Fixed-rate control loop that paces the gaits
+#include "control_loop.h"
+#include "dog_tracking.h"
+#include "dog_tasks.h"
+#include "dog_trace.h"
+#include "dog_bench.h"
+#include "motion_timeline.h"
+#include "motion_primitives.h"
 
 static const char *TAG = "ROBOT_MAIN";
 
@@ -45,8 +57,9 @@ static const char *TAG = "ROBOT_MAIN";
  */
 static void on_servo_move(float fr, float fl, float br, float bl,
                           uint16_t speed, uint16_t delay_ms) {
-    ESP_LOGI(TAG, "Move: FR=%.0f FL=%.0f BR=%.0f BL=%.0f spd=%u dly=%u",
-             fr, fl, br, bl, speed, delay_ms);
+    DOG_HOT_LOGI(TAG, "Move: FR=%.0f FL=%.0f BR=%.0f BL=%.0f spd=%u dly=%u",
+                 fr, fl, br, bl, speed, delay_ms);
+    DOG_TRACE(DOG_TRACE_MOVE, speed, delay_ms);
     
     // Check if this is a selective move (some legs have -1)
     bool fr_move = (fr >= 0);
@@ -56,13 +69,14 @@ static void on_servo_move(float fr, float fl, float br, float bl,
     
     if (fr_move && fl_move && br_move && bl_move) {
         // All legs moving - use batch move
-        dog_servo_move_all(fr, fl, br, bl, speed);
+        dog_servo_move_all_prio(fr, fl, br, bl, speed, DOG_BUS_PRIO_BLE);
     } else {
         // Selective leg movement - move only specified legs
-        if (fr_move) dog_servo_move(DOG_SERVO_FR, fr, speed);
-        if (fl_move) dog_servo_move(DOG_SERVO_FL, fl, speed);
-        if (br_move) dog_servo_move(DOG_SERVO_BR, br, speed);
-        if (bl_move) dog_servo_move(DOG_SERVO_BL, bl, speed);
+        // (the bus scheduler merges these into one sync write)
+        if (fr_move) dog_servo_move_prio(DOG_SERVO_FR, fr, speed, DOG_BUS_PRIO_BLE);
+        if (fl_move) dog_servo_move_prio(DOG_SERVO_FL, fl, speed, DOG_BUS_PRIO_BLE);
+        if (br_move) dog_servo_move_prio(DOG_SERVO_BR, br, speed, DOG_BUS_PRIO_BLE);
+        if (bl_move) dog_servo_move_prio(DOG_SERVO_BL, bl, speed, DOG_BUS_PRIO_BLE);
     }
     
     // Apply delay if specified
@@ -80,38 +94,40 @@ static void on_servo_move(float fr, float fl, float br, float bl,
  */
 static void on_leg_move(ble_leg_move_t fr, ble_leg_move_t fl,
                         ble_leg_move_t br, ble_leg_move_t bl) {
-    ESP_LOGI(TAG, "Per-leg move: FR=%.0f/%u/%u FL=%.0f/%u/%u BR=%.0f/%u/%u BL=%.0f/%u/%u",
-             fr.angle, fr.speed, fr.delay_ms,
-             fl.angle, fl.speed, fl.delay_ms,
-             br.angle, br.speed, br.delay_ms,
-             bl.angle, bl.speed, bl.delay_ms);
+    DOG_HOT_LOGI(TAG, "Per-leg move: FR=%.0f/%u/%u FL=%.0f/%u/%u BR=%.0f/%u/%u BL=%.0f/%u/%u",
+                 fr.angle, fr.speed, fr.delay_ms,
+                 fl.angle, fl.speed, fl.delay_ms,
+                 br.angle, br.speed, br.delay_ms,
+                 bl.angle, bl.speed, bl.delay_ms);
+    DOG_TRACE(DOG_TRACE_LEG_MOVE,
+              (fr.angle >= 0) | (fl.angle >= 0) << 1 | (br.angle >= 0) << 2 | (bl.angle >= 0) << 3, 0);
     
     // Move each leg with its individual speed
     // Skip legs with angle == -1 (not part of this move in offset gait mode)
     
     if (fr.angle >= 0 && fr.speed > 0) {
-        dog_servo_move(DOG_SERVO_FR, fr.angle, fr.speed);
+        dog_servo_move_prio(DOG_SERVO_FR, fr.angle, fr.speed, DOG_BUS_PRIO_BLE);
         if (fr.delay_ms > 0) {
             vTaskDelay(pdMS_TO_TICKS(fr.delay_ms));
         }
     }
     
     if (fl.angle >= 0 && fl.speed > 0) {
-        dog_servo_move(DOG_SERVO_FL, fl.angle, fl.speed);
+        dog_servo_move_prio(DOG_SERVO_FL, fl.angle, fl.speed, DOG_BUS_PRIO_BLE);
         if (fl.delay_ms > 0) {
             vTaskDelay(pdMS_TO_TICKS(fl.delay_ms));
         }
     }
     
     if (br.angle >= 0 && br.speed > 0) {
-        dog_servo_move(DOG_SERVO_BR, br.angle, br.speed);
+        dog_servo_move_prio(DOG_SERVO_BR, br.angle, br.speed, DOG_BUS_PRIO_BLE);
         if (br.delay_ms > 0) {
             vTaskDelay(pdMS_TO_TICKS(br.delay_ms));
         }
     }
     
     if (bl.angle >= 0 && bl.speed > 0) {
-        dog_servo_move(DOG_SERVO_BL, bl.angle, bl.speed);
+        dog_servo_move_prio(DOG_SERVO_BL, bl.angle, bl.speed, DOG_BUS_PRIO_BLE);
         if (bl.delay_ms > 0) {
             vTaskDelay(pdMS_TO_TICKS(bl.delay_ms));
         }
@@ -123,10 +139,9 @@ static void on_leg_move(ble_leg_move_t fr, ble_leg_move_t fl,
  */
 static void on_stance(void) {
     ESP_LOGI(TAG, "Stance command received");
+    DOG_TRACE(DOG_TRACE_STANCE, 0, 0);
     // Stop any running gait
-    if (crawl_gait_is_running()) {
-        crawl_gait_stop();
-    }
+    gait_manager_stop();
     dog_goto_stance();
 }
 
@@ -137,9 +152,7 @@ static void on_connect(bool connected) {
     if (connected) {
         ESP_LOGI(TAG, "=== BLE Client Connected ===");
         // Stop gait and go to stance on new connection
-        if (crawl_gait_is_running()) {
-            crawl_gait_stop();
-        }
+        gait_manager_stop();
         dog_goto_stance();
     } else {
         ESP_LOGI(TAG, "=== BLE Client Disconnected ===");
@@ -155,36 +168,42 @@ static void on_connect(bool connected) {
 static void run_demo_mode(void) {
     ESP_LOGI(TAG, "Running Demo Mode");
     
-    // Initialize crawl gait
-    crawl_gait_config_t crawl_config = {
-        .stance_angle_fr = DOG_STANCE_FRONT,
-        .stance_angle_fl = DOG_STANCE_FRONT,
-        .stance_angle_br = DOG_STANCE_BACK,
-        .stance_angle_bl = DOG_STANCE_BACK,
-        .swing_amplitude = DOG_SWING_AMPLITUDE,
-        .step_duration_ms = 250,
-        .servo_speed = DOG_SPEED_VERY_FAST,
-    };
-    crawl_gait_init(&crawl_config);
-    
-    // Demo: Forward 6s -> Right 6s -> Left 6s -> Forward 6s -> Stop
+    // Demo: Crawl forward 6s -> Right 6s -> Left 6s -> Trot 6s -> Walk 6s -> Stop
+    // (each change takes effect at the next step boundary), then the
+    // motion primitives: turn right 3 cycles -> arc (crawl + turn) 3 cycles
     ESP_LOGI(TAG, ">>> FORWARD");
-    crawl_gait_start(GAIT_DIRECTION_FORWARD);
+    gait_manager_start(GAIT_TYPE_CRAWL, GAIT_DIRECTION_FORWARD);
     vTaskDelay(pdMS_TO_TICKS(6000));
     
     ESP_LOGI(TAG, ">>> TURN RIGHT");
-    crawl_gait_set_direction(GAIT_DIRECTION_TURN_RIGHT);
+    gait_manager_set_direction(GAIT_DIRECTION_TURN_RIGHT);
     vTaskDelay(pdMS_TO_TICKS(6000));
     
     ESP_LOGI(TAG, ">>> TURN LEFT");
-    crawl_gait_set_direction(GAIT_DIRECTION_TURN_LEFT);
+    gait_manager_set_direction(GAIT_DIRECTION_TURN_LEFT);
     vTaskDelay(pdMS_TO_TICKS(6000));
     
-    ESP_LOGI(TAG, ">>> FORWARD");
-    crawl_gait_set_direction(GAIT_DIRECTION_FORWARD);
+    ESP_LOGI(TAG, ">>> TROT");
+    gait_manager_start(GAIT_TYPE_TROT, GAIT_DIRECTION_FORWARD);
     vTaskDelay(pdMS_TO_TICKS(6000));
     
-    crawl_gait_stop();
+    ESP_LOGI(TAG, ">>> WALK");
+    gait_manager_start(GAIT_TYPE_WALK, GAIT_DIRECTION_FORWARD);
+    vTaskDelay(pdMS_TO_TICKS(6000));
+    
+    gait_manager_stop();
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    
+    ESP_LOGI(TAG, ">>> PRIMITIVES");
+    motion_prim_play(MOTION_PRIM_TURN_RIGHT, 3);
+    while (motion_is_playing()) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    motion_prim_play_blend(MOTION_PRIM_CRAWL_FORWARD, MOTION_PRIM_TURN_RIGHT, 0.5f, 3);
+    while (motion_is_playing()) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    
     ESP_LOGI(TAG, "Demo complete!");
 }
 
@@ -210,6 +229,8 @@ void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
     ESP_LOGI(TAG, "NVS initialized");
+    ESP_LOGI(TAG, "Control tasks on core %d, BLE/telemetry on core %d",
+             DOG_CONTROL_CORE, DOG_COMMS_CORE);
     
     // ───────────────────────────────────────────────────────
     // STEP 2: Initialize dog hardware
@@ -221,6 +242,27 @@ void app_main(void)
     ESP_LOGI(TAG, "Dog hardware initialized");
     vTaskDelay(pdMS_TO_TICKS(500));
     
+    // Fixed-rate loop that paces the gaits
+    if (!control_loop_start(CONTROL_LOOP_DEFAULT_HZ)) {
+        ESP_LOGW(TAG, "Control loop failed to start, gaits unavailable");
+    }
+    
+    // Tuning latch takes the first client slot, ahead of every reader
+    // (balance registers from dog_imu_init, the gaits after it)
+    if (!dog_params_init()) {
+        ESP_LOGW(TAG, "Parameter registry unavailable, tuning applies unsynchronized");
+    }
+    
+    // Stored timelines replay from the control loop
+    if (!motion_timeline_init()) {
+        ESP_LOGW(TAG, "Timeline player unavailable");
+    }
+    
+    // Keyframe clips (motion primitives, push reactions) too
+    if (!motion_player_init()) {
+        ESP_LOGW(TAG, "Clip player unavailable");
+    }
+    
     // Initialize IMU with smart logging
     if (dog_imu_init()) {
         dog_imu_task_start();
@@ -230,7 +272,7 @@ void app_main(void)
     }
     
     // ───────────────────────────────────────────────────────
-    // STEP 3: Initialize crawl gait (for text commands)
+    // STEP 3: Initialize the gait manager (parks at stance)
     // ───────────────────────────────────────────────────────
     
     crawl_gait_config_t crawl_config = {
@@ -242,8 +284,22 @@ void app_main(void)
         .step_duration_ms = 250,
         .servo_speed = DOG_SPEED_VERY_FAST,
     };
-    crawl_gait_init(&crawl_config);
-    ESP_LOGI(TAG, "Crawl gait initialized");
+    if (gait_manager_init()) {
+        gait_manager_set_config(GAIT_TYPE_CRAWL, &crawl_config);
+        ESP_LOGI(TAG, "Gait manager initialized");
+        
+        // Tuning stored with {"pset":...,"save":1} overrides the configs above
+        if (dog_params_load() == ESP_OK) {
+            ESP_LOGI(TAG, "Stored tuning parameters applied");
+        }
+    } else {
+        ESP_LOGW(TAG, "Gait manager unavailable");
+    }
+    
+    // Compare the servos with their goals, derate the gaits on lag or overload
+    if (!dog_tracking_init()) {
+        ESP_LOGW(TAG, "Tracking monitor unavailable");
+    }
     
 #if RUN_DEMO_MODE
     // ───────────────────────────────────────────────────────
@@ -273,10 +329,21 @@ void app_main(void)
     ESP_LOGI(TAG, "  Per-leg:  {\"l\":[[fr,spd,dly],[fl,...],[br,...],[bl,...]]}");
     ESP_LOGI(TAG, "  Per-leg+: {\"L\":[per-leg moves...]}");
     ESP_LOGI(TAG, "  Stance:   {\"c\":\"stance\"}");
+    ESP_LOGI(TAG, "  Gait:     {\"g\":\"trot\",\"d\":\"f\"} / {\"g\":\"stop\"}");
     ESP_LOGI(TAG, "  Ping:     {\"c\":\"ping\"}");
+    ESP_LOGI(TAG, "  Stats:    {\"st\":1}");
+    ESP_LOGI(TAG, "  Tuning:   {\"pset\":{\"trot.step_ms\":180},\"save\":1} / {\"pget\":1}");
+    ESP_LOGI(TAG, "  Timeline: {\"play\":id}");
+    ESP_LOGI(TAG, "  Trace:    {\"tr\":1} (BLE) / {\"tr\":2} (console)");
+    ESP_LOGI(TAG, "  Bench:    {\"bench\":1}");
     ESP_LOGI(TAG, "");
 #endif
     
+#if CONFIG_DOG_BENCHMARK_AT_BOOT
+    // Report goes to the console, see dog_bench.h
+    dog_bench_start();
+#endif
+    
     // ───────────────────────────────────────────────────────
     // Main loop
     // ───────────────────────────────────────────────────────
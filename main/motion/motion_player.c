@@ -0,0 +1,166 @@
+/**
+ * @file motion_player.c
+ * @brief Asynchronous Keyframe Clip Player Implementation
+ * 
+ * Callers post a request under a spinlock; the control loop tick picks it
+ * up, so all playback state is owned by the control task.
+ */
+
+#include "motion_player.h"
+#include "dog_config.h"
+#include "control_loop.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "MOTION";
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+// Pending request (written by callers, taken by the tick)
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static const motion_clip_t *s_request_clip = NULL;
+static uint8_t s_request_cycles = 0;
+static bool s_request_cancel = false;
+
+// Visible to callers for preemption checks
+static const motion_clip_t * volatile s_current = NULL;
+
+// Playback state (control task only)
+static uint8_t s_cycles = 0;
+static uint8_t s_cycle = 0;
+static uint8_t s_frame = 0;
+static int64_t s_next_us = 0;
+
+static int s_loop_client = -1;          // Control loop registration
+
+// ═══════════════════════════════════════════════════════
+// PLAYBACK
+// ═══════════════════════════════════════════════════════
+
+static void finish(const char *why)
+{
+    ESP_LOGI(TAG, "Clip '%s' %s, returning to stance", s_current->name, why);
+    s_current = NULL;
+    
+    dog_bus_release(DOG_BUS_PRIO_REACTION);
+    dog_goto_stance();
+}
+
+/**
+ * @brief Control loop tick: step the playing clip
+ */
+static void player_tick(void *ctx, int64_t tick_us)
+{
+    portENTER_CRITICAL(&s_lock);
+    const motion_clip_t *request = s_request_clip;
+    uint8_t cycles = s_request_cycles;
+    bool cancel = s_request_cancel;
+    s_request_clip = NULL;
+    s_request_cancel = false;
+    portEXIT_CRITICAL(&s_lock);
+    
+    if (cancel && request == NULL && s_current != NULL) {
+        finish("cancelled");
+        return;
+    }
+    
+    if (request != NULL) {
+        if (s_current != NULL && s_current != request) {
+            ESP_LOGI(TAG, "Clip '%s' preempted by '%s'", s_current->name, request->name);
+        }
+        ESP_LOGI(TAG, "Playing '%s' (%d cycles, %d keyframes each)",
+                 request->name, cycles, request->frame_count);
+        s_current = request;
+        s_cycles = cycles;
+        s_cycle = 0;
+        s_frame = 0;
+        s_next_us = tick_us;
+    }
+    
+    const motion_clip_t *clip = s_current;
+    if (clip == NULL || tick_us < s_next_us) {
+        return;
+    }
+    
+    if (s_frame >= clip->frame_count) {
+        s_frame = 0;
+        if (++s_cycle >= s_cycles) {
+            finish("complete");
+            return;
+        }
+    }
+    
+    const motion_keyframe_t *kf = &clip->frames[s_frame++];
+    dog_servo_move_all_prio(kf->fr, kf->fl, kf->br, kf->bl, kf->speed,
+                            DOG_BUS_PRIO_REACTION);
+    
+    s_next_us += (int64_t)(kf->delay_ms + clip->delay_offset_ms) * 1000;
+    if (s_next_us < tick_us) {
+        s_next_us = tick_us;    // Do not burst through frames after a stall
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool motion_player_init(void)
+{
+    if (s_loop_client >= 0) {
+        return true;
+    }
+    
+    s_loop_client = control_loop_register("motion", player_tick, NULL);
+    if (s_loop_client < 0) {
+        ESP_LOGE(TAG, "Failed to register with control loop");
+        return false;
+    }
+    
+    ESP_LOGI(TAG, "Motion player ready");
+    return true;
+}
+
+bool motion_play(const motion_clip_t *clip, uint8_t cycles)
+{
+    if (s_loop_client < 0 || clip == NULL || clip->frames == NULL ||
+        clip->frame_count == 0 || cycles == 0) {
+        return false;
+    }
+    
+    bool accepted = false;
+    
+    portENTER_CRITICAL(&s_lock);
+    const motion_clip_t *active = (s_request_clip != NULL) ? s_request_clip : s_current;
+    if (active == NULL || clip->priority >= active->priority) {
+        s_request_clip = clip;
+        s_request_cycles = cycles;
+        s_request_cancel = false;
+        accepted = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    
+    if (!accepted) {
+        ESP_LOGD(TAG, "Clip '%s' refused: '%s' has higher priority", clip->name, active->name);
+    }
+    return accepted;
+}
+
+void motion_cancel(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_request_clip = NULL;
+    s_request_cancel = true;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool motion_is_playing(void)
+{
+    return s_current != NULL || s_request_clip != NULL;
+}
+
+const motion_clip_t* motion_current(void)
+{
+    return s_current;
+}
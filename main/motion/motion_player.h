@@ -0,0 +1,81 @@
+/**
+ * @file motion_player.h
+ * @brief Asynchronous Keyframe Clip Player
+ * 
+ * Plays keyframe animations (motion clips) from the control loop, so the
+ * caller returns immediately. A new clip preempts one of equal or lower
+ * priority; a playing clip can be cancelled at any time. When a clip ends
+ * or is cancelled, the player releases the reaction bus priority and
+ * returns to stance.
+ * 
+ * Angles are unified (right side reversed automatically).
+ */
+
+#ifndef MOTION_PLAYER_H
+#define MOTION_PLAYER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief One pose of a clip
+ */
+typedef struct {
+    float fr;           // Front-right angle
+    float fl;           // Front-left angle
+    float br;           // Back-right angle
+    float bl;           // Back-left angle
+    uint16_t speed;     // Movement speed
+    uint16_t delay_ms;  // Time before the next keyframe
+} motion_keyframe_t;
+
+/**
+ * @brief A keyframe animation (static storage; the player keeps a pointer)
+ */
+typedef struct {
+    const char *name;
+    const motion_keyframe_t *frames;
+    uint8_t frame_count;
+    uint8_t priority;           // Preempts clips of equal or lower priority
+    uint16_t delay_offset_ms;   // Added to every keyframe delay
+} motion_clip_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Register the player with the control loop
+ * @return true if the player is ready
+ */
+bool motion_player_init(void);
+
+/**
+ * @brief Start a clip (non-blocking, safe from any task)
+ * @param clip Clip to play
+ * @param cycles Number of times to repeat the clip
+ * @return false if a higher-priority clip is playing (or not initialized)
+ */
+bool motion_play(const motion_clip_t *clip, uint8_t cycles);
+
+/**
+ * @brief Stop the playing clip and return to stance
+ */
+void motion_cancel(void);
+
+/**
+ * @brief Check if a clip is playing (or about to start)
+ */
+bool motion_is_playing(void);
+
+/**
+ * @brief Get the playing clip
+ * @return Clip pointer, or NULL when idle
+ */
+const motion_clip_t* motion_current(void);
+
+#endif // MOTION_PLAYER_H
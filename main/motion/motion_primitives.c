@@ -0,0 +1,259 @@
+/**
+ * @file motion_primitives.c
+ * @brief Built-in Motion Primitives Implementation
+ * 
+ * The crawl and turn cycles are one keyframe per phase: the listed leg
+ * swings forward while the other three push back, 250 ms a phase. The
+ * walk clips are the push reactions' animations, unchanged.
+ */
+
+#include "motion_primitives.h"
+#include "dog_config.h"
+#include "reaction/reaction_config.h"
+#include "esp_log.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "PRIM";
+
+// Crawl cycle angles (unified, 25° either side of stance)
+#define CRAWL_SWING_DEG     25.0f
+#define CRAWL_PHASE_MS      250
+#define F_SWING             (DOG_STANCE_FRONT + CRAWL_SWING_DEG)
+#define F_PUSH              (DOG_STANCE_FRONT - CRAWL_SWING_DEG)
+#define B_SWING             (DOG_STANCE_BACK + CRAWL_SWING_DEG)
+#define B_PUSH              (DOG_STANCE_BACK - CRAWL_SWING_DEG)
+
+#define FRAME_COUNT(frames) (sizeof(frames) / sizeof(motion_keyframe_t))
+
+// ═══════════════════════════════════════════════════════
+// KEYFRAMES
+// ═══════════════════════════════════════════════════════
+
+// BL -> FR -> BR -> FL (alternating sides)
+static const motion_keyframe_t crawl_forward_keyframes[] = {
+    { .fr = F_PUSH,  .fl = F_PUSH,  .br = B_PUSH,  .bl = B_SWING, .speed = DOG_SPEED_VERY_FAST, .delay_ms = CRAWL_PHASE_MS },
+    { .fr = F_SWING, .fl = F_PUSH,  .br = B_PUSH,  .bl = B_PUSH,  .speed = DOG_SPEED_VERY_FAST, .delay_ms = CRAWL_PHASE_MS },
+    { .fr = F_PUSH,  .fl = F_PUSH,  .br = B_SWING, .bl = B_PUSH,  .speed = DOG_SPEED_VERY_FAST, .delay_ms = CRAWL_PHASE_MS },
+    { .fr = F_PUSH,  .fl = F_SWING, .br = B_PUSH,  .bl = B_PUSH,  .speed = DOG_SPEED_VERY_FAST, .delay_ms = CRAWL_PHASE_MS },
+};
+
+// BL -> BR -> FL -> FR (same side in turn)
+static const motion_keyframe_t turn_right_keyframes[] = {
+    { .fr = F_PUSH,  .fl = F_PUSH,  .br = B_PUSH,  .bl = B_SWING, .speed = DOG_SPEED_MEDIUM, .delay_ms = CRAWL_PHASE_MS },
+    { .fr = F_PUSH,  .fl = F_PUSH,  .br = B_SWING, .bl = B_PUSH,  .speed = DOG_SPEED_MEDIUM, .delay_ms = CRAWL_PHASE_MS },
+    { .fr = F_PUSH,  .fl = F_SWING, .br = B_PUSH,  .bl = B_PUSH,  .speed = DOG_SPEED_MEDIUM, .delay_ms = CRAWL_PHASE_MS },
+    { .fr = F_SWING, .fl = F_PUSH,  .br = B_PUSH,  .bl = B_PUSH,  .speed = DOG_SPEED_MEDIUM, .delay_ms = CRAWL_PHASE_MS },
+};
+
+// BR -> BL -> FR -> FL (mirror of turn right)
+static const motion_keyframe_t turn_left_keyframes[] = {
+    { .fr = F_PUSH,  .fl = F_PUSH,  .br = B_SWING, .bl = B_PUSH,  .speed = DOG_SPEED_MEDIUM, .delay_ms = CRAWL_PHASE_MS },
+    { .fr = F_PUSH,  .fl = F_PUSH,  .br = B_PUSH,  .bl = B_SWING, .speed = DOG_SPEED_MEDIUM, .delay_ms = CRAWL_PHASE_MS },
+    { .fr = F_SWING, .fl = F_PUSH,  .br = B_PUSH,  .bl = B_PUSH,  .speed = DOG_SPEED_MEDIUM, .delay_ms = CRAWL_PHASE_MS },
+    { .fr = F_PUSH,  .fl = F_SWING, .br = B_PUSH,  .bl = B_PUSH,  .speed = DOG_SPEED_MEDIUM, .delay_ms = CRAWL_PHASE_MS },
+};
+
+static const motion_keyframe_t walk_forward_keyframes[] = {
+    { .fr = 55,  .fl = 110, .br = 290, .bl = 240, .speed = 1600, .delay_ms = 150 },
+    { .fr = 95,  .fl = 80,  .br = 260, .bl = 285, .speed = 1050, .delay_ms = 150 },
+    { .fr = 90,  .fl = 90,  .br = 270, .bl = 270, .speed = 1300, .delay_ms = 75  },
+    { .fr = 110, .fl = 55,  .br = 240, .bl = 290, .speed = 1600, .delay_ms = 150 },
+    { .fr = 80,  .fl = 95,  .br = 285, .bl = 260, .speed = 950,  .delay_ms = 150 },
+    { .fr = 90,  .fl = 90,  .br = 270, .bl = 270, .speed = 700,  .delay_ms = 75  },
+};
+
+// Every transition of walk_forward run the other way, keeping its speed
+// and delay, so the feet sweep front-to-back while loaded
+static const motion_keyframe_t walk_backward_keyframes[] = {
+    // Forward keyframe 5
+    { .fr = 80,  .fl = 95,  .br = 285, .bl = 260, .speed = 700,  .delay_ms = 75  },
+    // Forward keyframe 4
+    { .fr = 110, .fl = 55,  .br = 240, .bl = 290, .speed = 950,  .delay_ms = 150 },
+    // Forward keyframe 3
+    { .fr = 90,  .fl = 90,  .br = 270, .bl = 270, .speed = 1600, .delay_ms = 150 },
+    // Forward keyframe 2
+    { .fr = 95,  .fl = 80,  .br = 260, .bl = 285, .speed = 1300, .delay_ms = 75  },
+    // Forward keyframe 1
+    { .fr = 55,  .fl = 110, .br = 290, .bl = 240, .speed = 1050, .delay_ms = 150 },
+    // Forward keyframe 6 (stance)
+    { .fr = 90,  .fl = 90,  .br = 270, .bl = 270, .speed = 1600, .delay_ms = 150 },
+};
+
+// ═══════════════════════════════════════════════════════
+// CLIPS
+// ═══════════════════════════════════════════════════════
+
+static const motion_clip_t s_clips[MOTION_PRIM_COUNT] = {
+    [MOTION_PRIM_CRAWL_FORWARD] = {
+        .name = "crawl_forward",
+        .frames = crawl_forward_keyframes,
+        .frame_count = FRAME_COUNT(crawl_forward_keyframes),
+        .priority = MOTION_PRIM_PRIORITY,
+    },
+    [MOTION_PRIM_TURN_RIGHT] = {
+        .name = "turn_right",
+        .frames = turn_right_keyframes,
+        .frame_count = FRAME_COUNT(turn_right_keyframes),
+        .priority = MOTION_PRIM_PRIORITY,
+    },
+    [MOTION_PRIM_TURN_LEFT] = {
+        .name = "turn_left",
+        .frames = turn_left_keyframes,
+        .frame_count = FRAME_COUNT(turn_left_keyframes),
+        .priority = MOTION_PRIM_PRIORITY,
+    },
+    [MOTION_PRIM_WALK_FORWARD] = {
+        .name = "walk_forward",
+        .frames = walk_forward_keyframes,
+        .frame_count = FRAME_COUNT(walk_forward_keyframes),
+        .priority = REACTION_CLIP_PRIORITY,
+        .delay_offset_ms = REACTION_TIMING_OFFSET_MS,
+    },
+    [MOTION_PRIM_WALK_BACKWARD] = {
+        .name = "walk_backward",
+        .frames = walk_backward_keyframes,
+        .frame_count = FRAME_COUNT(walk_backward_keyframes),
+        .priority = REACTION_CLIP_PRIORITY,
+        .delay_offset_ms = REACTION_TIMING_OFFSET_MS,
+    },
+};
+
+// Blend buffers (blending task only, except the slot handed to the player)
+typedef struct {
+    motion_keyframe_t frames[MOTION_PRIM_BLEND_FRAMES];
+    motion_clip_t clip;
+} blend_slot_t;
+
+static blend_slot_t s_blend[MOTION_PRIM_BLEND_SLOTS];
+static const motion_clip_t *s_blend_last = NULL;    // Last blend handed to the player
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL HELPERS
+// ═══════════════════════════════════════════════════════
+
+static inline float lerp(float a, float b, float w)
+{
+    return a + (b - a) * w;
+}
+
+/**
+ * @brief A blend buffer the player is neither playing nor about to play
+ */
+static blend_slot_t *free_blend_slot(void)
+{
+    const motion_clip_t *current = motion_current();
+    
+    for (int i = 0; i < MOTION_PRIM_BLEND_SLOTS; i++) {
+        const motion_clip_t *clip = &s_blend[i].clip;
+        if (clip != current && clip != s_blend_last) {
+            return &s_blend[i];
+        }
+    }
+    return NULL;
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+const motion_clip_t *motion_prim_get(motion_prim_id_t id)
+{
+    return ((unsigned)id < MOTION_PRIM_COUNT) ? &s_clips[id] : NULL;
+}
+
+int motion_prim_find(const char *name)
+{
+    for (int i = 0; i < MOTION_PRIM_COUNT; i++) {
+        if (strcmp(name, s_clips[i].name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool motion_prim_play(motion_prim_id_t id, uint8_t cycles)
+{
+    return motion_play(motion_prim_get(id), cycles);
+}
+
+bool motion_prim_play_blend(motion_prim_id_t a, motion_prim_id_t b, float weight, uint8_t cycles)
+{
+    const motion_clip_t *ca = motion_prim_get(a);
+    const motion_clip_t *cb = motion_prim_get(b);
+    
+    if (ca == NULL || cb == NULL) {
+        return false;
+    }
+    if (ca->frame_count != cb->frame_count || ca->frame_count > MOTION_PRIM_BLEND_FRAMES) {
+        ESP_LOGW(TAG, "Cannot blend '%s' (%d keyframes) with '%s' (%d)",
+                 ca->name, ca->frame_count, cb->name, cb->frame_count);
+        return false;
+    }
+    if (weight < 0.0f) weight = 0.0f;
+    if (weight > 1.0f) weight = 1.0f;
+    
+    blend_slot_t *slot = free_blend_slot();
+    if (slot == NULL) {
+        return false;
+    }
+    
+    for (int i = 0; i < ca->frame_count; i++) {
+        const motion_keyframe_t *ka = &ca->frames[i];
+        const motion_keyframe_t *kb = &cb->frames[i];
+        slot->frames[i] = (motion_keyframe_t){
+            .fr = lerp(ka->fr, kb->fr, weight),
+            .fl = lerp(ka->fl, kb->fl, weight),
+            .br = lerp(ka->br, kb->br, weight),
+            .bl = lerp(ka->bl, kb->bl, weight),
+            .speed = (uint16_t)lroundf(lerp(ka->speed, kb->speed, weight)),
+            .delay_ms = (uint16_t)lroundf(lerp(ka->delay_ms, kb->delay_ms, weight)),
+        };
+    }
+    slot->clip = (motion_clip_t){
+        .name = "blend",
+        .frames = slot->frames,
+        .frame_count = ca->frame_count,
+        .priority = (ca->priority > cb->priority) ? ca->priority : cb->priority,
+        .delay_offset_ms = (uint16_t)lroundf(lerp(ca->delay_offset_ms, cb->delay_offset_ms, weight)),
+    };
+    
+    if (!motion_play(&slot->clip, cycles)) {
+        return false;
+    }
+    s_blend_last = &slot->clip;
+    ESP_LOGI(TAG, "Blending '%s' and '%s' (%.0f%%)", ca->name, cb->name, weight * 100.0f);
+    return true;
+}
+
+uint16_t motion_prim_to_events(motion_prim_id_t id, motion_event_t *events, uint16_t max,
+                               uint32_t *duration_ms)
+{
+    const motion_clip_t *clip = motion_prim_get(id);
+    
+    if (clip == NULL || clip->frame_count * MOTION_TIMELINE_LEGS > max) {
+        return 0;
+    }
+    
+    uint16_t n = 0;
+    uint32_t t_ms = 0;
+    for (int i = 0; i < clip->frame_count; i++) {
+        const motion_keyframe_t *kf = &clip->frames[i];
+        const float angles[MOTION_TIMELINE_LEGS] = { kf->fr, kf->fl, kf->br, kf->bl };
+        for (int leg = 0; leg < MOTION_TIMELINE_LEGS; leg++) {
+            events[n++] = (motion_event_t){
+                .t_ms = t_ms,
+                .angle_x10 = (int16_t)lroundf(angles[leg] * 10.0f),
+                .speed = kf->speed,
+                .leg = (uint8_t)leg,
+                .interp = MOTION_INTERP_STEP,
+            };
+        }
+        t_ms += kf->delay_ms + clip->delay_offset_ms;
+    }
+    
+    if (duration_ms) {
+        *duration_ms = t_ms;
+    }
+    return n;
+}
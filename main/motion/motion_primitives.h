@@ -0,0 +1,95 @@
+/**
+ * @file motion_primitives.h
+ * @brief Built-in Motion Primitives
+ * 
+ * The robot's canned movements as keyframe clips in flash, ready for the
+ * motion player: nothing is computed or loaded when one is triggered, so
+ * BLE, the push reactions and demo mode all start them instantly and
+ * without blocking.
+ * 
+ *   crawl_forward  one crawl cycle, BL -> FR -> BR -> FL (1 s)
+ *   turn_right     one turning cycle, BL -> BR -> FL -> FR (1 s)
+ *   turn_left      mirror of turn_right, BR -> BL -> FR -> FL (1 s)
+ *   walk_forward   steps forward after a push from behind (reaction)
+ *   walk_backward  walk_forward run in reverse (reaction)
+ * 
+ * Two primitives with the same number of keyframes can be blended: every
+ * keyframe is mixed by weight, so crawl_forward and turn_right make an
+ * arc. A blend is built into a buffer neither playing nor queued.
+ * 
+ * A primitive can also be exported as timeline events (one STEP event
+ * per leg and keyframe) to be stored and edited like an uploaded one.
+ */
+
+#ifndef MOTION_PRIMITIVES_H
+#define MOTION_PRIMITIVES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motion_player.h"
+#include "motion_timeline.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define MOTION_PRIM_PRIORITY        1       // Locomotion primitives (equal to the reactions)
+#define MOTION_PRIM_BLEND_FRAMES    8       // Longest primitive that can be blended
+#define MOTION_PRIM_BLEND_SLOTS     3       // Playing, queued and the one being built
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef enum {
+    MOTION_PRIM_CRAWL_FORWARD,
+    MOTION_PRIM_TURN_RIGHT,
+    MOTION_PRIM_TURN_LEFT,
+    MOTION_PRIM_WALK_FORWARD,
+    MOTION_PRIM_WALK_BACKWARD,
+    MOTION_PRIM_COUNT
+} motion_prim_id_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Get a primitive's clip
+ * @return Clip, or NULL for an unknown ID
+ */
+const motion_clip_t *motion_prim_get(motion_prim_id_t id);
+
+/**
+ * @brief Look a primitive up by its clip name
+ * @return ID, or -1 if there is none with that name
+ */
+int motion_prim_find(const char *name);
+
+/**
+ * @brief Play a primitive (non-blocking, safe from any task)
+ * @param cycles Number of times to repeat it; returns to stance after the last
+ * @return false if a higher-priority clip is playing
+ */
+bool motion_prim_play(motion_prim_id_t id, uint8_t cycles);
+
+/**
+ * @brief Play a mix of two primitives
+ * @param weight Share of b in every keyframe, 0.0 (all a) to 1.0 (all b)
+ * @return false if their keyframe counts differ or the clip was refused
+ * 
+ * Call from one task at a time (the BLE host task).
+ */
+bool motion_prim_play_blend(motion_prim_id_t a, motion_prim_id_t b, float weight, uint8_t cycles);
+
+/**
+ * @brief Convert one pass of a primitive to timeline events
+ * @param events Output, 4 events per keyframe
+ * @param max Capacity of events
+ * @param duration_ms Output, length of the pass (clip delay offset included)
+ * @return Number of events, or 0 for an unknown ID or too small a buffer
+ */
+uint16_t motion_prim_to_events(motion_prim_id_t id, motion_event_t *events, uint16_t max,
+                               uint32_t *duration_ms);
+
+#endif // MOTION_PRIMITIVES_H
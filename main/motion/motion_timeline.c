@@ -0,0 +1,422 @@
+/**
+ * @file motion_timeline.c
+ * @brief Stored Keyframe Timeline Implementation
+ * 
+ * Timelines are stored as one NVS blob per slot: a header followed by
+ * the events, sorted by time. Playing loads the blob into whichever of
+ * two buffers the control tick is not using and hands it over under a
+ * spinlock, so loading never touches the timeline being played.
+ */
+
+#include "motion_timeline.h"
+#include "dog_config.h"
+#include "control_loop.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "TIMELINE";
+
+#define TIMELINE_MAGIC      0x4C54      // "TL"
+#define TIMELINE_VERSION    1
+#define NO_EVENT            0xFFFF
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Stored blob header
+ */
+typedef struct {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t flags;
+    uint16_t count;
+    uint16_t reserved;
+    uint32_t duration_ms;
+} timeline_header_t;
+
+typedef struct {
+    timeline_header_t header;
+    motion_event_t events[MOTION_TIMELINE_MAX_EVENTS];
+    uint16_t next[MOTION_TIMELINE_MAX_EVENTS];  // Next event index for the same leg
+} timeline_buf_t;
+
+// Events follow the header directly, in the blob and in the buffer
+_Static_assert(offsetof(timeline_buf_t, events) == sizeof(timeline_header_t),
+               "timeline blob layout must match timeline_buf_t");
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+// Upload staging (BLE host task only)
+static timeline_header_t s_upload_header;
+static motion_event_t s_upload_events[MOTION_TIMELINE_MAX_EVENTS];
+static uint8_t s_upload_id = 0;
+static uint16_t s_upload_received = 0;
+static bool s_upload_open = false;
+
+// Playback buffers: one playing, one free for the next load
+static timeline_buf_t s_bufs[2];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static timeline_buf_t *s_pending = NULL;        // Loaded, waiting for the tick
+static timeline_buf_t * volatile s_active = NULL;
+static bool s_stop_request = false;
+
+// Playback state (control task only)
+static int64_t s_start_us = 0;
+static uint16_t s_cursor = 0;                   // Next event to fire
+static uint16_t s_segment[MOTION_TIMELINE_LEGS]; // Last fired event per leg
+
+static int s_loop_client = -1;
+
+// ═══════════════════════════════════════════════════════
+// HELPER FUNCTIONS
+// ═══════════════════════════════════════════════════════
+
+static void slot_key(uint8_t id, char *key, size_t len)
+{
+    snprintf(key, len, "tl%u", id);
+}
+
+static float event_angle(const motion_event_t *e)
+{
+    return e->angle_x10 / 10.0f;
+}
+
+/**
+ * @brief Link each event to the next one for the same leg
+ */
+static void link_segments(timeline_buf_t *buf)
+{
+    uint16_t last[MOTION_TIMELINE_LEGS];
+    for (int leg = 0; leg < MOTION_TIMELINE_LEGS; leg++) {
+        last[leg] = NO_EVENT;
+    }
+    
+    for (uint16_t i = 0; i < buf->header.count; i++) {
+        uint8_t leg = buf->events[i].leg;
+        buf->next[i] = NO_EVENT;
+        if (last[leg] != NO_EVENT) {
+            buf->next[last[leg]] = i;
+        }
+        last[leg] = i;
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// PLAYBACK
+// ═══════════════════════════════════════════════════════
+
+static void restart(int64_t tick_us)
+{
+    s_start_us = tick_us;
+    s_cursor = 0;
+    for (int leg = 0; leg < MOTION_TIMELINE_LEGS; leg++) {
+        s_segment[leg] = NO_EVENT;
+    }
+}
+
+/**
+ * @brief Control loop tick: fire due events and step linear segments
+ */
+static void timeline_tick(void *ctx, int64_t tick_us)
+{
+    // s_active changes under the lock so a concurrent load never picks it
+    portENTER_CRITICAL(&s_lock);
+    timeline_buf_t *pending = s_pending;
+    bool stopped = s_stop_request && s_active != NULL;
+    if (s_stop_request) {
+        s_active = NULL;
+    }
+    if (pending != NULL) {
+        s_active = pending;
+    }
+    s_pending = NULL;
+    s_stop_request = false;
+    portEXIT_CRITICAL(&s_lock);
+    
+    if (stopped) {
+        ESP_LOGI(TAG, "Timeline stopped");
+        dog_bus_release(DOG_BUS_PRIO_BLE);
+    }
+    if (pending != NULL) {
+        restart(tick_us);
+    }
+    
+    timeline_buf_t *tl = s_active;
+    if (tl == NULL) {
+        return;
+    }
+    
+    uint32_t now_ms = (uint32_t)((tick_us - s_start_us) / 1000);
+    float targets[MOTION_TIMELINE_LEGS];
+    uint16_t speeds[MOTION_TIMELINE_LEGS];
+    uint8_t changed = 0;
+    
+    // Events whose time has come
+    while (s_cursor < tl->header.count && tl->events[s_cursor].t_ms <= now_ms) {
+        const motion_event_t *e = &tl->events[s_cursor];
+        s_segment[e->leg] = s_cursor;
+        targets[e->leg] = event_angle(e);
+        speeds[e->leg] = e->speed;
+        changed |= (1u << e->leg);
+        s_cursor++;
+    }
+    
+    // Linear segments move every tick until the leg's next event
+    for (int leg = 0; leg < MOTION_TIMELINE_LEGS; leg++) {
+        uint16_t idx = s_segment[leg];
+        if (idx == NO_EVENT || tl->events[idx].interp != MOTION_INTERP_LINEAR ||
+            tl->next[idx] == NO_EVENT) {
+            continue;
+        }
+        
+        const motion_event_t *a = &tl->events[idx];
+        const motion_event_t *b = &tl->events[tl->next[idx]];
+        float span = (float)(b->t_ms - a->t_ms);
+        float alpha = (span > 0.0f) ? (float)(now_ms - a->t_ms) / span : 1.0f;
+        if (alpha > 1.0f) {
+            alpha = 1.0f;
+        }
+        
+        targets[leg] = event_angle(a) + (event_angle(b) - event_angle(a)) * alpha;
+        speeds[leg] = a->speed;
+        changed |= (1u << leg);
+    }
+    
+    // One bus command for every leg that moves this tick
+    if (changed) {
+        uint8_t ids[MOTION_TIMELINE_LEGS];
+        float angles[MOTION_TIMELINE_LEGS];
+        uint16_t goal_speeds[MOTION_TIMELINE_LEGS];
+        int count = 0;
+        
+        for (int leg = 0; leg < MOTION_TIMELINE_LEGS; leg++) {
+            if (!(changed & (1u << leg))) {
+                continue;
+            }
+            uint8_t servo_id = leg + 1;
+            ids[count] = servo_id;
+            angles[count] = DOG_IS_RIGHT_SIDE(servo_id) ? DOG_REVERSE_ANGLE(targets[leg]) : targets[leg];
+            goal_speeds[count] = speeds[leg];
+            count++;
+        }
+        dog_servo_move_raw(ids, angles, goal_speeds, count, DOG_BUS_PRIO_BLE);
+    }
+    
+    if (s_cursor >= tl->header.count && now_ms >= tl->header.duration_ms) {
+        if (tl->header.flags & MOTION_TIMELINE_FLAG_LOOP) {
+            restart(s_start_us + (int64_t)tl->header.duration_ms * 1000);
+        } else {
+            ESP_LOGI(TAG, "Timeline complete");
+            s_active = NULL;
+            dog_bus_release(DOG_BUS_PRIO_BLE);
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool motion_timeline_init(void)
+{
+    if (s_loop_client >= 0) {
+        return true;
+    }
+    
+    s_loop_client = control_loop_register("timeline", timeline_tick, NULL);
+    if (s_loop_client < 0) {
+        ESP_LOGE(TAG, "Failed to register with control loop");
+        return false;
+    }
+    
+    ESP_LOGI(TAG, "Timeline player ready (%d events max)", MOTION_TIMELINE_MAX_EVENTS);
+    return true;
+}
+
+bool motion_timeline_upload_begin(uint8_t id, uint16_t count, uint8_t flags, uint32_t duration_ms)
+{
+    if (count == 0 || count > MOTION_TIMELINE_MAX_EVENTS) {
+        ESP_LOGW(TAG, "Timeline %u: %u events (max %d)", id, count, MOTION_TIMELINE_MAX_EVENTS);
+        s_upload_open = false;
+        return false;
+    }
+    
+    s_upload_header = (timeline_header_t) {
+        .magic = TIMELINE_MAGIC,
+        .version = TIMELINE_VERSION,
+        .flags = flags,
+        .count = count,
+        .duration_ms = duration_ms,
+    };
+    s_upload_id = id;
+    s_upload_received = 0;
+    s_upload_open = true;
+    return true;
+}
+
+bool motion_timeline_upload_events(uint16_t first, const motion_event_t *events, uint16_t n)
+{
+    if (!s_upload_open || first != s_upload_received ||
+        n > s_upload_header.count - s_upload_received) {
+        ESP_LOGW(TAG, "Timeline upload out of order (got %u, expected %u)", first, s_upload_received);
+        s_upload_open = false;
+        return false;
+    }
+    
+    memcpy(&s_upload_events[first], events, n * sizeof(motion_event_t));
+    s_upload_received += n;
+    return true;
+}
+
+esp_err_t motion_timeline_upload_commit(void)
+{
+    if (!s_upload_open || s_upload_received != s_upload_header.count) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_upload_open = false;
+    
+    uint16_t count = s_upload_header.count;
+    for (uint16_t i = 0; i < count; i++) {
+        if (s_upload_events[i].leg >= MOTION_TIMELINE_LEGS ||
+            s_upload_events[i].interp > MOTION_INTERP_LINEAR) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    
+    // Stable insertion sort by time (uploads are usually sorted already)
+    for (uint16_t i = 1; i < count; i++) {
+        motion_event_t e = s_upload_events[i];
+        int j = i - 1;
+        while (j >= 0 && s_upload_events[j].t_ms > e.t_ms) {
+            s_upload_events[j + 1] = s_upload_events[j];
+            j--;
+        }
+        s_upload_events[j + 1] = e;
+    }
+    
+    if (s_upload_header.duration_ms < s_upload_events[count - 1].t_ms) {
+        s_upload_header.duration_ms = s_upload_events[count - 1].t_ms;
+    }
+    
+    // Header and events in one blob, so a slot is never half written
+    static uint8_t blob[sizeof(timeline_header_t) + sizeof(s_upload_events)];
+    size_t size = sizeof(timeline_header_t) + count * sizeof(motion_event_t);
+    memcpy(blob, &s_upload_header, sizeof(timeline_header_t));
+    memcpy(blob + sizeof(timeline_header_t), s_upload_events, count * sizeof(motion_event_t));
+    
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(MOTION_TIMELINE_NVS_NS, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "nvs_open failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    char key[8];
+    slot_key(s_upload_id, key, sizeof(key));
+    ret = nvs_set_blob(handle, key, blob, size);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to store timeline %u: %s", s_upload_id, esp_err_to_name(ret));
+        return ret;
+    }
+    
+    ESP_LOGI(TAG, "Stored timeline %u: %u events, %lu ms%s", s_upload_id, count,
+             (unsigned long)s_upload_header.duration_ms,
+             (s_upload_header.flags & MOTION_TIMELINE_FLAG_LOOP) ? ", looping" : "");
+    return ESP_OK;
+}
+
+esp_err_t motion_timeline_play(uint8_t id)
+{
+    if (s_loop_client < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    // Claim the buffer the tick is not playing, cancelling any pending load
+    portENTER_CRITICAL(&s_lock);
+    timeline_buf_t *buf = (s_active == &s_bufs[0]) ? &s_bufs[1] : &s_bufs[0];
+    s_pending = NULL;
+    portEXIT_CRITICAL(&s_lock);
+    
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(MOTION_TIMELINE_NVS_NS, NVS_READONLY, &handle);
+    if (ret != ESP_OK) {
+        return (ret == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : ret;
+    }
+    
+    char key[8];
+    slot_key(id, key, sizeof(key));
+    size_t size = sizeof(timeline_header_t) + sizeof(buf->events);
+    ret = nvs_get_blob(handle, key, buf, &size);
+    nvs_close(handle);
+    
+    if (ret == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    const timeline_header_t *h = &buf->header;
+    if (h->magic != TIMELINE_MAGIC || h->version != TIMELINE_VERSION ||
+        h->count == 0 || h->count > MOTION_TIMELINE_MAX_EVENTS ||
+        size != sizeof(timeline_header_t) + h->count * sizeof(motion_event_t)) {
+        ESP_LOGW(TAG, "Timeline %u is corrupt or from another version", id);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    
+    link_segments(buf);
+    
+    portENTER_CRITICAL(&s_lock);
+    s_pending = buf;
+    s_stop_request = false;
+    portEXIT_CRITICAL(&s_lock);
+    
+    ESP_LOGI(TAG, "Playing timeline %u (%u events, %lu ms)", id, h->count,
+             (unsigned long)h->duration_ms);
+    return ESP_OK;
+}
+
+void motion_timeline_stop(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_pending = NULL;
+    s_stop_request = true;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool motion_timeline_is_playing(void)
+{
+    return s_active != NULL || s_pending != NULL;
+}
+
+esp_err_t motion_timeline_erase(uint8_t id)
+{
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(MOTION_TIMELINE_NVS_NS, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    char key[8];
+    slot_key(id, key, sizeof(key));
+    ret = nvs_erase_key(handle, key);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    
+    return (ret == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : ret;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file motion_timeline.h
+ * @brief Stored Keyframe Timelines
+ * 
+ * A timeline is a list of per-leg events with absolute timestamps. It is
+ * uploaded once (begin / events / commit), stored in NVS under a small
+ * numeric ID, and replayed by ID. Playback runs from the control loop, so
+ * timing follows the control-loop clock, not BLE arrival times.
+ * 
+ * At its timestamp an event either commands the leg directly (STEP: the
+ * servo moves at the event speed) or starts a LINEAR segment that is
+ * interpolated every tick until the leg's next event.
+ */
+
+#ifndef MOTION_TIMELINE_H
+#define MOTION_TIMELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// ═══════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+#define MOTION_TIMELINE_MAX_EVENTS  256     // Events per timeline
+#define MOTION_TIMELINE_LEGS        4       // FR, FL, BR, BL (servo ID - 1)
+#define MOTION_TIMELINE_NVS_NS      "timeline"
+
+#define MOTION_TIMELINE_FLAG_LOOP   0x01    // Restart after duration_ms
+
+// ═══════════════════════════════════════════════════════
+// TYPES
+// ═══════════════════════════════════════════════════════
+
+typedef enum {
+    MOTION_INTERP_STEP = 0,     // Command the target at the event time
+    MOTION_INTERP_LINEAR,       // Interpolate towards the leg's next event
+} motion_interp_t;
+
+/**
+ * @brief One leg target at an absolute time
+ */
+typedef struct {
+    uint32_t t_ms;              // Time from timeline start
+    int16_t angle_x10;          // Unified angle, tenths of a degree
+    uint16_t speed;             // Servo speed (0-4095)
+    uint8_t leg;                // 0-3: FR, FL, BR, BL
+    uint8_t interp;             // motion_interp_t
+} motion_event_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Register the player with the control loop
+ * @return true if the player is ready
+ */
+bool motion_timeline_init(void);
+
+/**
+ * @brief Start uploading a timeline (replaces any upload in progress)
+ * @param id Storage slot
+ * @param count Number of events that will follow
+ * @param flags MOTION_TIMELINE_FLAG_*
+ * @param duration_ms Length of one pass (at least the last event time)
+ * @return false if count is 0 or above MOTION_TIMELINE_MAX_EVENTS
+ */
+bool motion_timeline_upload_begin(uint8_t id, uint16_t count, uint8_t flags, uint32_t duration_ms);
+
+/**
+ * @brief Add events to the upload, in order
+ * @param first Index of events[0] (must continue the previous call)
+ * @param events Events to add
+ * @param n Number of events
+ * @return false on an out-of-order or out-of-range batch
+ */
+bool motion_timeline_upload_events(uint16_t first, const motion_event_t *events, uint16_t n);
+
+/**
+ * @brief Validate the complete upload and store it in NVS
+ * 
+ * Events are sorted by time, so they may be uploaded in any order.
+ * 
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if events are missing,
+ *         ESP_ERR_INVALID_ARG on a bad event, or an NVS error
+ */
+esp_err_t motion_timeline_upload_commit(void);
+
+/**
+ * @brief Load a stored timeline and start it on the next control tick
+ * @param id Storage slot
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the slot is empty, or an NVS error
+ */
+esp_err_t motion_timeline_play(uint8_t id);
+
+/**
+ * @brief Stop the playing timeline (servos keep their last goals)
+ */
+void motion_timeline_stop(void);
+
+/**
+ * @brief Check if a timeline is playing (or about to start)
+ */
+bool motion_timeline_is_playing(void);
+
+/**
+ * @brief Delete a stored timeline
+ * @param id Storage slot
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the slot is empty, or an NVS error
+ */
+esp_err_t motion_timeline_erase(uint8_t id);
+
+#endif // MOTION_TIMELINE_H
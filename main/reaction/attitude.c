@@ -0,0 +1,189 @@
+/**
+ * @file attitude.c
+ * @brief Attitude estimator implementation
+ * 
+ * Mahony filter: the cross product between measured and estimated gravity
+ * is the tilt error. It feeds back into the gyro rates through a PI term
+ * before the quaternion is integrated. Runs in single-precision float on
+ * the S3 FPU, about 60 flops per sample.
+ */
+
+#include "attitude.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "ATTITUDE";
+
+#define DEG_TO_RAD      0.017453293f
+#define RAD_TO_DEG      57.29577951f
+#define GRAVITY_MS2     9.81f
+
+// ═══════════════════════════════════════════════════════
+// ESTIMATOR STATE
+// ═══════════════════════════════════════════════════════
+
+// Working state, touched only by the IMU task
+static float q0 = 1.0f, q1 = 0.0f, q2 = 0.0f, q3 = 0.0f;
+static float bias_x = 0.0f, bias_y = 0.0f, bias_z = 0.0f;   // Integral term (rad/s)
+static int64_t last_us = 0;
+static bool seeded = false;
+
+// Published estimate, copied under the lock for readers on other tasks
+static attitude_t s_estimate;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ═══════════════════════════════════════════════════════
+// HELPER FUNCTIONS
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Set the orientation from the gravity direction alone (yaw = 0)
+ */
+static void seed_from_accel(float ax, float ay, float az)
+{
+    float roll = atan2f(ay, az);
+    float pitch = atan2f(-ax, sqrtf(ay * ay + az * az));
+    
+    float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+    float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+    
+    q0 = cr * cp;
+    q1 = sr * cp;
+    q2 = cr * sp;
+    q3 = -sr * sp;
+    
+    bias_x = bias_y = bias_z = 0.0f;
+}
+
+/**
+ * @brief One Mahony step (gyro in rad/s, accel in any unit)
+ */
+static void fuse(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+{
+    float norm = sqrtf(ax * ax + ay * ay + az * az);
+    float g_ratio = norm / GRAVITY_MS2;
+    
+    // Only trust the accelerometer when it mostly measures gravity
+    if (g_ratio > 1.0f - ATTITUDE_ACCEL_GATE_G && g_ratio < 1.0f + ATTITUDE_ACCEL_GATE_G) {
+        float inv = 1.0f / norm;
+        ax *= inv;
+        ay *= inv;
+        az *= inv;
+        
+        // Gravity direction predicted by the current estimate
+        float vx = 2.0f * (q1 * q3 - q0 * q2);
+        float vy = 2.0f * (q0 * q1 + q2 * q3);
+        float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+        
+        // Error is the rotation that takes the estimate onto the measurement
+        float ex = ay * vz - az * vy;
+        float ey = az * vx - ax * vz;
+        float ez = ax * vy - ay * vx;
+        
+        bias_x += ATTITUDE_KI * ex * dt;
+        bias_y += ATTITUDE_KI * ey * dt;
+        bias_z += ATTITUDE_KI * ez * dt;
+        
+        gx += ATTITUDE_KP * ex + bias_x;
+        gy += ATTITUDE_KP * ey + bias_y;
+        gz += ATTITUDE_KP * ez + bias_z;
+    } else {
+        gx += bias_x;
+        gy += bias_y;
+        gz += bias_z;
+    }
+    
+    // q += 0.5 * q ⊗ (0, g) * dt
+    float h = 0.5f * dt;
+    float a = q0, b = q1, c = q2;
+    q0 += (-b * gx - c * gy - q3 * gz) * h;
+    q1 += ( a * gx + c * gz - q3 * gy) * h;
+    q2 += ( a * gy - b * gz + q3 * gx) * h;
+    q3 += ( a * gz + b * gy - c * gx) * h;
+    
+    float qn = 1.0f / sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q0 *= qn;
+    q1 *= qn;
+    q2 *= qn;
+    q3 *= qn;
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+void attitude_init(void)
+{
+    attitude_reset();
+    
+    ESP_LOGI(TAG, "Attitude estimator initialized (Kp=%.2f Ki=%.3f, accel gate ±%.0f%%)",
+             ATTITUDE_KP, ATTITUDE_KI, ATTITUDE_ACCEL_GATE_G * 100.0f);
+}
+
+void attitude_reset(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    seeded = false;
+    memset(&s_estimate, 0, sizeof(s_estimate));
+    s_estimate.q[0] = 1.0f;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void attitude_update(const qmi8658a_fixed_data_t *samples, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+    
+    float rate_x = 0.0f, rate_y = 0.0f;
+    
+    for (int i = 0; i < count; i++) {
+        const qmi8658a_fixed_data_t *s = &samples[i];
+        float ax = QMI8658A_Q16_TO_FLOAT(s->accel_x);
+        float ay = QMI8658A_Q16_TO_FLOAT(s->accel_y);
+        float az = QMI8658A_Q16_TO_FLOAT(s->accel_z);
+        float gx = QMI8658A_Q16_TO_FLOAT(s->gyro_x) * DEG_TO_RAD;
+        float gy = QMI8658A_Q16_TO_FLOAT(s->gyro_y) * DEG_TO_RAD;
+        float gz = QMI8658A_Q16_TO_FLOAT(s->gyro_z) * DEG_TO_RAD;
+        
+        int64_t dt_us = s->timestamp_us - last_us;
+        last_us = s->timestamp_us;
+        
+        if (!seeded || dt_us <= 0 || dt_us > (int64_t)ATTITUDE_MAX_DT_MS * 1000) {
+            seed_from_accel(ax, ay, az);
+            seeded = true;
+        } else {
+            fuse(gx, gy, gz, ax, ay, az, dt_us * 1e-6f);
+        }
+        
+        rate_x = gx + bias_x;
+        rate_y = gy + bias_y;
+    }
+    
+    attitude_t est = {
+        .q = { q0, q1, q2, q3 },
+        .roll = atan2f(2.0f * (q0 * q1 + q2 * q3), 1.0f - 2.0f * (q1 * q1 + q2 * q2)) * RAD_TO_DEG,
+        .pitch = asinf(fmaxf(-1.0f, fminf(1.0f, 2.0f * (q0 * q2 - q1 * q3)))) * RAD_TO_DEG,
+        .roll_rate = rate_x * RAD_TO_DEG,
+        .pitch_rate = rate_y * RAD_TO_DEG,
+        .timestamp_us = last_us,
+        .valid = true,
+    };
+    
+    portENTER_CRITICAL(&s_lock);
+    s_estimate = est;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void attitude_get(attitude_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_lock);
+    *out = s_estimate;
+    portEXIT_CRITICAL(&s_lock);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file attitude.h
+ * @brief Attitude estimator (Mahony complementary filter)
+ * 
+ * Fuses gyro and accelerometer at the IMU sample rate into an orientation
+ * quaternion. The gyro is integrated for fast response while the measured
+ * gravity direction pulls roll and pitch back, so they do not drift.
+ * Yaw is unobservable without a magnetometer and is left free.
+ */
+
+#ifndef ATTITUDE_H
+#define ATTITUDE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "qmi8658a.h"
+
+// ═══════════════════════════════════════════════════════
+// ESTIMATOR CONFIGURATION
+// ═══════════════════════════════════════════════════════
+
+// Proportional gain pulling the estimate toward measured gravity (1/s)
+// Higher trusts the accelerometer more; lower rides out vibration better
+#define ATTITUDE_KP                 1.0f
+
+// Integral gain for gyro bias estimation (1/s²)
+#define ATTITUDE_KI                 0.1f
+
+// Skip accelerometer correction when |a| is this far from 1 g (pushes, steps)
+#define ATTITUDE_ACCEL_GATE_G       0.25f
+
+// Largest sample gap integrated; longer gaps re-seed from the accelerometer
+#define ATTITUDE_MAX_DT_MS          100
+
+// ═══════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Current attitude estimate
+ * 
+ * Pitch is rotation about the gyro Y axis and roll about X, signed like
+ * the gyro rates.
+ */
+typedef struct {
+    float q[4];             // Orientation quaternion (w, x, y, z)
+    float roll;             // degrees
+    float pitch;            // degrees
+    float roll_rate;        // °/s, bias-corrected
+    float pitch_rate;       // °/s, bias-corrected
+    int64_t timestamp_us;   // Time of the last fused sample
+    bool valid;             // false until the first sample
+} attitude_t;
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+/**
+ * @brief Initialize the estimator (the first sample seeds the orientation)
+ */
+void attitude_init(void);
+
+/**
+ * @brief Discard the estimate and re-seed from the next sample
+ */
+void attitude_reset(void);
+
+/**
+ * @brief Fuse a batch of IMU samples
+ * @param samples Q16.16 IMU samples, oldest first (timestamps required)
+ * @param count Number of samples
+ */
+void attitude_update(const qmi8658a_fixed_data_t *samples, int count);
+
+/**
+ * @brief Get a consistent copy of the latest estimate (any task)
+ * @param out Output estimate
+ */
+void attitude_get(attitude_t *out);
+
+#endif // ATTITUDE_H
@@ -2,12 +2,26 @@
  * @file gyro_balance.c
  * @brief Gyroscope-based balance/stabilization implementation
  * 
- * Uses gyro Y axis to keep legs facing ground.
+ * Uses the estimated pitch to keep legs facing ground.
  * Toggle feature: rotate robot on X axis (like a barrel roll) to enable/disable.
+ * 
+ * Each ring batch is split into per-axis blocks (dog_dsp.h). Gesture
+ * detection scans the gyro X block for threshold edges in integers; the
+ * D term is deadzoned and low-passed over the whole gyro Y block at the
+ * sample rate, and the PD loop runs once per update on the attitude
+ * estimate and the newest filtered rate.
+ * 
+ * Gains, deadzone, cutoff and stance come from the active parameter set
+ * (dog_params.h), taken once per tick.
  */
 
 #include "gyro_balance.h"
+#include "attitude.h"
 #include "dog_config.h"
+#include "dog_imu_ring.h"
+#include "dog_dsp.h"
+#include "dog_params.h"
+#include "control_loop.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -15,16 +29,27 @@
 
 static const char *TAG = "GYRO_BAL";
 
+// Gesture threshold in the Q16.16 format of the sample path
+#define TOGGLE_THRESHOLD_Q16    QMI8658A_Q16(GYRO_BALANCE_TOGGLE_THRESHOLD)
+
+// Speed power curve sampled at 0, 1/16 .. 1 (replaces powf per update)
+#define SPEED_CURVE_SEGMENTS    16
+
 // ═══════════════════════════════════════════════════════
 // BALANCE STATE
 // ═══════════════════════════════════════════════════════
 
 static bool balance_enabled = GYRO_BALANCE_ENABLED_DEFAULT;
-static bool initialized = false;
-static float gyro_filtered_y = 0.0f;
-static float accumulated_angle = 0.0f;
-static float prev_accumulated_angle = 0.0f;
-static TickType_t last_balance_time = 0;
+static float pitch_rate_filtered = 0.0f;      // D term input (°/s)
+static dog_dsp_biquad_t s_rate_filter;
+static uint32_t s_rate_period_us = 0;   // Sample period the filter was designed for
+static float s_rate_cutoff_hz = 0.0f;   // Cutoff it was designed for
+static float prev_front_correction = 0.0f;
+static float prev_back_correction = 0.0f;
+static int64_t last_balance_us = 0;
+static float speed_curve[SPEED_CURVE_SEGMENTS + 1];
+static dog_imu_ring_reader_t s_reader;
+static int s_loop_client = -1;          // Control loop registration
 
 // ═══════════════════════════════════════════════════════
 // TOGGLE GESTURE STATE
@@ -41,6 +66,37 @@ static int8_t first_rotation_dir = 0;   // +1 or -1
 static TickType_t toggle_gesture_start = 0;
 static TickType_t last_toggle_time = 0;
 
+// ═══════════════════════════════════════════════════════
+// HELPERS
+// ═══════════════════════════════════════════════════════
+
+static inline int32_t q16_abs(int32_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+static float clamp_correction(float angle, float max)
+{
+    if (angle > max) return max;
+    if (angle < -max) return -max;
+    return angle;
+}
+
+/**
+ * @brief Sample the speed power curve for a ratio in [0, 1]
+ */
+static float speed_curve_lookup(float ratio)
+{
+    float pos = ratio * SPEED_CURVE_SEGMENTS;
+    int index = (int)pos;
+    if (index >= SPEED_CURVE_SEGMENTS) {
+        return speed_curve[SPEED_CURVE_SEGMENTS];
+    }
+    
+    float frac = pos - index;
+    return speed_curve[index] + (speed_curve[index + 1] - speed_curve[index]) * frac;
+}
+
 // ═══════════════════════════════════════════════════════
 // TOGGLE GESTURE DETECTION
 // ═══════════════════════════════════════════════════════
@@ -50,65 +106,81 @@ static TickType_t last_toggle_time = 0;
  * 
  * Gesture: Rotate robot on X axis one way, then back.
  * This creates a distinctive pattern in gyro_x readings.
+ * 
+ * Each state only waits for one edge of |gyro_x| against the threshold,
+ * so the block is scanned from edge to edge instead of sample by sample.
+ * 
+ * @param gyro_x Gyro X block (Q16.16 °/s), oldest first
  */
-static void detect_toggle_gesture(const qmi8658a_data_t *data)
+static void detect_toggle_gesture(const int32_t *gyro_x, int count)
 {
     TickType_t now = xTaskGetTickCount();
+    int i = 0;
     
     // Check cooldown
     if (pdTICKS_TO_MS(now - last_toggle_time) < GYRO_BALANCE_TOGGLE_COOLDOWN_MS) {
         return;
     }
     
-    float gyro_x = data->gyro_x;
-    bool above_threshold = fabsf(gyro_x) >= GYRO_BALANCE_TOGGLE_THRESHOLD;
-    int8_t current_dir = (gyro_x > 0) ? 1 : -1;
-    
-    switch (toggle_state) {
-        case TOGGLE_IDLE:
-            if (above_threshold) {
-                // Start of gesture - first rotation detected
-                toggle_state = TOGGLE_FIRST_ROTATION;
-                first_rotation_dir = current_dir;
-                toggle_gesture_start = now;
-                ESP_LOGD(TAG, "Toggle gesture started (dir: %+d)", first_rotation_dir);
-            }
-            break;
-            
-        case TOGGLE_FIRST_ROTATION:
-            // Check timeout
-            if (pdTICKS_TO_MS(now - toggle_gesture_start) > GYRO_BALANCE_TOGGLE_WINDOW_MS) {
-                toggle_state = TOGGLE_IDLE;
-                ESP_LOGD(TAG, "Toggle gesture timed out");
+    while (i < count) {
+        int edge;
+        
+        switch (toggle_state) {
+            case TOGGLE_IDLE:
+                edge = i + dog_dsp_find_above(&gyro_x[i], count - i, TOGGLE_THRESHOLD_Q16);
+                if (edge < count) {
+                    // Start of gesture - first rotation detected
+                    toggle_state = TOGGLE_FIRST_ROTATION;
+                    first_rotation_dir = (gyro_x[edge] > 0) ? 1 : -1;
+                    toggle_gesture_start = now;
+                    ESP_LOGD(TAG, "Toggle gesture started (dir: %+d)", first_rotation_dir);
+                }
+                i = edge + 1;
                 break;
-            }
-            
-            // If rotation stopped, wait for reverse
-            if (!above_threshold) {
-                toggle_state = TOGGLE_WAITING_REVERSE;
-            }
-            break;
-            
-        case TOGGLE_WAITING_REVERSE:
-            // Check timeout
-            if (pdTICKS_TO_MS(now - toggle_gesture_start) > GYRO_BALANCE_TOGGLE_WINDOW_MS) {
-                toggle_state = TOGGLE_IDLE;
-                ESP_LOGD(TAG, "Toggle gesture timed out waiting for reverse");
+                
+            case TOGGLE_FIRST_ROTATION:
+                // Check timeout
+                if (pdTICKS_TO_MS(now - toggle_gesture_start) > GYRO_BALANCE_TOGGLE_WINDOW_MS) {
+                    toggle_state = TOGGLE_IDLE;
+                    ESP_LOGD(TAG, "Toggle gesture timed out");
+                    i++;
+                    break;
+                }
+                
+                // If rotation stopped, wait for reverse
+                edge = i + dog_dsp_find_below(&gyro_x[i], count - i, TOGGLE_THRESHOLD_Q16);
+                if (edge < count) {
+                    toggle_state = TOGGLE_WAITING_REVERSE;
+                }
+                i = edge + 1;
                 break;
-            }
-            
-            if (above_threshold) {
-                if (current_dir != first_rotation_dir) {
-                    // Reverse rotation detected - toggle!
+                
+            case TOGGLE_WAITING_REVERSE:
+                // Check timeout
+                if (pdTICKS_TO_MS(now - toggle_gesture_start) > GYRO_BALANCE_TOGGLE_WINDOW_MS) {
+                    toggle_state = TOGGLE_IDLE;
+                    ESP_LOGD(TAG, "Toggle gesture timed out waiting for reverse");
+                    i++;
+                    break;
+                }
+                
+                edge = i + dog_dsp_find_above(&gyro_x[i], count - i, TOGGLE_THRESHOLD_Q16);
+                if (edge == count) {
+                    return;
+                }
+                toggle_state = TOGGLE_IDLE;
+                if (((gyro_x[edge] > 0) ? 1 : -1) != first_rotation_dir) {
+                    // Reverse rotation detected - toggle! (the cooldown covers the rest)
                     bool new_state = !balance_enabled;
                     gyro_balance_enable(new_state);
                     last_toggle_time = now;
                     ESP_LOGI(TAG, "Toggle gesture complete! Balance: %s", 
                              new_state ? "ON" : "OFF");
+                    return;
                 }
-                toggle_state = TOGGLE_IDLE;
-            }
-            break;
+                i = edge + 1;
+                break;
+        }
     }
 }
 
@@ -117,74 +189,112 @@ static void detect_toggle_gesture(const qmi8658a_data_t *data)
 // ═══════════════════════════════════════════════════════
 
 /**
- * @brief Apply gyro-based stabilization to keep legs facing ground
+ * @brief PD stabilization on estimated pitch to keep legs facing ground
+ * 
+ * Front and back legs get their own correction so the axles can be
+ * scaled independently.
  */
-static void apply_balance(const qmi8658a_data_t *data)
+static void apply_balance(const dog_balance_params_t *bal, int64_t now_us)
 {
     if (!balance_enabled) {
         return;
     }
     
-    TickType_t now = xTaskGetTickCount();
-    TickType_t elapsed_ms = pdTICKS_TO_MS(now - last_balance_time);
-    
     // Rate limit updates
-    if (elapsed_ms < GYRO_BALANCE_UPDATE_INTERVAL_MS) {
+    int64_t elapsed_us = now_us - last_balance_us;
+    if (elapsed_us < (int64_t)GYRO_BALANCE_UPDATE_INTERVAL_MS * 1000) {
         return;
     }
-    last_balance_time = now;
+    last_balance_us = now_us;
     
-    // Get gyro Y reading (pitch rate in degrees/second)
-    float gyro_y = data->gyro_y;
-    
-    // Apply deadzone
-    if (fabsf(gyro_y) < GYRO_BALANCE_DEADZONE) {
-        gyro_y = 0.0f;
+    attitude_t att;
+    attitude_get(&att);
+    if (!att.valid) {
+        return;
     }
     
-    // Low-pass filter for smoothing
-    gyro_filtered_y = (GYRO_BALANCE_SMOOTHING * gyro_y) + 
-                      ((1.0f - GYRO_BALANCE_SMOOTHING) * gyro_filtered_y);
-    
-    // Calculate correction angle
-    float correction = gyro_filtered_y * GYRO_BALANCE_GAIN;
-    
-    // Integrate to accumulate angle (with decay to prevent drift)
-    accumulated_angle = accumulated_angle * 0.98f + correction * 0.02f;
+    // D term: pitch_rate_filtered, kept up to date by filter_pitch_rate()
+    float tilt = att.pitch - bal->pitch_offset;
+    float pd = bal->kp * tilt + bal->kd * pitch_rate_filtered;
     
-    // Clamp correction to maximum allowed
-    if (accumulated_angle > GYRO_BALANCE_MAX_CORRECTION) {
-        accumulated_angle = GYRO_BALANCE_MAX_CORRECTION;
-    } else if (accumulated_angle < -GYRO_BALANCE_MAX_CORRECTION) {
-        accumulated_angle = -GYRO_BALANCE_MAX_CORRECTION;
-    }
-    
-    // Apply correction to all legs
-    float front_correction = accumulated_angle;
-    float back_correction = accumulated_angle;
+    float front_correction = clamp_correction(bal->front_gain * pd, bal->max_correction);
+    float back_correction = clamp_correction(bal->back_gain * pd, bal->max_correction);
     
-    float angle_fl = DOG_STANCE_FRONT + front_correction;
-    float angle_fr = DOG_STANCE_FRONT + front_correction;
-    float angle_bl = DOG_STANCE_BACK + back_correction;
-    float angle_br = DOG_STANCE_BACK + back_correction;
+    float angle_fl = bal->stance_front + front_correction;
+    float angle_fr = bal->stance_front + front_correction;
+    float angle_bl = bal->stance_back + back_correction;
+    float angle_br = bal->stance_back + back_correction;
     
-    // Calculate dynamic speed based on angle change
-    float angle_delta = fabsf(accumulated_angle - prev_accumulated_angle);
-    prev_accumulated_angle = accumulated_angle;
+    // Calculate dynamic speed from how fast the correction is moving
+    float front_delta = fabsf(front_correction - prev_front_correction);
+    float back_delta = fabsf(back_correction - prev_back_correction);
+    prev_front_correction = front_correction;
+    prev_back_correction = back_correction;
     
-    float speed_ratio = angle_delta / GYRO_BALANCE_SPEED_THRESHOLD;
+    float dt = (elapsed_us > 1000000) ? 1.0f : elapsed_us * 1e-6f;
+    float speed_ratio = fmaxf(front_delta, back_delta) / (GYRO_BALANCE_SPEED_THRESHOLD * dt);
     if (speed_ratio > 1.0f) {
         speed_ratio = 1.0f;
     }
     
     // Apply power curve
-    speed_ratio = powf(speed_ratio, GYRO_BALANCE_SPEED_CURVE);
+    speed_ratio = speed_curve_lookup(speed_ratio);
     
     uint16_t dynamic_speed = (uint16_t)(GYRO_BALANCE_SPEED_MIN + 
                               speed_ratio * (GYRO_BALANCE_SPEED_MAX - GYRO_BALANCE_SPEED_MIN));
     
-    // Move servos
-    dog_servo_move_all(angle_fr, angle_fl, angle_br, angle_bl, dynamic_speed);
+    // Move servos (balance outranks gaits, reactions and BLE on the bus)
+    dog_servo_move_all_prio(angle_fr, angle_fl, angle_br, angle_bl, dynamic_speed,
+                            DOG_BUS_PRIO_BALANCE);
+}
+
+/**
+ * @brief Deadzone and low-pass a gyro Y block into the D term input
+ * 
+ * Filtering every sample keeps vibration above the cutoff from aliasing
+ * into the rate the PD loop picks up once per update.
+ */
+static void filter_pitch_rate(const dog_balance_params_t *bal, const int32_t *gyro_y, int count)
+{
+    static float rate[GYRO_BALANCE_BATCH_MAX];
+    
+    // Redesign when the IMU changes its output data rate or the cutoff is tuned
+    uint32_t period_us = qmi8658a_get_sample_period_us();
+    if (period_us != s_rate_period_us || bal->rate_cutoff_hz != s_rate_cutoff_hz) {
+        dog_dsp_biquad_lowpass(&s_rate_filter, bal->rate_cutoff_hz, 1e6f / period_us,
+                               GYRO_BALANCE_RATE_Q);
+        s_rate_period_us = period_us;
+        s_rate_cutoff_hz = bal->rate_cutoff_hz;
+    }
+    
+    dog_dsp_q16_to_float(gyro_y, rate, count);
+    dog_dsp_deadzone(rate, count, bal->deadzone);
+    dog_dsp_biquad_run(&s_rate_filter, rate, rate, count);
+    pitch_rate_filtered = rate[count - 1];
+}
+
+/**
+ * @brief Control loop tick: consume new IMU samples
+ */
+static void balance_tick(void *ctx, int64_t tick_us)
+{
+    static qmi8658a_fixed_data_t batch[GYRO_BALANCE_BATCH_MAX];
+    static int32_t axis[GYRO_BALANCE_BATCH_MAX];
+    const dog_balance_params_t *bal = &dog_params_active()->balance;
+    int count;
+    
+    while ((count = dog_imu_ring_read(&s_reader, batch, GYRO_BALANCE_BATCH_MAX)) > 0) {
+        // Always check for toggle gesture
+        dog_dsp_unpack(batch, count, DOG_DSP_GYRO_X, axis);
+        detect_toggle_gesture(axis, count);
+        
+        // Apply balance if enabled (the estimate already covers these samples)
+        if (balance_enabled) {
+            dog_dsp_unpack(batch, count, DOG_DSP_GYRO_Y, axis);
+            filter_pitch_rate(bal, axis, count);
+            apply_balance(bal, batch[count - 1].timestamp_us);
+        }
+    }
 }
 
 // ═══════════════════════════════════════════════════════
@@ -194,46 +304,47 @@ static void apply_balance(const qmi8658a_data_t *data)
 void gyro_balance_init(void)
 {
     ESP_LOGI(TAG, "Gyro balance system initialized");
-    ESP_LOGI(TAG, "Default: %s, Max correction: %.1f°, Gain: %.2f",
+    ESP_LOGI(TAG, "Default: %s, Max correction: %.1f°, Kp: %.2f, Kd: %.3f",
              GYRO_BALANCE_ENABLED_DEFAULT ? "ENABLED" : "DISABLED",
-             GYRO_BALANCE_MAX_CORRECTION, GYRO_BALANCE_GAIN);
+             GYRO_BALANCE_MAX_CORRECTION, GYRO_BALANCE_KP, GYRO_BALANCE_KD);
     ESP_LOGI(TAG, "Toggle gesture: rotate X-axis > %.0f dps both directions within %d ms",
              GYRO_BALANCE_TOGGLE_THRESHOLD, GYRO_BALANCE_TOGGLE_WINDOW_MS);
     
-    gyro_filtered_y = 0.0f;
-    accumulated_angle = 0.0f;
-    prev_accumulated_angle = 0.0f;
-    last_balance_time = xTaskGetTickCount();
+    pitch_rate_filtered = 0.0f;
+    prev_front_correction = 0.0f;
+    prev_back_correction = 0.0f;
+    last_balance_us = 0;
     toggle_state = TOGGLE_IDLE;
     last_toggle_time = 0;
     
-    initialized = true;
-}
-
-void gyro_balance_process(const qmi8658a_data_t *data)
-{
-    if (!initialized) {
-        return;
+    for (int i = 0; i <= SPEED_CURVE_SEGMENTS; i++) {
+        float ratio = (float)i / SPEED_CURVE_SEGMENTS;
+        speed_curve[i] = powf(ratio, GYRO_BALANCE_SPEED_CURVE);
     }
     
-    // Always check for toggle gesture
-    detect_toggle_gesture(data);
+    dog_imu_ring_reader_init(&s_reader);
     
-    // Apply balance if enabled
-    apply_balance(data);
+    if (s_loop_client < 0) {
+        s_loop_client = control_loop_register("balance", balance_tick, NULL);
+        if (s_loop_client < 0) {
+            ESP_LOGE(TAG, "Failed to register with control loop");
+        }
+    }
 }
 
 void gyro_balance_enable(bool enable)
 {
     if (enable && !balance_enabled) {
         // Reset state when enabling
-        gyro_filtered_y = 0.0f;
-        accumulated_angle = 0.0f;
-        prev_accumulated_angle = 0.0f;
-        last_balance_time = xTaskGetTickCount();
+        pitch_rate_filtered = 0.0f;
+        dog_dsp_biquad_reset(&s_rate_filter);
+        prev_front_correction = 0.0f;
+        prev_back_correction = 0.0f;
+        last_balance_us = 0;
         ESP_LOGI(TAG, "Gyro balance ENABLED");
     } else if (!enable && balance_enabled) {
-        // Return to stance smoothly when disabling
+        // Hand the legs back, then return to stance smoothly
+        dog_bus_release(DOG_BUS_PRIO_BALANCE);
         dog_goto_stance_smooth();
         ESP_LOGI(TAG, "Gyro balance DISABLED - returning to stance");
     }
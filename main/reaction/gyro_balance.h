@@ -2,7 +2,9 @@
  * @file gyro_balance.h
  * @brief Gyroscope-based balance/stabilization system
  * 
- * Keeps robot legs facing ground using gyro Y axis feedback.
+ * Keeps robot legs facing ground with a PD loop on the pitch from the
+ * attitude estimator. The legs only pivot fore/aft, so roll is not
+ * corrected.
  * Can be toggled on/off by rotating the robot on the X axis.
  */
 
@@ -16,23 +18,39 @@
 // BALANCE CONFIGURATION
 // ═══════════════════════════════════════════════════════
 
+// Gains, deadzone, rate cutoff, pitch offset, max correction and the
+// stance are defaults of the live tunable "bal.*" parameters (dog_params.h)
+
 // Enable/disable gyro stabilization at startup
 #define GYRO_BALANCE_ENABLED_DEFAULT        false
 
 // Maximum leg angle adjustment from neutral (degrees)
 #define GYRO_BALANCE_MAX_CORRECTION         90.0f
 
-// Gyro deadzone - ignore small rotations (degrees/second)
-#define GYRO_BALANCE_DEADZONE               0.5f
+// Pitch-rate deadzone for the D term (degrees/second); the gyro bias is
+// calibrated out (dog_imu_cal.h), so this only has to cover noise
+#define GYRO_BALANCE_DEADZONE               0.2f
+
+// PD gains: leg degrees per degree of tilt, and per °/s of pitch rate
+#define GYRO_BALANCE_KP                     1.0f
+#define GYRO_BALANCE_KD                     0.05f
 
-// Proportional gain for gyro response
-#define GYRO_BALANCE_GAIN                   1.6f
+// Per-axle scaling of the correction
+#define GYRO_BALANCE_FRONT_GAIN             1.0f
+#define GYRO_BALANCE_BACK_GAIN              1.0f
 
-// Low-pass filter coefficient (0.0-1.0)
-#define GYRO_BALANCE_SMOOTHING              0.3f
+// Estimated pitch when the body is level (IMU mounting offset, degrees)
+#define GYRO_BALANCE_PITCH_OFFSET           0.0f
+
+// Low-pass for the D term, run on every gyro sample (Hz, biquad Q)
+#define GYRO_BALANCE_RATE_CUTOFF_HZ         5.0f
+#define GYRO_BALANCE_RATE_Q                 0.7071f     // Butterworth
 
 // Update rate for stabilization (ms)
-#define GYRO_BALANCE_UPDATE_INTERVAL_MS     50
+#define GYRO_BALANCE_UPDATE_INTERVAL_MS     20
+
+// Samples drained from the IMU ring per read
+#define GYRO_BALANCE_BATCH_MAX              32
 
 // ═══════════════════════════════════════════════════════
 // DYNAMIC SPEED CONFIGURATION
@@ -40,7 +58,7 @@
 
 #define GYRO_BALANCE_SPEED_MIN              150
 #define GYRO_BALANCE_SPEED_MAX              2000
-#define GYRO_BALANCE_SPEED_THRESHOLD        10.0f
+#define GYRO_BALANCE_SPEED_THRESHOLD        200.0f  // Correction rate (°/s) for max speed
 #define GYRO_BALANCE_SPEED_CURVE            1.2f
 
 // ═══════════════════════════════════════════════════════
@@ -64,15 +82,12 @@
 
 /**
  * @brief Initialize the gyro balance system
+ * 
+ * Registers a control loop client that drains the IMU ring each tick
+ * for toggle detection and stabilization.
  */
 void gyro_balance_init(void);
 
-/**
- * @brief Process IMU data for balance and toggle detection
- * @param data Current IMU sensor data
- */
-void gyro_balance_process(const qmi8658a_data_t *data);
-
 /**
  * @brief Enable or disable gyro balance
  * @param enable true to enable, false to disable
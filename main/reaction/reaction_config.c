@@ -3,15 +3,19 @@
  * @brief Reaction system implementation
  * 
  * Monitors IMU data and triggers animations when thresholds are met.
+ * Samples come from this module's own cursor on the IMU ring.
  */
 
 #include "reaction_config.h"
 #include "gyro_balance.h"
 #include "walk_forward_reaction.h"
+#include "walk_backward_reaction.h"
+#include "motion_player.h"
+#include "dog_imu_ring.h"
+#include "dog_tasks.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include <math.h>
 
 static const char *TAG = "REACTION";
 
@@ -20,10 +24,20 @@ static const char *TAG = "REACTION";
 // ═══════════════════════════════════════════════════════
 
 static TickType_t last_reaction_time = 0;
-static bool initialized = false;
+static TaskHandle_t s_task_handle = NULL;
+static StaticTask_t s_task_tcb;
+static StackType_t s_task_stack[REACTION_TASK_STACK];
+static dog_imu_ring_reader_t s_reader;
 
-// Previous acceleration reading for delta calculation
-static float prev_accel_x = 0.0f;
+// Thresholds in the Q16.16 format of the sample path
+#define DELTA_THRESHOLD_Q16     QMI8658A_Q16(REACTION_DELTA_THRESHOLD)
+#define MIN_ACCEL_Q16           QMI8658A_Q16(REACTION_MIN_ACCEL)
+#define PLAYING_DELTA_Q16       QMI8658A_Q16(REACTION_DELTA_THRESHOLD * REACTION_PLAYING_THRESHOLD_SCALE)
+#define PLAYING_MIN_ACCEL_Q16   QMI8658A_Q16(REACTION_MIN_ACCEL * REACTION_PLAYING_THRESHOLD_SCALE)
+
+// Previous acceleration reading for delta calculation (Q16.16 m/s²)
+static int32_t prev_accel_x = 0;
+static int64_t prev_accel_us = 0;
 static bool has_prev_reading = false;
 
 // ═══════════════════════════════════════════════════════
@@ -48,49 +62,32 @@ static void update_reaction_time(void)
     last_reaction_time = xTaskGetTickCount();
 }
 
-// ═══════════════════════════════════════════════════════
-// PUBLIC API
-// ═══════════════════════════════════════════════════════
-
-void reaction_init(void)
-{
-    ESP_LOGI(TAG, "Reaction system initialized (delta-based detection)");
-    ESP_LOGI(TAG, "Delta threshold: %.1f m/s², Min accel: %.1f m/s²",
-             REACTION_DELTA_THRESHOLD, REACTION_MIN_ACCEL);
-    ESP_LOGI(TAG, "Cooldown: %d ms", REACTION_COOLDOWN_MS);
-    
-    prev_accel_x = 0.0f;
-    has_prev_reading = false;
-    
-    // Initialize the gyro balance subsystem
-    gyro_balance_init();
-    
-    initialized = true;
-}
-
-void reaction_process_imu(const qmi8658a_data_t *data)
+/**
+ * @brief Run push detection on one sample
+ */
+static void process_push_sample(const qmi8658a_fixed_data_t *data)
 {
-    if (!initialized) {
-        return;
-    }
-    
-    // Process gyro balance (toggle detection + stabilization)
-    gyro_balance_process(data);
-    
-    float current_accel_x = data->accel_x;
+    int32_t current_accel_x = data->accel_x;
     
     // Need a previous reading to calculate delta
     if (!has_prev_reading) {
         prev_accel_x = current_accel_x;
+        prev_accel_us = data->timestamp_us;
         has_prev_reading = true;
         return;
     }
     
+    // Compare against the reading one window earlier
+    if (data->timestamp_us - prev_accel_us < (int64_t)REACTION_DELTA_WINDOW_MS * 1000) {
+        return;
+    }
+    
     // Calculate delta (change from previous reading)
-    float delta = current_accel_x - prev_accel_x;
+    int32_t delta = current_accel_x - prev_accel_x;
     
     // Store current as previous for next iteration
     prev_accel_x = current_accel_x;
+    prev_accel_us = data->timestamp_us;
     
     // Skip push reactions if gyro balance is active
     if (gyro_balance_is_enabled()) {
@@ -102,11 +99,16 @@ void reaction_process_imu(const qmi8658a_data_t *data)
         return;
     }
     
+    // Raise the bar while our own animation is shaking the body
+    bool playing = motion_is_playing();
+    int32_t delta_threshold = playing ? PLAYING_DELTA_Q16 : DELTA_THRESHOLD_Q16;
+    int32_t min_accel = playing ? PLAYING_MIN_ACCEL_Q16 : MIN_ACCEL_Q16;
+    
     // Front push: large positive delta AND current reading is positive
     // (acceleration suddenly increased in +X direction)
-    if (delta >= REACTION_DELTA_THRESHOLD && current_accel_x >= REACTION_MIN_ACCEL) {
+    if (delta >= delta_threshold && current_accel_x >= min_accel) {
         ESP_LOGI(TAG, "Front push detected! (delta: +%.2f, accel: %.2f m/s²)",
-                 delta, current_accel_x);
+                 QMI8658A_Q16_TO_FLOAT(delta), QMI8658A_Q16_TO_FLOAT(current_accel_x));
         update_reaction_time();
         walk_forward_play(3);
         return;
@@ -114,12 +116,61 @@ void reaction_process_imu(const qmi8658a_data_t *data)
     
     // Back push: large negative delta AND current reading is negative
     // (acceleration suddenly increased in -X direction)
-    if (delta <= -REACTION_DELTA_THRESHOLD && current_accel_x <= -REACTION_MIN_ACCEL) {
+    if (delta <= -delta_threshold && current_accel_x <= -min_accel) {
         ESP_LOGI(TAG, "Back push detected! (delta: %.2f, accel: %.2f m/s²)",
-                 delta, current_accel_x);
+                 QMI8658A_Q16_TO_FLOAT(delta), QMI8658A_Q16_TO_FLOAT(current_accel_x));
         update_reaction_time();
-        // TODO: Add backward reaction animation here
-        ESP_LOGW(TAG, "Back push reaction not yet implemented");
-        return;
+        walk_backward_play(3);
+    }
+}
+
+/**
+ * @brief Drain the ring at the task's own pace and detect pushes
+ */
+static void reaction_task(void *pvParameters)
+{
+    static qmi8658a_fixed_data_t batch[REACTION_BATCH_MAX];
+    
+    dog_imu_ring_reader_init(&s_reader);
+    
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(REACTION_POLL_MS));
+        
+        int count;
+        while ((count = dog_imu_ring_read(&s_reader, batch, REACTION_BATCH_MAX)) > 0) {
+            for (int i = 0; i < count; i++) {
+                process_push_sample(&batch[i]);
+            }
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+void reaction_init(void)
+{
+    ESP_LOGI(TAG, "Reaction system initialized (delta-based detection)");
+    ESP_LOGI(TAG, "Delta threshold: %.1f m/s², Min accel: %.1f m/s²",
+             REACTION_DELTA_THRESHOLD, REACTION_MIN_ACCEL);
+    ESP_LOGI(TAG, "Cooldown: %d ms", REACTION_COOLDOWN_MS);
+    
+    prev_accel_x = 0;
+    has_prev_reading = false;
+    
+    // Reactions play as clips in the motion player
+    motion_player_init();
+    
+    // Initialize the gyro balance subsystem
+    gyro_balance_init();
+    
+    if (s_task_handle == NULL) {
+        s_task_handle = xTaskCreateStaticPinnedToCore(reaction_task, "reaction", REACTION_TASK_STACK,
+                                                      NULL, REACTION_TASK_PRIORITY, s_task_stack,
+                                                      &s_task_tcb, DOG_CONTROL_CORE);
+        if (s_task_handle == NULL) {
+            ESP_LOGE(TAG, "Failed to create reaction task");
+        }
     }
 }
@@ -22,6 +22,10 @@
 // This is the difference between current and previous reading
 #define REACTION_DELTA_THRESHOLD        7.0f    // m/s² change
 
+// Time between the two readings compared for the delta. The IMU now
+// delivers samples at the FIFO rate; the thresholds were tuned for 20 Hz.
+#define REACTION_DELTA_WINDOW_MS        50      // milliseconds
+
 // Minimum absolute acceleration to consider (filters out noise deltas)
 #define REACTION_MIN_ACCEL              3.0f    // m/s²
 
@@ -32,19 +36,34 @@
 // Increase if animation is too fast, decrease if too slow
 #define REACTION_TIMING_OFFSET_MS       100     // milliseconds
 
+// The robot's own steps shake the accelerometer; while a reaction is
+// playing, a push must beat the thresholds by this factor to preempt it
+#define REACTION_PLAYING_THRESHOLD_SCALE 1.5f
+
+// Motion player priority of push reactions (equal priority, so a new
+// push preempts the reaction already playing)
+#define REACTION_CLIP_PRIORITY          1
+
+// ═══════════════════════════════════════════════════════
+// TASK CONFIGURATION
+// ═══════════════════════════════════════════════════════
+// Reactions consume the IMU ring from their own task. Animations play
+// in the motion player, so detection keeps running while they do.
+
+#define REACTION_TASK_STACK             4096
+#define REACTION_TASK_PRIORITY          4       // Below the IMU task (5)
+#define REACTION_POLL_MS                20      // How often the ring is drained
+#define REACTION_BATCH_MAX              32      // Samples per ring read
+
 // ═══════════════════════════════════════════════════════
 // PUBLIC API
 // ═══════════════════════════════════════════════════════
 
 /**
- * @brief Initialize the reaction system
+ * @brief Initialize the reaction system and start its task
+ * 
+ * Also initializes gyro balance, which runs in the control loop.
  */
 void reaction_init(void);
 
-/**
- * @brief Process IMU data and trigger reactions if thresholds met
- * @param data Current IMU sensor data
- */
-void reaction_process_imu(const qmi8658a_data_t *data);
-
 #endif // REACTION_CONFIG_H
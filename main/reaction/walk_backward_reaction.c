@@ -0,0 +1,20 @@
+/**
+ * @file walk_backward_reaction.c
+ * @brief Walk backward animation implementation
+ * 
+ * Plays the walk_backward motion primitive, the walk forward cycle in
+ * reverse, so the feet sweep front-to-back while loaded and the body
+ * steps backward. Playback runs in the motion player.
+ */
+
+#include "walk_backward_reaction.h"
+#include "motion_primitives.h"
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool walk_backward_play(uint8_t cycles)
+{
+    return motion_prim_play(MOTION_PRIM_WALK_BACKWARD, cycles);
+}
@@ -0,0 +1,22 @@
+/**
+ * @file walk_backward_reaction.h
+ * @brief Walk backward animation triggered by back push
+ */
+
+#ifndef WALK_BACKWARD_REACTION_H
+#define WALK_BACKWARD_REACTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Start the walk backward animation (returns immediately)
+ * 
+ * Preempts a playing reaction; the robot returns to stance when done.
+ * 
+ * @param cycles Number of times to repeat the full animation
+ * @return true if playback started
+ */
+bool walk_backward_play(uint8_t cycles);
+
+#endif // WALK_BACKWARD_REACTION_H
@@ -7,11 +7,16 @@
 #define WALK_FORWARD_REACTION_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /**
- * @brief Execute the walk forward animation for the specified number of cycles
+ * @brief Start the walk forward animation (returns immediately)
+ * 
+ * Preempts a playing reaction; the robot returns to stance when done.
+ * 
  * @param cycles Number of times to repeat the full animation (default: 3)
+ * @return true if playback started
  */
-void walk_forward_play(uint8_t cycles);
+bool walk_forward_play(uint8_t cycles);
 
 #endif // WALK_FORWARD_REACTION_H
@@ -0,0 +1,48 @@
+/**
+ * @file gpio.h
+ * @brief Host Simulation: GPIO Types
+ */
+
+#ifndef SIM_DRIVER_GPIO_H
+#define SIM_DRIVER_GPIO_H
+
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_NC     (-1)
+#define GPIO_NUM_0      0
+#define GPIO_NUM_1      1
+#define GPIO_NUM_2      2
+#define GPIO_NUM_3      3
+#define GPIO_NUM_4      4
+#define GPIO_NUM_5      5
+#define GPIO_NUM_6      6
+#define GPIO_NUM_7      7
+#define GPIO_NUM_8      8
+#define GPIO_NUM_9      9
+#define GPIO_NUM_10     10
+#define GPIO_NUM_11     11
+#define GPIO_NUM_12     12
+#define GPIO_NUM_13     13
+#define GPIO_NUM_14     14
+#define GPIO_NUM_15     15
+#define GPIO_NUM_16     16
+#define GPIO_NUM_17     17
+#define GPIO_NUM_18     18
+#define GPIO_NUM_19     19
+#define GPIO_NUM_20     20
+#define GPIO_NUM_21     21
+#define GPIO_NUM_38     38
+#define GPIO_NUM_39     39
+#define GPIO_NUM_40     40
+#define GPIO_NUM_41     41
+#define GPIO_NUM_42     42
+#define GPIO_NUM_43     43
+#define GPIO_NUM_44     44
+#define GPIO_NUM_45     45
+#define GPIO_NUM_46     46
+#define GPIO_NUM_47     47
+#define GPIO_NUM_48     48
+
+#endif // SIM_DRIVER_GPIO_H
@@ -0,0 +1,16 @@
+/**
+ * @file i2c.h
+ * @brief Host Simulation: I2C Types
+ */
+
+#ifndef SIM_DRIVER_I2C_H
+#define SIM_DRIVER_I2C_H
+
+#include "driver/gpio.h"
+
+typedef int i2c_port_t;
+
+#define I2C_NUM_0       0
+#define I2C_NUM_1       1
+
+#endif // SIM_DRIVER_I2C_H
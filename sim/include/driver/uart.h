@@ -0,0 +1,17 @@
+/**
+ * @file uart.h
+ * @brief Host Simulation: UART Types
+ */
+
+#ifndef SIM_DRIVER_UART_H
+#define SIM_DRIVER_UART_H
+
+#include "esp_err.h"
+
+typedef int uart_port_t;
+
+#define UART_NUM_0      0
+#define UART_NUM_1      1
+#define UART_NUM_2      2
+
+#endif // SIM_DRIVER_UART_H
@@ -0,0 +1,32 @@
+/**
+ * @file esp_log.h
+ * @brief Host Simulation: ESP-IDF Logging
+ * 
+ * Messages go to stderr stamped with simulated time. The level is set at
+ * run time (sim_log_set_level), warnings and errors only by default so
+ * long runs are not bound by console output.
+ */
+
+#ifndef SIM_ESP_LOG_H
+#define SIM_ESP_LOG_H
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+void sim_log_set_level(esp_log_level_t level);
+void sim_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, format, ...)  sim_log_write(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  sim_log_write(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  sim_log_write(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  sim_log_write(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...)  sim_log_write(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+#endif // SIM_ESP_LOG_H
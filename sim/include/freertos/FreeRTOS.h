@@ -0,0 +1,46 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host Simulation: FreeRTOS Types and Port Macros
+ * 
+ * Simulated tasks run one at a time on a cooperative scheduler (see
+ * sim_rtos.h), so critical sections have nothing to exclude and are
+ * no-ops.
+ */
+
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              pdTRUE
+#define pdFAIL              pdFALSE
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFFUL)
+
+#define configTICK_RATE_HZ  CONFIG_FREERTOS_HZ
+#define portTICK_PERIOD_MS  (1000 / configTICK_RATE_HZ)
+
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define pdTICKS_TO_MS(t)    ((TickType_t)(((uint64_t)(t) * 1000) / configTICK_RATE_HZ))
+
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { 0 }
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux)     ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)      ((void)(mux))
+#define portYIELD_FROM_ISR(x)           ((void)(x))
+
+#endif // SIM_FREERTOS_H
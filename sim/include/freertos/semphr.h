@@ -0,0 +1,31 @@
+/**
+ * @file semphr.h
+ * @brief Host Simulation: FreeRTOS Mutexes
+ * 
+ * Tasks only switch when they block, so a critical region that does not
+ * block cannot be interleaved and mutexes never have to wait. Taking a
+ * mutex always succeeds.
+ */
+
+#ifndef SIM_FREERTOS_SEMPHR_H
+#define SIM_FREERTOS_SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_mutex *SemaphoreHandle_t;
+
+typedef struct {
+    int depth;
+} StaticSemaphore_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t *buffer);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks_to_wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+void vSemaphoreDelete(SemaphoreHandle_t mutex);
+
+#define xSemaphoreTakeRecursive(m, t)   xSemaphoreTake((m), (t))
+#define xSemaphoreGiveRecursive(m)      xSemaphoreGive(m)
+
+#endif // SIM_FREERTOS_SEMPHR_H
@@ -0,0 +1,41 @@
+/**
+ * @file task.h
+ * @brief Host Simulation: FreeRTOS Task API
+ * 
+ * Implemented by sim_rtos.c. A task runs until it blocks; the scheduler
+ * then advances simulated time to the earliest wake-up and resumes that
+ * task (higher priority first on ties).
+ */
+
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// Static task memory is unused: simulated tasks need bigger host stacks
+typedef struct {
+    int unused;
+} StaticTask_t;
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                       void *param, UBaseType_t priority, TaskHandle_t *out_handle);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *out_handle,
+                                   BaseType_t core_id);
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                                           void *param, UBaseType_t priority, StackType_t *stack,
+                                           StaticTask_t *tcb, BaseType_t core_id);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *previous_wake, TickType_t increment);
+BaseType_t xTaskDelayUntil(TickType_t *previous_wake, TickType_t increment);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+#endif // SIM_FREERTOS_TASK_H
@@ -0,0 +1,17 @@
+/**
+ * @file sdkconfig.h
+ * @brief Host Simulation Configuration
+ * 
+ * The subset of the firmware sdkconfig the simulated modules read.
+ * Tracing, benchmarks and hot-path logging stay off.
+ */
+
+#ifndef SIM_SDKCONFIG_H
+#define SIM_SDKCONFIG_H
+
+#define CONFIG_FREERTOS_HZ          100
+#define CONFIG_LOG_MAXIMUM_LEVEL    3
+#define CONFIG_DOG_CONTROL_CORE     1
+#define CONFIG_DOG_COMMS_CORE       0
+
+#endif // SIM_SDKCONFIG_H
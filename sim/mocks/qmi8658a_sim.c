@@ -0,0 +1,411 @@
+/**
+ * @file qmi8658a_sim.c
+ * @brief Simulated QMI8658A (replaces qmi8658a.c)
+ */
+
+#include "qmi8658a.h"
+#include "sim_imu.h"
+#include "sim_rtos.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static const char *TAG = "QMI_SIM";
+
+#define GRAVITY     9.81f
+
+typedef struct {
+    float t_ms;
+    float v[6];                 // ax, ay, az, gx, gy, gz
+} log_entry_t;
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static qmi8658a_config_t g_config;
+static qmi8658a_fifo_config_t g_fifo;
+static bool g_initialized = false;
+static bool g_fifo_enabled = false;
+
+static log_entry_t *s_log = NULL;
+static int s_log_len = 0;
+
+static float g_accel_lsb_per_g = 4096.0f;
+static float g_gyro_lsb_per_dps = 64.0f;
+static uint32_t g_period_us = 2000;
+static uint64_t s_next_sample = 1;      // Index of the next FIFO sample (sample k is at k * period)
+
+static qmi8658a_motion_config_t g_motion;
+static bool g_motion_enabled = false;
+static uint8_t s_motion_status = 0;     // STATUS1 flags since the last motion read
+static qmi8658a_raw_data_t s_last_raw;  // Previous FIFO sample, for the any-motion check
+static bool s_have_last = false;
+
+static qmi8658a_calibration_t g_cal = {
+    .accel_scale = { QMI8658A_Q16_ONE, QMI8658A_Q16_ONE, QMI8658A_Q16_ONE },
+};
+
+static const float odr_hz[9] = { 7174.4f, 3587.2f, 1793.6f, 896.8f, 448.4f,
+                                 224.2f, 112.1f, 56.05f, 28.025f };
+
+// ═══════════════════════════════════════════════════════
+// LOG REPLAY
+// ═══════════════════════════════════════════════════════
+
+bool sim_imu_load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return false;
+    }
+    
+    free(s_log);
+    s_log = malloc(SIM_IMU_MAX_ENTRIES * sizeof(log_entry_t));
+    s_log_len = 0;
+    
+    char line[256];
+    while (s_log && s_log_len < SIM_IMU_MAX_ENTRIES && fgets(line, sizeof(line), f)) {
+        log_entry_t e;
+        if (line[0] == '#') {
+            continue;
+        }
+        if (sscanf(line, "%f,%f,%f,%f,%f,%f,%f", &e.t_ms,
+                   &e.v[0], &e.v[1], &e.v[2], &e.v[3], &e.v[4], &e.v[5]) == 7) {
+            s_log[s_log_len++] = e;
+        }
+    }
+    fclose(f);
+    return s_log_len > 0;
+}
+
+int sim_imu_entries(void)
+{
+    return s_log_len;
+}
+
+/**
+ * @brief Physical values at a time (interpolated between log entries)
+ */
+static void sample_at(int64_t t_us, float v[6])
+{
+    static const float level[6] = { 0, 0, GRAVITY, 0, 0, 0 };
+    float t_ms = t_us / 1000.0f;
+    
+    if (s_log_len == 0) {
+        memcpy(v, level, sizeof(level));
+        return;
+    }
+    if (t_ms <= s_log[0].t_ms) {
+        memcpy(v, s_log[0].v, sizeof(s_log[0].v));
+        return;
+    }
+    if (t_ms >= s_log[s_log_len - 1].t_ms) {
+        memcpy(v, s_log[s_log_len - 1].v, sizeof(s_log[0].v));
+        return;
+    }
+    
+    // Samples are requested in time order, so resume the search
+    static int hint = 0;
+    if (hint >= s_log_len - 1 || s_log[hint].t_ms > t_ms) {
+        hint = 0;
+    }
+    while (s_log[hint + 1].t_ms < t_ms) {
+        hint++;
+    }
+    
+    const log_entry_t *a = &s_log[hint];
+    const log_entry_t *b = &s_log[hint + 1];
+    float span = b->t_ms - a->t_ms;
+    float w = (span > 0) ? (t_ms - a->t_ms) / span : 0;
+    for (int i = 0; i < 6; i++) {
+        v[i] = a->v[i] + (b->v[i] - a->v[i]) * w;
+    }
+}
+
+static int16_t quantize(float value, float lsb_per_unit)
+{
+    float raw = value * lsb_per_unit;
+    if (raw > 32767.0f) raw = 32767.0f;
+    if (raw < -32768.0f) raw = -32768.0f;
+    return (int16_t)(raw < 0 ? raw - 0.5f : raw + 0.5f);
+}
+
+static void raw_at(int64_t t_us, qmi8658a_raw_data_t *raw)
+{
+    float v[6];
+    sample_at(t_us, v);
+    
+    raw->accel_x = quantize(v[0], g_accel_lsb_per_g / GRAVITY);
+    raw->accel_y = quantize(v[1], g_accel_lsb_per_g / GRAVITY);
+    raw->accel_z = quantize(v[2], g_accel_lsb_per_g / GRAVITY);
+    raw->gyro_x = quantize(v[3], g_gyro_lsb_per_dps);
+    raw->gyro_y = quantize(v[4], g_gyro_lsb_per_dps);
+    raw->gyro_z = quantize(v[5], g_gyro_lsb_per_dps);
+    raw->timestamp_us = t_us;
+}
+
+/**
+ * @brief FIFO samples produced by now and not yet read
+ */
+static uint32_t fifo_pending(void)
+{
+    uint64_t produced = (uint64_t)esp_timer_get_time() / g_period_us;
+    return (produced >= s_next_sample) ? (uint32_t)(produced - s_next_sample + 1) : 0;
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+bool qmi8658a_init(const qmi8658a_config_t *config)
+{
+    static const float accel_lsb_per_g[4] = { 16384, 8192, 4096, 2048 };
+    static const float gyro_lsb_per_dps[8] = { 2048, 1024, 512, 256, 128, 64, 32, 16 };
+    
+    g_config = *config;
+    g_accel_lsb_per_g = accel_lsb_per_g[(config->accel_range >> 4) & 0x03];
+    g_gyro_lsb_per_dps = gyro_lsb_per_dps[(config->gyro_range >> 4) & 0x07];
+    g_period_us = (config->accel_odr < 9) ? (uint32_t)(1e6f / odr_hz[config->accel_odr]) : 10000;
+    g_initialized = true;
+    
+    ESP_LOGI(TAG, "Simulated IMU, %lu us period, %s", (unsigned long)g_period_us,
+             s_log_len ? "replaying log" : "level and still");
+    return true;
+}
+
+bool qmi8658a_check_device(void)
+{
+    return g_initialized;
+}
+
+bool qmi8658a_read_raw(qmi8658a_raw_data_t *out_data)
+{
+    if (!g_initialized) {
+        ESP_LOGE(TAG, "Not initialized");
+        return false;
+    }
+    raw_at(esp_timer_get_time(), out_data);
+    return true;
+}
+
+bool qmi8658a_read(qmi8658a_data_t *out_data)
+{
+    qmi8658a_raw_data_t raw;
+    if (!qmi8658a_read_raw(&raw)) {
+        return false;
+    }
+    qmi8658a_convert(&raw, out_data);
+    return true;
+}
+
+bool qmi8658a_read_fixed(qmi8658a_fixed_data_t *out_data)
+{
+    qmi8658a_raw_data_t raw;
+    if (!qmi8658a_read_raw(&raw)) {
+        return false;
+    }
+    qmi8658a_convert_fixed(&raw, out_data);
+    return true;
+}
+
+/**
+ * @brief Apply the calibration to one accel or gyro axis (as the driver does)
+ */
+static float calibrated(int16_t raw, float scale, int32_t cal_scale, int32_t offset)
+{
+    return raw * scale * QMI8658A_Q16_TO_FLOAT(cal_scale) - QMI8658A_Q16_TO_FLOAT(offset);
+}
+
+void qmi8658a_convert(const qmi8658a_raw_data_t *raw, qmi8658a_data_t *out_data)
+{
+    float accel_scale = GRAVITY / g_accel_lsb_per_g;
+    float gyro_scale = 1.0f / g_gyro_lsb_per_dps;
+    const int32_t one = QMI8658A_Q16_ONE;
+    
+    out_data->accel_x = calibrated(raw->accel_x, accel_scale, g_cal.accel_scale[0], g_cal.accel_offset[0]);
+    out_data->accel_y = calibrated(raw->accel_y, accel_scale, g_cal.accel_scale[1], g_cal.accel_offset[1]);
+    out_data->accel_z = calibrated(raw->accel_z, accel_scale, g_cal.accel_scale[2], g_cal.accel_offset[2]);
+    out_data->gyro_x = calibrated(raw->gyro_x, gyro_scale, one, g_cal.gyro_offset[0]);
+    out_data->gyro_y = calibrated(raw->gyro_y, gyro_scale, one, g_cal.gyro_offset[1]);
+    out_data->gyro_z = calibrated(raw->gyro_z, gyro_scale, one, g_cal.gyro_offset[2]);
+    out_data->accel_magnitude = sqrtf(out_data->accel_x * out_data->accel_x +
+                                      out_data->accel_y * out_data->accel_y +
+                                      out_data->accel_z * out_data->accel_z);
+    out_data->timestamp_us = raw->timestamp_us;
+}
+
+void qmi8658a_convert_fixed(const qmi8658a_raw_data_t *raw, qmi8658a_fixed_data_t *out_data)
+{
+    float accel_scale = GRAVITY / g_accel_lsb_per_g;
+    float gyro_scale = 1.0f / g_gyro_lsb_per_dps;
+    
+    const int32_t one = QMI8658A_Q16_ONE;
+    
+    out_data->accel_x = QMI8658A_Q16(calibrated(raw->accel_x, accel_scale, g_cal.accel_scale[0], g_cal.accel_offset[0]));
+    out_data->accel_y = QMI8658A_Q16(calibrated(raw->accel_y, accel_scale, g_cal.accel_scale[1], g_cal.accel_offset[1]));
+    out_data->accel_z = QMI8658A_Q16(calibrated(raw->accel_z, accel_scale, g_cal.accel_scale[2], g_cal.accel_offset[2]));
+    out_data->gyro_x = QMI8658A_Q16(calibrated(raw->gyro_x, gyro_scale, one, g_cal.gyro_offset[0]));
+    out_data->gyro_y = QMI8658A_Q16(calibrated(raw->gyro_y, gyro_scale, one, g_cal.gyro_offset[1]));
+    out_data->gyro_z = QMI8658A_Q16(calibrated(raw->gyro_z, gyro_scale, one, g_cal.gyro_offset[2]));
+    out_data->timestamp_us = raw->timestamp_us;
+}
+
+uint32_t qmi8658a_get_sample_period_us(void)
+{
+    return g_period_us;
+}
+
+void qmi8658a_set_calibration(const qmi8658a_calibration_t *cal)
+{
+    if (cal) {
+        g_cal = *cal;
+    } else {
+        memset(&g_cal, 0, sizeof(g_cal));
+        for (int axis = 0; axis < 3; axis++) {
+            g_cal.accel_scale[axis] = QMI8658A_Q16_ONE;
+        }
+    }
+}
+
+void qmi8658a_get_calibration(qmi8658a_calibration_t *cal)
+{
+    *cal = g_cal;
+}
+
+bool qmi8658a_set_odr(qmi8658a_accel_odr_t accel_odr, qmi8658a_gyro_odr_t gyro_odr)
+{
+    if (!g_initialized || accel_odr >= 9) {
+        return false;
+    }
+    g_config.accel_odr = accel_odr;
+    g_config.gyro_odr = gyro_odr;
+    g_period_us = (uint32_t)(1e6f / odr_hz[accel_odr]);
+    
+    // The chip restarts its sample clock and the FIFO is reset
+    s_next_sample = (uint64_t)esp_timer_get_time() / g_period_us + 1;
+    s_have_last = false;
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════
+// MOTION ENGINE API
+// ═══════════════════════════════════════════════════════
+
+bool qmi8658a_motion_enable(const qmi8658a_motion_config_t *motion)
+{
+    if (!g_initialized || motion == NULL) {
+        return false;
+    }
+    g_motion = *motion;
+    g_motion_enabled = true;
+    s_motion_status = 0;
+    return true;
+}
+
+bool qmi8658a_motion_read(uint8_t *status)
+{
+    if (!g_motion_enabled) {
+        return false;
+    }
+    *status = s_motion_status;
+    s_motion_status = 0;
+    return true;
+}
+
+/**
+ * @brief Flag any-motion when an accel axis changes by more than the threshold
+ */
+static void check_motion(const qmi8658a_raw_data_t *raw)
+{
+    if (g_motion_enabled && s_have_last) {
+        float limit = g_motion.any_threshold_g * g_accel_lsb_per_g;
+        if (fabsf((float)(raw->accel_x - s_last_raw.accel_x)) > limit ||
+            fabsf((float)(raw->accel_y - s_last_raw.accel_y)) > limit ||
+            fabsf((float)(raw->accel_z - s_last_raw.accel_z)) > limit) {
+            s_motion_status |= QMI8658A_STATUS1_ANY_MOTION;
+        }
+    }
+    s_last_raw = *raw;
+    s_have_last = true;
+}
+
+// ═══════════════════════════════════════════════════════
+// FIFO API
+// ═══════════════════════════════════════════════════════
+
+bool qmi8658a_fifo_enable(const qmi8658a_fifo_config_t *fifo)
+{
+    g_fifo = *fifo;
+    if (g_fifo.watermark == 0) {
+        g_fifo.watermark = 1;
+    }
+    s_next_sample = (uint64_t)esp_timer_get_time() / g_period_us + 1;
+    g_fifo_enabled = true;
+    return true;
+}
+
+bool qmi8658a_fifo_wait(uint32_t timeout_ms)
+{
+    if (fifo_pending() < g_fifo.watermark) {
+        int64_t watermark_us = (int64_t)(s_next_sample + g_fifo.watermark - 1) * g_period_us;
+        int64_t timeout_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+        sim_sleep_until_us(watermark_us < timeout_us ? watermark_us : timeout_us);
+    }
+    return fifo_pending() >= g_fifo.watermark;
+}
+
+int qmi8658a_fifo_read_raw(qmi8658a_raw_data_t *out, int max_samples)
+{
+    if (!g_fifo_enabled) {
+        return -1;
+    }
+    
+    int n = (int)fifo_pending();
+    if (n > max_samples) {
+        n = max_samples;
+    }
+    for (int i = 0; i < n; i++) {
+        raw_at((int64_t)s_next_sample++ * g_period_us, &out[i]);
+        check_motion(&out[i]);
+    }
+    return n;
+}
+
+int qmi8658a_fifo_read(qmi8658a_data_t *out, int max_samples)
+{
+    qmi8658a_raw_data_t raw[QMI8658A_FIFO_MAX_SAMPLES];
+    int n = qmi8658a_fifo_read_raw(raw, max_samples < QMI8658A_FIFO_MAX_SAMPLES ? max_samples : QMI8658A_FIFO_MAX_SAMPLES);
+    for (int i = 0; i < n; i++) {
+        qmi8658a_convert(&raw[i], &out[i]);
+    }
+    return n;
+}
+
+int qmi8658a_fifo_read_fixed(qmi8658a_fixed_data_t *out, int max_samples)
+{
+    qmi8658a_raw_data_t raw[QMI8658A_FIFO_MAX_SAMPLES];
+    int n = qmi8658a_fifo_read_raw(raw, max_samples < QMI8658A_FIFO_MAX_SAMPLES ? max_samples : QMI8658A_FIFO_MAX_SAMPLES);
+    for (int i = 0; i < n; i++) {
+        qmi8658a_convert_fixed(&raw[i], &out[i]);
+    }
+    return n;
+}
+
+uint32_t qmi8658a_fifo_get_overflows(void)
+{
+    return 0;
+}
+
+void qmi8658a_debug_status(void)
+{
+    ESP_LOGI(TAG, "Simulated IMU: %d log entries", s_log_len);
+}
+
+const qmi8658a_config_t* qmi8658a_get_config(void)
+{
+    return &g_config;
+}
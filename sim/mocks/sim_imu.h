@@ -0,0 +1,32 @@
+/**
+ * @file sim_imu.h
+ * @brief Simulated QMI8658A Replaying a Recorded IMU Log
+ * 
+ * Replaces qmi8658a.c. Samples are generated at the configured ODR from
+ * the log, linearly interpolated between entries and quantized like the
+ * sensor. Before the first and after the last entry the nearest entry
+ * holds; without a log the robot stands level and still.
+ * 
+ * Log format (CSV, '#' starts a comment, times relative to boot):
+ *   t_ms,ax,ay,az,gx,gy,gz      accel in m/s², gyro in °/s
+ */
+
+#ifndef SIM_IMU_H
+#define SIM_IMU_H
+
+#include <stdbool.h>
+
+#define SIM_IMU_MAX_ENTRIES     65536
+
+/**
+ * @brief Load an IMU log (replaces any log loaded before)
+ * @return false if the file cannot be read or holds no samples
+ */
+bool sim_imu_load(const char *path);
+
+/**
+ * @brief Number of log entries loaded
+ */
+int sim_imu_entries(void);
+
+#endif // SIM_IMU_H
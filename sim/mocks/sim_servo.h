@@ -0,0 +1,51 @@
+/**
+ * @file sim_servo.h
+ * @brief Simulated STS3032 Servos
+ * 
+ * Replaces sts3032_protocol.c. Packets never leave the host: writes land
+ * in a register file per servo and reads are answered from it. Present
+ * position follows the goal at the commanded speed, so telemetry and
+ * balance see plausible motion. Every goal write is recorded.
+ */
+
+#ifndef SIM_SERVO_H
+#define SIM_SERVO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define SIM_SERVO_MAX_ID        16
+#define SIM_SERVO_REGS          0x50
+#define SIM_SERVO_MAX_SPEED     3000    // steps/s at 7.4 V (goal speed 0 = this)
+#define SIM_SERVO_START_POS     2048
+
+typedef struct {
+    uint32_t goal_writes;       // Goal blocks written (all servos)
+    uint32_t packets;           // Packets "sent"
+    uint64_t hash;              // FNV-1a over every recorded goal (compare between builds)
+} sim_servo_stats_t;
+
+/**
+ * @brief Power up servos 1..count at SIM_SERVO_START_POS
+ */
+void sim_servo_init(int count);
+
+/**
+ * @brief Record goals as CSV lines "t_us,id,position,speed" (NULL to stop)
+ */
+void sim_servo_record(FILE *out);
+
+/**
+ * @brief Present position of a servo at the current simulated time
+ */
+uint16_t sim_servo_position(uint8_t id);
+
+/**
+ * @brief Hold a leg so it cannot move (stall); it then reports 100% load
+ */
+void sim_servo_block(uint8_t id, bool blocked);
+
+void sim_servo_get_stats(sim_servo_stats_t *stats);
+
+#endif // SIM_SERVO_H
@@ -0,0 +1,361 @@
+/**
+ * @file sts3032_sim.c
+ * @brief Simulated STS3032 Bus (replaces sts3032_protocol.c)
+ * 
+ * The real sts3032_servo.c runs on top of this, so the register blocks
+ * it builds are exactly the ones the firmware would put on the wire.
+ * All buses share one set of simulated servos.
+ */
+
+#include "sts3032_protocol.h"
+#include "sim_servo.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "STS_SIM";
+
+#define FNV_OFFSET  0xcbf29ce484222325ULL
+#define FNV_PRIME   0x100000001b3ULL
+
+typedef struct {
+    bool present;
+    uint8_t regs[SIM_SERVO_REGS];
+    float position;             // Present position, fractional steps
+    int64_t updated_us;
+    bool blocked;               // Leg held: does not move, reports full load
+} sim_servo_t;
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static sim_servo_t s_servos[SIM_SERVO_MAX_ID + 1];
+static FILE *s_record = NULL;
+static sim_servo_stats_t s_stats = { .hash = FNV_OFFSET };
+
+// Reply to the last PING/READ, handed out by sts_read_response()
+static uint8_t s_reply[STS_MAX_PACKET_LEN];
+static int s_reply_len = 0;
+
+// Register block of the last SYNC READ request, read by sts_sync_read_collect()
+static uint8_t s_sync_address;
+
+// ═══════════════════════════════════════════════════════
+// SERVO MODEL
+// ═══════════════════════════════════════════════════════
+
+static uint16_t reg16(const sim_servo_t *s, uint8_t addr)
+{
+    return s->regs[addr] | (s->regs[addr + 1] << 8);
+}
+
+static void set_reg16(sim_servo_t *s, uint8_t addr, uint16_t value)
+{
+    s->regs[addr] = value & 0xFF;
+    s->regs[addr + 1] = value >> 8;
+}
+
+static sim_servo_t *servo(uint8_t id)
+{
+    return (id <= SIM_SERVO_MAX_ID && s_servos[id].present) ? &s_servos[id] : NULL;
+}
+
+/**
+ * @brief Move the present position towards the goal up to now
+ */
+static void advance(sim_servo_t *s)
+{
+    int64_t now = esp_timer_get_time();
+    float dt = (float)(now - s->updated_us) * 1e-6f;
+    s->updated_us = now;
+    
+    float goal = reg16(s, STS_GOAL_POSITION_L);
+    float speed = reg16(s, STS_GOAL_SPEED_L);
+    if (speed == 0 || speed > SIM_SERVO_MAX_SPEED) {
+        speed = SIM_SERVO_MAX_SPEED;
+    }
+    
+    float step = (s->regs[STS_TORQUE_ENABLE] && !s->blocked ? speed : 0) * dt;
+    float error = goal - s->position;
+    float moved = (error > step) ? step : (error < -step) ? -step : error;
+    s->position += moved;
+    
+    // Present speed is sign-magnitude, bit 15 = reverse
+    uint16_t present_speed = (uint16_t)(dt > 0 ? (moved < 0 ? -moved : moved) / dt : 0);
+    if (moved < 0) {
+        present_speed |= 0x8000;
+    }
+    set_reg16(s, STS_PRESENT_POSITION_L, (uint16_t)(s->position + 0.5f));
+    set_reg16(s, STS_PRESENT_SPEED_L, present_speed);
+    set_reg16(s, STS_PRESENT_LOAD_L, (s->blocked && s->regs[STS_TORQUE_ENABLE]) ? 1000 : 0);
+    s->regs[STS_MOVING] = (s->position != goal);
+}
+
+static void record_goal(uint8_t id, const sim_servo_t *s)
+{
+    int64_t t = esp_timer_get_time();
+    uint16_t pos = reg16(s, STS_GOAL_POSITION_L);
+    uint16_t speed = reg16(s, STS_GOAL_SPEED_L);
+    
+    uint64_t fields[4] = { (uint64_t)t, id, pos, speed };
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 8; b++) {
+            s_stats.hash = (s_stats.hash ^ ((fields[i] >> (b * 8)) & 0xFF)) * FNV_PRIME;
+        }
+    }
+    s_stats.goal_writes++;
+    
+    if (s_record) {
+        fprintf(s_record, "%lld,%u,%u,%u\n", (long long)t, id, pos, speed);
+    }
+}
+
+static void write_regs(uint8_t id, uint8_t address, const uint8_t *data, int len)
+{
+    sim_servo_t *s = servo(id);
+    if (s == NULL || address + len > SIM_SERVO_REGS) {
+        return;
+    }
+    
+    advance(s);
+    memcpy(&s->regs[address], data, len);
+    if (address <= STS_GOAL_POSITION_H && address + len > STS_GOAL_POSITION_L) {
+        record_goal(id, s);
+    }
+}
+
+static bool read_regs(uint8_t id, uint8_t address, int len, uint8_t *data)
+{
+    sim_servo_t *s = servo(id);
+    if (s == NULL || address + len > SIM_SERVO_REGS) {
+        return false;
+    }
+    
+    advance(s);
+    memcpy(data, &s->regs[address], len);
+    return true;
+}
+
+/**
+ * @brief Stage a status packet for sts_read_response()
+ */
+static void stage_reply(uint8_t id, const uint8_t *params, int len)
+{
+    s_reply[0] = STS_FRAME_HEADER;
+    s_reply[1] = STS_FRAME_HEADER;
+    s_reply[2] = id;
+    s_reply[3] = len + 2;
+    s_reply[4] = 0;             // No error
+    memcpy(&s_reply[5], params, len);
+    s_reply_len = len + 6;
+    s_reply[s_reply_len - 1] = sts_checksum(s_reply, s_reply_len);
+}
+
+// ═══════════════════════════════════════════════════════
+// SIMULATION API
+// ═══════════════════════════════════════════════════════
+
+void sim_servo_init(int count)
+{
+    memset(s_servos, 0, sizeof(s_servos));
+    for (int id = 1; id <= count && id <= SIM_SERVO_MAX_ID; id++) {
+        sim_servo_t *s = &s_servos[id];
+        s->present = true;
+        s->regs[STS_ID] = id;
+        s->position = SIM_SERVO_START_POS;
+        set_reg16(s, STS_GOAL_POSITION_L, SIM_SERVO_START_POS);
+        set_reg16(s, STS_PRESENT_POSITION_L, SIM_SERVO_START_POS);
+        s->regs[STS_PRESENT_VOLTAGE] = 74;
+        s->regs[STS_PRESENT_TEMPERATURE] = 30;
+    }
+}
+
+void sim_servo_record(FILE *out)
+{
+    s_record = out;
+}
+
+uint16_t sim_servo_position(uint8_t id)
+{
+    sim_servo_t *s = servo(id);
+    if (s == NULL) {
+        return 0;
+    }
+    advance(s);
+    return reg16(s, STS_PRESENT_POSITION_L);
+}
+
+void sim_servo_block(uint8_t id, bool blocked)
+{
+    sim_servo_t *s = servo(id);
+    if (s != NULL) {
+        advance(s);
+        s->blocked = blocked;
+    }
+}
+
+void sim_servo_get_stats(sim_servo_stats_t *stats)
+{
+    *stats = s_stats;
+}
+
+// ═══════════════════════════════════════════════════════
+// PROTOCOL API
+// ═══════════════════════════════════════════════════════
+
+esp_err_t sts_protocol_init(sts_bus_t *bus, const sts_protocol_config_t *config)
+{
+    bus->uart_num = config->uart_num;
+    bus->timing_mode = config->timing_mode;
+    ESP_LOGI(TAG, "Simulated bus on UART %d at %lu baud", config->uart_num,
+             (unsigned long)config->baud_rate);
+    return ESP_OK;
+}
+
+void sts_protocol_deinit(sts_bus_t *bus)
+{
+    (void)bus;
+}
+
+void sts_protocol_lock(sts_bus_t *bus)
+{
+    (void)bus;
+}
+
+void sts_protocol_unlock(sts_bus_t *bus)
+{
+    (void)bus;
+}
+
+uint8_t sts_checksum(uint8_t *buf, int len)
+{
+    uint8_t sum = 0;
+    for (int i = 2; i < len - 1; i++) {
+        sum += buf[i];
+    }
+    return ~sum;
+}
+
+void sts_send_packet(sts_bus_t *bus, uint8_t id, uint8_t cmd, uint8_t *params, int param_len)
+{
+    (void)bus;
+    s_stats.packets++;
+    s_reply_len = 0;
+    
+    switch (cmd) {
+        case STS_PING:
+            if (servo(id)) {
+                stage_reply(id, NULL, 0);
+            }
+            break;
+        case STS_READ: {
+            uint8_t data[STS_MAX_PARAM_LEN];
+            if (param_len == 2 && params[1] <= sizeof(data) && read_regs(id, params[0], params[1], data)) {
+                stage_reply(id, data, params[1]);
+            }
+            break;
+        }
+        case STS_WRITE:
+            if (param_len >= 1) {
+                write_regs(id, params[0], params + 1, param_len - 1);
+                if (servo(id)) {
+                    stage_reply(id, NULL, 0);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief A reply that never comes costs the RS485 baud-derived timeout (one tick)
+ */
+static void reply_timeout(void)
+{
+    vTaskDelay(1);
+}
+
+bool sts_read_response(sts_bus_t *bus, uint8_t *response, int max_len, int *out_len)
+{
+    (void)bus;
+    if (s_reply_len == 0 || s_reply_len > max_len) {
+        reply_timeout();
+        return false;
+    }
+    
+    memcpy(response, s_reply, s_reply_len);
+    if (out_len) {
+        *out_len = s_reply_len;
+    }
+    s_reply_len = 0;
+    return true;
+}
+
+void sts_write_register(sts_bus_t *bus, uint8_t id, uint8_t address, uint8_t *data, int len)
+{
+    (void)bus;
+    s_stats.packets++;
+    write_regs(id, address, data, len);
+}
+
+bool sts_read_register(sts_bus_t *bus, uint8_t id, uint8_t address, int len, uint8_t *data)
+{
+    (void)bus;
+    s_stats.packets++;
+    if (!read_regs(id, address, len, data)) {
+        reply_timeout();
+        return false;
+    }
+    return true;
+}
+
+void sts_sync_write(sts_bus_t *bus, uint8_t address, uint8_t data_len,
+                    const uint8_t *ids, const uint8_t *data, int count)
+{
+    (void)bus;
+    s_stats.packets++;
+    for (int i = 0; i < count; i++) {
+        write_regs(ids[i], address, &data[i * data_len], data_len);
+    }
+}
+
+void sts_sync_read_request(sts_bus_t *bus, uint8_t address, uint8_t data_len,
+                           const uint8_t *ids, int count)
+{
+    (void)bus;
+    (void)data_len;
+    (void)ids;
+    (void)count;
+    s_stats.packets++;
+    s_sync_address = address;
+}
+
+int sts_sync_read_collect(sts_bus_t *bus, uint8_t data_len,
+                          const uint8_t *ids, int count, uint8_t *data, bool *valid)
+{
+    int found = 0;
+    
+    (void)bus;
+    for (int i = 0; i < count; i++) {
+        bool ok = read_regs(ids[i], s_sync_address, data_len, &data[i * data_len]);
+        if (valid) {
+            valid[i] = ok;
+        }
+        found += ok;
+    }
+    if (found < count) {
+        reply_timeout();
+    }
+    return found;
+}
+
+int sts_sync_read(sts_bus_t *bus, uint8_t address, uint8_t data_len,
+                  const uint8_t *ids, int count, uint8_t *data, bool *valid)
+{
+    sts_sync_read_request(bus, address, data_len, ids, count);
+    return sts_sync_read_collect(bus, data_len, ids, count, data, valid);
+}
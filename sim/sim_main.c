@@ -0,0 +1,341 @@
+/**
+ * @file sim_main.c
+ * @brief Host Simulation Driver
+ * 
+ * Boots the firmware modules the same way app_main does (dog hardware,
+ * control loop, tuning latch, motion players, IMU + reactions + balance,
+ * gait manager, tracking monitor), runs one gait for the
+ * requested simulated time and prints a one-line summary:
+ * 
+ *   SIM gait=crawl dir=forward sim_s=10.000 host_s=0.0421 speedup=237x
+ *       ticks=1000 overruns=0 goal_writes=4000 packets=1046 hash=0x...
+ * 
+ * The hash covers every recorded goal (time, servo, position, speed), so
+ * two builds produce the same hash exactly when they command the same
+ * trajectory. --out writes the goals as CSV for a closer look.
+ * 
+ * Gaits run on the gait manager, like on the robot. --switch requests a
+ * second gait halfway through, to check hot-switching.
+ */
+
+#include "dog_config.h"
+#include "control_loop.h"
+#include "gyro_balance.h"
+#include "gait_manager.h"
+#include "dog_params.h"
+#include "dog_tracking.h"
+#include "motion_timeline.h"
+#include "motion_player.h"
+#include "sim_rtos.h"
+#include "sim_servo.h"
+#include "sim_imu.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ═══════════════════════════════════════════════════════
+// GAITS
+// ═══════════════════════════════════════════════════════
+
+static const char *const s_directions[] = {
+    [GAIT_DIRECTION_FORWARD] = "forward",
+    [GAIT_DIRECTION_BACKWARD] = "backward",
+    [GAIT_DIRECTION_TURN_LEFT] = "left",
+    [GAIT_DIRECTION_TURN_RIGHT] = "right",
+};
+
+// ═══════════════════════════════════════════════════════
+// COMMAND LINE
+// ═══════════════════════════════════════════════════════
+
+typedef struct {
+    gait_type_t gait;
+    gait_direction_t direction;
+    int stall_id;               // 0 = none
+    double stall_s;
+    bool has_switch;
+    gait_type_t switch_gait;
+    gait_direction_t switch_direction;
+    bool foot_space;
+    double seconds;
+    const char *imu_log;
+    const char *out_path;
+    bool imu;
+    bool balance;
+    int verbosity;
+} sim_options_t;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -g, --gait NAME      crawl | walk | creep | trot (default crawl)\n"
+            "  -d, --dir DIR        forward | backward | left | right (default forward)\n"
+            "  -t, --seconds S      simulated run time (default 10)\n"
+            "  -s, --switch G[:DIR] switch to gait G halfway through\n"
+            "  -x, --stall ID@S     hold servo ID still from S seconds into the run\n"
+            "  -f, --foot-space     straight foot strokes\n"
+            "  -i, --imu-log FILE   replay an IMU log (t_ms,ax,ay,az,gx,gy,gz)\n"
+            "  -n, --no-imu         run without IMU, reactions and balance\n"
+            "  -b, --balance        enable gyro balance\n"
+            "  -o, --out FILE       write commanded goals as CSV\n"
+            "  -v, --verbose        firmware log output (repeat for debug)\n",
+            prog);
+}
+
+static bool parse_direction(const char *name, gait_direction_t *direction)
+{
+    for (int i = 0; i < 4; i++) {
+        if (strcmp(name, s_directions[i]) == 0) {
+            *direction = (gait_direction_t)i;
+            return true;
+        }
+    }
+    fprintf(stderr, "unknown direction '%s'\n", name);
+    return false;
+}
+
+static bool parse_options(int argc, char **argv, sim_options_t *opt)
+{
+    static const struct option long_options[] = {
+        { "gait",    required_argument, NULL, 'g' },
+        { "dir",     required_argument, NULL, 'd' },
+        { "seconds", required_argument, NULL, 't' },
+        { "switch",  required_argument, NULL, 's' },
+        { "stall",   required_argument, NULL, 'x' },
+        { "foot-space", no_argument,    NULL, 'f' },
+        { "imu-log", required_argument, NULL, 'i' },
+        { "no-imu",  no_argument,       NULL, 'n' },
+        { "balance", no_argument,       NULL, 'b' },
+        { "out",     required_argument, NULL, 'o' },
+        { "verbose", no_argument,       NULL, 'v' },
+        { "help",    no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    
+    *opt = (sim_options_t) {
+        .gait = GAIT_TYPE_CRAWL,
+        .direction = GAIT_DIRECTION_FORWARD,
+        .seconds = 10.0,
+        .imu = true,
+    };
+    
+    int c;
+    while ((c = getopt_long(argc, argv, "g:d:t:s:x:fi:nbo:vh", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'g':
+                if (!gait_manager_type_from_name(optarg, &opt->gait)) {
+                    fprintf(stderr, "unknown gait '%s'\n", optarg);
+                    return false;
+                }
+                break;
+            case 'd':
+                if (!parse_direction(optarg, &opt->direction)) {
+                    return false;
+                }
+                break;
+            case 's': {
+                char *dir = strchr(optarg, ':');
+                opt->switch_direction = GAIT_DIRECTION_STOP;    // Same as --dir
+                if (dir) {
+                    *dir++ = '\0';
+                    if (!parse_direction(dir, &opt->switch_direction)) {
+                        return false;
+                    }
+                }
+                if (!gait_manager_type_from_name(optarg, &opt->switch_gait)) {
+                    fprintf(stderr, "unknown gait '%s'\n", optarg);
+                    return false;
+                }
+                opt->has_switch = true;
+                break;
+            }
+            case 't':
+                opt->seconds = atof(optarg);
+                break;
+            case 'x':
+                if (sscanf(optarg, "%d@%lf", &opt->stall_id, &opt->stall_s) != 2 ||
+                    opt->stall_id < 1 || opt->stall_id > DOG_SERVO_COUNT) {
+                    fprintf(stderr, "bad stall '%s' (ID@SECONDS)\n", optarg);
+                    return false;
+                }
+                break;
+            case 'i':
+                opt->imu_log = optarg;
+                break;
+            case 'f':
+                opt->foot_space = true;
+                break;
+            case 'n':
+                opt->imu = false;
+                break;
+            case 'b':
+                opt->balance = true;
+                break;
+            case 'o':
+                opt->out_path = optarg;
+                break;
+            case 'v':
+                opt->verbosity++;
+                break;
+            default:
+                return false;
+        }
+    }
+    if (opt->switch_direction == GAIT_DIRECTION_STOP) {
+        opt->switch_direction = opt->direction;
+    }
+    return opt->seconds > 0;
+}
+
+/**
+ * @brief Holds the --stall servo once its time comes
+ */
+static void stall_task(void *param)
+{
+    const sim_options_t *opt = param;
+    
+    vTaskDelay(pdMS_TO_TICKS((uint32_t)(opt->stall_s * 1000.0)));
+    sim_servo_block((uint8_t)opt->stall_id, true);
+    vTaskDelete(NULL);
+}
+
+static double host_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ═══════════════════════════════════════════════════════
+// MAIN
+// ═══════════════════════════════════════════════════════
+
+int main(int argc, char **argv)
+{
+    sim_options_t opt;
+    if (!parse_options(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    
+    sim_rtos_init();
+    sim_log_set_level(opt.verbosity >= 2 ? ESP_LOG_DEBUG : opt.verbosity ? ESP_LOG_INFO : ESP_LOG_WARN);
+    sim_servo_init(DOG_SERVO_COUNT);
+    
+    if (opt.imu_log && !sim_imu_load(opt.imu_log)) {
+        fprintf(stderr, "cannot read IMU log '%s'\n", opt.imu_log);
+        return 1;
+    }
+    
+    FILE *out = NULL;
+    if (opt.out_path) {
+        out = fopen(opt.out_path, "w");
+        if (out == NULL) {
+            fprintf(stderr, "cannot write '%s'\n", opt.out_path);
+            return 1;
+        }
+        fprintf(out, "t_us,id,position,speed\n");
+    }
+    sim_servo_record(out);
+    
+    // Same bring-up order as app_main, so the control loop clients take the
+    // same slots. Left out: NVS tuning (dog_params_load), app_main's crawl
+    // config override and BLE; the gaits run on their default configs.
+    dog_init(NULL);
+    control_loop_start(CONTROL_LOOP_DEFAULT_HZ);
+    dog_params_init();
+    motion_timeline_init();
+    motion_player_init();
+    if (opt.imu && dog_imu_init()) {
+        dog_imu_task_start();
+        gyro_balance_enable(opt.balance);
+    }
+    
+    if (!gait_manager_init()) {
+        fprintf(stderr, "gait manager failed to initialize\n");
+        return 1;
+    }
+    for (int t = 0; opt.foot_space && t < GAIT_TYPE_COUNT; t++) {
+        gait_config_t config;
+        gait_manager_get_config((gait_type_t)t, &config);
+        config.foot_space = true;
+        gait_manager_set_config((gait_type_t)t, &config);
+    }
+    vTaskDelay(pdMS_TO_TICKS(500));     // First tick parks at stance
+    
+    dog_tracking_init();
+    
+    double host_start = host_seconds();
+    int64_t sim_start = sim_now_us();
+    uint32_t run_ms = (uint32_t)(opt.seconds * 1000.0);
+    
+    if (opt.stall_id) {
+        xTaskCreate(stall_task, "stall", 4096, &opt, 1, NULL);
+    }
+    
+    if (!gait_manager_start(opt.gait, opt.direction)) {
+        fprintf(stderr, "%s cannot walk %s\n", gait_manager_type_name(opt.gait),
+                s_directions[opt.direction]);
+        return 1;
+    }
+    if (opt.has_switch) {
+        vTaskDelay(pdMS_TO_TICKS(run_ms / 2));
+        if (!gait_manager_start(opt.switch_gait, opt.switch_direction)) {
+            fprintf(stderr, "%s cannot walk %s\n", gait_manager_type_name(opt.switch_gait),
+                    s_directions[opt.switch_direction]);
+            return 1;
+        }
+        vTaskDelay(pdMS_TO_TICKS(run_ms - run_ms / 2));
+    } else {
+        vTaskDelay(pdMS_TO_TICKS(run_ms));
+    }
+    gait_manager_stop();
+    
+    double host_s = host_seconds() - host_start;
+    double sim_s = (sim_now_us() - sim_start) / 1e6;
+    
+    control_loop_stats_t loop;
+    sim_servo_stats_t bus;
+    control_loop_get_stats(&loop);
+    sim_servo_get_stats(&bus);
+    
+    printf("SIM gait=%s dir=%s sim_s=%.3f host_s=%.4f speedup=%.0fx ticks=%lu overruns=%lu "
+           "goal_writes=%lu packets=%lu hash=0x%016llx\n",
+           gait_manager_type_name(opt.gait), s_directions[opt.direction], sim_s, host_s,
+           host_s > 0 ? sim_s / host_s : 0.0,
+           (unsigned long)loop.ticks, (unsigned long)loop.overruns,
+           (unsigned long)bus.goal_writes, (unsigned long)bus.packets,
+           (unsigned long long)bus.hash);
+    
+    if (opt.stall_id) {
+        dog_tracking_stats_t tk;
+        dog_tracking_get_stats(&tk);
+        const dog_tracking_servo_stats_t *ts = &tk.servo[opt.stall_id - 1];
+        printf("SIM stall=%d@%.3f speed_level=%u stroke_level=%u lag=%lu stall=%lu overload=%lu "
+               "err_max=%u faults=0x%02x\n",
+               opt.stall_id, opt.stall_s, tk.speed_level, tk.amplitude_level,
+               (unsigned long)tk.lag_events, (unsigned long)tk.stall_events,
+               (unsigned long)tk.overload_events, ts->error_max, ts->faults);
+    }
+    
+    if (opt.has_switch) {
+        gait_manager_state_t state;
+        gait_manager_get_state(&state);
+        printf("SIM switch=%s:%s transitions=%lu\n",
+               gait_manager_type_name(opt.switch_gait), s_directions[opt.switch_direction],
+               (unsigned long)state.transitions);
+    }
+    
+    if (out) {
+        fclose(out);
+    }
+    
+    // The other tasks are coroutines on this thread; nothing to join
+    exit(0);
+}
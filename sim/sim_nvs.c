@@ -0,0 +1,145 @@
+/**
+ * @file sim_nvs.c
+ * @brief Host Simulation: In-Memory NVS
+ * 
+ * Enough of the blob API for the firmware's stored settings. Namespaces
+ * are kept per handle; entries live until the process exits.
+ */
+
+#include "nvs.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_NVS_MAX_ENTRIES     32
+#define SIM_NVS_MAX_NAMESPACES  8
+#define SIM_NVS_NAME_LEN        16      // NVS limit (15 characters)
+
+typedef struct {
+    uint8_t ns;                         // Namespace index + 1 (0 = free)
+    char key[SIM_NVS_NAME_LEN];
+    void *data;
+    size_t len;
+} sim_nvs_entry_t;
+
+static char s_namespaces[SIM_NVS_MAX_NAMESPACES][SIM_NVS_NAME_LEN];
+static sim_nvs_entry_t s_entries[SIM_NVS_MAX_ENTRIES];
+
+static sim_nvs_entry_t *find(nvs_handle_t handle, const char *key)
+{
+    for (int i = 0; i < SIM_NVS_MAX_ENTRIES; i++) {
+        if (s_entries[i].ns == handle && strcmp(s_entries[i].key, key) == 0) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+static bool valid_handle(nvs_handle_t handle)
+{
+    return handle >= 1 && handle <= SIM_NVS_MAX_NAMESPACES && s_namespaces[handle - 1][0];
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    int free_slot = -1;
+    
+    for (int i = 0; i < SIM_NVS_MAX_NAMESPACES; i++) {
+        if (strcmp(s_namespaces[i], name) == 0) {
+            *out_handle = i + 1;
+            return ESP_OK;
+        }
+        if (!s_namespaces[i][0] && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    
+    // Like the real thing: a read-only open of an unknown namespace fails
+    if (open_mode == NVS_READONLY) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (free_slot < 0 || strlen(name) >= SIM_NVS_NAME_LEN) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+    
+    strcpy(s_namespaces[free_slot], name);
+    *out_handle = free_slot + 1;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return valid_handle(handle) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    if (!valid_handle(handle)) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    
+    sim_nvs_entry_t *e = find(handle, key);
+    if (e == NULL) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    
+    if (out_value == NULL) {
+        *length = e->len;
+        return ESP_OK;
+    }
+    if (*length < e->len) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out_value, e->data, e->len);
+    *length = e->len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    if (!valid_handle(handle) || strlen(key) >= SIM_NVS_NAME_LEN) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    
+    sim_nvs_entry_t *e = find(handle, key);
+    for (int i = 0; e == NULL && i < SIM_NVS_MAX_ENTRIES; i++) {
+        if (s_entries[i].ns == 0) {
+            e = &s_entries[i];
+            e->ns = (uint8_t)handle;
+            strcpy(e->key, key);
+        }
+    }
+    if (e == NULL) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+    
+    void *data = malloc(length ? length : 1);
+    if (data == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(data, value, length);
+    free(e->data);
+    e->data = data;
+    e->len = length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    if (!valid_handle(handle)) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    
+    sim_nvs_entry_t *e = find(handle, key);
+    if (e == NULL) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    free(e->data);
+    memset(e, 0, sizeof(*e));
+    return ESP_OK;
+}
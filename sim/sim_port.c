@@ -0,0 +1,48 @@
+/**
+ * @file sim_port.c
+ * @brief Host Simulation: Logging and Error Names
+ */
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "sim_rtos.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+static esp_log_level_t s_level = ESP_LOG_WARN;
+
+void sim_log_set_level(esp_log_level_t level)
+{
+    s_level = level;
+}
+
+void sim_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    
+    if (level > s_level) {
+        return;
+    }
+    
+    fprintf(stderr, "%c (%9.3f) %s: ", letters[level], sim_now_us() / 1000.0, tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_FAIL:              return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+        default:                    return "UNKNOWN ERROR";
+    }
+}
@@ -0,0 +1,423 @@
+/**
+ * @file sim_rtos.c
+ * @brief Deterministic Cooperative Scheduler Implementation
+ * 
+ * Ready tasks are the ones whose wake time has been reached; among those
+ * the highest priority runs, then the earliest created. A task that
+ * makes a higher priority task ready (create, notify) yields to it, as a
+ * preemptive kernel would.
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "sim_rtos.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+
+#define WAKE_NEVER          INT64_MAX
+#define TIMER_TASK_PRIORITY 22      // esp_timer task priority on target
+
+struct sim_task {
+    ucontext_t ctx;
+    void *stack;
+    TaskFunction_t fn;
+    void *param;
+    const char *name;
+    UBaseType_t priority;
+    int64_t wake_us;
+    uint32_t notify;
+    bool waiting_notify;
+    bool alive;
+};
+
+// ═══════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════
+
+static struct sim_task s_tasks[SIM_MAX_TASKS];
+static int s_task_count = 0;
+static struct sim_task *s_current = NULL;
+static int64_t s_now_us = 0;
+
+// ═══════════════════════════════════════════════════════
+// SCHEDULER
+// ═══════════════════════════════════════════════════════
+
+static struct sim_task *pick_next(void)
+{
+    struct sim_task *best = NULL;
+    
+    for (int i = 0; i < s_task_count; i++) {
+        struct sim_task *t = &s_tasks[i];
+        if (!t->alive || t->wake_us == WAKE_NEVER) {
+            continue;
+        }
+        
+        // Anything already due competes on priority alone
+        int64_t due = (t->wake_us < s_now_us) ? s_now_us : t->wake_us;
+        int64_t best_due = best ? ((best->wake_us < s_now_us) ? s_now_us : best->wake_us) : 0;
+        if (best == NULL || due < best_due || (due == best_due && t->priority > best->priority)) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Switch to the next ready task (returns when the caller runs again)
+ */
+static void reschedule(void)
+{
+    struct sim_task *next = pick_next();
+    if (next == NULL) {
+        fprintf(stderr, "sim: every task is blocked forever at t=%lld us\n", (long long)s_now_us);
+        exit(1);
+    }
+    
+    if (next->wake_us > s_now_us) {
+        s_now_us = next->wake_us;
+    }
+    
+    struct sim_task *prev = s_current;
+    if (next != prev) {
+        s_current = next;
+        if (prev->alive) {
+            swapcontext(&prev->ctx, &next->ctx);
+        } else {
+            setcontext(&next->ctx);
+        }
+    }
+}
+
+static void task_entry(void)
+{
+    s_current->fn(s_current->param);
+    vTaskDelete(NULL);
+}
+
+static void block_until(int64_t t_us)
+{
+    s_current->wake_us = t_us;
+    reschedule();
+}
+
+// ═══════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════
+
+void sim_rtos_init(void)
+{
+    s_task_count = 1;
+    s_current = &s_tasks[0];
+    *s_current = (struct sim_task) {
+        .name = "main",
+        .priority = SIM_MAIN_PRIORITY,
+        .wake_us = 0,
+        .alive = true,
+    };
+}
+
+int64_t sim_now_us(void)
+{
+    return s_now_us;
+}
+
+void sim_sleep_until_us(int64_t t_us)
+{
+    block_until(t_us > s_now_us ? t_us : s_now_us);
+}
+
+int sim_task_count(void)
+{
+    return s_task_count;
+}
+
+
+// ═══════════════════════════════════════════════════════
+// FREERTOS TASK API
+// ═══════════════════════════════════════════════════════
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                       void *param, UBaseType_t priority, TaskHandle_t *out_handle)
+{
+    if (s_task_count >= SIM_MAX_TASKS) {
+        fprintf(stderr, "sim: too many tasks (creating %s)\n", name);
+        return pdFAIL;
+    }
+    
+    size_t stack_size = (size_t)stack_depth * 8;
+    if (stack_size < SIM_MIN_STACK) {
+        stack_size = SIM_MIN_STACK;
+    }
+    
+    struct sim_task *t = &s_tasks[s_task_count++];
+    *t = (struct sim_task) {
+        .stack = malloc(stack_size),
+        .fn = fn,
+        .param = param,
+        .name = name,
+        .priority = priority,
+        .wake_us = s_now_us,
+        .alive = true,
+    };
+    if (t->stack == NULL) {
+        s_task_count--;
+        return pdFAIL;
+    }
+    
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->stack;
+    t->ctx.uc_stack.ss_size = stack_size;
+    t->ctx.uc_link = NULL;
+    makecontext(&t->ctx, task_entry, 0);
+    
+    if (out_handle) {
+        *out_handle = t;
+    }
+    
+    if (priority > s_current->priority) {
+        block_until(s_now_us);      // Preempted by the new task
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                                   void *param, UBaseType_t priority, TaskHandle_t *out_handle,
+                                   BaseType_t core_id)
+{
+    (void)core_id;
+    return xTaskCreate(fn, name, stack_depth, param, priority, out_handle);
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                                           void *param, UBaseType_t priority, StackType_t *stack,
+                                           StaticTask_t *tcb, BaseType_t core_id)
+{
+    (void)stack;
+    (void)tcb;
+    (void)core_id;
+    TaskHandle_t handle = NULL;
+    if (xTaskCreate(fn, name, stack_depth, param, priority, &handle) != pdPASS) {
+        return NULL;
+    }
+    return handle;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL || task == s_current) {
+        // The stack stays allocated: we are still running on it
+        s_current->alive = false;
+        reschedule();
+        return;
+    }
+    task->alive = false;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (ticks == 0) {
+        block_until(s_now_us);
+        return;
+    }
+    
+    // Like the kernel: wake on a tick boundary
+    block_until(((int64_t)xTaskGetTickCount() + ticks) * SIM_TICK_US);
+}
+
+BaseType_t xTaskDelayUntil(TickType_t *previous_wake, TickType_t increment)
+{
+    TickType_t wake = *previous_wake + increment;
+    *previous_wake = wake;
+    
+    if ((int64_t)wake * SIM_TICK_US <= s_now_us) {
+        return pdFALSE;     // Already late, no delay
+    }
+    block_until((int64_t)wake * SIM_TICK_US);
+    return pdTRUE;
+}
+
+void vTaskDelayUntil(TickType_t *previous_wake, TickType_t increment)
+{
+    xTaskDelayUntil(previous_wake, increment);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(s_now_us / SIM_TICK_US);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return s_current;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    if (s_current->notify == 0 && ticks_to_wait > 0) {
+        s_current->waiting_notify = true;
+        block_until((ticks_to_wait == portMAX_DELAY)
+                    ? WAKE_NEVER
+                    : ((int64_t)xTaskGetTickCount() + ticks_to_wait) * SIM_TICK_US);
+        s_current->waiting_notify = false;
+    }
+    
+    uint32_t value = s_current->notify;
+    if (clear_on_exit) {
+        s_current->notify = 0;
+    } else if (value > 0) {
+        s_current->notify--;
+    }
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    task->notify++;
+    if (task->waiting_notify) {
+        task->wake_us = s_now_us;
+        if (task->priority > s_current->priority) {
+            block_until(s_now_us);
+        }
+    }
+    return pdPASS;
+}
+
+// ═══════════════════════════════════════════════════════
+// ESP_TIMER
+// ═══════════════════════════════════════════════════════
+
+struct sim_timer {
+    esp_timer_create_args_t args;
+    TaskHandle_t task;
+    int64_t next_us;            // WAKE_NEVER while stopped
+    uint64_t period_us;         // 0 for one-shot
+};
+
+static void timer_task(void *param)
+{
+    struct sim_timer *timer = (struct sim_timer *)param;
+    
+    while (1) {
+        block_until(timer->next_us);
+        if (timer->next_us == WAKE_NEVER || s_now_us < timer->next_us) {
+            continue;           // Stopped or restarted while waiting
+        }
+        
+        timer->next_us = timer->period_us ? timer->next_us + (int64_t)timer->period_us : WAKE_NEVER;
+        timer->args.callback(timer->args.arg);
+    }
+}
+
+/**
+ * @brief Re-arm a timer task to wake at the timer's next expiry
+ */
+static void timer_rearm(struct sim_timer *timer)
+{
+    timer->task->wake_us = timer->next_us;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_us;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out_handle)
+{
+    if (args == NULL || args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    struct sim_timer *timer = calloc(1, sizeof(*timer));
+    if (timer == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->args = *args;
+    timer->next_us = WAKE_NEVER;
+    
+    if (xTaskCreate(timer_task, args->name ? args->name : "esp_timer", 4096, timer,
+                    TIMER_TASK_PRIORITY, &timer->task) != pdPASS) {
+        free(timer);
+        return ESP_ERR_NO_MEM;
+    }
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    timer->period_us = period_us;
+    timer->next_us = s_now_us + (int64_t)period_us;
+    timer_rearm(timer);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    timer->period_us = 0;
+    timer->next_us = s_now_us + (int64_t)timeout_us;
+    timer_rearm(timer);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    timer->next_us = WAKE_NEVER;
+    timer_rearm(timer);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    vTaskDelete(timer->task);
+    free(timer);
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════
+// MUTEXES
+// ═══════════════════════════════════════════════════════
+
+struct sim_mutex {
+    int depth;              // Same layout as StaticSemaphore_t
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return calloc(1, sizeof(struct sim_mutex));
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return calloc(1, sizeof(struct sim_mutex));
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t *buffer)
+{
+    buffer->depth = 0;
+    return (SemaphoreHandle_t)buffer;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    mutex->depth++;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex)
+{
+    if (mutex->depth == 0) {
+        return pdFALSE;
+    }
+    mutex->depth--;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t mutex)
+{
+    free(mutex);
+}
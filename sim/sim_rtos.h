@@ -0,0 +1,43 @@
+/**
+ * @file sim_rtos.h
+ * @brief Deterministic Cooperative Scheduler for the Host Simulation
+ * 
+ * Every FreeRTOS task of the simulated firmware becomes a ucontext
+ * coroutine. Only one runs at a time and it runs until it blocks
+ * (delay, notify wait); running code takes no simulated time. When all
+ * tasks are blocked, simulated time jumps to the earliest wake-up. Runs
+ * are therefore reproducible bit for bit and as fast as the host can
+ * execute the control code.
+ */
+
+#ifndef SIM_RTOS_H
+#define SIM_RTOS_H
+
+#include <stdint.h>
+
+#define SIM_TICK_US         (1000000 / configTICK_RATE_HZ)
+#define SIM_MAX_TASKS       32
+#define SIM_MIN_STACK       (256 * 1024)    // Host frames (printf, libm) are larger than on target
+#define SIM_MAIN_PRIORITY   1               // Priority of the adopted main thread (app_main)
+
+/**
+ * @brief Adopt the calling thread as the first task (app_main)
+ */
+void sim_rtos_init(void);
+
+/**
+ * @brief Current simulated time (µs since start)
+ */
+int64_t sim_now_us(void);
+
+/**
+ * @brief Block the calling task until the given simulated time
+ */
+void sim_sleep_until_us(int64_t t_us);
+
+/**
+ * @brief Number of tasks created so far (including main)
+ */
+int sim_task_count(void);
+
+#endif // SIM_RTOS_H
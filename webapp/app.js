@@ -11,6 +11,7 @@
 
 const BLE_SERVICE_UUID = '0d9be2a0-4757-43d9-83df-704ae274b8df';
 const BLE_CHARACTERISTIC_UUID = '8116d8c0-d45d-4fdf-998e-33ab8c471d59';
+const BLE_TELEMETRY_UUID = '8116d8c1-d45d-4fdf-998e-33ab8c471d59';
 const BLE_DEVICE_NAME = 'MicroPupper';
 
 // ═══════════════════════════════════════════════════════
@@ -23,6 +24,8 @@ let isConnected = false;
 let keyframes = [];
 let isPlaying = false;
 let keyframeMode = 'unified'; // 'unified' or 'offset'
+let queuePaused = false;      // Device motion queue asked us to wait
+let telemetrySamples = [];    // Decoded telemetry, newest last
 
 // Default stance positions
 const STANCE = {
@@ -90,6 +93,10 @@ const elements = {
     playBtn: document.getElementById('play-btn'),
     cycleCount: document.getElementById('cycle-count'),
     clearBtn: document.getElementById('clear-btn'),
+    timelineSlot: document.getElementById('timeline-slot'),
+    timelineLoop: document.getElementById('timeline-loop'),
+    storeBtn: document.getElementById('store-btn'),
+    playStoredBtn: document.getElementById('play-stored-btn'),
     timeline: document.getElementById('timeline'),
     animationName: document.getElementById('animation-name'),
     saveBtn: document.getElementById('save-btn'),
@@ -105,6 +112,8 @@ const elements = {
     importBatchInput: document.getElementById('import-batch-input'),
     
     // Log
+    telemetryReadout: document.getElementById('telemetry-readout'),
+    telemetryPlot: document.getElementById('telemetry-plot'),
     log: document.getElementById('log')
 };
 
@@ -160,6 +169,15 @@ async function connect() {
         await bleCharacteristic.startNotifications();
         bleCharacteristic.addEventListener('characteristicvaluechanged', onNotification);
         
+        // Telemetry stream (older firmware has no telemetry characteristic)
+        try {
+            const telemetry = await service.getCharacteristic(BLE_TELEMETRY_UUID);
+            await telemetry.startNotifications();
+            telemetry.addEventListener('characteristicvaluechanged', onTelemetry);
+        } catch (e) {
+            log('Telemetry not available', 'info');
+        }
+        
         setConnected(true);
         log('Connected successfully!', 'success');
         
@@ -182,13 +200,183 @@ function onDisconnected() {
     log('Device disconnected', 'error');
 }
 
+// Chunked responses being reassembled: id -> array of data parts
+const pendingChunks = new Map();
+
+/**
+ * Collect a {"chunk":{id,index,total,data}} part
+ * @returns the joined response once every part arrived, else null
+ */
+function collectChunk(chunk) {
+    let parts = pendingChunks.get(chunk.id);
+    if (!parts || parts.length !== chunk.total) {
+        parts = new Array(chunk.total);
+        pendingChunks.set(chunk.id, parts);
+    }
+    parts[chunk.index] = chunk.data;
+    
+    for (let i = 0; i < parts.length; i++) {
+        if (parts[i] === undefined) return null;
+    }
+    pendingChunks.delete(chunk.id);
+    return parts.join('');
+}
+
 function onNotification(event) {
-    const value = new TextDecoder().decode(event.target.value);
+    let value = new TextDecoder().decode(event.target.value);
+    
+    // Long responses arrive in parts; handle them once complete
+    if (value.startsWith('{"chunk":')) {
+        try {
+            value = collectChunk(JSON.parse(value).chunk);
+        } catch (e) {
+            value = null;
+        }
+        if (value === null) return;
+    }
     log(`Received: ${value}`, 'info');
+    
+    // Motion queue backpressure: {"bp":1} pause, {"bp":0} resume
+    try {
+        const msg = JSON.parse(value);
+        if (msg.bp !== undefined) {
+            queuePaused = (msg.bp === 1);
+        }
+        if (msg.mtu !== undefined) {
+            setNegotiatedMtu(msg.mtu);
+        }
+    } catch (e) {
+        // Not JSON - nothing to track
+    }
+}
+
+// ═══════════════════════════════════════════════════════
+// TELEMETRY
+// ═══════════════════════════════════════════════════════
+
+// Field order of a telemetry sample (see ble_telemetry.h)
+const TELEMETRY_FIELDS = [
+    't_ms', 'valid',
+    'fr_pos', 'fr_speed', 'fr_load', 'fr_temp',
+    'fl_pos', 'fl_speed', 'fl_load', 'fl_temp',
+    'br_pos', 'br_speed', 'br_load', 'br_temp',
+    'bl_pos', 'bl_speed', 'bl_load', 'bl_temp',
+    'roll', 'pitch', 'roll_rate', 'pitch_rate',
+    'loop_jitter_us', 'loop_exec_us', 'loop_overruns'
+];
+const TELEMETRY_VERSION = 1;
+const TELEMETRY_HISTORY = 250;  // Samples kept for the plot (5 s at 50 Hz)
+
+/**
+ * Decode a telemetry notification: [version][seq][count] + zigzag varints,
+ * first sample absolute, later samples as deltas
+ */
+function decodeTelemetry(bytes) {
+    if (bytes.length < 3 || bytes[0] !== TELEMETRY_VERSION) return [];
+    
+    const count = bytes[2];
+    const samples = [];
+    let pos = 3;
+    let prev = null;
+    
+    const readVarint = () => {
+        let z = 0, shift = 0, b;
+        do {
+            if (pos >= bytes.length) throw new Error('truncated');
+            b = bytes[pos++];
+            z |= (b & 0x7F) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        return (z >>> 1) ^ -(z & 1);
+    };
+    
+    for (let i = 0; i < count; i++) {
+        const values = TELEMETRY_FIELDS.map((_, f) => {
+            const v = readVarint();
+            return prev ? (prev[f] + v) | 0 : v;
+        });
+        prev = values;
+        
+        const sample = {};
+        TELEMETRY_FIELDS.forEach((name, f) => { sample[name] = values[f]; });
+        samples.push(sample);
+    }
+    return samples;
+}
+
+function onTelemetry(event) {
+    const v = event.target.value;
+    let samples;
+    try {
+        samples = decodeTelemetry(new Uint8Array(v.buffer, v.byteOffset, v.byteLength));
+    } catch (e) {
+        return;     // Malformed notification - skip it
+    }
+    if (samples.length === 0) return;
+    
+    telemetrySamples.push(...samples);
+    if (telemetrySamples.length > TELEMETRY_HISTORY) {
+        telemetrySamples.splice(0, telemetrySamples.length - TELEMETRY_HISTORY);
+    }
+    
+    const s = samples[samples.length - 1];
+    const deg = p => (p * 360 / 4096).toFixed(0);
+    elements.telemetryReadout.textContent =
+        `FR ${deg(s.fr_pos)}° FL ${deg(s.fl_pos)}° BR ${deg(s.br_pos)}° BL ${deg(s.bl_pos)}° | ` +
+        `roll ${(s.roll / 100).toFixed(1)}° pitch ${(s.pitch / 100).toFixed(1)}° | ` +
+        `temp ${s.fr_temp}/${s.fl_temp}/${s.br_temp}/${s.bl_temp}°C | ` +
+        `loop ${s.loop_exec_us}µs jitter ${s.loop_jitter_us}µs overruns ${s.loop_overruns}`;
+    drawTelemetry();
+}
+
+/**
+ * Plot servo angles (0-360°) and roll/pitch (±45°) over the kept history
+ */
+function drawTelemetry() {
+    const canvas = elements.telemetryPlot;
+    const ctx = canvas.getContext('2d');
+    const w = canvas.width, h = canvas.height;
+    ctx.clearRect(0, 0, w, h);
+    
+    const series = [
+        { key: 'fr_pos', color: '#4a90d9', scale: p => p / 4096 },
+        { key: 'fl_pos', color: '#5cb85c', scale: p => p / 4096 },
+        { key: 'br_pos', color: '#f0ad4e', scale: p => p / 4096 },
+        { key: 'bl_pos', color: '#d9534f', scale: p => p / 4096 },
+        { key: 'roll', color: '#ecf0f1', scale: r => 0.5 + r / 9000 },
+        { key: 'pitch', color: '#a0a0a0', scale: r => 0.5 + r / 9000 }
+    ];
+    const step = w / (TELEMETRY_HISTORY - 1);
+    
+    for (const line of series) {
+        ctx.strokeStyle = line.color;
+        ctx.beginPath();
+        telemetrySamples.forEach((s, i) => {
+            const y = h - Math.min(1, Math.max(0, line.scale(s[line.key]))) * h;
+            if (i === 0) ctx.moveTo(i * step, y); else ctx.lineTo(i * step, y);
+        });
+        ctx.stroke();
+    }
+}
+
+/**
+ * Size chunks to the MTU the device negotiated ({"mtu":n})
+ * Below the default, long writes still carry the default chunk size.
+ */
+function setNegotiatedMtu(mtu) {
+    const writeMax = Math.min(mtu - ATT_WRITE_OVERHEAD, BLE_WRITE_MAX);
+    const overhead = BLE_USE_BINARY ? FRAME_CHUNK_OVERHEAD : JSON_CHUNK_OVERHEAD;
+    const size = Math.max(BLE_CHUNK_SIZE_DEFAULT, writeMax - overhead);
+    if (size !== bleChunkSize) {
+        bleChunkSize = size;
+        log(`MTU ${mtu}: ${bleChunkSize}-byte chunks`, 'info');
+    }
 }
 
 function setConnected(connected) {
     isConnected = connected;
+    queuePaused = false;
+    if (!connected) bleChunkSize = BLE_CHUNK_SIZE_DEFAULT;
     elements.statusDot.className = `status-dot ${connected ? 'connected' : 'disconnected'}`;
     elements.statusText.textContent = connected ? 'Connected' : 'Disconnected';
     elements.connectBtn.disabled = connected;
@@ -199,12 +387,57 @@ function setConnected(connected) {
 // BLE COMMANDS
 // ═══════════════════════════════════════════════════════
 
-// BLE chunk size - conservative to work with default MTU
-const BLE_CHUNK_SIZE = 180;  // Max payload per chunk (leaves room for chunk header)
+// BLE chunk size - conservative until the device reports its MTU
+const BLE_CHUNK_SIZE_DEFAULT = 180;  // Max payload per chunk (leaves room for chunk header)
 const BLE_CHUNK_DELAY = 50;  // ms between chunks for reliability
+const BLE_WRITE_MAX = 512;   // Device receive buffer (one ATT attribute)
+const ATT_WRITE_OVERHEAD = 3;       // Opcode + attribute handle
+const JSON_CHUNK_OVERHEAD = 32;     // {"k":..,"t":..,"d":".."} envelope and escapes
+let bleChunkSize = BLE_CHUNK_SIZE_DEFAULT;
+
+// Binary frames (see ble_servo.h); set to false to send the JSON commands
+const BLE_USE_BINARY = true;
+const FRAME_OP = {
+    MOVE: 0x01,
+    SEQUENCE: 0x02,
+    LEG_MOVE: 0x03,
+    LEG_SEQUENCE: 0x04,
+    PING: 0x05,
+    STANCE: 0x06,
+    STATS: 0x07,
+    CHUNK: 0x08,
+    TL_BEGIN: 0x09,
+    TL_EVENTS: 0x0A,
+    TL_COMMIT: 0x0B,
+    TL_PLAY: 0x0C
+};
+const FRAME_ANGLE_SCALE = 10;   // int16 units per degree
+const FRAME_MOVE_SIZE = 12;     // Bytes per move payload
+const FRAME_OVERHEAD = 3;       // Opcode + CRC
+const FRAME_CHUNK_OVERHEAD = 5; // Opcode + num + total + CRC
+const FRAME_TL_EVENT_SIZE = 10; // t_ms:u32, leg:u8, interp:u8, angle:i16, speed:u16
+
+// Moves / timeline events per frame (a frame must fit one chunk)
+const frameMaxMoves = () => Math.floor((bleChunkSize - FRAME_OVERHEAD - 1) / FRAME_MOVE_SIZE);
+const frameMaxTimelineEvents = () => Math.floor((bleChunkSize - FRAME_OVERHEAD - 2) / FRAME_TL_EVENT_SIZE);
+const TIMELINE_MAX_EVENTS = 256;    // MOTION_TIMELINE_MAX_EVENTS
+const TIMELINE_FLAG_LOOP = 0x01;
+
+// Longest wait for the device to lift backpressure before sending anyway
+const QUEUE_WAIT_MAX = 10000;   // ms
+
+/**
+ * Wait while the device motion queue is over its high mark
+ */
+async function waitForQueue() {
+    const start = Date.now();
+    while (queuePaused && isConnected && Date.now() - start < QUEUE_WAIT_MAX) {
+        await sleep(20);
+    }
+}
 
 /**
- * Send raw data to BLE characteristic
+ * Send raw data to BLE characteristic (string or Uint8Array)
  */
 async function sendRaw(data) {
     if (!isConnected || !bleCharacteristic) {
@@ -212,9 +445,11 @@ async function sendRaw(data) {
         return false;
     }
     
+    await waitForQueue();
+    
     try {
-        const encoder = new TextEncoder();
-        await bleCharacteristic.writeValue(encoder.encode(data));
+        const bytes = (typeof data === 'string') ? new TextEncoder().encode(data) : data;
+        await bleCharacteristic.writeValue(bytes);
         return true;
     } catch (error) {
         log(`Send failed: ${error.message}`, 'error');
@@ -224,7 +459,8 @@ async function sendRaw(data) {
 
 /**
  * Send command - automatically chunks if message is too large
- * Chunk format: {"k":<num>,"t":<total>,"d":"<data>"}
+ * Chunk format: CHUNK frame [0x08][num][total][data][crc16], or
+ * {"k":<num>,"t":<total>,"d":"<data>"} when BLE_USE_BINARY is off
  */
 async function sendCommand(cmd) {
     if (!isConnected || !bleCharacteristic) {
@@ -235,26 +471,39 @@ async function sendCommand(cmd) {
     const json = JSON.stringify(cmd);
     
     // If small enough, send directly
-    if (json.length <= BLE_CHUNK_SIZE) {
+    if (json.length <= bleChunkSize) {
         const success = await sendRaw(json);
         if (success) log(`Sent: ${json}`, 'success');
         return success;
     }
     
-    // Need to chunk the message
-    const totalChunks = Math.ceil(json.length / BLE_CHUNK_SIZE);
-    log(`Chunking: ${json.length} bytes into ${totalChunks} chunks...`, 'info');
+    // Need to chunk the message (binary chunks carry the raw JSON bytes)
+    const bytes = new TextEncoder().encode(json);
+    const totalChunks = Math.ceil(bytes.length / bleChunkSize);
+    if (BLE_USE_BINARY && totalChunks > 255) {
+        log(`Command too large: ${bytes.length} bytes`, 'error');
+        return false;
+    }
+    log(`Chunking: ${bytes.length} bytes into ${totalChunks} chunks...`, 'info');
     
     for (let i = 0; i < totalChunks; i++) {
-        const start = i * BLE_CHUNK_SIZE;
-        const end = Math.min(start + BLE_CHUNK_SIZE, json.length);
-        const payload = json.slice(start, end);
+        const start = i * bleChunkSize;
+        const end = Math.min(start + bleChunkSize, bytes.length);
         
-        const chunk = JSON.stringify({
-            k: i + 1,           // chunk number (1-based)
-            t: totalChunks,     // total chunks
-            d: payload          // data payload
-        });
+        let chunk;
+        if (BLE_USE_BINARY) {
+            chunk = buildFrame(FRAME_OP.CHUNK, 2 + (end - start), (view, offset) => {
+                view.setUint8(offset, i + 1);           // chunk number (1-based)
+                view.setUint8(offset + 1, totalChunks); // total chunks
+                new Uint8Array(view.buffer, offset + 2, end - start).set(bytes.subarray(start, end));
+            });
+        } else {
+            chunk = JSON.stringify({
+                k: i + 1,           // chunk number (1-based)
+                t: totalChunks,     // total chunks
+                d: json.slice(start, end)   // data payload
+            });
+        }
         
         const success = await sendRaw(chunk);
         if (!success) {
@@ -274,11 +523,65 @@ async function sendCommand(cmd) {
     return true;
 }
 
+/**
+ * CRC-16/CCITT-FALSE over the first len bytes (matches the firmware)
+ */
+function crc16(bytes, len) {
+    let crc = 0xFFFF;
+    for (let i = 0; i < len; i++) {
+        crc ^= bytes[i] << 8;
+        for (let bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) & 0xFFFF : (crc << 1) & 0xFFFF;
+        }
+    }
+    return crc;
+}
+
+/**
+ * Build a binary frame: [opcode][payload][crc16], little-endian
+ * writePayload(view, offset) fills payloadSize bytes starting at offset
+ */
+function buildFrame(op, payloadSize, writePayload) {
+    const frame = new Uint8Array(FRAME_OVERHEAD + payloadSize);
+    const view = new DataView(frame.buffer);
+    frame[0] = op;
+    if (writePayload) writePayload(view, 1);
+    view.setUint16(1 + payloadSize, crc16(frame, 1 + payloadSize), true);
+    return frame;
+}
+
+/**
+ * Write one move payload (int16 tenths of a degree, uint16 speed/delay)
+ */
+function writeMove(view, offset, m) {
+    view.setInt16(offset, Math.round(m.fr * FRAME_ANGLE_SCALE), true);
+    view.setInt16(offset + 2, Math.round(m.fl * FRAME_ANGLE_SCALE), true);
+    view.setInt16(offset + 4, Math.round(m.br * FRAME_ANGLE_SCALE), true);
+    view.setInt16(offset + 6, Math.round(m.bl * FRAME_ANGLE_SCALE), true);
+    view.setUint16(offset + 8, m.speed, true);
+    view.setUint16(offset + 10, m.delay, true);
+}
+
+/**
+ * Send a binary frame
+ */
+async function sendFrame(frame, label) {
+    const success = await sendRaw(frame);
+    if (success) log(`Sent: ${label} (${frame.length} bytes)`, 'success');
+    return success;
+}
+
 /**
  * Send a single servo position command
- * Format: {"s":[fr,fl,br,bl,speed,delay]}
+ * Format: MOVE frame, or {"s":[fr,fl,br,bl,speed,delay]}
  */
 async function sendServoPosition(fr, fl, br, bl, speed, delay) {
+    if (BLE_USE_BINARY) {
+        const move = { fr, fl, br, bl, speed, delay };
+        return sendFrame(buildFrame(FRAME_OP.MOVE, FRAME_MOVE_SIZE,
+                                    (view, offset) => writeMove(view, offset, move)),
+                         `move [${fr},${fl},${br},${bl},${speed},${delay}]`);
+    }
     return sendCommand({
         s: [fr, fl, br, bl, speed, delay]
     });
@@ -286,9 +589,25 @@ async function sendServoPosition(fr, fl, br, bl, speed, delay) {
 
 /**
  * Send multiple moves as a sequence
- * Format: {"m":[[fr,fl,br,bl,speed,delay],[...]]}
+ * Format: SEQUENCE frames of up to frameMaxMoves() moves (played back to
+ * back by the device), or {"m":[[fr,fl,br,bl,speed,delay],[...]]}
  */
 async function sendServoSequence(moves) {
+    if (BLE_USE_BINARY) {
+        const perFrame = frameMaxMoves();
+        for (let start = 0; start < moves.length; start += perFrame) {
+            const part = moves.slice(start, start + perFrame);
+            const frame = buildFrame(FRAME_OP.SEQUENCE, 1 + part.length * FRAME_MOVE_SIZE,
+                (view, offset) => {
+                    view.setUint8(offset, part.length);
+                    part.forEach((m, i) => writeMove(view, offset + 1 + i * FRAME_MOVE_SIZE, m));
+                });
+            if (!await sendFrame(frame, `sequence ${start + 1}-${start + part.length}/${moves.length}`)) {
+                return false;
+            }
+        }
+        return true;
+    }
     return sendCommand({
         m: moves.map(m => [m.fr, m.fl, m.br, m.bl, m.speed, m.delay])
     });
@@ -296,17 +615,19 @@ async function sendServoSequence(moves) {
 
 /**
  * Send ping command
- * Format: {"p":1}
+ * Format: PING frame, or {"p":1}
  */
 async function sendPing() {
+    if (BLE_USE_BINARY) return sendFrame(buildFrame(FRAME_OP.PING, 0), 'ping');
     return sendCommand({ p: 1 });
 }
 
 /**
  * Send stance (return to default) command
- * Format: {"r":1}
+ * Format: STANCE frame, or {"r":1}
  */
 async function sendStance() {
+    if (BLE_USE_BINARY) return sendFrame(buildFrame(FRAME_OP.STANCE, 0), 'stance');
     return sendCommand({ r: 1 });
 }
 
@@ -328,6 +649,60 @@ async function sendOffsetGait(offsets, keyframes, speed) {
     });
 }
 
+/**
+ * Store a timeline on the device (binary frames only)
+ * Each movement from buildInterleavedSequence() becomes one STEP event:
+ * TL_BEGIN, TL_EVENTS batches, then TL_COMMIT, which stores it in slot id.
+ */
+async function uploadTimeline(id, movements, durationMs, loop) {
+    if (movements.length === 0 || movements.length > TIMELINE_MAX_EVENTS) {
+        log(`Timeline needs 1-${TIMELINE_MAX_EVENTS} events (have ${movements.length})`, 'error');
+        return false;
+    }
+    
+    const begin = buildFrame(FRAME_OP.TL_BEGIN, 8, (view, offset) => {
+        view.setUint8(offset, id);
+        view.setUint8(offset + 1, loop ? TIMELINE_FLAG_LOOP : 0);
+        view.setUint16(offset + 2, movements.length, true);
+        view.setUint32(offset + 4, durationMs, true);
+    });
+    if (!await sendFrame(begin, `timeline ${id} begin`)) return false;
+    
+    const perFrame = frameMaxTimelineEvents();
+    for (let first = 0; first < movements.length; first += perFrame) {
+        const part = movements.slice(first, first + perFrame);
+        const frame = buildFrame(FRAME_OP.TL_EVENTS, 2 + part.length * FRAME_TL_EVENT_SIZE,
+            (view, offset) => {
+                view.setUint16(offset, first, true);
+                part.forEach((mv, i) => {
+                    const o = offset + 2 + i * FRAME_TL_EVENT_SIZE;
+                    view.setUint32(o, Math.round(mv.time), true);
+                    view.setUint8(o + 4, mv.legId);
+                    view.setUint8(o + 5, 0);    // STEP
+                    view.setInt16(o + 6, Math.round(mv.angle * FRAME_ANGLE_SCALE), true);
+                    view.setUint16(o + 8, mv.speed, true);
+                });
+            });
+        if (!await sendFrame(frame, `timeline ${id} events ${first + 1}-${first + part.length}`)) {
+            return false;
+        }
+    }
+    
+    return sendFrame(buildFrame(FRAME_OP.TL_COMMIT, 0), `timeline ${id} commit`);
+}
+
+/**
+ * Replay a stored timeline
+ * Format: TL_PLAY frame, or {"play":id}
+ */
+async function playTimeline(id) {
+    if (BLE_USE_BINARY) {
+        return sendFrame(buildFrame(FRAME_OP.TL_PLAY, 1, (view, offset) => view.setUint8(offset, id)),
+                         `play timeline ${id}`);
+    }
+    return sendCommand({ play: id });
+}
+
 /**
  * Send interleaved movement sequence for offset gait
  * This pre-calculates the exact timing and sends individual moves
@@ -766,6 +1141,28 @@ async function playAnimation() {
     stopAnimation();
 }
 
+/**
+ * Store the current keyframes in the selected device slot
+ * Unified mode uses zero offsets, so all legs share each keyframe time.
+ */
+async function storeTimeline() {
+    if (keyframes.length === 0) {
+        log('No keyframes to store!', 'error');
+        return;
+    }
+    
+    const id = parseInt(elements.timelineSlot.value) || 0;
+    const speed = parseInt(elements.speedInput.value) || 1000;
+    const offsets = (keyframeMode === 'offset') ? getCurrentOffsets() : { fr: 0, fl: 0, br: 0, bl: 0 };
+    const movements = buildInterleavedSequence(keyframes, offsets, speed);
+    const maxOffset = Math.max(offsets.fl, offsets.br, offsets.fr, offsets.bl);
+    const duration = maxOffset + keyframes.reduce((sum, kf) => sum + (kf.delay || 100), 0);
+    
+    if (await uploadTimeline(id, movements, duration, elements.timelineLoop.checked)) {
+        log(`Stored ${movements.length} events in slot ${id}`, 'success');
+    }
+}
+
 function stopAnimation() {
     isPlaying = false;
     elements.playBtn.textContent = '▶️ Play';
@@ -1092,6 +1489,10 @@ function initEventListeners() {
     // Animation
     elements.playBtn.addEventListener('click', playAnimation);
     elements.clearBtn.addEventListener('click', clearKeyframes);
+    elements.storeBtn.addEventListener('click', storeTimeline);
+    elements.playStoredBtn.addEventListener('click', () => {
+        playTimeline(parseInt(elements.timelineSlot.value) || 0);
+    });
     elements.saveBtn.addEventListener('click', saveAnimation);
     elements.addBtn.addEventListener('click', () => {
         const name = elements.animationName.value.trim();